@@ -0,0 +1,402 @@
+/*******************************************************************************
+* File Name: channel.c
+*
+* Version: 1.0
+*
+* Description:
+*  Virtual channel layer of the USBFS Bulk Wraparound example project. The
+*  packets move through the endpoints with the multi-packet transfer API, one
+*  short packet per transfer, so the layer works with every endpoint memory
+*  management mode. An OUT packet is parsed into the receive queues of the
+*  channels as soon as it is read. An IN packet is built when the IN endpoint
+*  is free: first the credits to return, then one DATA frame from each
+*  channel that has a frame and a credit and fits, starting after the last
+*  channel served. A frame that does not fit goes first in the next packet,
+*  and the credits of that packet leave room for it, so a long frame is not
+*  passed over for as long as shorter frames of other channels keep coming.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "channel.h"
+
+/* Packet buffers. They are sized and aligned like the packet buffers of the
+* loopback for the 16-bit APIs.
+*/
+#ifdef CY_ALIGN
+    CY_ALIGN(4) static uint8 channelRxPacket[CHANNEL_PACKET_SIZE + 1u];
+    CY_ALIGN(4) static uint8 channelTxPacket[CHANNEL_PACKET_SIZE + 1u];
+#else
+    #pragma data_alignment = 4
+    static uint8 channelRxPacket[CHANNEL_PACKET_SIZE + 1u];
+    #pragma data_alignment = 4
+    static uint8 channelTxPacket[CHANNEL_PACKET_SIZE + 1u];
+#endif /* (CY_ALIGN) */
+
+static CHANNEL channelState[CHANNEL_COUNT];
+static TRANSFER *channelIn;
+static TRANSFER *channelOut;
+
+/* Channel whose DATA frame is tried first for the next IN packet. */
+static uint8 channelNext;
+
+/* Non-zero when the DATA frame of channelNext did not fit in the last IN
+* packet.
+*/
+static uint8 channelHeld;
+
+uint32 channelErrors;
+
+static void  Channel_Parse(uint8 length);
+static uint8 Channel_Build(void);
+
+
+/*******************************************************************************
+* Function Name: Channel_Start
+********************************************************************************
+*
+* Summary:
+*  Empties the channels and starts receiving. The first IN packet grants the
+*  host CHANNEL_RX_DEPTH credits on every channel; the device sends no DATA
+*  frame until the host grants credits. The transfer control blocks must be
+*  initialized and idle.
+*
+* Parameters:
+*  inTransfer:  Transfer control block of the IN endpoint.
+*  outTransfer: Transfer control block of the OUT endpoint.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Channel_Start(TRANSFER *inTransfer, TRANSFER *outTransfer)
+{
+    uint8 number;
+
+    for (number = 0u; number < CHANNEL_COUNT; ++number)
+    {
+        channelState[number].rxHead    = 0u;
+        channelState[number].rxCount   = 0u;
+        channelState[number].rxCredits = CHANNEL_RX_DEPTH;
+        channelState[number].txLength  = 0u;
+        channelState[number].txCredits = 0u;
+    }
+
+    channelIn     = inTransfer;
+    channelOut    = outTransfer;
+    channelNext   = 0u;
+    channelHeld   = 0u;
+    channelErrors = 0u;
+
+    Transfer_StartOut(channelOut, channelRxPacket, sizeof(channelRxPacket));
+    Channel_Service();
+}
+
+
+/*******************************************************************************
+* Function Name: Channel_Service
+********************************************************************************
+*
+* Summary:
+*  Parses the OUT packet the host has written and sends the next IN packet
+*  when the host has read the previous one. Call it on every endpoint event
+*  and after the application has read or written frames.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Channel_Service(void)
+{
+    uint8 state;
+    uint8 length;
+
+    state = Transfer_Service(channelOut);
+
+    if ((TRANSFER_DONE == state) || (TRANSFER_OVERFLOW == state))
+    {
+        if (TRANSFER_DONE == state)
+        {
+            Channel_Parse((uint8) channelOut->count);
+        }
+        else
+        {
+            /* Packet longer than CHANNEL_PACKET_SIZE. */
+            ++channelErrors;
+        }
+
+        Transfer_StartOut(channelOut, channelRxPacket, sizeof(channelRxPacket));
+    }
+
+    if (TRANSFER_BUSY != Transfer_Service(channelIn))
+    {
+        length = Channel_Build();
+
+        if (0u != length)
+        {
+            Transfer_StartIn(channelIn, channelTxPacket, length);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Channel_Read
+********************************************************************************
+*
+* Summary:
+*  Reads the next frame received on a channel. The credit of the frame is
+*  returned to the host with the next IN packet.
+*
+* Parameters:
+*  number: Channel number.
+*  pData:  Buffer of CHANNEL_MAX_PAYLOAD bytes for the payload.
+*
+* Return:
+*  Number of payload bytes; 0 if the receive queue is empty.
+*
+*******************************************************************************/
+uint8 Channel_Read(uint8 number, uint8 pData[])
+{
+    CHANNEL *channel = &channelState[number];
+    uint8 length = 0u;
+
+    if (0u != channel->rxCount)
+    {
+        length = channel->rxLength[channel->rxHead];
+        (void) memcpy(pData, channel->rxData[channel->rxHead], length);
+
+        channel->rxHead = (channel->rxHead + 1u) % CHANNEL_RX_DEPTH;
+        --channel->rxCount;
+        ++channel->rxCredits;
+    }
+
+    return (length);
+}
+
+
+/*******************************************************************************
+* Function Name: Channel_CanWrite
+********************************************************************************
+*
+* Summary:
+*  Checks if a frame can be written to a channel.
+*
+* Parameters:
+*  number: Channel number.
+*
+* Return:
+*  Non-zero if the transmit slot of the channel is free.
+*
+*******************************************************************************/
+uint8 Channel_CanWrite(uint8 number)
+{
+    return ((0u == channelState[number].txLength) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Channel_Write
+********************************************************************************
+*
+* Summary:
+*  Queues a frame on a channel. It is sent when the host has granted a credit
+*  on the channel and the IN endpoint is free.
+*
+* Parameters:
+*  number: Channel number.
+*  pData:  Payload.
+*  length: Number of payload bytes, 1 to CHANNEL_MAX_PAYLOAD.
+*
+* Return:
+*  Non-zero if the frame is queued; 0 if the transmit slot is in use.
+*
+*******************************************************************************/
+uint8 Channel_Write(uint8 number, const uint8 pData[], uint8 length)
+{
+    CHANNEL *channel = &channelState[number];
+    uint8 queued = 0u;
+
+    if ((0u == channel->txLength) && (0u != length) && (length <= CHANNEL_MAX_PAYLOAD))
+    {
+        (void) memcpy(channel->txData, pData, length);
+        channel->txLength = length;
+        queued = 1u;
+    }
+
+    return (queued);
+}
+
+
+/*******************************************************************************
+* Function Name: Channel_Parse
+********************************************************************************
+*
+* Summary:
+*  Stores the DATA frames of an OUT packet in the receive queues and adds the
+*  credits the host has granted. A DATA frame beyond the credits granted, or
+*  a malformed frame, is counted in channelErrors and dropped; parsing stops
+*  at a malformed frame.
+*
+* Parameters:
+*  length: Number of bytes in the packet.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Channel_Parse(uint8 length)
+{
+    CHANNEL *channel;
+    uint8 offset = 0u;
+    uint8 number;
+    uint8 type;
+    uint8 value;
+    uint8 tail;
+
+    while ((offset + CHANNEL_HEADER_SIZE) <= length)
+    {
+        number = channelRxPacket[offset] & CHANNEL_NUMBER_MASK;
+        type   = channelRxPacket[offset] & CHANNEL_TYPE_MASK;
+        value  = channelRxPacket[offset + 1u];
+        offset += CHANNEL_HEADER_SIZE;
+
+        if (number >= CHANNEL_COUNT)
+        {
+            ++channelErrors;
+            break;
+        }
+
+        channel = &channelState[number];
+
+        if (CHANNEL_FRAME_CREDIT == type)
+        {
+            channel->txCredits += value;
+        }
+        else if ((CHANNEL_FRAME_DATA == type) && (0u != value) && (value <= (length - offset)))
+        {
+            if (channel->rxCount < CHANNEL_RX_DEPTH)
+            {
+                tail = (channel->rxHead + channel->rxCount) % CHANNEL_RX_DEPTH;
+                (void) memcpy(channel->rxData[tail], &channelRxPacket[offset], value);
+                channel->rxLength[tail] = value;
+                ++channel->rxCount;
+            }
+            else
+            {
+                /* Host has sent without a credit. */
+                ++channelErrors;
+            }
+
+            offset += value;
+        }
+        else
+        {
+            ++channelErrors;
+            break;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Channel_Build
+********************************************************************************
+*
+* Summary:
+*  Builds the next IN packet: the credits to return, then the DATA frames the
+*  host has credits for. Each frame sent frees its transmit slot. The first
+*  frame that does not fit is held: the next packet starts with it, and
+*  credits that would leave no room for it wait for the packet after.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Number of bytes in the packet; 0 if there is nothing to send.
+*
+*******************************************************************************/
+static uint8 Channel_Build(void)
+{
+    CHANNEL *channel;
+    uint8 length = 0u;
+    uint8 reserve = 0u;
+    uint8 first = channelNext;
+    uint8 number;
+    uint8 i;
+
+    channel = &channelState[first];
+
+    if ((0u != channelHeld) && (0u != channel->txLength) && (0u != channel->txCredits))
+    {
+        reserve = CHANNEL_HEADER_SIZE + channel->txLength;
+    }
+
+    channelHeld = 0u;
+
+    for (number = 0u; number < CHANNEL_COUNT; ++number)
+    {
+        channel = &channelState[number];
+
+        if ((0u != channel->rxCredits) &&
+            ((length + CHANNEL_HEADER_SIZE + reserve) <= CHANNEL_PACKET_SIZE))
+        {
+            channelTxPacket[length]      = CHANNEL_FRAME_CREDIT | number;
+            channelTxPacket[length + 1u] = channel->rxCredits;
+            length += CHANNEL_HEADER_SIZE;
+            channel->rxCredits = 0u;
+        }
+    }
+
+    for (i = 0u; i < CHANNEL_COUNT; ++i)
+    {
+        number  = (first + i) % CHANNEL_COUNT;
+        channel = &channelState[number];
+
+        if ((0u != channel->txLength) && (0u != channel->txCredits))
+        {
+            if ((length + CHANNEL_HEADER_SIZE + channel->txLength) <= CHANNEL_PACKET_SIZE)
+            {
+                channelTxPacket[length]      = CHANNEL_FRAME_DATA | number;
+                channelTxPacket[length + 1u] = channel->txLength;
+                (void) memcpy(&channelTxPacket[length + CHANNEL_HEADER_SIZE],
+                              channel->txData, channel->txLength);
+                length += CHANNEL_HEADER_SIZE + channel->txLength;
+
+                channel->txLength = 0u;
+                --channel->txCredits;
+
+                /* The next packet starts after the last channel served,
+                * unless a frame is held.
+                */
+                if (0u == channelHeld)
+                {
+                    channelNext = (number + 1u) % CHANNEL_COUNT;
+                }
+            }
+            else if (0u == channelHeld)
+            {
+                channelNext = number;
+                channelHeld = 1u;
+            }
+        }
+    }
+
+    return (length);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,98 @@
+/*******************************************************************************
+* File Name: channel.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants, the channel state and function prototypes of
+*  the virtual channel layer of the USBFS Bulk Wraparound example project.
+*
+*  The layer carries CHANNEL_COUNT independent streams of frames over the one
+*  bulk OUT and IN endpoint pair. Each packet holds one or more frames back to
+*  back; a frame starts with a two-byte header:
+*   byte 0: channel number (bits 3:0) and frame type (bits 7:4).
+*   byte 1: DATA:   number of payload bytes that follow (1 to
+*                   CHANNEL_MAX_PAYLOAD).
+*           CREDIT: number of DATA frames the receiver grants on the channel.
+*  A packet is at most CHANNEL_PACKET_SIZE bytes, one less than
+*  wMaxPacketSize, so every packet is short and ends a transfer.
+*
+*  Flow control is credit based and works the same way in both directions: a
+*  sender may only send a DATA frame on a channel while it holds a credit for
+*  it, and the receiver returns a credit when the application has read the
+*  frame from the receive queue of the channel. A slow consumer therefore
+*  only stops its own channel; the frames of the other channels keep moving.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(CHANNEL_H)
+#define CHANNEL_H
+
+#include <project.h>
+#include "transfer.h"
+
+
+/***************************************
+*    Constants
+****************************************/
+
+#define CHANNEL_COUNT           (4u)
+
+/* Frames each channel queues on receive: the credits granted to the host. */
+#define CHANNEL_RX_DEPTH        (2u)
+
+#define CHANNEL_PACKET_SIZE     (63u)
+#define CHANNEL_HEADER_SIZE     (2u)
+#define CHANNEL_MAX_PAYLOAD     (CHANNEL_PACKET_SIZE - CHANNEL_HEADER_SIZE)
+
+/* Frame header. */
+#define CHANNEL_NUMBER_MASK     (0x0Fu)
+#define CHANNEL_TYPE_MASK       (0xF0u)
+#define CHANNEL_FRAME_DATA      (0x00u)
+#define CHANNEL_FRAME_CREDIT    (0x10u)
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* State of one channel. */
+typedef struct
+{
+    uint8 rxData[CHANNEL_RX_DEPTH][CHANNEL_MAX_PAYLOAD];
+    uint8 rxLength[CHANNEL_RX_DEPTH];
+    uint8 rxHead;                   /* Next frame to read. */
+    uint8 rxCount;                  /* Frames in the receive queue. */
+    uint8 rxCredits;                /* Credits to return to the host. */
+    uint8 txData[CHANNEL_MAX_PAYLOAD];
+    uint8 txLength;                 /* Frame to send; 0 if none. */
+    uint8 txCredits;                /* Frames the host can accept. */
+} CHANNEL;
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void  Channel_Start(TRANSFER *inTransfer, TRANSFER *outTransfer);
+void  Channel_Service(void);
+uint8 Channel_Read(uint8 number, uint8 pData[]);
+uint8 Channel_CanWrite(uint8 number);
+uint8 Channel_Write(uint8 number, const uint8 pData[], uint8 length);
+
+/* Frames received beyond the credits granted, or malformed. */
+extern uint32 channelErrors;
+
+#endif /* (CHANNEL_H) */
+
+
+/* [] END OF FILE */
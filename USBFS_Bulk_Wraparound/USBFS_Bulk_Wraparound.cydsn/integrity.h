@@ -0,0 +1,94 @@
+/*******************************************************************************
+* File Name: integrity.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants, the status block and function prototypes of
+*  the integrity check stage of the USBFS Bulk Wraparound example project.
+*  The loopback runs a CRC-32 over the data of every OUT packet as it is
+*  received and checks the sequence number the host puts in the first four
+*  bytes of each packet. The host reads the running CRC and the sequence
+*  errors with the GET_INTEGRITY request and compares the CRC with the one it
+*  computed over the data it sent, so a soak test proves the device received
+*  every byte as sent.
+*
+*  The stage is built with INTEGRITY_ENABLE set to 1u (add INTEGRITY_ENABLE=1u
+*  to the compiler preprocessor definitions). Otherwise the macro expands to
+*  nothing and no code or RAM is used.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(INTEGRITY_H)
+#define INTEGRITY_H
+
+#include <project.h>
+
+#if !defined(INTEGRITY_ENABLE)
+    #define INTEGRITY_ENABLE    (0u)
+#endif /* !defined(INTEGRITY_ENABLE) */
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* CRC-32 of IEEE 802.3 (zlib): reflected polynomial, initial value and final
+* XOR of all ones.
+*/
+#define INTEGRITY_CRC_POLYNOMIAL    (0xEDB88320u)
+#define INTEGRITY_CRC_INIT          (0xFFFFFFFFu)
+
+/* Bytes of the little-endian sequence number at the start of a packet. */
+#define INTEGRITY_SEQUENCE_SIZE     (4u)
+
+/* wValue of the GET_INTEGRITY request: start a new check after the read. */
+#define INTEGRITY_CLEAR             (0x01u)
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Block returned by the GET_INTEGRITY request: 32-bit words without padding. */
+typedef struct
+{
+    uint32 packets;
+    uint32 bytes;
+    uint32 crc;                 /* CRC-32 of all bytes so far, final XOR applied */
+    uint32 nextSequence;        /* Sequence number expected in the next packet */
+    uint32 sequenceErrors;      /* Packets with an unexpected sequence number */
+    uint32 shortPackets;        /* Packets too short for a sequence number */
+} INTEGRITY_STATUS;
+
+
+/***************************************
+*    Function Prototypes and Macros
+****************************************/
+
+#if (INTEGRITY_ENABLE)
+    void Integrity_Start(void);
+    void Integrity_Clear(void);
+    void Integrity_RequestClear(void);
+    void Integrity_Packet(const uint8 pData[], uint16 length);
+    const INTEGRITY_STATUS *Integrity_Status(void);
+
+    /* Checks a packet received into a 4-byte aligned buffer. */
+    #define INTEGRITY_PACKET(pData, length)     Integrity_Packet((pData), (length))
+#else
+    #define INTEGRITY_PACKET(pData, length)
+#endif /* (INTEGRITY_ENABLE) */
+
+#endif /* (INTEGRITY_H) */
+
+
+/* [] END OF FILE */
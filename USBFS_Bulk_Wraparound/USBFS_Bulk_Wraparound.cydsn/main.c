@@ -8,7 +8,32 @@
 *  the PC and Vendor-Specific USB device. The device has two endpoints: 
 *  BULK IN and BULK OUT. The OUT endpoint allows the host to write data into 
 *  the device and the IN endpoint allows the host to read data from the device. 
-*  The data received in the OUT endpoint is looped back to the IN endpoint.
+*  The data received in the OUT endpoint is looped back to the IN endpoint
+*  through a queue of SRAM buffers. With DMA with Automatic Memory Management
+*  the loopback is zero-copy: the DMA streams OUT packets straight into the
+*  queue buffers and IN packets straight out of them, and the CPU only hands
+*  buffer pointers between the endpoints. The DMA with Manual Memory
+*  Management mode copies the data with the 8-bit or 16-bit APIs. The Manual
+*  mode has no DMA: the firmware copies the data through the endpoint data
+*  register itself, reading or writing a word of SRAM per four register
+*  accesses (EP_COPY_WIDE).
+*  A vendor-specific control request switches the device between the
+*  loopback and two throughput test modes: IN source, which keeps the IN
+*  endpoint loaded with a test pattern, and OUT sink, which discards the data
+*  received in the OUT endpoint. A third test mode loops back messages of up
+*  to 4 KB with the multi-packet transfer API (transfer.c): each OUT transfer,
+*  ended by a short packet, is sent back as one IN transfer. The channel
+*  test mode runs the virtual channel layer (channel.c) over the endpoint
+*  pair and echoes the frames of each channel back on the same channel, with
+*  credit-based flow control per channel.
+*  Built with STAGE_TIMING_ENABLE=1u, the loopback measures the cycles each
+*  stage of the loop takes (stage_timing.h), including the residence time of
+*  each packet from the completion of its OUT transaction to LoadInEP(); the
+*  host reads the statistics with another vendor-specific request.
+*  Built with INTEGRITY_ENABLE=1u, the loopback runs a CRC-32 over the data
+*  of every OUT packet and checks the sequence number the host puts in it
+*  (integrity.h); the host reads the CRC and the errors with the
+*  GET_INTEGRITY request and compares them with the data it sent.
 *
 ********************************************************************************
 * Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
@@ -22,6 +47,10 @@
 *******************************************************************************/
 
 #include <project.h>
+#include "channel.h"
+#include "integrity.h"
+#include "stage_timing.h"
+#include "transfer.h"
 
 /* USB device number. */
 #define USBFS_DEVICE  (0u)
@@ -33,27 +62,156 @@
 /* Size of SRAM buffer to store endpoint data. */
 #define BUFFER_SIZE   (64u)
 
-#if (USBFS_16BITS_EP_ACCESS_ENABLE)
-    /* To use the 16-bit APIs, the buffer has to be:
-    *  1. The buffer size must be multiple of 2 (when endpoint size is odd).
-    *     For example: the endpoint size is 63, the buffer size must be 64.
-    *  2. The buffer has to be aligned to 2 bytes boundary to not cause exception
-    *     while 16-bit access.
+/* Size of SRAM buffer in 32-bit words. */
+#define BUFFER_WORDS  (BUFFER_SIZE / 4u)
+
+/* Depth of the packet queue between the OUT and IN endpoints: the number of
+* endpoint-sized SRAM buffers. The OUT endpoint is read into a free buffer
+* while the buffers ahead of it are queued on the IN endpoint. The queue
+* absorbs bursts of late IN requests before the OUT endpoint has to NAK.
+*/
+#if !defined(QUEUE_DEPTH)
+    #define QUEUE_DEPTH (8u)
+#endif /* !defined(QUEUE_DEPTH) */
+
+/* Manual mode: the loopback and the IN source copy the packets with
+* LoadInEpWide() and ReadOutEpWide() instead of the byte copy of
+* USBFS_LoadInEP() and USBFS_ReadOutEP(). Build with EP_COPY_WIDE=0u to time
+* the component copy instead (bulk_bench -c). The 8051 of PSoC 3 has no word
+* loads and keeps the component copy.
+*/
+#if !defined(EP_COPY_WIDE)
+    #define EP_COPY_WIDE    (1u)
+#endif /* !defined(EP_COPY_WIDE) */
+
+#define EP_COPY_WIDE_ENABLE ((0u != EP_COPY_WIDE) && USBFS_EP_MANAGEMENT_MANUAL && (!CY_PSOC3))
+
+#if (EP_COPY_WIDE_ENABLE)
+    /* Arbiter data register of an endpoint: each access reads or writes the
+    * next byte of the endpoint buffer.
     */
-    #ifdef CY_ALIGN
-        /* Compiler supports alignment attribute: __ARMCC_VERSION and __GNUC__ */
-        CY_ALIGN(2) uint8 buffer[BUFFER_SIZE];
-    #else
-        /* Complier uses pragma for alignment: __ICCARM__ */
-        #pragma data_alignment = 2
-        uint8 buffer[BUFFER_SIZE];
-    #endif /* (CY_ALIGN) */
+    #define EP_DATA_REG(epNumber)   (&USBFS_ARB_EP_BASE.arbEp[(epNumber)].rwDr)
+
+    /* Writes the bytes of a word to the data register, first byte in SRAM
+    * (the low byte) first.
+    */
+    #define EP_WRITE_WORD(dataReg, word) \
+        do { \
+            CY_SET_REG8((dataReg), (word)); \
+            CY_SET_REG8((dataReg), (word) >> 8u); \
+            CY_SET_REG8((dataReg), (word) >> 16u); \
+            CY_SET_REG8((dataReg), (word) >> 24u); \
+        } while (0)
+
+    /* Reads four bytes of the data register into a word. */
+    #define EP_READ_WORD(dataReg, word) \
+        do { \
+            (word)  = (uint32) CY_GET_REG8(dataReg); \
+            (word) |= (uint32) CY_GET_REG8(dataReg) << 8u; \
+            (word) |= (uint32) CY_GET_REG8(dataReg) << 16u; \
+            (word) |= (uint32) CY_GET_REG8(dataReg) << 24u; \
+        } while (0)
+#endif /* (EP_COPY_WIDE_ENABLE) */
+
+/* Vendor-specific requests. SET_TEST_MODE has no data stage and selects the
+* test mode in wValue; GET_TEST_MODE returns the test mode in one byte.
+* GET_STAGE_TIMING returns the STAGE_TIMING block; the statistics are cleared
+* when a test mode is applied. GET_INTEGRITY returns the INTEGRITY_STATUS
+* block; the check starts again when a test mode is applied, or after the
+* read if wValue is INTEGRITY_CLEAR.
+*/
+#define VENDOR_RQST_SET_TEST_MODE       (0x01u)
+#define VENDOR_RQST_GET_TEST_MODE       (0x02u)
+#define VENDOR_RQST_GET_STAGE_TIMING    (0x03u)
+#define VENDOR_RQST_GET_INTEGRITY       (0x05u)
+
+/* Test modes. */
+#define TEST_MODE_LOOPBACK  (0u)    /* OUT data is sent back on IN. */
+#define TEST_MODE_SOURCE    (1u)    /* IN endpoint is kept loaded. */
+#define TEST_MODE_SINK      (2u)    /* OUT data is discarded. */
+#define TEST_MODE_MESSAGE   (3u)    /* OUT transfers are sent back on IN. */
+#define TEST_MODE_CHANNELS  (4u)    /* Channel frames are sent back on their channel. */
+#define TEST_MODE_NONE      (0xFFu) /* No mode applied yet. */
+
+/* To use the 16-bit APIs, the buffer has to be:
+*  1. The buffer size must be multiple of 2 (when endpoint size is odd).
+*     For example: the endpoint size is 63, the buffer size must be 64.
+*  2. The buffer has to be aligned to 2 bytes boundary to not cause exception
+*     while 16-bit access.
+* There are no specific requirements to the buffer size and alignment for the
+* 8-bit APIs usage. The buffers are arrays of words in all cases: a word-wide
+* copy of the endpoint data in Manual mode then moves whole words of SRAM, and
+* only the bytes after the last whole word are copied one at a time. The other
+* APIs access the bytes of a buffer through BUFFER_BYTES().
+*/
+#ifdef CY_ALIGN
+    /* Compiler supports alignment attribute: __ARMCC_VERSION and __GNUC__ */
+    CY_ALIGN(4) uint32 buffer[QUEUE_DEPTH][BUFFER_WORDS];
+#else
+    /* Complier uses pragma for alignment: __ICCARM__ */
+    #pragma data_alignment = 4
+    uint32 buffer[QUEUE_DEPTH][BUFFER_WORDS];
+#endif /* (CY_ALIGN) */
+
+/* Bytes of a buffer. */
+#define BUFFER_BYTES(index)     ((uint8 *) buffer[(index)])
+
+/* BUFFER_SIZE is whole words, so each buffer starts on a word boundary and
+* holds exactly BUFFER_SIZE bytes.
+*/
+typedef uint8 bufferAssert_align[(0u == (BUFFER_SIZE % sizeof(uint32))) ? 1 : -1];
+typedef uint8 bufferAssert_size[(sizeof(buffer[0u]) == BUFFER_SIZE) ? 1 : -1];
+
+/* Number of data bytes stored in each buffer. */
+uint16 length[QUEUE_DEPTH];
+
+/* Size of the message buffer of the message test mode. */
+#define MESSAGE_SIZE  (4096u)
+
+/* Message buffer and transfer control blocks of the message test mode. The
+* buffer is aligned like the packet buffers.
+*/
+#ifdef CY_ALIGN
+    CY_ALIGN(4) uint8 message[MESSAGE_SIZE];
 #else
-    /* There are no specific requirements to the buffer size and alignment for 
-    * the 8-bit APIs usage.
+    #pragma data_alignment = 4
+    uint8 message[MESSAGE_SIZE];
+#endif /* (CY_ALIGN) */
+
+TRANSFER inTransfer;
+TRANSFER outTransfer;
+
+/* Queue statistics: the maximum number of buffers in use and the number of
+* times the queue became full, leaving the OUT endpoint NAKing.
+*/
+volatile uint8  queueHighWater  = 0u;
+volatile uint32 queueFullStalls = 0u;
+
+/* Events posted by the USB interrupt callbacks: the host has completed a
+* transfer on the IN or OUT endpoint, or the configuration may have changed.
+* An event is cleared before the related state is checked, so an event posted
+* while the state is checked is not lost.
+*/
+volatile uint8 epEvent = 0u;
+volatile uint8 configEvent = 0u;
+
+/* Test mode selected by the host with the SET_TEST_MODE request. */
+volatile uint8 testMode = TEST_MODE_LOOPBACK;
+
+#if (STAGE_TIMING_ENABLE)
+    /* Time the OUT endpoint ISR ran for the last OUT packet. The OUT endpoint
+    * NAKs until it is enabled again, so the next OUT buffer full detected
+    * belongs to this timestamp.
     */
-    uint8 buffer[BUFFER_SIZE];
-#endif /* (USBFS_GEN_16BITS_EP_ACCESS) */
+    volatile uint32 outDoneTime = 0u;
+#endif /* (STAGE_TIMING_ENABLE) */
+
+void WaitForUsbEvent(void);
+
+#if (EP_COPY_WIDE_ENABLE)
+    void LoadInEpWide(uint8 epNumber, const uint32 pData[], uint16 length);
+    void ReadOutEpWide(uint8 epNumber, uint32 pData[], uint16 length);
+#endif /* (EP_COPY_WIDE_ENABLE) */
 
 
 /*******************************************************************************
@@ -66,7 +224,22 @@
 *   2. Waits until the device is enumerated by the host.
 *   3. Enables the OUT endpoint to start communication with the host.
 *   4. Waits for OUT data coming from the host and sends it back on a
-*      subsequent IN request.
+*      subsequent IN request. The buffers form a queue: the OUT endpoint is
+*      re-enabled to receive into a free buffer while the buffers ahead of it
+*      wait to be read by the host from the IN endpoint, so OUT and IN
+*      transfers overlap. The OUT endpoint NAKs only when the queue is full.
+*      With DMA with Automatic Memory Management the OUT endpoint receives
+*      directly into the free buffer and the IN endpoint is loaded directly
+*      from the queued buffer, so no data is copied by the firmware.
+*   5. In the IN source test mode, loads the IN endpoint with a test pattern
+*      as soon as the host has read it; in the OUT sink test mode, re-enables
+*      the OUT endpoint as soon as data is received, without reading it.
+*      In the message test mode, receives an OUT transfer into the message
+*      buffer and sends it back as an IN transfer. In the channel test mode,
+*      echoes the frames of each virtual channel while the channel can send.
+*      The test mode is applied with empty buffers.
+*   6. Sleeps between USB events: the endpoint interrupt callbacks post an
+*      event and the CPU waits in WFI while there is no work to do.
 *
 * Parameters:
 *  None.
@@ -77,7 +250,35 @@
 *******************************************************************************/
 int main()
 {
-    uint16 length;
+    uint8 outBuf = 0u;      /* Buffer that receives next OUT packet. */
+    uint8 inBuf  = 0u;      /* Buffer that is sent on next IN request. */
+    uint8 used   = 0u;      /* Number of buffers holding data. */
+    uint8 readPending = 0u; /* OUT data is being copied into buffer. */
+    uint8 inPending   = 0u; /* IN endpoint holds buffer not read by host. */
+    uint8 outEnabled  = 0u; /* OUT endpoint is enabled to receive data. */
+    uint8 mode = TEST_MODE_NONE; /* Test mode applied to the buffers. */
+    uint8 transferState;
+    uint8 frame[CHANNEL_MAX_PAYLOAD];   /* Frame echoed by the channel mode. */
+    uint8 frameLength;
+    uint8 i;
+#if (INTEGRITY_ENABLE)
+    uint8 checkBuf = QUEUE_DEPTH;       /* Buffer to check; none if QUEUE_DEPTH. */
+#endif /* (INTEGRITY_ENABLE) */
+#if (STAGE_TIMING_ENABLE)
+    uint32 outIsrTime[QUEUE_DEPTH];     /* OUT transaction completed. */
+    uint32 outFullTime[QUEUE_DEPTH];    /* OUT buffer full detected. */
+    uint32 readTime[QUEUE_DEPTH];       /* ReadOutEP() completed. */
+    uint32 loadStart;                   /* LoadInEP() called. */
+    uint32 loadTime = 0u;               /* LoadInEP() completed. */
+    uint32 rearmStart = 0u;             /* Read before OUT endpoint re-enabled. */
+    uint8  rearmTimed = 0u;
+    uint32 now;
+
+    StageTiming_Start();
+#endif /* (STAGE_TIMING_ENABLE) */
+#if (INTEGRITY_ENABLE)
+    Integrity_Start();
+#endif /* (INTEGRITY_ENABLE) */
 
     CyGlobalIntEnable;
 
@@ -87,62 +288,670 @@ int main()
     /* Wait until device is enumerated by host. */
     while (0u == USBFS_GetConfiguration())
     {
+        WaitForUsbEvent();
     }
 
-    /* Enable OUT endpoint to receive data from host. */
-    USBFS_EnableOutEP(OUT_EP_NUM);
-
     for(;;)
     {
-        /* Check if configuration is changed. */
-        if (0u != USBFS_IsConfigurationChanged())
+        /* Configuration can change only in the control endpoint or bus reset
+        * interrupt.
+        */
+        if (0u != configEvent)
         {
-            /* Re-enable endpoint when device is configured. */
-            if (0u != USBFS_GetConfiguration())
+            configEvent = 0u;
+
+            /* Check if configuration is changed. */
+            if (0u != USBFS_IsConfigurationChanged())
             {
-                /* Enable OUT endpoint to receive data from host. */
+                /* Apply test mode again when device is configured. */
+                if (0u != USBFS_GetConfiguration())
+                {
+                    /* Data in buffers is lost: apply test mode again below. */
+                    readPending = 0u;
+                    Transfer_Init(&inTransfer,  IN_EP_NUM);
+                    Transfer_Init(&outTransfer, OUT_EP_NUM);
+                    mode = TEST_MODE_NONE;
+                }
+            }
+        }
+
+        /* Test mode can change only in the control endpoint interrupt. It is
+        * applied when no DMA transfer is in progress.
+        */
+        if ((mode != testMode) && (0u == readPending) && (0u == outTransfer.dmaPending))
+        {
+            mode = testMode;
+
+            /* Start again with empty buffers. */
+            outBuf = 0u;
+            inBuf  = 0u;
+            used   = 0u;
+            inPending = 0u;
+
+            /* OUT endpoint is enabled to receive data from host below. */
+            outEnabled = 0u;
+
+        #if (STAGE_TIMING_ENABLE)
+            rearmTimed = 0u;
+            StageTiming_Clear();
+        #endif /* (STAGE_TIMING_ENABLE) */
+
+        #if (INTEGRITY_ENABLE)
+            checkBuf = QUEUE_DEPTH;
+            Integrity_Clear();
+        #endif /* (INTEGRITY_ENABLE) */
+
+            if (TEST_MODE_SOURCE == mode)
+            {
+                /* The first buffer holds the IN test pattern. */
+                for (i = 0u; i < BUFFER_SIZE; ++i)
+                {
+                    BUFFER_BYTES(0u)[i] = i;
+                }
+            }
+            else if (TEST_MODE_MESSAGE == mode)
+            {
+                /* Wait for the first message. */
+                Transfer_Init(&inTransfer,  IN_EP_NUM);
+                Transfer_Init(&outTransfer, OUT_EP_NUM);
+                Transfer_StartOut(&outTransfer, message, MESSAGE_SIZE);
+            }
+            else if (TEST_MODE_CHANNELS == mode)
+            {
+                Transfer_Init(&inTransfer,  IN_EP_NUM);
+                Transfer_Init(&outTransfer, OUT_EP_NUM);
+                Channel_Start(&inTransfer, &outTransfer);
+            }
+            else
+            {
+                /* Packet loopback. */
+            }
+        }
+
+        if (TEST_MODE_SOURCE == mode)
+        {
+            /* Load IN endpoint again as soon as host has read it. */
+            if (USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(IN_EP_NUM))
+            {
+            #if (USBFS_16BITS_EP_ACCESS_ENABLE)
+                USBFS_LoadInEP16(IN_EP_NUM, BUFFER_BYTES(0u), BUFFER_SIZE);
+            #elif (EP_COPY_WIDE_ENABLE)
+                LoadInEpWide(IN_EP_NUM, buffer[0u], BUFFER_SIZE);
+            #else
+                USBFS_LoadInEP(IN_EP_NUM, BUFFER_BYTES(0u), BUFFER_SIZE);
+            #endif /* (USBFS_GEN_16BITS_EP_ACCESS) */
+            }
+        }
+        else if (TEST_MODE_SINK == mode)
+        {
+            /* Discard OUT data: enable OUT endpoint without reading it. */
+            if ((0u == outEnabled) || (USBFS_OUT_BUFFER_FULL == USBFS_GetEPState(OUT_EP_NUM)))
+            {
+            #if (USBFS_EP_MANAGEMENT_DMA_AUTO)
+                if (0u == outEnabled)
+                {
+                    /* DMA stores the data in the first buffer. */
+                    (void) USBFS_ReadOutEP(OUT_EP_NUM, BUFFER_BYTES(0u), BUFFER_SIZE);
+                }
+            #endif /* (USBFS_EP_MANAGEMENT_DMA_AUTO) */
+
                 USBFS_EnableOutEP(OUT_EP_NUM);
+                outEnabled = 1u;
+            }
+        }
+        else if (TEST_MODE_MESSAGE == mode)
+        {
+            /* Send the message back when it has been received. */
+            transferState = Transfer_Service(&outTransfer);
+
+            if (TRANSFER_DONE == transferState)
+            {
+                Transfer_StartIn(&inTransfer, message, outTransfer.count);
+            }
+            else if (TRANSFER_OVERFLOW == transferState)
+            {
+                /* Message does not fit in the buffer: drop it. */
+                Transfer_StartOut(&outTransfer, message, MESSAGE_SIZE);
+            }
+            else
+            {
+                /* Message is being received. */
+            }
+
+            /* Receive the next message when the host has read this one. */
+            if (TRANSFER_DONE == Transfer_Service(&inTransfer))
+            {
+                Transfer_StartOut(&outTransfer, message, MESSAGE_SIZE);
             }
         }
+        else if (TEST_MODE_CHANNELS == mode)
+        {
+            Channel_Service();
 
-        /* Check if data was received. */
-        if (USBFS_OUT_BUFFER_FULL == USBFS_GetEPState(OUT_EP_NUM))
+            /* Echo a frame on each channel that can send it. A channel whose
+            * frames the host does not read keeps its frame: its receive
+            * queue fills and the host runs out of credits on it, while the
+            * other channels continue.
+            */
+            for (i = 0u; i < CHANNEL_COUNT; ++i)
+            {
+                if (0u != Channel_CanWrite(i))
+                {
+                    frameLength = Channel_Read(i, frame);
+
+                    if (0u != frameLength)
+                    {
+                        (void) Channel_Write(i, frame, frameLength);
+                    }
+                }
+            }
+
+            /* Send the echoed frames and the credits returned. */
+            Channel_Service();
+        }
+        else
         {
-            /* Read number of received data bytes. */
-            length = USBFS_GetEPCount(OUT_EP_NUM);
+            /* Loopback: check if data was received and there is a free buffer for it. */
+            if ((0u != outEnabled) && (0u == readPending) && (used < QUEUE_DEPTH) &&
+                (USBFS_OUT_BUFFER_FULL == USBFS_GetEPState(OUT_EP_NUM)))
+            {
+                STAGE_TIMESTAMP(outFullTime[outBuf]);
+            #if (STAGE_TIMING_ENABLE)
+                outIsrTime[outBuf] = outDoneTime;
+            #endif /* (STAGE_TIMING_ENABLE) */
+
+                /* Read number of received data bytes. */
+                length[outBuf] = USBFS_GetEPCount(OUT_EP_NUM);
 
-            /* Trigger DMA to copy data from OUT endpoint buffer. */
-        #if (USBFS_16BITS_EP_ACCESS_ENABLE)
-            USBFS_ReadOutEP16(OUT_EP_NUM, buffer, length);
+            #if (USBFS_EP_MANAGEMENT_DMA_AUTO)
+                /* DMA has already stored the data in buffer while the host was
+                * sending it: there is nothing to copy.
+                */
+            #elif (USBFS_16BITS_EP_ACCESS_ENABLE)
+                /* Trigger DMA to copy data from OUT endpoint buffer. */
+                USBFS_ReadOutEP16(OUT_EP_NUM, BUFFER_BYTES(outBuf), length[outBuf]);
+            #elif (EP_COPY_WIDE_ENABLE)
+                /* Copy data from OUT endpoint buffer. */
+                ReadOutEpWide(OUT_EP_NUM, buffer[outBuf], length[outBuf]);
+            #else
+                /* Trigger DMA to copy data from OUT endpoint buffer. */
+                USBFS_ReadOutEP(OUT_EP_NUM, BUFFER_BYTES(outBuf), length[outBuf]);
+            #endif /* (USBFS_EP_MANAGEMENT_DMA_AUTO) */
+
+                readPending = 1u;
+            #if (USBFS_EP_MANAGEMENT_DMA || EP_COPY_WIDE_ENABLE)
+                /* OUT endpoint is re-enabled after DMA completes, or after
+                * the word-wide copy.
+                */
+                outEnabled = 0u;
+            #endif /* (USBFS_EP_MANAGEMENT_DMA || EP_COPY_WIDE_ENABLE) */
+            }
+
+        #if (USBFS_EP_MANAGEMENT_DMA_MANUAL)
+            /* Check if DMA completed copying data from OUT endpoint buffer. */
+            if ((0u != readPending) && (USBFS_OUT_BUFFER_FULL != USBFS_GetEPState(OUT_EP_NUM)))
         #else
-            USBFS_ReadOutEP(OUT_EP_NUM, buffer, length);
-        #endif /* (USBFS_GEN_16BITS_EP_ACCESS) */
+            /* Data was copied from OUT endpoint buffer before ReadOutEP
+            * returned, or was stored in buffer by DMA during the transfer.
+            */
+            if (0u != readPending)
+        #endif /* (USBFS_EP_MANAGEMENT_DMA_MANUAL) */
+            {
+                STAGE_TIMESTAMP(readTime[outBuf]);
+                STAGE_RECORD(STAGE_OUT_READ, outFullTime[outBuf], readTime[outBuf]);
+
+            #if (STAGE_TIMING_ENABLE)
+                if (0u != outEnabled)
+                {
+                    /* USBFS_ReadOutEP() of the Manual mode has enabled the
+                    * OUT endpoint again before it returned.
+                    */
+                    STAGE_RECORD(STAGE_OUT_REARM, readTime[outBuf], readTime[outBuf]);
+                }
+                else
+                {
+                    /* OUT endpoint is re-enabled below. */
+                    rearmStart = readTime[outBuf];
+                    rearmTimed = 1u;
+                }
+            #endif /* (STAGE_TIMING_ENABLE) */
+
+            #if (INTEGRITY_ENABLE)
+                /* Checked below, once both endpoints are busy again. */
+                checkBuf = outBuf;
+            #endif /* (INTEGRITY_ENABLE) */
+
+                readPending = 0u;
+                outBuf = (outBuf + 1u) % QUEUE_DEPTH;
+                ++used;
+
+                if (used > queueHighWater)
+                {
+                    queueHighWater = used;
+                }
+
+                if (QUEUE_DEPTH == used)
+                {
+                    ++queueFullStalls;
+                }
+            }
 
-            /* Wait until DMA completes copying data from OUT endpoint buffer. */
-            while (USBFS_OUT_BUFFER_FULL == USBFS_GetEPState(OUT_EP_NUM))
+            /* Check if host has read the buffer from IN endpoint. */
+            if ((0u != inPending) && (USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(IN_EP_NUM)))
             {
+                STAGE_TIMESTAMP(now);
+                STAGE_RECORD(STAGE_IN_HOST, loadTime, now);
+                STAGE_RECORD(STAGE_LOOP, outFullTime[inBuf], now);
+
+                inPending = 0u;
+                inBuf = (inBuf + 1u) % QUEUE_DEPTH;
+                --used;
             }
-            
-            /* Enable OUT endpoint to receive data from host. */
-            USBFS_EnableOutEP(OUT_EP_NUM);
 
-            /* Wait until IN buffer becomes empty (host has read data). */
-            while (USBFS_IN_BUFFER_EMPTY != USBFS_GetEPState(IN_EP_NUM))
+            /* Enable OUT endpoint to receive data from host when there is a
+            * free buffer. OUT endpoint NAKs only while all buffers hold data.
+            */
+            if ((0u == outEnabled) && (0u == readPending) && (used < QUEUE_DEPTH))
             {
+            #if (USBFS_EP_MANAGEMENT_DMA_AUTO)
+                /* Direct DMA to store next OUT packet in the free buffer. */
+            #if (USBFS_16BITS_EP_ACCESS_ENABLE)
+                (void) USBFS_ReadOutEP16(OUT_EP_NUM, BUFFER_BYTES(outBuf), BUFFER_SIZE);
+            #else
+                (void) USBFS_ReadOutEP(OUT_EP_NUM, BUFFER_BYTES(outBuf), BUFFER_SIZE);
+            #endif /* (USBFS_GEN_16BITS_EP_ACCESS) */
+            #endif /* (USBFS_EP_MANAGEMENT_DMA_AUTO) */
+
+                USBFS_EnableOutEP(OUT_EP_NUM);
+                outEnabled = 1u;
+
+            #if (STAGE_TIMING_ENABLE)
+                if (0u != rearmTimed)
+                {
+                    rearmTimed = 0u;
+                    STAGE_TIMESTAMP(now);
+                    STAGE_RECORD(STAGE_OUT_REARM, rearmStart, now);
+                }
+            #endif /* (STAGE_TIMING_ENABLE) */
             }
 
-        /* Trigger DMA to copy data into IN endpoint buffer.
-        * After data has been copied, IN endpoint is ready to be read by the
-        * host.
+            /* Check if there is a buffer to send and IN endpoint is empty. */
+            if ((0u == inPending) && (0u != used) &&
+                (USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(IN_EP_NUM)))
+            {
+                /* Trigger DMA to copy data into IN endpoint buffer.
+                * After data has been copied, IN endpoint is ready to be read by
+                * the host. With automatic memory management DMA reads buffer
+                * while the host reads the IN endpoint: buffer stays queued until
+                * then.
+                */
+                STAGE_TIMESTAMP(loadStart);
+
+            #if (USBFS_16BITS_EP_ACCESS_ENABLE)
+                USBFS_LoadInEP16(IN_EP_NUM, BUFFER_BYTES(inBuf), length[inBuf]);
+            #elif (EP_COPY_WIDE_ENABLE)
+                LoadInEpWide(IN_EP_NUM, buffer[inBuf], length[inBuf]);
+            #else
+                USBFS_LoadInEP(IN_EP_NUM, BUFFER_BYTES(inBuf), length[inBuf]);
+            #endif /* (USBFS_GEN_16BITS_EP_ACCESS) */
+
+                STAGE_TIMESTAMP(loadTime);
+                STAGE_RECORD(STAGE_IN_LOAD,  loadStart, loadTime);
+                STAGE_RECORD(STAGE_IN_QUEUE, readTime[inBuf], loadTime);
+                STAGE_RECORD(STAGE_RESIDENCE, outIsrTime[inBuf], loadTime);
+
+                inPending = 1u;
+            }
+
+        #if (INTEGRITY_ENABLE)
+            /* Check the packet read in this pass while the endpoints transfer
+            * the next ones. The buffer stays queued until a later pass finds
+            * that the host has read it from the IN endpoint.
+            */
+            if (QUEUE_DEPTH != checkBuf)
+            {
+                INTEGRITY_PACKET(BUFFER_BYTES(checkBuf), length[checkBuf]);
+                checkBuf = QUEUE_DEPTH;
+            }
+        #endif /* (INTEGRITY_ENABLE) */
+        }
+
+        /* Sleep until the next USB event. DMA completion has no event: while
+        * OUT data is being copied the loop polls to re-enable the OUT
+        * endpoint as soon as possible. With manual and automatic memory
+        * management readPending is always cleared in the same pass.
         */
-        #if (USBFS_16BITS_EP_ACCESS_ENABLE)
-            USBFS_LoadInEP16(IN_EP_NUM, buffer, length);
-        #else
-            USBFS_LoadInEP(IN_EP_NUM, buffer, length);
-        #endif /* (USBFS_GEN_16BITS_EP_ACCESS) */
+        if ((0u == readPending) && (0u == outTransfer.dmaPending))
+        {
+            WaitForUsbEvent();
         }
     }
 }
 
 
+/*******************************************************************************
+* Function Name: WaitForUsbEvent
+********************************************************************************
+*
+* Summary:
+*  Puts the CPU into Sleep mode until a USB interrupt posts an event. Returns
+*  immediately if an event is already posted. The events are checked with
+*  interrupts disabled: an interrupt that occurs after the check stays pending
+*  and wakes the CPU from WFI. The endpoint event is cleared on return; the
+*  caller checks the endpoint state after that. PSoC 3 has no WFI and polls.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void WaitForUsbEvent(void)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    if ((0u == epEvent) && (0u == configEvent))
+    {
+    #if (CY_PSOC4)
+        CySysPmSleep();
+    #elif (CY_PSOC5)
+        CY_PM_WFI;
+    #endif /* (CY_PSOC4) */
+    }
+
+    CyExitCriticalSection(interruptState);
+
+    epEvent = 0u;
+}
+
+
+#if (EP_COPY_WIDE_ENABLE)
+/*******************************************************************************
+* Function Name: LoadInEpWide
+********************************************************************************
+*
+* Summary:
+*  Writes the data to the IN endpoint buffer through the arbiter data register
+*  and arms the endpoint with USBFS_LoadInEP(), which only sets the count when
+*  pData is NULL. The data register takes a byte per access, so the copy saves
+*  the SRAM side: one word load per four bytes, four words per loop pass, and
+*  no loop overhead per byte. The bytes after the last whole word are written
+*  one at a time. Call it only when the IN endpoint is empty.
+*
+* Parameters:
+*  epNumber: IN endpoint number.
+*  pData:    Data, as words in SRAM byte order.
+*  length:   Number of bytes, up to the endpoint size.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LoadInEpWide(uint8 epNumber, const uint32 pData[], uint16 length)
+{
+    reg8 *dataReg = (reg8 *) EP_DATA_REG(epNumber);
+    const uint32 *word = pData;
+    const uint8  *bytes = (const uint8 *) pData;
+    const uint8  *tail = &bytes[length & ~3u];
+    uint16 blocks = length >> 4u;
+    uint16 words  = (length >> 2u) & 3u;
+    uint32 value;
+
+    while (0u != blocks)
+    {
+        value = word[0u];
+        EP_WRITE_WORD(dataReg, value);
+        value = word[1u];
+        EP_WRITE_WORD(dataReg, value);
+        value = word[2u];
+        EP_WRITE_WORD(dataReg, value);
+        value = word[3u];
+        EP_WRITE_WORD(dataReg, value);
+        word = &word[4u];
+        --blocks;
+    }
+
+    while (0u != words)
+    {
+        value = *word;
+        EP_WRITE_WORD(dataReg, value);
+        ++word;
+        --words;
+    }
+
+    while (tail < &bytes[length])
+    {
+        CY_SET_REG8(dataReg, *tail);
+        ++tail;
+    }
+
+    USBFS_LoadInEP(epNumber, NULL, length);
+}
+
+
+/*******************************************************************************
+* Function Name: ReadOutEpWide
+********************************************************************************
+*
+* Summary:
+*  Reads the data of the OUT endpoint buffer through the arbiter data register
+*  into SRAM a word at a time, four words per loop pass, and the bytes after
+*  the last whole word one at a time. Unlike USBFS_ReadOutEP() it leaves the
+*  OUT endpoint NAKing: the caller enables it with USBFS_EnableOutEP().
+*
+* Parameters:
+*  epNumber: OUT endpoint number.
+*  pData:    Buffer, as words in SRAM byte order.
+*  length:   Number of bytes, up to the USBFS_GetEPCount() of the endpoint.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void ReadOutEpWide(uint8 epNumber, uint32 pData[], uint16 length)
+{
+    reg8 *dataReg = (reg8 *) EP_DATA_REG(epNumber);
+    uint32 *word = pData;
+    uint8  *bytes = (uint8 *) pData;
+    uint8  *tail = &bytes[length & ~3u];
+    uint16 blocks = length >> 4u;
+    uint16 words  = (length >> 2u) & 3u;
+    uint32 value;
+
+    while (0u != blocks)
+    {
+        EP_READ_WORD(dataReg, value);
+        word[0u] = value;
+        EP_READ_WORD(dataReg, value);
+        word[1u] = value;
+        EP_READ_WORD(dataReg, value);
+        word[2u] = value;
+        EP_READ_WORD(dataReg, value);
+        word[3u] = value;
+        word = &word[4u];
+        --blocks;
+    }
+
+    while (0u != words)
+    {
+        EP_READ_WORD(dataReg, value);
+        *word = value;
+        ++word;
+        --words;
+    }
+
+    while (tail < &bytes[length])
+    {
+        *tail = CY_GET_REG8(dataReg);
+        ++tail;
+    }
+}
+#endif /* (EP_COPY_WIDE_ENABLE) */
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_0_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the control endpoint ISR. It posts an
+*  event to check for a configuration change.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_0_ISR_ExitCallback(void)
+{
+    configEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_1_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the IN endpoint ISR, after the host
+*  has read the IN endpoint buffer. It posts an event to load the next buffer.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_1_ISR_ExitCallback(void)
+{
+    epEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_2_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the OUT endpoint ISR, after the host
+*  has written the OUT endpoint buffer. It takes the timestamp the residence
+*  time of the packet starts from and posts an event to read the data.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_2_ISR_ExitCallback(void)
+{
+    STAGE_TIMESTAMP(outDoneTime);
+    epEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_HandleVendorRqst_Callback
+********************************************************************************
+*
+* Summary:
+*  This function is called by the component to handle vendor-specific
+*  requests. It handles the requests that set and get the test mode and, if
+*  enabled, the requests that read the stage timing and the integrity check.
+*  The new test mode is applied by the main loop.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  TRUE if the request is handled; FALSE otherwise.
+*
+*******************************************************************************/
+uint8 USBFS_HandleVendorRqst_Callback(void)
+{
+    uint8 requestHandled = USBFS_FALSE;
+    uint8 direction = USBFS_bmRequestTypeReg & USBFS_RQST_DIR_MASK;
+
+    switch (USBFS_bRequestReg)
+    {
+        case VENDOR_RQST_SET_TEST_MODE:
+            if ((USBFS_RQST_DIR_H2D == direction) && (USBFS_wValueLoReg <= TEST_MODE_CHANNELS))
+            {
+                testMode = USBFS_wValueLoReg;
+                requestHandled = USBFS_InitNoDataControlTransfer();
+            }
+            break;
+
+        case VENDOR_RQST_GET_TEST_MODE:
+            if (USBFS_RQST_DIR_D2H == direction)
+            {
+                USBFS_currentTD.pData = &testMode;
+                USBFS_currentTD.count = 1u;
+                requestHandled = USBFS_InitControlRead();
+            }
+            break;
+
+    #if (STAGE_TIMING_ENABLE)
+        case VENDOR_RQST_GET_STAGE_TIMING:
+            if (USBFS_RQST_DIR_D2H == direction)
+            {
+                USBFS_currentTD.pData = (volatile uint8 *) &stageTiming;
+                USBFS_currentTD.count = sizeof(stageTiming);
+                requestHandled = USBFS_InitControlRead();
+            }
+            break;
+    #endif /* (STAGE_TIMING_ENABLE) */
+
+    #if (INTEGRITY_ENABLE)
+        case VENDOR_RQST_GET_INTEGRITY:
+            if (USBFS_RQST_DIR_D2H == direction)
+            {
+                USBFS_currentTD.pData = (volatile uint8 *) Integrity_Status();
+                USBFS_currentTD.count = sizeof(INTEGRITY_STATUS);
+                requestHandled = USBFS_InitControlRead();
+
+                if (INTEGRITY_CLEAR == USBFS_wValueLoReg)
+                {
+                    Integrity_RequestClear();
+                }
+            }
+            break;
+    #endif /* (INTEGRITY_ENABLE) */
+
+        default:
+            break;
+    }
+
+    return (requestHandled);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_BUS_RESET_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the bus reset ISR. It posts an event
+*  to check for a configuration change.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_BUS_RESET_ISR_ExitCallback(void)
+{
+    configEvent = 1u;
+}
+
+
 /* [] END OF FILE */
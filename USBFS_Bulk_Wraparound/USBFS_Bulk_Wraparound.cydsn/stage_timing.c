@@ -0,0 +1,147 @@
+/*******************************************************************************
+* File Name: stage_timing.c
+*
+* Version: 1.0
+*
+* Description:
+*  Stage timing instrumentation of the USBFS Bulk Wraparound example project.
+*  SysTick runs free over its 24-bit range with the interrupt disabled, so a
+*  stage can be up to 2^24 cycles long (349 ms at 48 MHz). Each timestamp
+*  costs a SysTick register read.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "stage_timing.h"
+
+#if (STAGE_TIMING_ENABLE)
+
+STAGE_TIMING stageTiming;
+
+
+/*******************************************************************************
+* Function Name: StageTiming_Start
+********************************************************************************
+*
+* Summary:
+*  Starts SysTick as a free-running cycle counter and clears the statistics.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void StageTiming_Start(void)
+{
+    CySysTickStart();
+    CySysTickDisableInterrupt();
+    CySysTickSetReload(CY_SYS_SYST_RVR_CNT_MASK);
+    CySysTickClear();
+
+    StageTiming_Clear();
+}
+
+
+/*******************************************************************************
+* Function Name: StageTiming_Clear
+********************************************************************************
+*
+* Summary:
+*  Clears the statistics of all stages.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void StageTiming_Clear(void)
+{
+    uint8 stage;
+    uint8 bin;
+
+    stageTiming.clockHz    = cydelay_freq_hz;
+    stageTiming.stageCount = STAGE_COUNT;
+
+    for (stage = 0u; stage < STAGE_COUNT; ++stage)
+    {
+        stageTiming.stage[stage].count = 0u;
+        stageTiming.stage[stage].min   = 0xFFFFFFFFu;
+        stageTiming.stage[stage].max   = 0u;
+        stageTiming.stage[stage].sumLo = 0u;
+        stageTiming.stage[stage].sumHi = 0u;
+
+        for (bin = 0u; bin < STAGE_HIST_BINS; ++bin)
+        {
+            stageTiming.stage[stage].histogram[bin] = 0u;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StageTiming_Record
+********************************************************************************
+*
+* Summary:
+*  Adds a sample to the statistics of a stage. SysTick counts down, so the
+*  stage took start - end cycles, modulo 2^24.
+*
+* Parameters:
+*  stage: Stage number.
+*  start: SysTick counter at the start of the stage.
+*  end:   SysTick counter at the end of the stage.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void StageTiming_Record(uint8 stage, uint32 start, uint32 end)
+{
+    STAGE_STATS *stats = &stageTiming.stage[stage];
+    uint32 cycles = (start - end) & CY_SYS_SYST_RVR_CNT_MASK;
+    uint32 value = cycles;
+    uint8  bin = 0u;
+
+    ++stats->count;
+
+    if (cycles < stats->min)
+    {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+
+    stats->sumLo += cycles;
+    if (stats->sumLo < cycles)
+    {
+        ++stats->sumHi;
+    }
+
+    /* Bin of the most significant bit. */
+    while (value > 1u)
+    {
+        value >>= 1u;
+        ++bin;
+    }
+
+    ++stats->histogram[bin];
+}
+
+#endif /* (STAGE_TIMING_ENABLE) */
+
+
+/* [] END OF FILE */
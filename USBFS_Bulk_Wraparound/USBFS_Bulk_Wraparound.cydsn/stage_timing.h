@@ -0,0 +1,108 @@
+/*******************************************************************************
+* File Name: stage_timing.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants, macros and function prototypes of the stage
+*  timing instrumentation of the USBFS Bulk Wraparound example project. The
+*  wraparound loop takes SysTick timestamps as a packet moves through it; the
+*  cycles each stage takes accumulate in RAM as min, mean, max and a log2
+*  histogram. The host reads them with the GET_STAGE_TIMING request.
+*
+*  The instrumentation is built with STAGE_TIMING_ENABLE set to 1u (add
+*  STAGE_TIMING_ENABLE=1u to the compiler preprocessor definitions). Otherwise
+*  the macros expand to nothing and no code or RAM is used.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(STAGE_TIMING_H)
+#define STAGE_TIMING_H
+
+#include <project.h>
+
+#if !defined(STAGE_TIMING_ENABLE)
+    #define STAGE_TIMING_ENABLE     (0u)
+#endif /* !defined(STAGE_TIMING_ENABLE) */
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* Stages of the wraparound loop. */
+#define STAGE_OUT_READ      (0u)    /* OUT buffer full detected to ReadOutEP() completed */
+#define STAGE_OUT_REARM     (1u)    /* ReadOutEP() completed to OUT endpoint enabled again; 0 if ReadOutEP() enabled it */
+#define STAGE_IN_QUEUE      (2u)    /* ReadOutEP() completed to LoadInEP() completed */
+#define STAGE_IN_LOAD       (3u)    /* LoadInEP() call */
+#define STAGE_IN_HOST       (4u)    /* LoadInEP() completed to IN buffer empty detected */
+#define STAGE_LOOP          (5u)    /* OUT buffer full detected to IN buffer empty detected */
+#define STAGE_RESIDENCE     (6u)    /* OUT transaction completed (OUT endpoint ISR) to LoadInEP() completed */
+#define STAGE_COUNT         (7u)
+
+/* Histogram bin n counts the samples of 2^n to 2^(n+1)-1 cycles; bin 0 also
+* counts 0 cycles. The bins cover the 24-bit SysTick range.
+*/
+#define STAGE_HIST_BINS     (24u)
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Statistics of one stage, in SYSCLK cycles. All fields are 32-bit so the
+* layout the host reads has no padding.
+*/
+typedef struct
+{
+    uint32 count;
+    uint32 min;
+    uint32 max;
+    uint32 sumLo;
+    uint32 sumHi;
+    uint32 histogram[STAGE_HIST_BINS];
+} STAGE_STATS;
+
+/* Block returned by the GET_STAGE_TIMING request. */
+typedef struct
+{
+    uint32 clockHz;                 /* SYSCLK frequency */
+    uint32 stageCount;              /* STAGE_COUNT */
+    STAGE_STATS stage[STAGE_COUNT];
+} STAGE_TIMING;
+
+
+/***************************************
+*    Function Prototypes and Macros
+****************************************/
+
+#if (STAGE_TIMING_ENABLE)
+    void StageTiming_Start(void);
+    void StageTiming_Clear(void);
+    void StageTiming_Record(uint8 stage, uint32 start, uint32 end);
+
+    extern STAGE_TIMING stageTiming;
+
+    /* Stores the SysTick counter in timestamp. */
+    #define STAGE_TIMESTAMP(timestamp)      do { (timestamp) = CySysTickGetValue(); } while (0)
+
+    /* Adds the cycles from timestamp start to timestamp end to the stage. */
+    #define STAGE_RECORD(stage, start, end) StageTiming_Record((stage), (start), (end))
+#else
+    #define STAGE_TIMESTAMP(timestamp)
+    #define STAGE_RECORD(stage, start, end)
+#endif /* (STAGE_TIMING_ENABLE) */
+
+#endif /* (STAGE_TIMING_H) */
+
+
+/* [] END OF FILE */
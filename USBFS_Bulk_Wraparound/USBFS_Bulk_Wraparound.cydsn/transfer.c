@@ -0,0 +1,396 @@
+/*******************************************************************************
+* File Name: transfer.c
+*
+* Version: 1.0
+*
+* Description:
+*  Multi-packet transfer API of the USBFS Bulk Wraparound example project.
+*  A transfer moves a buffer of any length through one bulk endpoint, one
+*  endpoint-sized packet at a time, with the single-packet USBFS_LoadInEP()
+*  and USBFS_ReadOutEP() APIs:
+*   IN:  the buffer is sent in wMaxPacketSize packets. A transfer whose length
+*        is a multiple of wMaxPacketSize (including zero) ends with a
+*        zero-length packet, so the host sees where it ends.
+*   OUT: packets are stored one after another in the buffer until a short
+*        packet (including a zero-length packet) ends the transfer.
+*  The API does not block: the main loop calls Transfer_Service() on USB
+*  events and it loads or reads the next packet when the endpoint is ready.
+*  With DMA with Automatic Memory Management the DMA reads and writes the
+*  buffer directly, packet by packet.
+*
+*  To use the 16-bit APIs, the buffer has to be aligned to 2 bytes boundary
+*  and wMaxPacketSize has to be even.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "transfer.h"
+
+static void Transfer_ServiceIn(TRANSFER *transfer);
+static void Transfer_ServiceOut(TRANSFER *transfer);
+static void Transfer_EndOutPacket(TRANSFER *transfer);
+static void Transfer_EnableOut(TRANSFER *transfer);
+
+
+/*******************************************************************************
+* Function Name: Transfer_Init
+********************************************************************************
+*
+* Summary:
+*  Initializes the transfer control block of an endpoint. Call it when the
+*  device is configured, before the first transfer on the endpoint.
+*
+* Parameters:
+*  transfer: Transfer control block.
+*  epNumber: Data endpoint number.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Transfer_Init(TRANSFER *transfer, uint8 epNumber)
+{
+    transfer->pData      = NULL;
+    transfer->size       = 0u;
+    transfer->count      = 0u;
+    transfer->packet     = 0u;
+    transfer->epNumber   = epNumber;
+    transfer->state      = TRANSFER_IDLE;
+    transfer->dirIn      = 0u;
+    transfer->epArmed    = 0u;
+    transfer->dmaPending = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Transfer_StartIn
+********************************************************************************
+*
+* Summary:
+*  Starts sending the buffer on an IN endpoint. The first packet is loaded
+*  if the endpoint is empty. The buffer must not change until the transfer
+*  is done.
+*
+* Parameters:
+*  transfer: Transfer control block of the IN endpoint.
+*  pData:    Data to send.
+*  length:   Number of bytes to send.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Transfer_StartIn(TRANSFER *transfer, const uint8 pData[], uint16 length)
+{
+    transfer->pData = (uint8 *) pData;
+    transfer->size  = length;
+    transfer->count = 0u;
+    transfer->dirIn = 1u;
+    transfer->state = TRANSFER_BUSY;
+
+    Transfer_ServiceIn(transfer);
+}
+
+
+/*******************************************************************************
+* Function Name: Transfer_StartOut
+********************************************************************************
+*
+* Summary:
+*  Starts receiving into the buffer from an OUT endpoint. The endpoint is
+*  enabled unless it already holds or waits for the next packet.
+*
+* Parameters:
+*  transfer: Transfer control block of the OUT endpoint.
+*  pData:    Buffer to receive into.
+*  size:     Size of the buffer.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Transfer_StartOut(TRANSFER *transfer, uint8 pData[], uint16 size)
+{
+    transfer->pData = pData;
+    transfer->size  = size;
+    transfer->count = 0u;
+    transfer->dirIn = 0u;
+    transfer->state = TRANSFER_BUSY;
+
+    Transfer_EnableOut(transfer);
+}
+
+
+/*******************************************************************************
+* Function Name: Transfer_Service
+********************************************************************************
+*
+* Summary:
+*  Moves the transfer forward: completes the packet the host has read or
+*  written and starts the next one. Call it on every endpoint event.
+*
+* Parameters:
+*  transfer: Transfer control block.
+*
+* Return:
+*  TRANSFER_IDLE, TRANSFER_BUSY, or TRANSFER_DONE or TRANSFER_OVERFLOW once
+*  when the transfer ends. The count field holds the number of bytes sent or
+*  received. After an overflow, the rest of the host transfer is received by
+*  the next OUT transfer.
+*
+*******************************************************************************/
+uint8 Transfer_Service(TRANSFER *transfer)
+{
+    uint8 state;
+
+    if (TRANSFER_BUSY == transfer->state)
+    {
+        if (0u != transfer->dirIn)
+        {
+            Transfer_ServiceIn(transfer);
+        }
+        else
+        {
+            Transfer_ServiceOut(transfer);
+        }
+    }
+
+    state = transfer->state;
+
+    if ((TRANSFER_DONE == state) || (TRANSFER_OVERFLOW == state))
+    {
+        transfer->state = TRANSFER_IDLE;
+    }
+
+    return (state);
+}
+
+
+/*******************************************************************************
+* Function Name: Transfer_ServiceIn
+********************************************************************************
+*
+* Summary:
+*  Completes the IN packet the host has read and loads the next one. A short
+*  packet ends the transfer: the last partial packet, or a zero-length packet
+*  after a full one.
+*
+* Parameters:
+*  transfer: Transfer control block.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Transfer_ServiceIn(TRANSFER *transfer)
+{
+    uint8  epNumber = transfer->epNumber;
+    uint16 maxPacket = USBFS_EP[epNumber].bufferSize;
+
+    if (USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(epNumber))
+    {
+        if (0u != transfer->epArmed)
+        {
+            /* Host has read the packet. */
+            transfer->epArmed = 0u;
+            transfer->count  += transfer->packet;
+
+            if (transfer->packet < maxPacket)
+            {
+                transfer->state = TRANSFER_DONE;
+            }
+        }
+
+        if (TRANSFER_BUSY == transfer->state)
+        {
+            transfer->packet = transfer->size - transfer->count;
+
+            if (transfer->packet > maxPacket)
+            {
+                transfer->packet = maxPacket;
+            }
+
+            /* A zero-length packet is sent without data. */
+        #if (USBFS_16BITS_EP_ACCESS_ENABLE)
+            USBFS_LoadInEP16(epNumber, (0u != transfer->packet) ? &transfer->pData[transfer->count] : NULL,
+                             transfer->packet);
+        #else
+            USBFS_LoadInEP(epNumber, (0u != transfer->packet) ? &transfer->pData[transfer->count] : NULL,
+                           transfer->packet);
+        #endif /* (USBFS_16BITS_EP_ACCESS_ENABLE) */
+
+            transfer->epArmed = 1u;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Transfer_ServiceOut
+********************************************************************************
+*
+* Summary:
+*  Reads the OUT packet the host has written into the buffer, after the
+*  packets received before it.
+*
+* Parameters:
+*  transfer: Transfer control block.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Transfer_ServiceOut(TRANSFER *transfer)
+{
+    uint8  epNumber = transfer->epNumber;
+#if (!USBFS_EP_MANAGEMENT_DMA_AUTO)
+    uint16 length;
+#endif /* (!USBFS_EP_MANAGEMENT_DMA_AUTO) */
+
+    if (0u != transfer->dmaPending)
+    {
+        /* Check if DMA completed copying data from OUT endpoint buffer. */
+        if (USBFS_OUT_BUFFER_FULL != USBFS_GetEPState(epNumber))
+        {
+            transfer->dmaPending = 0u;
+            Transfer_EndOutPacket(transfer);
+        }
+    }
+    else if ((0u != transfer->epArmed) && (USBFS_OUT_BUFFER_FULL == USBFS_GetEPState(epNumber)))
+    {
+        transfer->epArmed = 0u;
+        transfer->packet  = USBFS_GetEPCount(epNumber);
+
+    #if (USBFS_EP_MANAGEMENT_DMA_AUTO)
+        /* DMA has already stored the data in the buffer while the host was
+        * sending it.
+        */
+    #else
+        /* Bytes of the packet that fit in the buffer. */
+        length = transfer->size - transfer->count;
+        length = (transfer->packet < length) ? transfer->packet : length;
+
+        /* A zero-length packet has no data to read: the endpoint is enabled
+        * again by Transfer_EnableOut().
+        */
+        if (0u != length)
+        {
+        #if (USBFS_16BITS_EP_ACCESS_ENABLE)
+            (void) USBFS_ReadOutEP16(epNumber, &transfer->pData[transfer->count], length);
+        #else
+            (void) USBFS_ReadOutEP(epNumber, &transfer->pData[transfer->count], length);
+        #endif /* (USBFS_16BITS_EP_ACCESS_ENABLE) */
+
+        #if (USBFS_EP_MANAGEMENT_MANUAL)
+            /* The endpoint is enabled when the data is read. */
+            transfer->epArmed = 1u;
+        #else
+            /* The endpoint is enabled again when DMA completes. */
+            transfer->dmaPending = 1u;
+        #endif /* (USBFS_EP_MANAGEMENT_MANUAL) */
+        }
+    #endif /* (USBFS_EP_MANAGEMENT_DMA_AUTO) */
+
+        if (0u == transfer->dmaPending)
+        {
+            Transfer_EndOutPacket(transfer);
+        }
+    }
+    else
+    {
+        /* Wait for the host. */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Transfer_EndOutPacket
+********************************************************************************
+*
+* Summary:
+*  Adds the OUT packet that has been read to the buffer. A short packet ends
+*  the transfer; after a full packet the endpoint is enabled for the next one.
+*
+* Parameters:
+*  transfer: Transfer control block.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Transfer_EndOutPacket(TRANSFER *transfer)
+{
+    uint16 length = transfer->size - transfer->count;
+
+    if (transfer->packet > length)
+    {
+        transfer->count = transfer->size;
+        transfer->state = TRANSFER_OVERFLOW;
+    }
+    else
+    {
+        transfer->count += transfer->packet;
+
+        if (transfer->packet < USBFS_EP[transfer->epNumber].bufferSize)
+        {
+            transfer->state = TRANSFER_DONE;
+        }
+        else
+        {
+            Transfer_EnableOut(transfer);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Transfer_EnableOut
+********************************************************************************
+*
+* Summary:
+*  Enables the OUT endpoint to receive the next packet. With DMA with
+*  Automatic Memory Management the DMA is directed to store the packet after
+*  the data received so far; the part of the packet that does not fit in the
+*  buffer is dropped.
+*
+* Parameters:
+*  transfer: Transfer control block.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Transfer_EnableOut(TRANSFER *transfer)
+{
+#if (USBFS_EP_MANAGEMENT_DMA_AUTO)
+    uint16 length = transfer->size - transfer->count;
+    uint16 maxPacket = USBFS_EP[transfer->epNumber].bufferSize;
+#endif /* (USBFS_EP_MANAGEMENT_DMA_AUTO) */
+
+    if (0u == transfer->epArmed)
+    {
+    #if (USBFS_EP_MANAGEMENT_DMA_AUTO)
+        length = (length > maxPacket) ? maxPacket : length;
+
+    #if (USBFS_16BITS_EP_ACCESS_ENABLE)
+        (void) USBFS_ReadOutEP16(transfer->epNumber, &transfer->pData[transfer->count], length);
+    #else
+        (void) USBFS_ReadOutEP(transfer->epNumber, &transfer->pData[transfer->count], length);
+    #endif /* (USBFS_16BITS_EP_ACCESS_ENABLE) */
+    #endif /* (USBFS_EP_MANAGEMENT_DMA_AUTO) */
+
+        USBFS_EnableOutEP(transfer->epNumber);
+        transfer->epArmed = 1u;
+    }
+}
+
+
+/* [] END OF FILE */
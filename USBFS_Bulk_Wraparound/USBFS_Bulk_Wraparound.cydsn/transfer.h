@@ -0,0 +1,75 @@
+/*******************************************************************************
+* File Name: transfer.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants, the transfer control block and function
+*  prototypes of the multi-packet transfer API of the USBFS Bulk Wraparound
+*  example project.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(TRANSFER_H)
+#define TRANSFER_H
+
+#include <project.h>
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* Transfer states returned by Transfer_Service(). TRANSFER_DONE and
+* TRANSFER_OVERFLOW are returned once; the transfer is idle afterwards.
+*/
+#define TRANSFER_IDLE       (0u)    /* No transfer started. */
+#define TRANSFER_BUSY       (1u)    /* Packets remain to be sent or received. */
+#define TRANSFER_DONE       (2u)    /* Transfer completed. */
+#define TRANSFER_OVERFLOW   (3u)    /* OUT data did not fit in the buffer. */
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Transfer control block: one per endpoint. It is initialized with
+* Transfer_Init() when the device is configured and keeps the endpoint state
+* between transfers.
+*/
+typedef struct
+{
+    uint8  *pData;          /* Data to send or buffer to receive into. */
+    uint16 size;            /* IN: transfer length; OUT: buffer size. */
+    uint16 count;           /* Bytes sent or received. */
+    uint16 packet;          /* Length of the packet in progress. */
+    uint8  epNumber;
+    uint8  state;
+    uint8  dirIn;           /* IN transfer in progress. */
+    uint8  epArmed;         /* IN loaded or OUT enabled by the transfer. */
+    uint8  dmaPending;      /* DMA copies the OUT packet into pData. */
+} TRANSFER;
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void  Transfer_Init(TRANSFER *transfer, uint8 epNumber);
+void  Transfer_StartIn(TRANSFER *transfer, const uint8 pData[], uint16 length);
+void  Transfer_StartOut(TRANSFER *transfer, uint8 pData[], uint16 size);
+uint8 Transfer_Service(TRANSFER *transfer);
+
+#endif /* (TRANSFER_H) */
+
+
+/* [] END OF FILE */
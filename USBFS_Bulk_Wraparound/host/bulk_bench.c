@@ -0,0 +1,885 @@
+/*******************************************************************************
+* File Name: bulk_bench.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host throughput tool of the USBFS Bulk Wraparound example. Selects the test
+*  mode of the device with the SET_TEST_MODE vendor request and measures the
+*  bulk throughput of the mode:
+*   loopback: writes a transfer to the OUT endpoint and reads it back from the
+*             IN endpoint, and checks the data.
+*   source:   reads the IN endpoint back-to-back and checks the test pattern.
+*   sink:     writes the OUT endpoint back-to-back.
+*   message:  writes a message of up to 4 KB to the OUT endpoint, ended by a
+*             short or zero-length packet, reads it back from the IN endpoint
+*             as one transfer, and checks the data.
+*   pingpong: loopback of single small packets, one in flight. Records the
+*             round-trip time of each packet and prints its percentiles and
+*             log2 histogram, followed by the stage timing of the firmware if
+*             it is built in: the residence stage is the time each packet
+*             spent in the firmware, from its OUT transaction to LoadInEP().
+*  With -t the tool reads the stage timing of the loopback after the run and
+*  prints the cycles each stage took and their log2 histogram. The firmware
+*  has to be built with STAGE_TIMING_ENABLE=1u. In the loopback mode every
+*  packet passes through every stage: the run fails if a stage has no sample.
+*  With -c the tool loops packets of each length from 1 to 64 bytes and
+*  prints the mean cycles the firmware took to copy each one out of the OUT
+*  endpoint (out-read stage) and into the IN endpoint (in-load stage), from
+*  the stage timing. Build the firmware once with EP_COPY_WIDE=0u and once
+*  without it to compare the byte copy of the component with the word-wide
+*  copy of the firmware in Manual mode.
+*  With -i, in the loopback and pingpong modes, the tool puts a sequence
+*  number in the first four bytes of each packet and computes the CRC-32 of
+*  the data it sends. After the run it reads the integrity check of the
+*  firmware with the GET_INTEGRITY request and compares the packets, bytes
+*  and CRC the firmware received with the ones sent. The firmware has to be
+*  built with INTEGRITY_ENABLE=1u.
+*  The device is left in the loopback mode.
+*
+*  Build against a device on the bus (libusb-1.0):
+*   gcc -I USBFS_Host_Emulation USBFS_Bulk_Wraparound/host/bulk_bench.c \
+*       USBFS_Host_Emulation/libusb/host_usb_libusb.c -lusb-1.0 -o bulk_bench
+*  Build against the emulated firmware: add -pthread and this file to the
+*  build command in USBFS_Host_Emulation/README.md, then run
+*   ./bulk_bench_sim -s host -- -m source
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "host_usb.h"
+
+/* Device of the example. */
+#define BENCH_VID               (0x04B4u)
+#define BENCH_PID               (0x8051u)
+#define BENCH_IN_EP             (0x81u)
+#define BENCH_OUT_EP            (0x02u)
+#define BENCH_MAX_PACKET        (64u)
+
+/* Vendor-specific requests and test modes of the firmware. */
+#define BENCH_RQST_OUT          (0x40u)     /* Vendor, device, host to device */
+#define BENCH_RQST_IN           (0xC0u)     /* Vendor, device, device to host */
+#define BENCH_SET_TEST_MODE     (0x01u)
+#define BENCH_GET_TEST_MODE     (0x02u)
+#define BENCH_GET_STAGE_TIMING  (0x03u)
+#define BENCH_GET_INTEGRITY     (0x05u)
+#define BENCH_INTEGRITY_CLEAR   (0x01u)     /* wValue: start a new check after the read */
+#define BENCH_MODE_LOOPBACK     (0u)
+#define BENCH_MODE_SOURCE       (1u)
+#define BENCH_MODE_SINK         (2u)
+#define BENCH_MODE_MESSAGE      (3u)
+#define BENCH_MODE_PINGPONG     (4u)        /* Loopback mode of the firmware */
+#define BENCH_MESSAGE_SIZE      (4096u)     /* Message buffer of the firmware */
+
+/* STAGE_TIMING block of the firmware: clock and stage count, then per stage
+* count, min, max, sum (low and high word) and the histogram, all 32-bit
+* little-endian words.
+*/
+#define BENCH_STAGE_COUNT       (7u)
+#define BENCH_STAGE_BINS        (24u)
+#define BENCH_STAGE_HEADER      (8u)
+#define BENCH_STAGE_SIZE        ((5u + BENCH_STAGE_BINS) * 4u)
+#define BENCH_STAGE_OUT_READ    (0u)
+#define BENCH_STAGE_IN_LOAD     (3u)
+
+/* INTEGRITY_STATUS block of the firmware: packets, bytes, CRC-32, next
+* sequence number, sequence errors and short packets, all 32-bit
+* little-endian words.
+*/
+#define BENCH_INTEGRITY_SIZE    (24u)
+#define BENCH_SEQUENCE_SIZE     (4u)
+#define BENCH_CRC_POLYNOMIAL    (0xEDB88320u)
+
+/* Defaults of the options. */
+#define BENCH_DEFAULT_DURATION  (1000u)     /* ms */
+#define BENCH_DEFAULT_LENGTH    (4096u)
+#define BENCH_LOOPBACK_LENGTH   (BENCH_MAX_PACKET)
+#define BENCH_PINGPONG_LENGTH   (8u)
+#define BENCH_MAX_LENGTH        (65536u)
+#define BENCH_TIMEOUT           (1000u)     /* ms */
+#define BENCH_DRAIN_TIMEOUT     (10u)       /* ms */
+
+/* Packets of each length looped by the copy sweep. */
+#define BENCH_SWEEP_PACKETS     (64u)
+
+/* Round-trip times kept by the pingpong mode; the run ends when full. */
+#define BENCH_MAX_SAMPLES       (1u << 20u)
+#define BENCH_RTT_BINS          (32u)
+
+static const char *const benchModeName[] = {"loopback", "source", "sink", "message", "pingpong"};
+
+static const char *const benchStageName[] =
+{
+    "out-read", "out-rearm", "in-queue", "in-load", "in-host", "loop", "residence"
+};
+
+static const HOST_USB_EP benchEps[] =
+{
+    {BENCH_IN_EP,  HOST_USB_EP_BULK, BENCH_MAX_PACKET},
+    {BENCH_OUT_EP, HOST_USB_EP_BULK, BENCH_MAX_PACKET}
+};
+
+static uint8 benchOut[BENCH_MAX_LENGTH];
+static uint8 benchIn[BENCH_MAX_LENGTH];
+static uint32 benchRtt[BENCH_MAX_SAMPLES];
+static uint32 benchCrcTable[256];
+
+/* Integrity check of the data sent: CRC-32 without the final XOR, the next
+* sequence number and the packets too short to hold one.
+*/
+static uint32 benchCrc;
+static uint32 benchSequence;
+static uint32 benchShortPackets;
+
+static int    Bench_SetMode(uint8 mode);
+static uint32 Bench_Word(const uint8 data[]);
+static int    Bench_CompareRtt(const void *a, const void *b);
+static void   Bench_PrintLatency(uint32 samples);
+static int    Bench_GetStageTiming(uint8 block[], uint32 *clockHz, uint32 *stages);
+static int    Bench_PrintStageTiming(uint8 checkStages);
+static int    Bench_CopySweep(void);
+static void   Bench_AddSequence(uint8 data[], uint32 length);
+static int    Bench_CheckIntegrity(uint64 bytes, uint64 packets, uint8 clear);
+static void   Bench_Usage(const char *program);
+
+
+/*******************************************************************************
+* Function Name: Bench_SetMode
+********************************************************************************
+*
+* Summary:
+*  Selects the test mode and reads it back.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Bench_SetMode(uint8 mode)
+{
+    uint8 readBack = 0xFFu;
+
+    if ((HOST_USB_SUCCESS != HostUsb_Control(BENCH_RQST_OUT, BENCH_SET_TEST_MODE, mode, 0u,
+                                              NULL, 0u, BENCH_TIMEOUT)) ||
+        (1 != HostUsb_Control(BENCH_RQST_IN, BENCH_GET_TEST_MODE, 0u, 0u,
+                              &readBack, 1u, BENCH_TIMEOUT)) ||
+        (readBack != mode))
+    {
+        printf("device does not support SET_TEST_MODE %u\n", mode);
+        return (HOST_USB_ERROR);
+    }
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_Word
+********************************************************************************
+*
+* Summary:
+*  Returns the little-endian 32-bit word at data.
+*
+*******************************************************************************/
+static uint32 Bench_Word(const uint8 data[])
+{
+    return ((uint32) data[0] | ((uint32) data[1] << 8u) |
+            ((uint32) data[2] << 16u) | ((uint32) data[3] << 24u));
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_CompareRtt
+********************************************************************************
+*
+* Summary:
+*  Orders round-trip times for qsort().
+*
+*******************************************************************************/
+static int Bench_CompareRtt(const void *a, const void *b)
+{
+    uint32 rttA = *(const uint32 *) a;
+    uint32 rttB = *(const uint32 *) b;
+
+    return ((rttA > rttB) - (rttA < rttB));
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_PrintLatency
+********************************************************************************
+*
+* Summary:
+*  Prints the percentiles of the round-trip times of the pingpong mode and
+*  their log2 histogram in microseconds. Sorts the samples.
+*
+*******************************************************************************/
+static void Bench_PrintLatency(uint32 samples)
+{
+    static const double percentile[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+    uint32 histogram[BENCH_RTT_BINS];
+    uint64 sum = 0u;
+    uint32 value;
+    uint32 bin;
+    uint32 i;
+
+    if (0u == samples)
+    {
+        return;
+    }
+
+    memset(histogram, 0, sizeof(histogram));
+
+    for (i = 0u; i < samples; ++i)
+    {
+        sum += benchRtt[i];
+
+        /* Bin of the most significant bit of the time in microseconds. */
+        value = benchRtt[i] / 1000u;
+        for (bin = 0u; value > 1u; ++bin)
+        {
+            value >>= 1u;
+        }
+        ++histogram[bin];
+    }
+
+    qsort(benchRtt, samples, sizeof(benchRtt[0]), &Bench_CompareRtt);
+
+    printf("round trip      : %u samples, us\n", samples);
+    printf("  min %.1f  mean %.1f  max %.1f\n", benchRtt[0] / 1e3,
+           ((double) sum / samples) / 1e3, benchRtt[samples - 1u] / 1e3);
+
+    printf(" ");
+    for (i = 0u; i < (sizeof(percentile) / sizeof(percentile[0])); ++i)
+    {
+        printf(" p%g %.1f", percentile[i],
+               benchRtt[(uint32) (((samples - 1u) * percentile[i]) / 100.0)] / 1e3);
+    }
+    printf("\n");
+
+    printf("  histogram: samples of 2^n to 2^(n+1)-1 us\n ");
+    for (bin = 0u; bin < BENCH_RTT_BINS; ++bin)
+    {
+        if (0u != histogram[bin])
+        {
+            printf(" 2^%u:%u", bin, histogram[bin]);
+        }
+    }
+    printf("\n");
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_GetStageTiming
+********************************************************************************
+*
+* Summary:
+*  Reads the stage timing block with the GET_STAGE_TIMING request and checks
+*  its layout.
+*
+* Parameters:
+*  block:   Buffer for BENCH_STAGE_COUNT stages.
+*  clockHz: Returns the SYSCLK frequency of the firmware.
+*  stages:  Returns the number of stages in the block.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Bench_GetStageTiming(uint8 block[], uint32 *clockHz, uint32 *stages)
+{
+    int length;
+
+    length = HostUsb_Control(BENCH_RQST_IN, BENCH_GET_STAGE_TIMING, 0u, 0u, block,
+                             BENCH_STAGE_HEADER + (BENCH_STAGE_COUNT * BENCH_STAGE_SIZE),
+                             BENCH_TIMEOUT);
+
+    if (length < (int) BENCH_STAGE_HEADER)
+    {
+        printf("stage timing    : not built into the firmware\n");
+        return (HOST_USB_ERROR);
+    }
+
+    *clockHz = Bench_Word(&block[0]);
+    *stages  = Bench_Word(&block[4]);
+
+    if ((0u == *clockHz) || (*stages > BENCH_STAGE_COUNT) ||
+        ((uint32) length < (BENCH_STAGE_HEADER + (*stages * BENCH_STAGE_SIZE))))
+    {
+        printf("stage timing    : unknown block layout\n");
+        return (HOST_USB_ERROR);
+    }
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_PrintStageTiming
+********************************************************************************
+*
+* Summary:
+*  Reads the stage timing with the GET_STAGE_TIMING request and prints the
+*  cycles of each stage and the histogram bins that hold samples.
+*
+* Parameters:
+*  checkStages: Non-zero after a loopback run: every stage must have samples.
+*
+* Return:
+*  HOST_USB_SUCCESS, or HOST_USB_ERROR if the request fails or, with
+*  checkStages set, a stage has no sample.
+*
+*******************************************************************************/
+static int Bench_PrintStageTiming(uint8 checkStages)
+{
+    uint8  block[BENCH_STAGE_HEADER + (BENCH_STAGE_COUNT * BENCH_STAGE_SIZE)];
+    const uint8 *stage;
+    uint32 clockHz;
+    uint32 stages;
+    uint32 count;
+    uint64 sum;
+    uint32 i;
+    uint32 bin;
+    int    result = HOST_USB_SUCCESS;
+
+    if (HOST_USB_SUCCESS != Bench_GetStageTiming(block, &clockHz, &stages))
+    {
+        return (HOST_USB_ERROR);
+    }
+
+    printf("stage timing    : cycles at %.1f MHz\n", (double) clockHz / 1e6);
+    printf("  %-10s %8s %8s %8s %8s %9s\n", "stage", "samples", "min", "mean", "max", "mean us");
+
+    for (i = 0u; i < stages; ++i)
+    {
+        stage = &block[BENCH_STAGE_HEADER + (i * BENCH_STAGE_SIZE)];
+        count = Bench_Word(&stage[0]);
+        sum   = (uint64) Bench_Word(&stage[12]) | ((uint64) Bench_Word(&stage[16]) << 32u);
+
+        if (0u == count)
+        {
+            printf("  %-10s %8u\n", benchStageName[i], 0u);
+
+            if (0u != checkStages)
+            {
+                result = HOST_USB_ERROR;
+            }
+            continue;
+        }
+
+        printf("  %-10s %8u %8u %8.1f %8u %9.2f\n", benchStageName[i], count,
+               Bench_Word(&stage[4]), (double) sum / count, Bench_Word(&stage[8]),
+               ((double) sum / count) * 1e6 / clockHz);
+    }
+
+    printf("  histogram: samples of 2^n to 2^(n+1)-1 cycles\n");
+
+    for (i = 0u; i < stages; ++i)
+    {
+        stage = &block[BENCH_STAGE_HEADER + (i * BENCH_STAGE_SIZE)];
+        printf("  %-10s", benchStageName[i]);
+
+        for (bin = 0u; bin < BENCH_STAGE_BINS; ++bin)
+        {
+            count = Bench_Word(&stage[20u + (bin * 4u)]);
+
+            if (0u != count)
+            {
+                printf(" 2^%u:%u", bin, count);
+            }
+        }
+        printf("\n");
+    }
+
+    if ((0u != checkStages) && ((HOST_USB_ERROR == result) || (stages != BENCH_STAGE_COUNT)))
+    {
+        printf("stage timing    : stage without samples\n");
+        result = HOST_USB_ERROR;
+    }
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_CopySweep
+********************************************************************************
+*
+* Summary:
+*  Loops BENCH_SWEEP_PACKETS packets of each length from 1 to 64 bytes, one in
+*  flight, and prints the mean cycles of the out-read and in-load stages of
+*  each length, per packet and per byte. The stage statistics accumulate over
+*  the sweep: the mean of a length is taken from the difference between the
+*  blocks read before and after its packets.
+*
+* Return:
+*  HOST_USB_SUCCESS, or HOST_USB_ERROR on a transfer or data error.
+*
+*******************************************************************************/
+static int Bench_CopySweep(void)
+{
+    static const uint8 sweepStage[2u] = {BENCH_STAGE_OUT_READ, BENCH_STAGE_IN_LOAD};
+    uint8  block[2u][BENCH_STAGE_HEADER + (BENCH_STAGE_COUNT * BENCH_STAGE_SIZE)];
+    const uint8 *stage;
+    const uint8 *last;
+    uint32 clockHz;
+    uint32 stages;
+    uint32 transferred;
+    uint32 length;
+    uint32 count;
+    uint64 sum;
+    uint32 packet;
+    uint32 i;
+    int result;
+
+    result = Bench_GetStageTiming(block[0], &clockHz, &stages);
+
+    if ((HOST_USB_SUCCESS == result) && (stages <= BENCH_STAGE_IN_LOAD))
+    {
+        printf("stage timing    : no copy stages\n");
+        result = HOST_USB_ERROR;
+    }
+
+    if (HOST_USB_SUCCESS == result)
+    {
+        printf("copy sweep      : mean cycles at %.1f MHz, %u packets per length\n",
+               (double) clockHz / 1e6, BENCH_SWEEP_PACKETS);
+        printf("  %5s %9s %9s %9s %9s\n", "bytes", "out-read", "per byte", "in-load", "per byte");
+    }
+
+    for (length = 1u; (HOST_USB_SUCCESS == result) && (length <= BENCH_MAX_PACKET); ++length)
+    {
+        for (packet = 0u; (HOST_USB_SUCCESS == result) && (packet < BENCH_SWEEP_PACKETS); ++packet)
+        {
+            for (i = 0u; i < length; ++i)
+            {
+                benchOut[i] = (uint8) ((packet * 7u) + i);
+            }
+
+            result = HostUsb_Transfer(BENCH_OUT_EP, benchOut, length, &transferred, BENCH_TIMEOUT);
+
+            if (HOST_USB_SUCCESS == result)
+            {
+                result = HostUsb_Transfer(BENCH_IN_EP, benchIn, length, &transferred, BENCH_TIMEOUT);
+            }
+
+            if ((HOST_USB_SUCCESS == result) &&
+                ((transferred != length) || (0 != memcmp(benchIn, benchOut, length))))
+            {
+                printf("data error      : %u-byte packet\n", length);
+                result = HOST_USB_ERROR;
+            }
+        }
+
+        if (HOST_USB_SUCCESS == result)
+        {
+            result = Bench_GetStageTiming(block[length % 2u], &clockHz, &stages);
+        }
+
+        if (HOST_USB_SUCCESS == result)
+        {
+            printf("  %5u", length);
+
+            for (i = 0u; i < 2u; ++i)
+            {
+                stage = &block[length % 2u][BENCH_STAGE_HEADER + (sweepStage[i] * BENCH_STAGE_SIZE)];
+                last  = &block[(length + 1u) % 2u][BENCH_STAGE_HEADER + (sweepStage[i] * BENCH_STAGE_SIZE)];
+                count = Bench_Word(&stage[0]) - Bench_Word(&last[0]);
+                sum   = ((uint64) Bench_Word(&stage[12]) | ((uint64) Bench_Word(&stage[16]) << 32u)) -
+                        ((uint64) Bench_Word(&last[12]) | ((uint64) Bench_Word(&last[16]) << 32u));
+
+                if (0u != count)
+                {
+                    printf(" %9.1f %9.2f", (double) sum / count, ((double) sum / count) / length);
+                }
+                else
+                {
+                    printf(" %9s %9s", "-", "-");
+                }
+            }
+            printf("\n");
+        }
+    }
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_AddSequence
+********************************************************************************
+*
+* Summary:
+*  Puts the next sequence number in the first bytes of each packet of a
+*  transfer and adds the transfer to the CRC-32 of the data sent.
+*
+*******************************************************************************/
+static void Bench_AddSequence(uint8 data[], uint32 length)
+{
+    uint32 offset;
+    uint32 size;
+    uint32 i;
+
+    for (offset = 0u; offset < length; offset += BENCH_MAX_PACKET)
+    {
+        size = ((length - offset) < BENCH_MAX_PACKET) ? (length - offset) : BENCH_MAX_PACKET;
+
+        if (size >= BENCH_SEQUENCE_SIZE)
+        {
+            for (i = 0u; i < BENCH_SEQUENCE_SIZE; ++i)
+            {
+                data[offset + i] = (uint8) (benchSequence >> (8u * i));
+            }
+            ++benchSequence;
+        }
+        else
+        {
+            ++benchShortPackets;
+        }
+    }
+
+    for (i = 0u; i < length; ++i)
+    {
+        benchCrc = benchCrcTable[(benchCrc ^ data[i]) & 0xFFu] ^ (benchCrc >> 8u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_CheckIntegrity
+********************************************************************************
+*
+* Summary:
+*  Reads the integrity check of the firmware with the GET_INTEGRITY request.
+*  With clear set, the firmware starts a new check and the tool starts a new
+*  CRC; otherwise the tool prints the check and compares it with the data
+*  sent.
+*
+* Return:
+*  HOST_USB_SUCCESS, or HOST_USB_ERROR if the request fails or the check
+*  does not match.
+*
+*******************************************************************************/
+static int Bench_CheckIntegrity(uint64 bytes, uint64 packets, uint8 clear)
+{
+    uint8  block[BENCH_INTEGRITY_SIZE];
+    uint32 value;
+    uint32 bit;
+    uint32 i;
+    int    length;
+    int    result = HOST_USB_SUCCESS;
+
+    length = HostUsb_Control(BENCH_RQST_IN, BENCH_GET_INTEGRITY,
+                             (0u != clear) ? BENCH_INTEGRITY_CLEAR : 0u, 0u,
+                             block, sizeof(block), BENCH_TIMEOUT);
+
+    if (length < (int) BENCH_INTEGRITY_SIZE)
+    {
+        printf("integrity       : not built into the firmware\n");
+        return (HOST_USB_ERROR);
+    }
+
+    if (0u != clear)
+    {
+        for (i = 0u; i < 256u; ++i)
+        {
+            value = i;
+            for (bit = 0u; bit < 8u; ++bit)
+            {
+                value = (0u != (value & 1u)) ? ((value >> 1u) ^ BENCH_CRC_POLYNOMIAL) : (value >> 1u);
+            }
+            benchCrcTable[i] = value;
+        }
+
+        benchCrc = 0xFFFFFFFFu;
+        benchSequence = 0u;
+        benchShortPackets = 0u;
+        return (HOST_USB_SUCCESS);
+    }
+
+    printf("integrity       : %10s %10s\n", "device", "sent");
+    printf("  packets       : %10u %10u\n", Bench_Word(&block[0]), (uint32) packets);
+    printf("  bytes         : %10u %10u\n", Bench_Word(&block[4]), (uint32) bytes);
+    printf("  crc-32        : 0x%08X 0x%08X\n", Bench_Word(&block[8]), benchCrc ^ 0xFFFFFFFFu);
+    printf("  next sequence : %10u %10u\n", Bench_Word(&block[12]), benchSequence);
+    printf("  seq. errors   : %10u\n", Bench_Word(&block[16]));
+    printf("  short packets : %10u %10u\n", Bench_Word(&block[20]), benchShortPackets);
+
+    if ((Bench_Word(&block[0]) != (uint32) packets) ||
+        (Bench_Word(&block[4]) != (uint32) bytes) ||
+        (Bench_Word(&block[8]) != (benchCrc ^ 0xFFFFFFFFu)) ||
+        (Bench_Word(&block[12]) != benchSequence) ||
+        (Bench_Word(&block[16]) != 0u) ||
+        (Bench_Word(&block[20]) != benchShortPackets))
+    {
+        printf("integrity       : MISMATCH\n");
+        result = HOST_USB_ERROR;
+    }
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_Usage
+********************************************************************************
+*
+* Summary:
+*  Prints the command line help.
+*
+*******************************************************************************/
+static void Bench_Usage(const char *program)
+{
+    printf("usage: %s [-m loopback|source|sink|message|pingpong] [-d ms] [-l bytes] [-t] [-i]\n"
+           "       %s -c\n", program, program);
+    printf("  -m   test mode (loopback)\n");
+    printf("  -d   duration, ms (%u)\n", BENCH_DEFAULT_DURATION);
+    printf("  -l   bytes per transfer (%u, loopback %u, pingpong %u, max %u,\n"
+           "       message max %u, pingpong max %u)\n",
+           BENCH_DEFAULT_LENGTH, BENCH_LOOPBACK_LENGTH, BENCH_PINGPONG_LENGTH, BENCH_MAX_LENGTH,
+           BENCH_MESSAGE_SIZE, BENCH_MAX_PACKET);
+    printf("  -t   print the stage timing of the firmware\n");
+    printf("  -i   check the data received by the firmware (loopback and pingpong)\n");
+    printf("  -c   cycles of the endpoint copy for packets of 1 to %u bytes\n", BENCH_MAX_PACKET);
+}
+
+
+/*******************************************************************************
+* Function Name: HostTool_Main
+********************************************************************************
+*
+* Summary:
+*  Runs the selected test mode for the duration and prints the throughput.
+*  A loopback transfer must fit in the packet queue of the device. The
+*  pingpong mode also prints the round-trip times.
+*
+* Return:
+*  0 on success, 1 on a transfer or data error, 4 on a usage error.
+*
+*******************************************************************************/
+int HostTool_Main(int argc, char *argv[])
+{
+    uint8  mode = BENCH_MODE_LOOPBACK;
+    uint8  deviceMode;
+    uint8  loopback;
+    uint32 durationMs = BENCH_DEFAULT_DURATION;
+    uint32 length = 0u;
+    uint32 transferred;
+    uint32 zeroLength;
+    uint64 bytes = 0u;
+    uint64 packets = 0u;
+    uint32 errors = 0u;
+    uint8  timing = 0u;
+    uint8  integrity = 0u;
+    uint8  sweep = 0u;
+    uint32 samples = 0u;
+    uint64 sent = 0u;
+    uint64 start;
+    uint64 elapsed;
+    uint32 i;
+    int result = HOST_USB_SUCCESS;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "m:d:l:tich")))
+    {
+        switch (opt)
+        {
+            case 'm':
+                for (mode = 0u; (mode <= BENCH_MODE_PINGPONG) &&
+                     (0 != strcmp(optarg, benchModeName[mode])); ++mode)
+                {
+                }
+                break;
+            case 'd': durationMs = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'l': length     = (uint32) strtoul(optarg, NULL, 0); break;
+            case 't': timing     = 1u; break;
+            case 'i': integrity  = 1u; break;
+            case 'c': sweep      = 1u; break;
+            default:
+                mode = 0xFFu;
+                break;
+        }
+    }
+
+    if (0u == length)
+    {
+        length = (BENCH_MODE_LOOPBACK == mode) ? BENCH_LOOPBACK_LENGTH :
+                 (BENCH_MODE_PINGPONG == mode) ? BENCH_PINGPONG_LENGTH : BENCH_DEFAULT_LENGTH;
+    }
+
+    if ((mode > BENCH_MODE_PINGPONG) || (length > BENCH_MAX_LENGTH) ||
+        ((BENCH_MODE_MESSAGE == mode) && (length > BENCH_MESSAGE_SIZE)) ||
+        ((BENCH_MODE_PINGPONG == mode) && (length > BENCH_MAX_PACKET)) ||
+        ((0u != integrity) && (BENCH_MODE_LOOPBACK != mode) && (BENCH_MODE_PINGPONG != mode)) ||
+        ((0u != sweep) && (BENCH_MODE_LOOPBACK != mode)))
+    {
+        Bench_Usage(argv[0]);
+        return (4);
+    }
+
+    /* The pingpong mode uses the loopback of the firmware. */
+    loopback   = ((BENCH_MODE_LOOPBACK == mode) || (BENCH_MODE_PINGPONG == mode)) ? 1u : 0u;
+    deviceMode = (BENCH_MODE_PINGPONG == mode) ? BENCH_MODE_LOOPBACK : mode;
+
+    if ((HOST_USB_SUCCESS != HostUsb_Open(BENCH_VID, BENCH_PID, benchEps, 2u)) ||
+        (HOST_USB_SUCCESS != Bench_SetMode(deviceMode)))
+    {
+        HostUsb_Close(1);
+        return (1);
+    }
+
+    if ((0u != loopback) || (BENCH_MODE_MESSAGE == mode))
+    {
+        /* Drop an IN packet left loaded by the source mode. */
+        while (HOST_USB_SUCCESS == HostUsb_Transfer(BENCH_IN_EP, benchIn, BENCH_MAX_PACKET,
+                                                    &transferred, BENCH_DRAIN_TIMEOUT))
+        {
+        }
+    }
+
+    if ((0u != integrity) && (HOST_USB_SUCCESS != Bench_CheckIntegrity(0u, 0u, 1u)))
+    {
+        HostUsb_Close(1);
+        return (1);
+    }
+
+    if (0u != sweep)
+    {
+        result = (HOST_USB_SUCCESS == Bench_CopySweep()) ? 0 : 1;
+        HostUsb_Close(result);
+        return (result);
+    }
+
+    start = HostUsb_TimeNs();
+
+    do
+    {
+        if (BENCH_MODE_SOURCE == mode)
+        {
+            result = HostUsb_Transfer(BENCH_IN_EP, benchIn, length, &transferred, BENCH_TIMEOUT);
+
+            for (i = 0u; i < transferred; ++i)
+            {
+                errors += (benchIn[i] != (uint8) (i % BENCH_MAX_PACKET)) ? 1u : 0u;
+            }
+        }
+        else
+        {
+            for (i = 0u; i < length; ++i)
+            {
+                benchOut[i] = (uint8) ((packets * 7u) + i);
+            }
+
+            if (0u != integrity)
+            {
+                Bench_AddSequence(benchOut, length);
+            }
+
+            sent = HostUsb_TimeNs();
+            result = HostUsb_Transfer(BENCH_OUT_EP, benchOut, length, &transferred, BENCH_TIMEOUT);
+
+            /* The firmware reassembles a message until a short packet. */
+            if ((HOST_USB_SUCCESS == result) && (BENCH_MODE_MESSAGE == mode) &&
+                (0u == (length % BENCH_MAX_PACKET)))
+            {
+                result = HostUsb_Transfer(BENCH_OUT_EP, benchOut, 0u, &zeroLength, BENCH_TIMEOUT);
+            }
+
+            if ((HOST_USB_SUCCESS == result) && (0u != loopback))
+            {
+                result = HostUsb_Transfer(BENCH_IN_EP, benchIn, length, &transferred, BENCH_TIMEOUT);
+                errors += ((transferred != length) ||
+                           (0 != memcmp(benchIn, benchOut, length))) ? 1u : 0u;
+
+                if ((HOST_USB_SUCCESS == result) && (BENCH_MODE_PINGPONG == mode))
+                {
+                    benchRtt[samples] = (uint32) (HostUsb_TimeNs() - sent);
+                    ++samples;
+                }
+            }
+            else if ((HOST_USB_SUCCESS == result) && (BENCH_MODE_MESSAGE == mode))
+            {
+                /* Read more than the message: the firmware ends it with a
+                * short or zero-length packet.
+                */
+                result = HostUsb_Transfer(BENCH_IN_EP, benchIn, BENCH_MAX_LENGTH,
+                                          &transferred, BENCH_TIMEOUT);
+                errors += ((transferred != length) ||
+                           (0 != memcmp(benchIn, benchOut, length))) ? 1u : 0u;
+            }
+            else
+            {
+                /* Sink, or transfer error. */
+            }
+        }
+
+        bytes += transferred;
+        packets += (transferred + BENCH_MAX_PACKET - 1u) / BENCH_MAX_PACKET;
+        elapsed = HostUsb_TimeNs() - start;
+    }
+    while ((HOST_USB_SUCCESS == result) && (0u == errors) && (samples < BENCH_MAX_SAMPLES) &&
+           (elapsed < ((uint64) durationMs * 1000000u)));
+
+    printf("mode            : %s\n", benchModeName[mode]);
+    printf("transfer        : %u bytes\n", length);
+    printf("bytes           : %llu\n", (unsigned long long) bytes);
+    printf("packets         : %llu\n", (unsigned long long) packets);
+    printf("time            : %.3f ms\n", (double) elapsed / 1e6);
+    printf("throughput      : %.3f MB/s, %.0f packets/s\n",
+           (0u != elapsed) ? ((double) bytes * 1e3 / (double) elapsed) : 0.0,
+           (0u != elapsed) ? ((double) packets * 1e9 / (double) elapsed) : 0.0);
+
+    if (HOST_USB_SUCCESS != result)
+    {
+        printf("transfer error  : %d\n", result);
+    }
+    if (0u != errors)
+    {
+        printf("data errors     : %u\n", errors);
+    }
+
+    if (BENCH_MODE_PINGPONG == mode)
+    {
+        Bench_PrintLatency(samples);
+    }
+
+    if ((0u != timing) && (HOST_USB_SUCCESS == result))
+    {
+        result = Bench_PrintStageTiming((BENCH_MODE_LOOPBACK == mode) ? 1u : 0u);
+    }
+    else if ((BENCH_MODE_PINGPONG == mode) && (HOST_USB_SUCCESS == result))
+    {
+        /* The firmware-side residence time is optional here. */
+        (void) Bench_PrintStageTiming(0u);
+    }
+    else
+    {
+        /* No stage timing requested. */
+    }
+
+    if ((0u != integrity) && (HOST_USB_SUCCESS == result))
+    {
+        result = Bench_CheckIntegrity(bytes, packets, 0u);
+    }
+
+    result = ((HOST_USB_SUCCESS == result) && (0u == errors)) ? 0 : 1;
+    (void) Bench_SetMode(BENCH_MODE_LOOPBACK);
+    HostUsb_Close(result);
+
+    return (result);
+}
+
+
+/* [] END OF FILE */
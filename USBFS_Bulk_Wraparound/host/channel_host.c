@@ -0,0 +1,372 @@
+/*******************************************************************************
+* File Name: channel_host.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host side of the virtual channel layer of the USBFS Bulk Wraparound
+*  example. ChannelHost_Write() sends one OUT packet: the credits to return,
+*  then the DATA frame. ChannelHost_Poll() reads one IN packet into the
+*  receive queues of the channels, and first sends the credits to return if
+*  there are any. The functions block like the host_usb.h calls they make;
+*  one thread uses the library.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "channel_host.h"
+
+#define CHANNEL_HOST_TIMEOUT        (1000u)     /* ms */
+
+/* State of one channel. */
+typedef struct
+{
+    uint8  rxData[CHANNEL_HOST_RX_DEPTH][CHANNEL_HOST_MAX_PAYLOAD];
+    uint8  rxLength[CHANNEL_HOST_RX_DEPTH];
+    uint32 rxHead;                  /* Next frame to read. */
+    uint32 rxCount;                 /* Frames in the receive queue. */
+    uint32 rxCredits;               /* Credits to return to the device. */
+    uint32 txCredits;               /* Frames the device can accept. */
+} CHANNEL_HOST;
+
+static CHANNEL_HOST channelHost[CHANNEL_HOST_COUNT];
+static uint8  channelHostIn;
+static uint8  channelHostOut;
+static uint32 channelHostErrors;
+
+static uint32 ChannelHost_AddCredits(uint8 packet[]);
+static int    ChannelHost_Send(const uint8 packet[], uint32 length);
+static void   ChannelHost_Parse(const uint8 packet[], uint32 length);
+
+
+/*******************************************************************************
+* Function Name: ChannelHost_AddCredits
+********************************************************************************
+*
+* Summary:
+*  Writes a CREDIT frame for each channel with credits to return. At most
+*  CHANNEL_HOST_RX_DEPTH credits are pending per channel, so one byte holds
+*  them.
+*
+* Return:
+*  Number of bytes written.
+*
+*******************************************************************************/
+static uint32 ChannelHost_AddCredits(uint8 packet[])
+{
+    uint32 length = 0u;
+    uint8  channel;
+
+    for (channel = 0u; channel < CHANNEL_HOST_COUNT; ++channel)
+    {
+        if (0u != channelHost[channel].rxCredits)
+        {
+            packet[length]      = CHANNEL_HOST_FRAME_CREDIT | channel;
+            packet[length + 1u] = (uint8) channelHost[channel].rxCredits;
+            length += CHANNEL_HOST_HEADER_SIZE;
+            channelHost[channel].rxCredits = 0u;
+        }
+    }
+
+    return (length);
+}
+
+
+/*******************************************************************************
+* Function Name: ChannelHost_Send
+********************************************************************************
+*
+* Summary:
+*  Sends a packet to the OUT endpoint.
+*
+*******************************************************************************/
+static int ChannelHost_Send(const uint8 packet[], uint32 length)
+{
+    uint32 transferred;
+
+    return (HostUsb_Transfer(channelHostOut, (uint8 *) packet, length, &transferred,
+                             CHANNEL_HOST_TIMEOUT));
+}
+
+
+/*******************************************************************************
+* Function Name: ChannelHost_Parse
+********************************************************************************
+*
+* Summary:
+*  Stores the DATA frames of an IN packet in the receive queues and adds the
+*  credits the device has granted. Frames beyond the credits granted and
+*  malformed frames are counted as errors and dropped.
+*
+*******************************************************************************/
+static void ChannelHost_Parse(const uint8 packet[], uint32 length)
+{
+    CHANNEL_HOST *state;
+    uint32 offset = 0u;
+    uint32 tail;
+    uint8  channel;
+    uint8  type;
+    uint8  value;
+
+    while ((offset + CHANNEL_HOST_HEADER_SIZE) <= length)
+    {
+        channel = packet[offset] & CHANNEL_HOST_NUMBER_MASK;
+        type    = packet[offset] & CHANNEL_HOST_TYPE_MASK;
+        value   = packet[offset + 1u];
+        offset += CHANNEL_HOST_HEADER_SIZE;
+
+        if (channel >= CHANNEL_HOST_COUNT)
+        {
+            ++channelHostErrors;
+            break;
+        }
+
+        state = &channelHost[channel];
+
+        if (CHANNEL_HOST_FRAME_CREDIT == type)
+        {
+            state->txCredits += value;
+        }
+        else if ((CHANNEL_HOST_FRAME_DATA == type) && (0u != value) && (value <= (length - offset)))
+        {
+            if (state->rxCount < CHANNEL_HOST_RX_DEPTH)
+            {
+                tail = (state->rxHead + state->rxCount) % CHANNEL_HOST_RX_DEPTH;
+                memcpy(state->rxData[tail], &packet[offset], value);
+                state->rxLength[tail] = value;
+                ++state->rxCount;
+            }
+            else
+            {
+                ++channelHostErrors;
+            }
+
+            offset += value;
+        }
+        else
+        {
+            ++channelHostErrors;
+            break;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ChannelHost_Start
+********************************************************************************
+*
+* Summary:
+*  Empties the channels, waits for the first IN packet of the device, which
+*  grants its credits, and grants the device CHANNEL_HOST_RX_DEPTH credits on
+*  every channel. Waiting for the device first makes sure that it has entered
+*  its channel mode before the host sends anything.
+*
+* Return:
+*  HOST_USB_SUCCESS or a host_usb.h error.
+*
+*******************************************************************************/
+int ChannelHost_Start(uint8 inEp, uint8 outEp)
+{
+    uint8  packet[CHANNEL_HOST_PACKET_SIZE + 1u];
+    uint32 length;
+    uint8  channel;
+    int    result;
+
+    channelHostIn     = inEp;
+    channelHostOut    = outEp;
+    channelHostErrors = 0u;
+
+    for (channel = 0u; channel < CHANNEL_HOST_COUNT; ++channel)
+    {
+        channelHost[channel].rxHead    = 0u;
+        channelHost[channel].rxCount   = 0u;
+        channelHost[channel].rxCredits = CHANNEL_HOST_RX_DEPTH;
+        channelHost[channel].txCredits = 0u;
+    }
+
+    result = HostUsb_Transfer(channelHostIn, packet, sizeof(packet), &length,
+                              CHANNEL_HOST_TIMEOUT);
+
+    if (HOST_USB_SUCCESS == result)
+    {
+        ChannelHost_Parse(packet, length);
+
+        length = ChannelHost_AddCredits(packet);
+        result = ChannelHost_Send(packet, length);
+    }
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: ChannelHost_Write
+********************************************************************************
+*
+* Summary:
+*  Sends a frame on a channel, with the credits to return in the same packet.
+*
+* Return:
+*  HOST_USB_SUCCESS, CHANNEL_HOST_NO_CREDIT, or a host_usb.h error.
+*
+*******************************************************************************/
+int ChannelHost_Write(uint8 channel, const uint8 data[], uint8 length)
+{
+    uint8  packet[CHANNEL_HOST_PACKET_SIZE];
+    uint32 size;
+    int    result;
+
+    if ((channel >= CHANNEL_HOST_COUNT) || (0u == length) || (length > CHANNEL_HOST_MAX_PAYLOAD))
+    {
+        return (HOST_USB_ERROR);
+    }
+
+    if (0u == channelHost[channel].txCredits)
+    {
+        return (CHANNEL_HOST_NO_CREDIT);
+    }
+
+    /* Four credit frames and a DATA frame fit when the payload leaves room;
+    * otherwise the credits go in a packet of their own first.
+    */
+    size = ChannelHost_AddCredits(packet);
+
+    if ((size + CHANNEL_HOST_HEADER_SIZE + length) > CHANNEL_HOST_PACKET_SIZE)
+    {
+        result = ChannelHost_Send(packet, size);
+        size = 0u;
+
+        if (HOST_USB_SUCCESS != result)
+        {
+            return (result);
+        }
+    }
+
+    packet[size]      = CHANNEL_HOST_FRAME_DATA | channel;
+    packet[size + 1u] = length;
+    memcpy(&packet[size + CHANNEL_HOST_HEADER_SIZE], data, length);
+    size += CHANNEL_HOST_HEADER_SIZE + length;
+
+    result = ChannelHost_Send(packet, size);
+
+    if (HOST_USB_SUCCESS == result)
+    {
+        --channelHost[channel].txCredits;
+    }
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: ChannelHost_Read
+********************************************************************************
+*
+* Summary:
+*  Reads the next frame received on a channel into a buffer of
+*  CHANNEL_HOST_MAX_PAYLOAD bytes. The credit of the frame is returned to the
+*  device with the next packet sent.
+*
+* Return:
+*  Number of payload bytes; 0 if the receive queue is empty.
+*
+*******************************************************************************/
+int ChannelHost_Read(uint8 channel, uint8 data[])
+{
+    CHANNEL_HOST *state = &channelHost[channel];
+    int length = 0;
+
+    if (0u != state->rxCount)
+    {
+        length = state->rxLength[state->rxHead];
+        memcpy(data, state->rxData[state->rxHead], (size_t) length);
+
+        state->rxHead = (state->rxHead + 1u) % CHANNEL_HOST_RX_DEPTH;
+        --state->rxCount;
+        ++state->rxCredits;
+    }
+
+    return (length);
+}
+
+
+/*******************************************************************************
+* Function Name: ChannelHost_Poll
+********************************************************************************
+*
+* Summary:
+*  Sends the credits to return, then reads one IN packet and parses it.
+*
+* Return:
+*  HOST_USB_SUCCESS if a packet was read, HOST_USB_TIMEOUT, or a host_usb.h
+*  error.
+*
+*******************************************************************************/
+int ChannelHost_Poll(uint32 timeoutMs)
+{
+    uint8  packet[CHANNEL_HOST_PACKET_SIZE + 1u];
+    uint32 length;
+    int    result = HOST_USB_SUCCESS;
+
+    length = ChannelHost_AddCredits(packet);
+
+    if (0u != length)
+    {
+        result = ChannelHost_Send(packet, length);
+    }
+
+    if (HOST_USB_SUCCESS == result)
+    {
+        result = HostUsb_Transfer(channelHostIn, packet, sizeof(packet), &length, timeoutMs);
+
+        if (HOST_USB_SUCCESS == result)
+        {
+            ChannelHost_Parse(packet, length);
+        }
+    }
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: ChannelHost_Credits
+********************************************************************************
+*
+* Summary:
+*  Returns the number of frames the device can accept on a channel.
+*
+*******************************************************************************/
+uint32 ChannelHost_Credits(uint8 channel)
+{
+    return (channelHost[channel].txCredits);
+}
+
+
+/*******************************************************************************
+* Function Name: ChannelHost_Errors
+********************************************************************************
+*
+* Summary:
+*  Returns the number of frames received beyond the credits granted, or
+*  malformed.
+*
+*******************************************************************************/
+uint32 ChannelHost_Errors(void)
+{
+    return (channelHostErrors);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,65 @@
+/*******************************************************************************
+* File Name: channel_host.h
+*
+* Version: 1.0
+*
+* Description:
+*  Host side of the virtual channel layer of the USBFS Bulk Wraparound
+*  example (channel.h in the firmware): the same framing and credit-based
+*  flow control over the bulk OUT and IN endpoint pair, on top of host_usb.h.
+*  The host queues CHANNEL_HOST_RX_DEPTH frames per channel and grants the
+*  device that many credits on each channel.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(CHANNEL_HOST_H)
+#define CHANNEL_HOST_H
+
+#include "host_usb.h"
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* Framing of the firmware. */
+#define CHANNEL_HOST_COUNT          (4u)
+#define CHANNEL_HOST_PACKET_SIZE    (63u)
+#define CHANNEL_HOST_HEADER_SIZE    (2u)
+#define CHANNEL_HOST_MAX_PAYLOAD    (CHANNEL_HOST_PACKET_SIZE - CHANNEL_HOST_HEADER_SIZE)
+#define CHANNEL_HOST_NUMBER_MASK    (0x0Fu)
+#define CHANNEL_HOST_TYPE_MASK      (0xF0u)
+#define CHANNEL_HOST_FRAME_DATA     (0x00u)
+#define CHANNEL_HOST_FRAME_CREDIT   (0x10u)
+
+/* Frames the host queues on receive per channel. */
+#define CHANNEL_HOST_RX_DEPTH       (8u)
+
+/* Return value of ChannelHost_Write(): no credit on the channel. */
+#define CHANNEL_HOST_NO_CREDIT      (-5)
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+int    ChannelHost_Start(uint8 inEp, uint8 outEp);
+int    ChannelHost_Write(uint8 channel, const uint8 data[], uint8 length);
+int    ChannelHost_Read(uint8 channel, uint8 data[]);
+int    ChannelHost_Poll(uint32 timeoutMs);
+uint32 ChannelHost_Credits(uint8 channel);
+uint32 ChannelHost_Errors(void);
+
+#endif /* (CHANNEL_HOST_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,333 @@
+/*******************************************************************************
+* File Name: channel_test.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host tool of the virtual channel layer of the USBFS Bulk Wraparound
+*  example. Selects the channel test mode of the device, in which the device
+*  echoes the frames of each channel on the same channel, and sends numbered
+*  frames on every channel as fast as the credits allow. The echoed frames
+*  are checked for order and content.
+*  With -s one channel is stalled: the tool never reads its frames. Its
+*  queues fill on both sides and the device stops granting credits on it,
+*  while the other channels keep their throughput. The tool checks that the
+*  stalled channel stops after its credits and queues are used up.
+*  With -m the channels send frames of different lengths, so that the frame
+*  of one channel often does not fit in a packet after the frame of another.
+*  Every channel must still get a fair share of the packets.
+*  The device is left in the loopback mode.
+*
+*  Build against a device on the bus (libusb-1.0):
+*   gcc -I USBFS_Host_Emulation USBFS_Bulk_Wraparound/host/channel_test.c \
+*       USBFS_Bulk_Wraparound/host/channel_host.c \
+*       USBFS_Host_Emulation/libusb/host_usb_libusb.c -lusb-1.0 -o channel_test
+*  Build against the emulated firmware: add -pthread, this file and
+*  channel_host.c to the build command in USBFS_Host_Emulation/README.md,
+*  then run
+*   ./channel_test_sim -s host -- -s 1
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "channel_host.h"
+
+/* Device of the example. */
+#define TEST_VID                (0x04B4u)
+#define TEST_PID                (0x8051u)
+#define TEST_IN_EP              (0x81u)
+#define TEST_OUT_EP             (0x02u)
+#define TEST_MAX_PACKET         (64u)
+
+/* Vendor-specific requests and test modes of the firmware. */
+#define TEST_RQST_OUT           (0x40u)     /* Vendor, device, host to device */
+#define TEST_RQST_IN            (0xC0u)     /* Vendor, device, device to host */
+#define TEST_SET_TEST_MODE      (0x01u)
+#define TEST_GET_TEST_MODE      (0x02u)
+#define TEST_MODE_LOOPBACK      (0u)
+#define TEST_MODE_CHANNELS      (4u)
+
+/* Frames a stalled channel can have in flight: the receive queue of the
+* host, the transmit slot and the receive queue of the device.
+*/
+#define TEST_DEVICE_RX_DEPTH    (2u)
+#define TEST_STALL_LIMIT        (CHANNEL_HOST_RX_DEPTH + 1u + TEST_DEVICE_RX_DEPTH)
+
+/* Defaults of the options. */
+#define TEST_DEFAULT_DURATION   (1000u)     /* ms */
+#define TEST_NO_STALL           (0xFFu)
+#define TEST_TIMEOUT            (1000u)     /* ms */
+#define TEST_POLL_TIMEOUT       (10u)       /* ms */
+#define TEST_SEQUENCE_SIZE      (4u)
+
+/* A channel that receives fewer than 1/TEST_FAIR_SHARE of the frames of
+* the busiest channel is starved.
+*/
+#define TEST_FAIR_SHARE         (4u)
+
+/* Frame lengths of the channels with -m. The frame of channel 2 shares a
+* packet with that of channel 1 only, the frames of channels 0 and 3 share
+* one: a device that passes over the frames that do not fit starves
+* channels 0 and 3.
+*/
+static const uint8 testMixedLength[CHANNEL_HOST_COUNT] = {32u, 8u, 40u, 24u};
+
+static uint32 testSent[CHANNEL_HOST_COUNT];
+static uint32 testReceived[CHANNEL_HOST_COUNT];
+
+static const HOST_USB_EP testEps[] =
+{
+    {TEST_IN_EP,  HOST_USB_EP_BULK, TEST_MAX_PACKET},
+    {TEST_OUT_EP, HOST_USB_EP_BULK, TEST_MAX_PACKET}
+};
+
+static int  Test_SetMode(uint8 mode);
+static void Test_Fill(uint8 data[], uint8 channel, uint32 sequence, uint8 length);
+static void Test_Usage(const char *program);
+
+
+/*******************************************************************************
+* Function Name: Test_SetMode
+********************************************************************************
+*
+* Summary:
+*  Selects the test mode and reads it back.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Test_SetMode(uint8 mode)
+{
+    uint8 readBack = 0xFFu;
+
+    if ((HOST_USB_SUCCESS != HostUsb_Control(TEST_RQST_OUT, TEST_SET_TEST_MODE, mode, 0u,
+                                              NULL, 0u, TEST_TIMEOUT)) ||
+        (1 != HostUsb_Control(TEST_RQST_IN, TEST_GET_TEST_MODE, 0u, 0u,
+                              &readBack, 1u, TEST_TIMEOUT)) ||
+        (readBack != mode))
+    {
+        printf("device does not support SET_TEST_MODE %u\n", mode);
+        return (HOST_USB_ERROR);
+    }
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Test_Fill
+********************************************************************************
+*
+* Summary:
+*  Fills a frame: the little-endian sequence number, then a pattern that
+*  depends on the channel and the sequence number.
+*
+*******************************************************************************/
+static void Test_Fill(uint8 data[], uint8 channel, uint32 sequence, uint8 length)
+{
+    uint8 i;
+
+    for (i = 0u; i < length; ++i)
+    {
+        data[i] = (i < TEST_SEQUENCE_SIZE) ? (uint8) (sequence >> (8u * i)) :
+                                             (uint8) (sequence + (channel * 31u) + i);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Test_Usage
+********************************************************************************
+*
+* Summary:
+*  Prints the command line help.
+*
+*******************************************************************************/
+static void Test_Usage(const char *program)
+{
+    printf("usage: %s [-d ms] [-l bytes] [-m] [-s channel]\n", program);
+    printf("  -d   duration, ms (%u)\n", TEST_DEFAULT_DURATION);
+    printf("  -l   payload bytes per frame (%u to %u, default %u)\n",
+           TEST_SEQUENCE_SIZE, CHANNEL_HOST_MAX_PAYLOAD, CHANNEL_HOST_MAX_PAYLOAD);
+    printf("  -m   frames of %u, %u, %u and %u bytes on the channels\n",
+           testMixedLength[0u], testMixedLength[1u], testMixedLength[2u], testMixedLength[3u]);
+    printf("  -s   channel whose frames are never read (none)\n");
+}
+
+
+/*******************************************************************************
+* Function Name: HostTool_Main
+********************************************************************************
+*
+* Summary:
+*  Sends and checks frames on all channels for the duration and prints the
+*  throughput of each channel.
+*
+* Return:
+*  0 on success, 1 on a transfer, data or flow control error, 4 on a usage
+*  error.
+*
+*******************************************************************************/
+int HostTool_Main(int argc, char *argv[])
+{
+    uint8  expected[CHANNEL_HOST_MAX_PAYLOAD];
+    uint8  data[CHANNEL_HOST_MAX_PAYLOAD];
+    uint32 lengths[CHANNEL_HOST_COUNT];
+    uint32 durationMs = TEST_DEFAULT_DURATION;
+    uint32 length = CHANNEL_HOST_MAX_PAYLOAD;
+    uint32 stalled = TEST_NO_STALL;
+    uint32 mixed = 0u;
+    uint32 busiest = 0u;
+    uint32 errors = 0u;
+    uint64 start;
+    uint64 elapsed;
+    uint8  channel;
+    int    received;
+    int    result;
+    int    opt;
+
+    while (-1 != (opt = getopt(argc, argv, "d:l:ms:h")))
+    {
+        switch (opt)
+        {
+            case 'd': durationMs = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'l': length     = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'm': mixed      = 1u;                                break;
+            case 's': stalled    = (uint32) strtoul(optarg, NULL, 0); break;
+            default:
+                length = 0u;
+                break;
+        }
+    }
+
+    if ((length < TEST_SEQUENCE_SIZE) || (length > CHANNEL_HOST_MAX_PAYLOAD) ||
+        ((stalled >= CHANNEL_HOST_COUNT) && (TEST_NO_STALL != stalled)))
+    {
+        Test_Usage(argv[0]);
+        return (4);
+    }
+
+    for (channel = 0u; channel < CHANNEL_HOST_COUNT; ++channel)
+    {
+        lengths[channel] = (0u != mixed) ? testMixedLength[channel] : length;
+    }
+
+    if ((HOST_USB_SUCCESS != HostUsb_Open(TEST_VID, TEST_PID, testEps, 2u)) ||
+        (HOST_USB_SUCCESS != Test_SetMode(TEST_MODE_CHANNELS)))
+    {
+        HostUsb_Close(1);
+        return (1);
+    }
+
+    result = ChannelHost_Start(TEST_IN_EP, TEST_OUT_EP);
+    start = HostUsb_TimeNs();
+
+    do
+    {
+        /* Send a frame on each channel that has a credit. */
+        for (channel = 0u; (channel < CHANNEL_HOST_COUNT) && (HOST_USB_SUCCESS == result); ++channel)
+        {
+            if (0u != ChannelHost_Credits(channel))
+            {
+                Test_Fill(data, channel, testSent[channel], (uint8) lengths[channel]);
+                result = ChannelHost_Write(channel, data, (uint8) lengths[channel]);
+                ++testSent[channel];
+            }
+        }
+
+        if (HOST_USB_SUCCESS == result)
+        {
+            result = ChannelHost_Poll(TEST_POLL_TIMEOUT);
+            result = (HOST_USB_TIMEOUT == result) ? HOST_USB_SUCCESS : result;
+        }
+
+        /* Check the echoed frames, except on the stalled channel. */
+        for (channel = 0u; channel < CHANNEL_HOST_COUNT; ++channel)
+        {
+            while ((channel != stalled) && (0 != (received = ChannelHost_Read(channel, data))))
+            {
+                Test_Fill(expected, channel, testReceived[channel], (uint8) lengths[channel]);
+                errors += (((uint32) received != lengths[channel]) ||
+                           (0 != memcmp(data, expected, lengths[channel]))) ? 1u : 0u;
+                ++testReceived[channel];
+            }
+        }
+
+        elapsed = HostUsb_TimeNs() - start;
+    }
+    while ((HOST_USB_SUCCESS == result) && (0u == errors) &&
+           (elapsed < ((uint64) durationMs * 1000000u)));
+
+    if (0u != mixed)
+    {
+        printf("frame           : %u, %u, %u, %u bytes\n",
+               lengths[0u], lengths[1u], lengths[2u], lengths[3u]);
+    }
+    else
+    {
+        printf("frame           : %u bytes\n", length);
+    }
+    printf("time            : %.3f ms\n", (double) elapsed / 1e6);
+    printf("  %-8s %10s %10s %10s\n", "channel", "sent", "received", "kB/s");
+
+    for (channel = 0u; channel < CHANNEL_HOST_COUNT; ++channel)
+    {
+        busiest = (testReceived[channel] > busiest) ? testReceived[channel] : busiest;
+    }
+
+    for (channel = 0u; channel < CHANNEL_HOST_COUNT; ++channel)
+    {
+        printf("  %-8u %10u %10u %10.1f%s\n", channel, testSent[channel], testReceived[channel],
+               (0u != elapsed) ? ((double) testReceived[channel] * lengths[channel] * 1e6 / elapsed) : 0.0,
+               (channel == stalled) ? "  (stalled)" : "");
+
+        /* Every channel gets its share, except the stalled one, which stops
+        * when its queues are full.
+        */
+        if (channel == stalled)
+        {
+            errors += (testSent[channel] > TEST_STALL_LIMIT) ? 1u : 0u;
+        }
+        else
+        {
+            errors += ((0u == testReceived[channel]) ||
+                       (testReceived[channel] < (busiest / TEST_FAIR_SHARE))) ? 1u : 0u;
+        }
+    }
+
+    if (HOST_USB_SUCCESS != result)
+    {
+        printf("transfer error  : %d\n", result);
+    }
+    if (0u != ChannelHost_Errors())
+    {
+        printf("framing errors  : %u\n", ChannelHost_Errors());
+    }
+    if (0u != errors)
+    {
+        printf("data errors     : %u\n", errors);
+    }
+
+    result = ((HOST_USB_SUCCESS == result) && (0u == errors) && (0u == ChannelHost_Errors())) ? 0 : 1;
+    (void) Test_SetMode(TEST_MODE_LOOPBACK);
+    HostUsb_Close(result);
+
+    return (result);
+}
+
+
+/* [] END OF FILE */
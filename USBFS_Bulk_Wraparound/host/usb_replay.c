@@ -0,0 +1,751 @@
+/*******************************************************************************
+* File Name: usb_replay.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host tool that replays a capture of the bulk traffic of the USBFS Bulk
+*  Wraparound example against the device. The capture is a pcap file
+*  recorded with Linux usbmon, for example on the PC of a customer:
+*   tcpdump -i usbmon1 -w capture.pcap
+*  or written by the emulation with -p. Both usbmon link types are read
+*  (LINKTYPE_USB_LINUX and LINKTYPE_USB_LINUX_MMAPPED), in either byte order.
+*
+*  The tool takes the transfers of one device from the capture: the bulk OUT
+*  transfers on EP 0x02 at their submission, the bulk IN transfers on EP 0x81
+*  at their completion, and the vendor-specific control requests, such as
+*  SET_TEST_MODE, at their submission. Standard and class requests belong to
+*  the enumeration and are left out. The transfers are replayed in that order
+*  with the original time between them, or with -f as fast as possible.
+*
+*  Each IN transfer is paired with the OUT transfer that carried its first
+*  byte: the time from the completion of that OUT transfer to the completion
+*  of the IN transfer is the latency of the packet through the device. The
+*  tool prints the latency of the replay next to the latency in the capture,
+*  and checks that the IN data matches the capture.
+*
+*  Build against a device on the bus (libusb-1.0):
+*   gcc -I USBFS_Host_Emulation USBFS_Bulk_Wraparound/host/usb_replay.c \
+*       USBFS_Host_Emulation/libusb/host_usb_libusb.c -lusb-1.0 -o usb_replay
+*  Build against the emulated firmware: add -pthread and this file to the
+*  build command in USBFS_Host_Emulation/README.md, then run
+*   ./usb_replay_sim -s host -- -r capture.pcap
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "host_usb.h"
+
+/* Device of the example. */
+#define REPLAY_VID              (0x04B4u)
+#define REPLAY_PID              (0x8051u)
+#define REPLAY_IN_EP            (0x81u)
+#define REPLAY_OUT_EP           (0x02u)
+#define REPLAY_MAX_PACKET       (64u)
+
+/* pcap file: header, record header and the magic numbers of microsecond and
+* nanosecond captures as read in the byte order of the writer.
+*/
+#define REPLAY_PCAP_HEADER      (24u)
+#define REPLAY_RECORD_HEADER    (16u)
+#define REPLAY_MAGIC_US         (0xA1B2C3D4u)
+#define REPLAY_MAGIC_NS         (0xA1B23C4Du)
+#define REPLAY_MAGIC_US_SWAPPED (0xD4C3B2A1u)
+#define REPLAY_MAGIC_NS_SWAPPED (0x4D3CB2A1u)
+
+/* usbmon link types and the size of their headers. */
+#define REPLAY_LINKTYPE_USB     (189u)      /* LINKTYPE_USB_LINUX */
+#define REPLAY_LINKTYPE_MMAPPED (220u)      /* LINKTYPE_USB_LINUX_MMAPPED */
+#define REPLAY_USB_HEADER       (48u)
+#define REPLAY_MMAPPED_HEADER   (64u)
+
+/* usbmon event and transfer types. */
+#define REPLAY_SUBMIT           ('S')
+#define REPLAY_COMPLETE         ('C')
+#define REPLAY_XFER_CONTROL     (2u)
+#define REPLAY_XFER_BULK        (3u)
+
+/* bmRequestType type field: vendor. */
+#define REPLAY_RQST_TYPE_MASK   (0x60u)
+#define REPLAY_RQST_TYPE_VENDOR (0x40u)
+
+/* Replayed transfer types. */
+#define REPLAY_OUT              (0u)
+#define REPLAY_IN               (1u)
+#define REPLAY_CONTROL          (2u)
+
+#define REPLAY_ANY_DEVICE       (0xFFFFu)
+#define REPLAY_MAX_LENGTH       (65536u)
+#define REPLAY_TIMEOUT          (1000u)     /* ms */
+#define REPLAY_DRAIN_TIMEOUT    (10u)       /* ms */
+#define REPLAY_LATE_NS          (1000000u)  /* Transfer issued over 1 ms late */
+
+/* Transfer taken from the capture. */
+typedef struct
+{
+    uint64 id;              /* URB id */
+    uint64 timeNs;          /* Issued: submission of OUT and control, completion of IN */
+    uint64 doneNs;          /* Completion in the capture */
+    uint32 order;           /* Position in the capture */
+    uint8  type;            /* REPLAY_OUT, REPLAY_IN or REPLAY_CONTROL */
+    uint8  completed;
+    uint8  setup[8u];
+    uint32 length;          /* Requested bytes */
+    uint32 actual;          /* Bytes transferred in the capture */
+    const uint8 *data;      /* OUT or control data, or IN data of the capture */
+    uint32 dataLength;      /* Bytes of data captured */
+} REPLAY_EVENT;
+
+/* Completed OUT transfer, for the pairing with the IN transfers. */
+typedef struct
+{
+    uint64 endByte;         /* OUT stream offset after the transfer */
+    uint64 doneNs;          /* Completion in the replay */
+    uint64 capturedNs;      /* Completion in the capture */
+} REPLAY_OUT_DONE;
+
+static const HOST_USB_EP replayEps[] =
+{
+    {REPLAY_IN_EP,  HOST_USB_EP_BULK, REPLAY_MAX_PACKET},
+    {REPLAY_OUT_EP, HOST_USB_EP_BULK, REPLAY_MAX_PACKET}
+};
+
+static uint8  *replayFile;
+static REPLAY_EVENT *replayEvents;
+static uint32 replayEventCount;
+static uint8  replayLittleEndian;
+static uint8  replayBuffer[REPLAY_MAX_LENGTH];
+
+static uint32 Replay_Get(const uint8 data[], uint8 size);
+static uint64 Replay_Get64(const uint8 data[]);
+static uint8  Replay_Load(const char *path, uint16 address);
+static uint8  Replay_Fail(FILE *file);
+static int    Replay_CompareEvents(const void *a, const void *b);
+static int    Replay_CompareNs(const void *a, const void *b);
+static void   Replay_PrintLatency(const char *label, uint64 samples[], uint32 count);
+static void   Replay_Usage(const char *program);
+
+
+/*******************************************************************************
+* Function Name: Replay_Get
+********************************************************************************
+*
+* Summary:
+*  Returns the field of 1, 2 or 4 bytes at data in the byte order of the
+*  capture.
+*
+*******************************************************************************/
+static uint32 Replay_Get(const uint8 data[], uint8 size)
+{
+    uint32 value = 0u;
+    uint8  i;
+
+    for (i = 0u; i < size; ++i)
+    {
+        value = (value << 8u) | data[(0u != replayLittleEndian) ? (size - 1u - i) : i];
+    }
+
+    return (value);
+}
+
+
+/*******************************************************************************
+* Function Name: Replay_Get64
+********************************************************************************
+*
+* Summary:
+*  Returns the 8-byte field at data in the byte order of the capture.
+*
+*******************************************************************************/
+static uint64 Replay_Get64(const uint8 data[])
+{
+    return ((0u != replayLittleEndian) ?
+            (((uint64) Replay_Get(&data[4u], 4u) << 32u) | Replay_Get(data, 4u)) :
+            (((uint64) Replay_Get(data, 4u) << 32u) | Replay_Get(&data[4u], 4u)));
+}
+
+
+/*******************************************************************************
+* Function Name: Replay_Load
+********************************************************************************
+*
+* Summary:
+*  Reads the capture and takes the transfers of the device with the address,
+*  or of the first device with traffic on the bulk endpoints, in the order
+*  they are replayed. Transfers that did not complete, or failed, are left
+*  out.
+*
+* Return:
+*  Non-zero on success.
+*
+*******************************************************************************/
+static uint8 Replay_Load(const char *path, uint16 address)
+{
+    REPLAY_EVENT *event;
+    const uint8 *usb;
+    FILE   *file;
+    long   size;
+    uint64 id;
+    uint32 offset;
+    uint32 captured;
+    uint32 headerSize;
+    uint32 magic;
+    uint32 count = 0u;
+    uint32 kept = 0u;
+    uint32 i;
+    uint8  transferType;
+    uint8  endpoint;
+    uint8  type;
+
+    file = fopen(path, "rb");
+
+    if (NULL == file)
+    {
+        printf("cannot read %s\n", path);
+        return (Replay_Fail(NULL));
+    }
+
+    if ((0 != fseek(file, 0, SEEK_END)) || ((size = ftell(file)) < (long) REPLAY_PCAP_HEADER))
+    {
+        printf("cannot read %s\n", path);
+        return (Replay_Fail(file));
+    }
+
+    replayFile = malloc((size_t) size);
+    rewind(file);
+
+    if ((NULL == replayFile) || (1u != fread(replayFile, (size_t) size, 1u, file)))
+    {
+        printf("cannot read %s\n", path);
+        return (Replay_Fail(file));
+    }
+    (void) fclose(file);
+
+    /* The magic number read big-endian tells the byte order of the writer;
+    * usbmon writes its header in the same byte order.
+    */
+    replayLittleEndian = 0u;
+    magic = Replay_Get(replayFile, 4u);
+    replayLittleEndian = ((REPLAY_MAGIC_US_SWAPPED == magic) || (REPLAY_MAGIC_NS_SWAPPED == magic)) ? 1u : 0u;
+    magic = Replay_Get(replayFile, 4u);
+
+    if ((REPLAY_MAGIC_US != magic) && (REPLAY_MAGIC_NS != magic))
+    {
+        printf("%s is not a pcap file; save pcapng captures as pcap\n", path);
+        return (Replay_Fail(NULL));
+    }
+
+    switch (Replay_Get(&replayFile[20u], 4u))
+    {
+        case REPLAY_LINKTYPE_USB:     headerSize = REPLAY_USB_HEADER;     break;
+        case REPLAY_LINKTYPE_MMAPPED: headerSize = REPLAY_MMAPPED_HEADER; break;
+        default:
+            printf("%s is not a usbmon capture\n", path);
+            return (Replay_Fail(NULL));
+    }
+
+    /* At most one transfer per record. */
+    replayEvents = calloc(((size_t) size / (REPLAY_RECORD_HEADER + headerSize)) + 1u,
+                          sizeof(REPLAY_EVENT));
+
+    if (NULL == replayEvents)
+    {
+        printf("out of memory\n");
+        return (Replay_Fail(NULL));
+    }
+
+    /* Take the first device with bulk traffic on the endpoints. The length
+    * of a record comes from the file: it is compared with the bytes left, so
+    * that a corrupt length cannot wrap the offset.
+    */
+    for (offset = REPLAY_PCAP_HEADER;
+         (REPLAY_ANY_DEVICE == address) && ((offset + REPLAY_RECORD_HEADER) <= (uint32) size);
+         offset += REPLAY_RECORD_HEADER + captured)
+    {
+        captured = Replay_Get(&replayFile[offset + 8u], 4u);
+        usb = &replayFile[offset + REPLAY_RECORD_HEADER];
+
+        if (captured > ((uint32) size - offset - REPLAY_RECORD_HEADER))
+        {
+            break;
+        }
+
+        if ((captured >= headerSize) && (REPLAY_XFER_BULK == usb[9u]) &&
+            ((REPLAY_IN_EP == usb[10u]) || (REPLAY_OUT_EP == usb[10u])))
+        {
+            address = usb[11u];
+        }
+    }
+
+    for (offset = REPLAY_PCAP_HEADER; (offset + REPLAY_RECORD_HEADER) <= (uint32) size;
+         offset += REPLAY_RECORD_HEADER + captured)
+    {
+        captured = Replay_Get(&replayFile[offset + 8u], 4u);
+        usb = &replayFile[offset + REPLAY_RECORD_HEADER];
+
+        if (captured > ((uint32) size - offset - REPLAY_RECORD_HEADER))
+        {
+            printf("capture is truncated\n");
+            break;
+        }
+        if (captured < headerSize)
+        {
+            continue;
+        }
+
+        id           = Replay_Get64(&usb[0u]);
+        type         = usb[8u];
+        transferType = usb[9u];
+        endpoint     = usb[10u];
+
+        if (usb[11u] != address)
+        {
+            continue;
+        }
+
+        if (REPLAY_SUBMIT == type)
+        {
+            event = &replayEvents[count];
+            (void) memset(event, 0, sizeof(REPLAY_EVENT));
+
+            if ((REPLAY_XFER_BULK == transferType) && (REPLAY_OUT_EP == endpoint))
+            {
+                event->type = REPLAY_OUT;
+            }
+            else if ((REPLAY_XFER_BULK == transferType) && (REPLAY_IN_EP == endpoint))
+            {
+                event->type = REPLAY_IN;
+            }
+            else if ((REPLAY_XFER_CONTROL == transferType) && (0u == usb[14u]) &&
+                     (REPLAY_RQST_TYPE_VENDOR == (usb[40u] & REPLAY_RQST_TYPE_MASK)))
+            {
+                event->type = REPLAY_CONTROL;
+            }
+            else
+            {
+                continue;
+            }
+
+            event->id     = id;
+            event->timeNs = (Replay_Get64(&usb[16u]) * 1000000000u) +
+                            ((uint64) Replay_Get(&usb[24u], 4u) * 1000u);
+            event->order  = count;
+            event->length = Replay_Get(&usb[32u], 4u);
+            (void) memcpy(event->setup, &usb[40u], sizeof(event->setup));
+
+            /* OUT data travels with the submission. */
+            if (0u == (endpoint & HOST_USB_DIR_IN))
+            {
+                event->data       = &usb[headerSize];
+                event->dataLength = captured - headerSize;
+            }
+            ++count;
+        }
+        else if (REPLAY_COMPLETE == type)
+        {
+            for (i = count; i > 0u; --i)
+            {
+                event = &replayEvents[i - 1u];
+
+                if ((0u == event->completed) && (event->id == id))
+                {
+                    /* Completed, or 2 if it failed. */
+                    event->completed = (0u == Replay_Get(&usb[28u], 4u)) ? 1u : 2u;
+                    event->actual    = Replay_Get(&usb[32u], 4u);
+                    event->doneNs    = (Replay_Get64(&usb[16u]) * 1000000000u) +
+                                       ((uint64) Replay_Get(&usb[24u], 4u) * 1000u);
+
+                    /* IN data travels with the completion. */
+                    if (0u != (endpoint & HOST_USB_DIR_IN))
+                    {
+                        event->data       = &usb[headerSize];
+                        event->dataLength = captured - headerSize;
+                    }
+                    break;
+                }
+            }
+        }
+        else
+        {
+            /* Error event: the URB was not submitted. */
+        }
+    }
+
+    /* Keep the transfers that completed. An IN transfer is issued at its
+    * completion: a replayed IN transfer blocks until the device has the data.
+    */
+    for (i = 0u; i < count; ++i)
+    {
+        if (1u == replayEvents[i].completed)
+        {
+            replayEvents[kept] = replayEvents[i];
+
+            if (REPLAY_IN == replayEvents[kept].type)
+            {
+                replayEvents[kept].timeNs = replayEvents[kept].doneNs;
+            }
+            ++kept;
+        }
+    }
+
+    qsort(replayEvents, kept, sizeof(REPLAY_EVENT), &Replay_CompareEvents);
+    replayEventCount = kept;
+
+    return (1u);
+}
+
+
+/*******************************************************************************
+* Function Name: Replay_Fail
+********************************************************************************
+*
+* Summary:
+*  Closes the capture file if it is open and frees what Replay_Load() has
+*  allocated.
+*
+* Return:
+*  0, the return value of Replay_Load() on failure.
+*
+*******************************************************************************/
+static uint8 Replay_Fail(FILE *file)
+{
+    if (NULL != file)
+    {
+        (void) fclose(file);
+    }
+
+    free(replayFile);
+    free(replayEvents);
+    replayFile   = NULL;
+    replayEvents = NULL;
+
+    return (0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Replay_CompareEvents
+********************************************************************************
+*
+* Summary:
+*  Orders transfers for qsort() by the time they are issued, then by their
+*  position in the capture.
+*
+*******************************************************************************/
+static int Replay_CompareEvents(const void *a, const void *b)
+{
+    const REPLAY_EVENT *eventA = (const REPLAY_EVENT *) a;
+    const REPLAY_EVENT *eventB = (const REPLAY_EVENT *) b;
+
+    if (eventA->timeNs != eventB->timeNs)
+    {
+        return ((eventA->timeNs > eventB->timeNs) ? 1 : -1);
+    }
+
+    return ((eventA->order > eventB->order) - (eventA->order < eventB->order));
+}
+
+
+/*******************************************************************************
+* Function Name: Replay_CompareNs
+********************************************************************************
+*
+* Summary:
+*  Orders latencies for qsort().
+*
+*******************************************************************************/
+static int Replay_CompareNs(const void *a, const void *b)
+{
+    uint64 nsA = *(const uint64 *) a;
+    uint64 nsB = *(const uint64 *) b;
+
+    return ((nsA > nsB) - (nsA < nsB));
+}
+
+
+/*******************************************************************************
+* Function Name: Replay_PrintLatency
+********************************************************************************
+*
+* Summary:
+*  Prints the minimum, mean, percentiles and maximum of the latencies in
+*  microseconds. Sorts the samples.
+*
+*******************************************************************************/
+static void Replay_PrintLatency(const char *label, uint64 samples[], uint32 count)
+{
+    uint64 sum = 0u;
+    uint32 i;
+
+    if (0u == count)
+    {
+        printf("  %-8s %10s\n", label, "-");
+        return;
+    }
+
+    for (i = 0u; i < count; ++i)
+    {
+        sum += samples[i];
+    }
+
+    qsort(samples, count, sizeof(samples[0]), &Replay_CompareNs);
+
+    printf("  %-8s %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f\n", label,
+           samples[0] / 1e3, ((double) sum / count) / 1e3,
+           samples[(count - 1u) / 2u] / 1e3,
+           samples[(uint32) ((count - 1u) * 0.9)] / 1e3,
+           samples[(uint32) ((count - 1u) * 0.99)] / 1e3,
+           samples[count - 1u] / 1e3);
+}
+
+
+/*******************************************************************************
+* Function Name: Replay_Usage
+********************************************************************************
+*
+* Summary:
+*  Prints the command line help.
+*
+*******************************************************************************/
+static void Replay_Usage(const char *program)
+{
+    printf("usage: %s -r capture.pcap [-a address] [-f]\n", program);
+    printf("  -r   usbmon capture in pcap format\n");
+    printf("  -a   device address in the capture (first device with bulk traffic)\n");
+    printf("  -f   replay as fast as possible instead of with the captured timing\n");
+}
+
+
+/*******************************************************************************
+* Function Name: HostTool_Main
+********************************************************************************
+*
+* Summary:
+*  Loads the capture, replays its transfers and prints the throughput, the
+*  latency of the replay and of the capture, and the data mismatches.
+*
+* Return:
+*  0 on success, 1 on a transfer or data error, 4 on a usage error.
+*
+*******************************************************************************/
+int HostTool_Main(int argc, char *argv[])
+{
+    REPLAY_EVENT *event;
+    REPLAY_OUT_DONE *outDone;
+    uint64 *replayLatency;
+    uint64 *captureLatency;
+    const char *path = NULL;
+    uint16 address = REPLAY_ANY_DEVICE;
+    uint8  fast = 0u;
+    uint8  usage = 0u;
+    uint64 start;
+    uint64 target;
+    uint64 now;
+    uint64 outBytes = 0u;
+    uint64 inBytes = 0u;
+    uint32 outCount = 0u;
+    uint32 outNext = 0u;
+    uint32 samples = 0u;
+    uint32 transfers = 0u;
+    uint32 late = 0u;
+    uint32 mismatches = 0u;
+    uint32 errors = 0u;
+    uint32 transferred;
+    uint32 i;
+    int    result;
+    int    opt;
+
+    while (-1 != (opt = getopt(argc, argv, "r:a:fh")))
+    {
+        switch (opt)
+        {
+            case 'r': path    = optarg; break;
+            case 'a': address = (uint16) strtoul(optarg, NULL, 0); break;
+            case 'f': fast    = 1u; break;
+            default:
+                usage = 1u;
+                break;
+        }
+    }
+
+    if ((0u != usage) || (NULL == path))
+    {
+        Replay_Usage(argv[0]);
+        return (4);
+    }
+
+    if (0u == Replay_Load(path, address))
+    {
+        return (1);
+    }
+
+    if (0u == replayEventCount)
+    {
+        printf("no bulk transfers on EP 0x%02X or 0x%02X in %s\n", REPLAY_IN_EP, REPLAY_OUT_EP, path);
+        return (1);
+    }
+
+    outDone        = calloc(replayEventCount, sizeof(REPLAY_OUT_DONE));
+    replayLatency  = calloc(replayEventCount, sizeof(uint64));
+    captureLatency = calloc(replayEventCount, sizeof(uint64));
+
+    if ((NULL == outDone) || (NULL == replayLatency) || (NULL == captureLatency) ||
+        (HOST_USB_SUCCESS != HostUsb_Open(REPLAY_VID, REPLAY_PID, replayEps, 2u)))
+    {
+        HostUsb_Close(1);
+        return (1);
+    }
+
+    /* Drop an IN packet left loaded by an earlier run. */
+    while (HOST_USB_SUCCESS == HostUsb_Transfer(REPLAY_IN_EP, replayBuffer, REPLAY_MAX_PACKET,
+                                                &transferred, REPLAY_DRAIN_TIMEOUT))
+    {
+    }
+
+    start = HostUsb_TimeNs();
+
+    for (i = 0u; i < replayEventCount; ++i)
+    {
+        event = &replayEvents[i];
+
+        /* Keep the time between the transfers of the capture. */
+        if (0u == fast)
+        {
+            target = start + (event->timeNs - replayEvents[0].timeNs);
+            now = HostUsb_TimeNs();
+
+            if (now < target)
+            {
+                HostUsb_SleepNs(target - now);
+            }
+            else if ((now - target) > REPLAY_LATE_NS)
+            {
+                ++late;
+            }
+            else
+            {
+                /* On time. */
+            }
+        }
+
+        if (event->length > REPLAY_MAX_LENGTH)
+        {
+            ++errors;
+            continue;
+        }
+
+        if (REPLAY_OUT == event->type)
+        {
+            /* Data beyond the snapshot length of the capture is sent as 0. */
+            (void) memset(replayBuffer, 0, event->length);
+            (void) memcpy(replayBuffer, event->data,
+                          (event->dataLength < event->length) ? event->dataLength : event->length);
+
+            result = HostUsb_Transfer(REPLAY_OUT_EP, replayBuffer, event->length,
+                                      &transferred, REPLAY_TIMEOUT);
+
+            outBytes += transferred;
+            outDone[outCount].endByte    = outBytes;
+            outDone[outCount].doneNs     = HostUsb_TimeNs();
+            outDone[outCount].capturedNs = event->doneNs;
+            ++outCount;
+        }
+        else if (REPLAY_IN == event->type)
+        {
+            result = HostUsb_Transfer(REPLAY_IN_EP, replayBuffer, event->length,
+                                      &transferred, REPLAY_TIMEOUT);
+            now = HostUsb_TimeNs();
+
+            if ((transferred != event->actual) ||
+                (0 != memcmp(replayBuffer, event->data,
+                             (event->dataLength < transferred) ? event->dataLength : transferred)))
+            {
+                ++mismatches;
+            }
+
+            /* Latency of the OUT transfer that carried the first byte. */
+            while ((outNext < outCount) && (outDone[outNext].endByte <= inBytes))
+            {
+                ++outNext;
+            }
+            if ((outNext < outCount) && (0u != transferred))
+            {
+                replayLatency[samples]  = now - outDone[outNext].doneNs;
+                captureLatency[samples] = event->doneNs - outDone[outNext].capturedNs;
+                ++samples;
+            }
+
+            inBytes += transferred;
+        }
+        else
+        {
+            (void) memset(replayBuffer, 0, sizeof(event->setup));
+            if ((0u == (event->setup[0u] & HOST_USB_DIR_IN)) && (NULL != event->data))
+            {
+                (void) memcpy(replayBuffer, event->data,
+                              (event->dataLength < event->length) ? event->dataLength : event->length);
+            }
+
+            result = HostUsb_Control(event->setup[0u], event->setup[1u],
+                                     (uint16) (event->setup[2u] | (event->setup[3u] << 8u)),
+                                     (uint16) (event->setup[4u] | (event->setup[5u] << 8u)),
+                                     replayBuffer, (uint16) event->length, REPLAY_TIMEOUT);
+            result = (result >= 0) ? HOST_USB_SUCCESS : result;
+        }
+
+        errors += (HOST_USB_SUCCESS != result) ? 1u : 0u;
+        ++transfers;
+    }
+
+    now = HostUsb_TimeNs() - start;
+    target = replayEvents[replayEventCount - 1u].timeNs - replayEvents[0].timeNs;
+
+    printf("capture         : %s\n", path);
+    printf("transfers       : %u (%llu bytes OUT, %llu bytes IN)\n", transfers,
+           (unsigned long long) outBytes, (unsigned long long) inBytes);
+    printf("timing          : %s\n", (0u != fast) ? "as fast as possible" : "as captured");
+    printf("time            : %.3f ms, captured %.3f ms\n", (double) now / 1e6, (double) target / 1e6);
+    printf("throughput      : %.3f MB/s, captured %.3f MB/s\n",
+           (0u != now) ? ((double) (outBytes + inBytes) * 1e3 / (double) now) : 0.0,
+           (0u != target) ? ((double) (outBytes + inBytes) * 1e3 / (double) target) : 0.0);
+
+    if (0u == fast)
+    {
+        printf("late transfers  : %u (issued more than 1 ms after the captured time)\n", late);
+    }
+
+    printf("latency         : %u packets, OUT completion to IN completion, us\n", samples);
+    printf("  %-8s %8s %8s %8s %8s %8s %8s\n", "", "min", "mean", "p50", "p90", "p99", "max");
+    Replay_PrintLatency("replay", replayLatency, samples);
+    Replay_PrintLatency("capture", captureLatency, samples);
+
+    if (0u != errors)
+    {
+        printf("transfer errors : %u\n", errors);
+    }
+    if (0u != mismatches)
+    {
+        printf("data mismatches : %u IN transfers differ from the capture\n", mismatches);
+    }
+
+    result = ((0u == errors) && (0u == mismatches)) ? 0 : 1;
+    HostUsb_Close(result);
+
+    return (result);
+}
+
+
+/* [] END OF FILE */
@@ -1,21 +1,38 @@
-/* ========================================
- *
- * Copyright YOUR COMPANY, THE YEAR
- * All Rights Reserved
- * UNPUBLISHED, LICENSED SOFTWARE.
- *
- * CONFIDENTIAL AND PROPRIETARY INFORMATION
- * WHICH IS THE PROPERTY OF your company.
- *
- * ========================================
-*/
+/*******************************************************************************
+* File Name: cyapicallbacks.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides function prototypes for the callbacks functions of
+*  USBFS HID code example.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
 #ifndef CYAPICALLBACKS_H
 #define CYAPICALLBACKS_H
     
+#define USBFS_EP_1_ISR_EXIT_CALLBACK
+void USBFS_EP_1_ISR_ExitCallback(void);
 
-    /*Define your macro callbacks here */
-    /*For more information, refer to the Writing Code topic in the PSoC Creator Help.*/
-
+/* Telemetry channel (telemetry.h), set in the compiler preprocessor
+* definitions.
+*/
+#if defined(TELEMETRY_ENABLE)
+#if (TELEMETRY_ENABLE)
+    #define USBFS_EP_2_ISR_EXIT_CALLBACK
+    void USBFS_EP_2_ISR_ExitCallback(void);
+#endif /* (TELEMETRY_ENABLE) */
+#endif /* defined(TELEMETRY_ENABLE) */
     
 #endif /* CYAPICALLBACKS_H */   
-/* [] */
+/* [] END OF FILE */
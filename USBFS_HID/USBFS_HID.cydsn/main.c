@@ -6,7 +6,12 @@
 * Description:
 *  This code example demonstrates USB HID interface class operation by 
 *  implementing a 3-button mouse. When the code is run, the mouse cursor moves 
-*  from the right to the left, and vice-versa.
+*  from the right to the left, and vice-versa, with a rest after each stroke.
+*  A report is only sent when the cursor has moved.
+*  Built with TELEMETRY_ENABLE, the device also streams demo telemetry to the
+*  host on a vendor-defined HID interface (telemetry.h). The shipped TopDesign
+*  does not have that interface: TELEMETRY_ENABLE is off by default and needs
+*  the USBFS component change given in telemetry.h first.
 *
 *
 * Related Document:
@@ -25,25 +30,68 @@
 *******************************************************************************/
 
 #include <project.h>
+#include "mouse_report.h"
+#include "telemetry.h"
 
 #define USBFS_DEVICE        (0u)
 
-#define MOUSE_ENDPOINT      (1u)
-#define MOUSE_DATA_LEN      (3u)
-#define CURSOR_STEP         (5u)
-#define CURSOR_STEP_POS     (1u)
+#define CURSOR_STEP         (5)
+
+/* The cursor moves one step every CURSOR_TICK_MS. A stroke to the right,
+* a rest, a stroke to the left and a rest take CURSOR_PHASE_TICKS each.
+*/
+#define CURSOR_TICK_MS      (10u)
+#define CURSOR_PHASE_TICKS  (128u)
+#define CURSOR_PHASE_RIGHT  (0u)
+#define CURSOR_PHASE_LEFT   (2u)
+
+/* SysTick callback slot used for the tick. The telemetry channel needs a
+* 1 ms tick; the cursor moves every CURSOR_TICK_MS / TICK_MS ticks.
+*/
+#define TICK_SYSTICK_CALLBACK   (0u)
+#if (TELEMETRY_ENABLE)
+    #define TICK_MS             (1u)
+#else
+    #define TICK_MS             (CURSOR_TICK_MS)
+#endif /* (TELEMETRY_ENABLE) */
+
+#if (TELEMETRY_ENABLE)
+/* Demo telemetry: records of TELEMETRY_DEMO_RECORD bytes, with this many
+* records per tick in each stream. The first stream takes two thirds of the
+* channel, the rate limit holds the second one to 200 reports per second and
+* the last one gets what bandwidth is left and drops the rest.
+*/
+#define TELEMETRY_DEMO_RECORD   (8u)
+
+static const uint8 telemetryDemoRecords[TELEMETRY_STREAMS] = {5u, 1u, 2u};
+
+static void TelemetryDemo(void);
+#endif /* (TELEMETRY_ENABLE) */
 
-/* Mouse packet array: button, X, Y */
-uint8 mouseData[MOUSE_DATA_LEN] = {0u, 0u, 0u};
 uint8 bSNstring[16u] = {0x0Eu, 0x03u, 'F', 0u, 'W', 0u, 'S', 0u, 'N', 0u, '0', 0u, '1', 0u};
 
+static void Tick(void);
+static void CursorTick(void);
+
 
 /*******************************************************************************
 * Function Name: main
 ********************************************************************************
 *
 * Summary:
-*  Wraps the OUT data coming from the host back to the host on a subsequent IN.
+*  The main function performs the following actions:
+*   1. Starts the USBFS component and waits until the device is enumerated
+*      by the host.
+*   2. Moves the cursor from the tick of SysTick: a stroke to the right, a
+*      rest, a stroke to the left and a rest, over and over. The movement
+*      goes to the mouse report engine (mouse_report.h), which sends a report
+*      when the host has read the last one and there is movement to report.
+*   3. With TELEMETRY_ENABLE, writes demo records to the telemetry streams
+*      at every 1 ms tick.
+*   4. Sleeps: the reports are sent from the SysTick and the endpoint
+*      interrupts. While the cursor rests, no report is loaded and the host
+*      polls get NAK. PSoC 3 has no SysTick and no WFI: the main loop paces
+*      the cursor with CyDelay().
 *
 * Parameters:
 *  None.
@@ -54,8 +102,6 @@ uint8 bSNstring[16u] = {0x0Eu, 0x03u, 'F', 0u, 'W', 0u, 'S', 0u, 'N', 0u, '0', 0
 *******************************************************************************/
 int main()
 {
-    uint8 counter = 0u;
-
     CyGlobalIntEnable;
 
     /* Set user-defined Serial Number string descriptor. */
@@ -69,37 +115,191 @@ int main()
     {
     }
 
-    /* Enumeration is done, load mouse endpoint. */
-    USBFS_LoadInEP(MOUSE_ENDPOINT, mouseData, MOUSE_DATA_LEN);
+    /* Enumeration is done: the endpoint is empty. */
+    MouseReport_Start();
+#if (TELEMETRY_ENABLE)
+    Telemetry_Start();
+#endif /* (TELEMETRY_ENABLE) */
+
+#if (!CY_PSOC3)
+    CySysTickStart();
+    CySysTickStop();
+    (void) CySysTickSetCallback(TICK_SYSTICK_CALLBACK, &Tick);
+    CySysTickSetReload((TICK_MS * (cydelay_freq_hz / 1000u)) - 1u);
+    CySysTickClear();
+    CySysTickEnable();
+#endif /* (!CY_PSOC3) */
 
     for(;;)
     {
-        /* Wait for ACK before loading data. */
-        while (0u == USBFS_GetEPAckState(MOUSE_ENDPOINT))
-        {
-        }
+    #if (CY_PSOC4)
+        CySysPmSleep();
+    #elif (CY_PSOC5)
+        CY_PM_WFI;
+    #else
+        CyDelay(CURSOR_TICK_MS);
+        CursorTick();
+    #endif /* (CY_PSOC4) */
+    }
+}
 
-        /* Load endpoint with data after ACK has been received. */
-        USBFS_LoadInEP(MOUSE_ENDPOINT, mouseData, MOUSE_DATA_LEN);
 
-        counter++;
-        if (counter == 128u)
-        {
-            /* Start moving mouse to the right. */
-            mouseData[CURSOR_STEP_POS] = CURSOR_STEP;
-        }
-        /* When our counter hits 255. */					
-        else if (counter == 255u)
-        {
-            /* Start moving mouse to left. */
-            mouseData[CURSOR_STEP_POS] = (uint8) -(int8) CURSOR_STEP;
-        }
-        else
+/*******************************************************************************
+* Function Name: Tick
+********************************************************************************
+*
+* Summary:
+*  SysTick tick: runs the telemetry channel and moves the cursor.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Tick(void)
+{
+    static uint8 ticks = 0u;
+
+#if (TELEMETRY_ENABLE)
+    TelemetryDemo();
+    Telemetry_Tick();
+#endif /* (TELEMETRY_ENABLE) */
+
+    ++ticks;
+    if (ticks >= (CURSOR_TICK_MS / TICK_MS))
+    {
+        ticks = 0u;
+        CursorTick();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: CursorTick
+********************************************************************************
+*
+* Summary:
+*  Moves the cursor one step in a stroke, or nothing in a rest.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void CursorTick(void)
+{
+    static uint16 counter = 0u;
+    uint16 phase = (counter / CURSOR_PHASE_TICKS) % 4u;
+
+    if (CURSOR_PHASE_RIGHT == phase)
+    {
+        MouseReport_Move(CURSOR_STEP, 0);
+    }
+    else if (CURSOR_PHASE_LEFT == phase)
+    {
+        MouseReport_Move(-CURSOR_STEP, 0);
+    }
+    else
+    {
+        /* Rest. */
+    }
+
+    ++counter;
+}
+
+
+#if (TELEMETRY_ENABLE)
+/*******************************************************************************
+* Function Name: TelemetryDemo
+********************************************************************************
+*
+* Summary:
+*  Writes the demo records of a tick to the telemetry streams. A record is
+*  its 16-bit sequence number, the report ID of its stream and five bytes of
+*  a pattern the host checks: byte i is the sequence number plus the report
+*  ID plus i. A gap in the sequence numbers is a dropped record.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void TelemetryDemo(void)
+{
+    static uint16 sequence[TELEMETRY_STREAMS];
+    uint8 record[TELEMETRY_DEMO_RECORD];
+    uint8 stream;
+    uint8 count;
+    uint8 i;
+
+    for (stream = 0u; stream < TELEMETRY_STREAMS; ++stream)
+    {
+        for (count = 0u; count < telemetryDemoRecords[stream]; ++count)
         {
-            /* Do nothing. */					
+            record[0u] = (uint8) sequence[stream];
+            record[1u] = (uint8) (sequence[stream] >> 8u);
+            record[2u] = stream + 1u;
+
+            for (i = 3u; i < TELEMETRY_DEMO_RECORD; ++i)
+            {
+                record[i] = (uint8) (record[0u] + record[2u] + i);
+            }
+
+            (void) Telemetry_Write(stream, record, TELEMETRY_DEMO_RECORD);
+            ++sequence[stream];
         }
     }
 }
+#endif /* (TELEMETRY_ENABLE) */
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_1_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  The host has read the mouse report: loads the next one if there is one.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_1_ISR_ExitCallback(void)
+{
+    MouseReport_Send();
+}
+
+
+#if (TELEMETRY_ENABLE)
+/*******************************************************************************
+* Function Name: USBFS_EP_2_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  The host has read the telemetry report: loads the next one if a stream is
+*  ready.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_2_ISR_ExitCallback(void)
+{
+    Telemetry_Send();
+}
+#endif /* (TELEMETRY_ENABLE) */
 
 
 /* [] END OF FILE */
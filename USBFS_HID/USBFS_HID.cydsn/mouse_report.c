@@ -0,0 +1,343 @@
+/*******************************************************************************
+* File Name: mouse_report.c
+*
+* Version: 1.0
+*
+* Description:
+*  Mouse report engine of the USBFS HID example project. The movement not
+*  reported yet is kept in 32-bit sums; a report takes at most
+*  MOUSE_REPORT_MAX_DELTA of it in each direction and leaves the rest for the
+*  next report. Every function works in a critical section, so producers in
+*  any interrupt and the endpoint interrupt can call them.
+*
+*  The report descriptor, the packing code and the build checks are
+*  expanded from MOUSE_REPORT_FIELDS. A check that fails declares an array
+*  of negative size and stops the build.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "mouse_report.h"
+
+#define MOUSE_REPORT_ASSERT(name, condition) \
+    typedef uint8 mouseReportAssert_##name[(condition) ? 1 : -1]
+
+/* Bits of a field and its sign bit, 0 for an unsigned field. */
+#define MOUSE_REPORT_MASK(bits)         ((uint32) ((1uL << (bits)) - 1u))
+#define MOUSE_REPORT_SIGN(min, bits)    (((min) < 0) ? (1uL << ((bits) - 1u)) : 0uL)
+
+/* Items of a field: one usage per value, the logical range of a value, and
+* the values of the field.
+*/
+#define MOUSE_REPORT_FIELD_ITEMS(NAME, member, page, first, last, min, max, size, count, flags) \
+    HID_ITEM_USAGE_PAGE, (page), \
+    HID_ITEM_USAGE_MINIMUM, (first), \
+    HID_ITEM_USAGE_MAXIMUM, (last), \
+    HID_ITEM_LOGICAL_MINIMUM, (uint8) (min), \
+    HID_ITEM_LOGICAL_MAXIMUM, (uint8) (max), \
+    HID_ITEM_REPORT_SIZE, (size), \
+    HID_ITEM_REPORT_COUNT, (count), \
+    HID_ITEM_INPUT, (flags),
+#define MOUSE_REPORT_PAD_ITEMS(NAME, bits) \
+    HID_ITEM_REPORT_SIZE, (bits), \
+    HID_ITEM_REPORT_COUNT, 1u, \
+    HID_ITEM_INPUT, HID_INPUT_CONSTANT,
+
+/* Checks of a field: it fits the packing code, it has a usage per value, and
+* its logical range fits the one-byte items and the bits of a value.
+*/
+#define MOUSE_REPORT_FIELD_CHECK(NAME, member, page, first, last, min, max, size, count, flags) \
+    MOUSE_REPORT_ASSERT(NAME##_bits, ((size) * (count)) <= 8u); \
+    MOUSE_REPORT_ASSERT(NAME##_usages, (((last) - (first)) + 1u) == (count)); \
+    MOUSE_REPORT_ASSERT(NAME##_range, ((min) >= -128) && ((max) <= 127) && ((min) < (max))); \
+    MOUSE_REPORT_ASSERT(NAME##_fits, ((min) < 0) ? \
+        (((min) >= -(1 << ((size) - 1u))) && ((max) < (1 << ((size) - 1u)))) : \
+        ((max) < (1 << (size))));
+#define MOUSE_REPORT_PAD_CHECK(NAME, bits)
+
+/* Straight-line packing: each field goes to its offset, with no test. */
+#define MOUSE_REPORT_FIELD_PACK(NAME, member, page, first, last, min, max, size, count, flags) \
+    packed |= ((uint32) (uint16) values->member & MOUSE_REPORT_MASK((size) * (count))) << \
+              MOUSE_REPORT_##NAME##_BIT;
+#define MOUSE_REPORT_FIELD_UNPACK(NAME, member, page, first, last, min, max, size, count, flags) \
+    value = (packed >> MOUSE_REPORT_##NAME##_BIT) & MOUSE_REPORT_MASK((size) * (count)); \
+    values->member = (int16) (int32) ((value ^ MOUSE_REPORT_SIGN((min), (size) * (count))) - \
+                                      MOUSE_REPORT_SIGN((min), (size) * (count)));
+#define MOUSE_REPORT_PAD_NONE(NAME, bits)
+
+/* Report descriptor of the report the table describes. The USBFS component
+* sends its own: the hid-mouse scenario of the host emulation checks that
+* both describe the same report.
+*/
+const uint8 mouseReportDescriptor[] =
+{
+    HID_ITEM_USAGE_PAGE, HID_PAGE_GENERIC_DESKTOP,
+    HID_ITEM_USAGE, HID_USAGE_MOUSE,
+    HID_ITEM_COLLECTION, HID_COLLECTION_APPLICATION,
+    HID_ITEM_USAGE, HID_USAGE_POINTER,
+    HID_ITEM_COLLECTION, HID_COLLECTION_PHYSICAL,
+    MOUSE_REPORT_FIELDS(MOUSE_REPORT_FIELD_ITEMS, MOUSE_REPORT_PAD_ITEMS)
+    HID_ITEM_END_COLLECTION,
+    HID_ITEM_END_COLLECTION
+};
+
+MOUSE_REPORT_FIELDS(MOUSE_REPORT_FIELD_CHECK, MOUSE_REPORT_PAD_CHECK)
+
+/* The report is whole bytes, fits the endpoint and the 32-bit packing, and
+* the descriptor has the items of every field.
+*/
+MOUSE_REPORT_ASSERT(bytes, 0u == (MOUSE_REPORT_BITS % 8u));
+MOUSE_REPORT_ASSERT(length, (MOUSE_REPORT_LENGTH <= MOUSE_REPORT_EP_SIZE) &&
+                            (MOUSE_REPORT_LENGTH <= sizeof(uint32)));
+MOUSE_REPORT_ASSERT(descriptor, sizeof(mouseReportDescriptor) == MOUSE_REPORT_DESCRIPTOR_SIZE);
+
+/* MouseReport_Take() limits both axes to MOUSE_REPORT_MAX_DELTA. */
+MOUSE_REPORT_ASSERT(delta, MOUSE_REPORT_X_MAX == MOUSE_REPORT_Y_MAX);
+
+/* Report in the IN endpoint: it stays unchanged until the host has read it. */
+static uint8 mouseReport[MOUSE_REPORT_LENGTH];
+
+static int32 mouseReportX;          /* Movement not reported yet. */
+static int32 mouseReportY;
+static uint8 mouseReportButtons;    /* Buttons pressed. */
+static uint8 mouseReportSent;       /* Buttons of the last report. */
+
+static int8 MouseReport_Take(int32 *sum);
+
+
+/*******************************************************************************
+* Function Name: MouseReport_Take
+********************************************************************************
+*
+* Summary:
+*  Takes the movement of one report from a sum, limited to
+*  MOUSE_REPORT_MAX_DELTA in each direction.
+*
+* Parameters:
+*  sum: movement not reported yet; the rest is left in it.
+*
+* Return:
+*  Movement of the report.
+*
+*******************************************************************************/
+static int8 MouseReport_Take(int32 *sum)
+{
+    int32 delta = *sum;
+
+    if (delta > MOUSE_REPORT_MAX_DELTA)
+    {
+        delta = MOUSE_REPORT_MAX_DELTA;
+    }
+    else if (delta < -MOUSE_REPORT_MAX_DELTA)
+    {
+        delta = -MOUSE_REPORT_MAX_DELTA;
+    }
+    else
+    {
+        /* The whole sum fits. */
+    }
+
+    *sum -= delta;
+
+    return ((int8) delta);
+}
+
+
+/*******************************************************************************
+* Function Name: MouseReport_Start
+********************************************************************************
+*
+* Summary:
+*  Drops the movement not reported yet and releases the buttons. Call it when
+*  the device is configured.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void MouseReport_Start(void)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    mouseReportX = 0;
+    mouseReportY = 0;
+    mouseReportButtons = 0u;
+    mouseReportSent = 0u;
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: MouseReport_Move
+********************************************************************************
+*
+* Summary:
+*  Adds cursor movement and sends it if the IN endpoint is empty.
+*
+* Parameters:
+*  dx: movement to the right.
+*  dy: movement down.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void MouseReport_Move(int16 dx, int16 dy)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    mouseReportX += dx;
+    mouseReportY += dy;
+    MouseReport_Send();
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: MouseReport_SetButtons
+********************************************************************************
+*
+* Summary:
+*  Sets the buttons pressed and sends them if the IN endpoint is empty. A
+*  press released before the host has read the report is not seen.
+*
+* Parameters:
+*  buttons: MOUSE_BUTTON_LEFT, _RIGHT and _MIDDLE, or 0 for none.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void MouseReport_SetButtons(uint8 buttons)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    mouseReportButtons = buttons;
+    MouseReport_Send();
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: MouseReport_Send
+********************************************************************************
+*
+* Summary:
+*  Loads the next report into the IN endpoint if the endpoint is empty and
+*  there is movement or a button change to report. Call it from the exit
+*  callback of the endpoint interrupt.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void MouseReport_Send(void)
+{
+    MOUSE_REPORT_VALUES values;
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    if ((0u != USBFS_GetConfiguration()) &&
+        (USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(MOUSE_REPORT_ENDPOINT)) &&
+        ((0 != mouseReportX) || (0 != mouseReportY) || (mouseReportButtons != mouseReportSent)))
+    {
+        values.buttons = (int16) mouseReportButtons;
+        values.x = MouseReport_Take(&mouseReportX);
+        values.y = MouseReport_Take(&mouseReportY);
+        MouseReport_Pack(mouseReport, &values);
+        mouseReportSent = mouseReportButtons;
+
+        USBFS_LoadInEP(MOUSE_REPORT_ENDPOINT, mouseReport, MOUSE_REPORT_LENGTH);
+    }
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: MouseReport_Pack
+********************************************************************************
+*
+* Summary:
+*  Packs the field values into a report. The fields are put together in a
+*  32-bit word by straight-line code, then stored little-endian, as HID
+*  reports are. Bits above the size of a field are dropped.
+*
+* Parameters:
+*  report: report, MOUSE_REPORT_LENGTH bytes.
+*  values: field values.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void MouseReport_Pack(uint8 report[], const MOUSE_REPORT_VALUES *values)
+{
+    uint32 packed = 0u;
+    uint8 i;
+
+    MOUSE_REPORT_FIELDS(MOUSE_REPORT_FIELD_PACK, MOUSE_REPORT_PAD_NONE)
+
+    for (i = 0u; i < MOUSE_REPORT_LENGTH; ++i)
+    {
+        report[i] = (uint8) (packed >> (8u * i));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: MouseReport_Unpack
+********************************************************************************
+*
+* Summary:
+*  Unpacks a report into the field values, with the sign of the signed
+*  fields extended without a test.
+*
+* Parameters:
+*  report: report, MOUSE_REPORT_LENGTH bytes.
+*  values: field values.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void MouseReport_Unpack(const uint8 report[], MOUSE_REPORT_VALUES *values)
+{
+    uint32 packed = 0u;
+    uint32 value;
+    uint8 i;
+
+    for (i = 0u; i < MOUSE_REPORT_LENGTH; ++i)
+    {
+        packed |= (uint32) report[i] << (8u * i);
+    }
+
+    MOUSE_REPORT_FIELDS(MOUSE_REPORT_FIELD_UNPACK, MOUSE_REPORT_PAD_NONE)
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,178 @@
+/*******************************************************************************
+* File Name: mouse_report.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants and function prototypes of the mouse report
+*  engine of the USBFS HID example project.
+*
+*  Producers, in interrupts or in the main loop, add cursor movement with
+*  MouseReport_Move() and set the buttons with MouseReport_SetButtons(). The
+*  engine adds up the movement until the host takes the next report, so no
+*  movement is lost however the producer rate and the polling interval
+*  compare. A report is loaded into the IN endpoint only when it carries
+*  movement or a button change, either at once when the endpoint is empty or
+*  from the endpoint interrupt when the host has read the last report. While
+*  the mouse rests, the endpoint stays empty: the host polls get NAK and the
+*  CPU does nothing.
+*
+*  The report layout is the table MOUSE_REPORT_FIELDS. The bit offsets, the
+*  report length, the packing code and the report descriptor are all
+*  generated from it, and the checks in mouse_report.c stop the build when
+*  the table does not make a valid report. The USBFS component sends the
+*  report descriptor of the .cysch, and the EP1 max packet size must hold
+*  MOUSE_REPORT_LENGTH. When the table changes, the .cysch descriptor must
+*  change with it: the hid-mouse scenario of the host emulation fails when
+*  it does not describe the same report as mouseReportDescriptor.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(MOUSE_REPORT_H)
+#define MOUSE_REPORT_H
+
+#include <project.h>
+
+
+/***************************************
+*    Constants
+****************************************/
+
+#define MOUSE_REPORT_ENDPOINT   (1u)
+
+/* Max packet size of the endpoint in the USBFS component. */
+#define MOUSE_REPORT_EP_SIZE    (8u)
+
+/* HID report descriptor items with one byte of data. */
+#define HID_ITEM_USAGE_PAGE     (0x05u)
+#define HID_ITEM_USAGE          (0x09u)
+#define HID_ITEM_USAGE_MINIMUM  (0x19u)
+#define HID_ITEM_USAGE_MAXIMUM  (0x29u)
+#define HID_ITEM_LOGICAL_MINIMUM (0x15u)
+#define HID_ITEM_LOGICAL_MAXIMUM (0x25u)
+#define HID_ITEM_REPORT_SIZE    (0x75u)
+#define HID_ITEM_REPORT_COUNT   (0x95u)
+#define HID_ITEM_INPUT          (0x81u)
+#define HID_ITEM_COLLECTION     (0xA1u)
+#define HID_ITEM_END_COLLECTION (0xC0u)
+
+#define HID_PAGE_GENERIC_DESKTOP (0x01u)
+#define HID_PAGE_BUTTON         (0x09u)
+#define HID_USAGE_POINTER       (0x01u)
+#define HID_USAGE_MOUSE         (0x02u)
+#define HID_USAGE_X             (0x30u)
+#define HID_USAGE_Y             (0x31u)
+#define HID_COLLECTION_PHYSICAL (0x00u)
+#define HID_COLLECTION_APPLICATION (0x01u)
+
+/* Input item flags. */
+#define HID_INPUT_CONSTANT      (0x01u)
+#define HID_INPUT_DATA_VAR_ABS  (0x02u)
+#define HID_INPUT_DATA_VAR_REL  (0x06u)
+
+/* Fields of the report, in report order:
+*  FIELD(NAME, member, usage page, first usage, last usage, logical minimum,
+*        logical maximum, report size, report count, input flags)
+*  PAD(NAME, bits)
+* NAME names the constants of a field and member its member in
+* MOUSE_REPORT_VALUES. A field holds report count values of report size
+* bits, packed as one value of up to 8 bits; it is signed when its logical
+* minimum is negative. A pad is constant bits that fill the report to a
+* whole byte.
+*/
+#define MOUSE_REPORT_FIELDS(FIELD, PAD) \
+    FIELD(BUTTONS, buttons, HID_PAGE_BUTTON, 1u, 3u, 0, 1, 1u, 3u, \
+          HID_INPUT_DATA_VAR_ABS) \
+    PAD(BUTTONS_PAD, 5u) \
+    FIELD(X, x, HID_PAGE_GENERIC_DESKTOP, HID_USAGE_X, HID_USAGE_X, -127, 127, 8u, 1u, \
+          HID_INPUT_DATA_VAR_REL) \
+    FIELD(Y, y, HID_PAGE_GENERIC_DESKTOP, HID_USAGE_Y, HID_USAGE_Y, -127, 127, 8u, 1u, \
+          HID_INPUT_DATA_VAR_REL)
+
+/* Bit offset, last bit and logical maximum of each field, then the report
+* bits: each offset follows the last bit of the field before it.
+*/
+#define MOUSE_REPORT_FIELD_ENUM(NAME, member, page, first, last, min, max, size, count, flags) \
+    MOUSE_REPORT_##NAME##_BIT, \
+    MOUSE_REPORT_##NAME##_LAST = MOUSE_REPORT_##NAME##_BIT + ((size) * (count)) - 1, \
+    MOUSE_REPORT_##NAME##_MAX = (max), \
+    MOUSE_REPORT_##NAME##_NEXT = MOUSE_REPORT_##NAME##_LAST,
+#define MOUSE_REPORT_PAD_ENUM(NAME, bits) \
+    MOUSE_REPORT_##NAME##_BIT, \
+    MOUSE_REPORT_##NAME##_NEXT = MOUSE_REPORT_##NAME##_BIT + (bits) - 1,
+
+enum
+{
+    MOUSE_REPORT_FIELDS(MOUSE_REPORT_FIELD_ENUM, MOUSE_REPORT_PAD_ENUM)
+    MOUSE_REPORT_BITS
+};
+
+#define MOUSE_REPORT_LENGTH     ((uint8) (MOUSE_REPORT_BITS / 8u))
+
+/* Largest movement of one report in each direction. */
+#define MOUSE_REPORT_MAX_DELTA  (MOUSE_REPORT_X_MAX)
+
+/* Report descriptor: a mouse application collection and a pointer physical
+* collection around the items of the fields.
+*/
+#define MOUSE_REPORT_DESCRIPTOR_HEAD    (10u)
+#define MOUSE_REPORT_DESCRIPTOR_FIELD   (16u)
+#define MOUSE_REPORT_DESCRIPTOR_PAD     (6u)
+#define MOUSE_REPORT_DESCRIPTOR_TAIL    (2u)
+
+#define MOUSE_REPORT_FIELD_SIZE(NAME, member, page, first, last, min, max, size, count, flags) \
+    MOUSE_REPORT_DESCRIPTOR_FIELD +
+#define MOUSE_REPORT_PAD_SIZE(NAME, bits) \
+    MOUSE_REPORT_DESCRIPTOR_PAD +
+
+#define MOUSE_REPORT_DESCRIPTOR_SIZE (MOUSE_REPORT_DESCRIPTOR_HEAD + \
+    MOUSE_REPORT_FIELDS(MOUSE_REPORT_FIELD_SIZE, MOUSE_REPORT_PAD_SIZE) \
+    MOUSE_REPORT_DESCRIPTOR_TAIL)
+
+/* Buttons. */
+#define MOUSE_BUTTON_LEFT       (0x01u)
+#define MOUSE_BUTTON_RIGHT      (0x02u)
+#define MOUSE_BUTTON_MIDDLE     (0x04u)
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Values of the report fields. */
+#define MOUSE_REPORT_FIELD_MEMBER(NAME, member, page, first, last, min, max, size, count, flags) \
+    int16 member;
+#define MOUSE_REPORT_PAD_MEMBER(NAME, bits)
+
+typedef struct
+{
+    MOUSE_REPORT_FIELDS(MOUSE_REPORT_FIELD_MEMBER, MOUSE_REPORT_PAD_MEMBER)
+} MOUSE_REPORT_VALUES;
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void MouseReport_Start(void);
+void MouseReport_Move(int16 dx, int16 dy);
+void MouseReport_SetButtons(uint8 buttons);
+void MouseReport_Send(void);
+void MouseReport_Pack(uint8 report[], const MOUSE_REPORT_VALUES *values);
+void MouseReport_Unpack(const uint8 report[], MOUSE_REPORT_VALUES *values);
+
+extern const uint8 mouseReportDescriptor[];
+
+#endif /* (MOUSE_REPORT_H) */
+
+
+/* [] END OF FILE */
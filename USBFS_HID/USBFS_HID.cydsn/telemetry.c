@@ -0,0 +1,277 @@
+/*******************************************************************************
+* File Name: telemetry.c
+*
+* Version: 1.0
+*
+* Description:
+*  Telemetry channel of the USBFS HID example project. The rings are byte
+*  rings with free-running 16-bit head and tail counters. Telemetry_Write()
+*  may be called from any interrupt and from the main loop; the report is
+*  built and loaded in Telemetry_Send(), from the endpoint interrupt when the
+*  host has read the last report, or from a write or a tick when the endpoint
+*  was left empty. All of them work in a critical section.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "telemetry.h"
+
+#if (TELEMETRY_ENABLE)
+
+/* Report ID and rate limit of a stream. */
+typedef struct
+{
+    uint8  reportId;
+    uint16 rate;                /* Reports per second, up to 1000. */
+    uint8  burst;               /* Reports the bucket holds. */
+} TELEMETRY_CONFIG;
+
+/* State of a stream. */
+typedef struct
+{
+    uint8  data[TELEMETRY_RING_SIZE];
+    uint16 head;                /* Bytes written. */
+    uint16 tail;                /* Bytes sent. */
+    uint16 mark;                /* Bytes written at the last tick. */
+    uint32 tokens;              /* Rate limit bucket. */
+    uint8  due;                 /* Data written before the last tick waits. */
+} TELEMETRY_STREAM;
+
+/* Streams, highest priority first. */
+static const TELEMETRY_CONFIG telemetryConfig[TELEMETRY_STREAMS] =
+{
+    {1u, 1000u, 4u},            /* Samples */
+    {2u,  200u, 2u},            /* Status, at most 200 reports per second */
+    {3u, 1000u, 4u}             /* Trace, what bandwidth is left */
+};
+
+static TELEMETRY_STREAM telemetryStream[TELEMETRY_STREAMS];
+
+/* Report in the IN endpoint: it stays unchanged until the host has read it. */
+static uint8 telemetryReport[TELEMETRY_REPORT_SIZE];
+
+TELEMETRY_STATS telemetryStats[TELEMETRY_STREAMS];
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Start
+********************************************************************************
+*
+* Summary:
+*  Empties the rings, fills the rate limit buckets and clears the counters.
+*  Call it when the device is configured.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Telemetry_Start(void)
+{
+    uint8 interruptState;
+    uint8 stream;
+
+    interruptState = CyEnterCriticalSection();
+
+    for (stream = 0u; stream < TELEMETRY_STREAMS; ++stream)
+    {
+        telemetryStream[stream].head = 0u;
+        telemetryStream[stream].tail = 0u;
+        telemetryStream[stream].mark = 0u;
+        telemetryStream[stream].due = 0u;
+        telemetryStream[stream].tokens =
+            (uint32) telemetryConfig[stream].burst * TELEMETRY_RATE_UNIT;
+    }
+
+    (void) memset(telemetryStats, 0, sizeof(telemetryStats));
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Write
+********************************************************************************
+*
+* Summary:
+*  Writes a record to the ring of a stream, or drops it whole when it does
+*  not fit. A record may be sent in two reports.
+*
+* Parameters:
+*  stream: stream index, 0 to TELEMETRY_STREAMS - 1.
+*  pData: record.
+*  length: record length.
+*
+* Return:
+*  1 if the record was written, 0 if it was dropped.
+*
+*******************************************************************************/
+uint8 Telemetry_Write(uint8 stream, const uint8 pData[], uint8 length)
+{
+    TELEMETRY_STREAM *state = &telemetryStream[stream];
+    uint8 interruptState;
+    uint8 written = 0u;
+    uint16 head;
+    uint8 i;
+
+    interruptState = CyEnterCriticalSection();
+
+    head = state->head;
+
+    if ((uint16) (TELEMETRY_RING_SIZE - (uint16) (head - state->tail)) >= length)
+    {
+        for (i = 0u; i < length; ++i)
+        {
+            state->data[(uint16) (head + i) & TELEMETRY_RING_MASK] = pData[i];
+        }
+
+        state->head = head + length;
+        telemetryStats[stream].bytes += length;
+        ++telemetryStats[stream].records;
+        written = 1u;
+
+        Telemetry_Send();
+    }
+    else
+    {
+        ++telemetryStats[stream].dropped;
+    }
+
+    CyExitCriticalSection(interruptState);
+
+    return (written);
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Tick
+********************************************************************************
+*
+* Summary:
+*  Refills the rate limit buckets. A stream whose data written before the
+*  previous tick is still waiting becomes due: a short report sends it. Call
+*  it every millisecond.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Telemetry_Tick(void)
+{
+    TELEMETRY_STREAM *state;
+    uint8 interruptState;
+    uint32 limit;
+    uint8 stream;
+
+    interruptState = CyEnterCriticalSection();
+
+    for (stream = 0u; stream < TELEMETRY_STREAMS; ++stream)
+    {
+        state = &telemetryStream[stream];
+        limit = (uint32) telemetryConfig[stream].burst * TELEMETRY_RATE_UNIT;
+
+        state->tokens += telemetryConfig[stream].rate;
+        if (state->tokens > limit)
+        {
+            state->tokens = limit;
+        }
+
+        /* The tail is behind the mark of the previous tick. */
+        state->due = ((uint16) (state->tail - state->mark) > TELEMETRY_RING_SIZE) ? 1u : 0u;
+        state->mark = state->head;
+    }
+
+    Telemetry_Send();
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Send
+********************************************************************************
+*
+* Summary:
+*  Loads a report of the first ready stream into the IN endpoint if the
+*  endpoint is empty. Call it from the exit callback of the endpoint
+*  interrupt.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Telemetry_Send(void)
+{
+    TELEMETRY_STREAM *state;
+    uint8 interruptState;
+    uint16 count;
+    uint16 first;
+    uint8 stream;
+
+    interruptState = CyEnterCriticalSection();
+
+    if ((0u != USBFS_GetConfiguration()) &&
+        (USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(TELEMETRY_ENDPOINT)))
+    {
+        for (stream = 0u; stream < TELEMETRY_STREAMS; ++stream)
+        {
+            state = &telemetryStream[stream];
+            count = (uint16) (state->head - state->tail);
+
+            if ((0u != count) && ((count >= TELEMETRY_PAYLOAD) || (0u != state->due)) &&
+                (state->tokens >= TELEMETRY_RATE_UNIT))
+            {
+                count = (count < TELEMETRY_PAYLOAD) ? count : TELEMETRY_PAYLOAD;
+
+                /* Up to the end of the ring, then from its start. */
+                first = (uint16) (TELEMETRY_RING_SIZE - (state->tail & TELEMETRY_RING_MASK));
+                first = (count < first) ? count : first;
+
+                telemetryReport[0u] = telemetryConfig[stream].reportId;
+                telemetryReport[1u] = (uint8) count;
+                (void) memcpy(&telemetryReport[TELEMETRY_HEADER_SIZE],
+                              &state->data[state->tail & TELEMETRY_RING_MASK], first);
+                (void) memcpy(&telemetryReport[TELEMETRY_HEADER_SIZE + first],
+                              &state->data[0u], count - first);
+                (void) memset(&telemetryReport[TELEMETRY_HEADER_SIZE + count], 0,
+                              TELEMETRY_PAYLOAD - count);
+
+                state->tail += count;
+                state->tokens -= TELEMETRY_RATE_UNIT;
+                if ((uint16) (state->tail - state->mark) <= TELEMETRY_RING_SIZE)
+                {
+                    state->due = 0u;
+                }
+                ++telemetryStats[stream].reports;
+
+                USBFS_LoadInEP(TELEMETRY_ENDPOINT, telemetryReport, TELEMETRY_REPORT_SIZE);
+                break;
+            }
+        }
+    }
+
+    CyExitCriticalSection(interruptState);
+}
+
+#endif /* (TELEMETRY_ENABLE) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,131 @@
+/*******************************************************************************
+* File Name: telemetry.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants, the stream statistics and function
+*  prototypes of the telemetry channel of the USBFS HID example project.
+*
+*  With TELEMETRY_ENABLE set, a vendor-defined HID interface sends
+*  TELEMETRY_STREAMS streams of bytes to the host in 64-byte input reports on
+*  an interrupt IN endpoint polled every frame. Each stream has its own report
+*  ID and its own ring; the report ID tells the host which stream a report
+*  belongs to. A report is:
+*   byte 0:     report ID of the stream.
+*   byte 1:     number of stream bytes that follow (1 to TELEMETRY_PAYLOAD).
+*   bytes 2-63: stream bytes; the rest of a short report is zero.
+*  With one report per 1 ms frame the interface carries 64 KB/s, which is
+*  62 KB/s of stream data, without a driver on the host.
+*
+*  When the endpoint is free, the report goes to the first stream in the
+*  stream table that is ready: it holds a full report, or it holds data
+*  written before the previous tick of Telemetry_Tick(), and its rate limit
+*  allows another report.
+*  The rate limit is a token bucket of TELEMETRY_RATE_UNIT per report,
+*  refilled by the rate in reports per second at every 1 ms tick and capped
+*  at a burst of reports. A record that does not fit the ring of its stream
+*  is dropped whole and counted.
+*
+*  TELEMETRY_ENABLE is 0 by default because the shipped TopDesign does not
+*  have the interface. The USBFS component must be changed in PSoC Creator
+*  before the channel is built; the build stops with an error while the
+*  component has a single interface. The host emulation supplies the
+*  interface itself. The component needs interface 1 of class HID with the
+*  report descriptor below, and endpoint 2 as an interrupt IN endpoint of 64
+*  bytes with bInterval 1.
+*   Usage Page (Vendor Defined 0xFF00), Usage (0x01), Collection (Application),
+*     Logical Minimum (0), Logical Maximum (255), Report Size (8),
+*     then for each stream: Report ID (n), Usage (0x01), Report Count (63),
+*     Input (Data, Variable, Absolute),
+*   End Collection.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(TELEMETRY_H)
+#define TELEMETRY_H
+
+#include <project.h>
+
+/* Set to 1u in the compiler preprocessor definitions to build the channel,
+* once the USBFS component has the interface described above.
+*/
+#if !defined(TELEMETRY_ENABLE)
+    #define TELEMETRY_ENABLE        (0u)
+#endif /* !defined(TELEMETRY_ENABLE) */
+
+#if (TELEMETRY_ENABLE)
+
+#if (CY_PSOC3)
+    #error The telemetry channel needs the 1 ms SysTick tick: PSoC 4 and PSoC 5LP only.
+#endif /* (CY_PSOC3) */
+
+#if (USBFS_MAX_INTERFACES_NUMBER < 2u)
+    #error The telemetry channel needs interface 1 and EP2 in the USBFS component: see telemetry.h.
+#endif /* (USBFS_MAX_INTERFACES_NUMBER < 2u) */
+
+
+/***************************************
+*    Constants
+****************************************/
+
+#define TELEMETRY_ENDPOINT      (2u)
+
+/* Report: report ID, length, stream bytes. */
+#define TELEMETRY_REPORT_SIZE   (64u)
+#define TELEMETRY_HEADER_SIZE   (2u)
+#define TELEMETRY_PAYLOAD       (TELEMETRY_REPORT_SIZE - TELEMETRY_HEADER_SIZE)
+
+/* Streams, in priority order: see telemetry.c for their report IDs and
+* rate limits.
+*/
+#define TELEMETRY_STREAMS       (3u)
+
+/* Ring size of a stream: a power of two. */
+#define TELEMETRY_RING_SIZE     (256u)
+#define TELEMETRY_RING_MASK     (TELEMETRY_RING_SIZE - 1u)
+
+/* Tokens a report takes from the rate limit of its stream. */
+#define TELEMETRY_RATE_UNIT     (1000u)
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Counters of one stream. */
+typedef struct
+{
+    uint32 bytes;               /* Bytes written. */
+    uint32 records;             /* Records written. */
+    uint32 dropped;             /* Records dropped: the ring was full. */
+    uint32 reports;             /* Reports sent. */
+} TELEMETRY_STATS;
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void  Telemetry_Start(void);
+uint8 Telemetry_Write(uint8 stream, const uint8 pData[], uint8 length);
+void  Telemetry_Tick(void);
+void  Telemetry_Send(void);
+
+extern TELEMETRY_STATS telemetryStats[TELEMETRY_STREAMS];
+
+#endif /* (TELEMETRY_ENABLE) */
+
+#endif /* (TELEMETRY_H) */
+
+
+/* [] END OF FILE */
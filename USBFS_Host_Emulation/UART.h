@@ -0,0 +1,128 @@
+/*******************************************************************************
+* File Name: UART.h
+*
+* Version: 1.0
+*
+* Description:
+*  Host stand-in for an SCB component in UART mode instantiated as UART, with
+*  RX and TX buffers the size of the FIFOs, the internal interrupt and the RTS
+*  and CTS signals, and its clock instantiated as UART_SCBCLK. The TX output
+*  is looped back to the RX input and the RTS output to the CTS input, so
+*  every byte the firmware sends is received again at the configured baud
+*  rate. UART_sim.c emulates the API.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(CY_SCB_UART_H)
+#define CY_SCB_UART_H
+
+#include "cytypes.h"
+
+
+/***************************************
+*    Component configuration
+****************************************/
+
+#define UART_FIFO_SIZE                      (8u)
+#define UART_UART_OVS_FACTOR                (16u)
+
+/* Clock of the SCB clock divider. */
+#define CYDEV_BCLK__HFCLK__HZ               (cydelay_freq_hz)
+
+
+/***************************************
+*    Registers
+****************************************/
+
+#define UART_TX_CTRL_REG                    (UART_simRegs[0u])
+#define UART_RX_CTRL_REG                    (UART_simRegs[1u])
+#define UART_UART_TX_CTRL_REG               (UART_simRegs[2u])
+#define UART_UART_RX_CTRL_REG               (UART_simRegs[3u])
+
+/* TX_CTRL and RX_CTRL: data width minus one. */
+#define UART_TX_CTRL_DATA_WIDTH_MASK        (0x0000000Fu)
+#define UART_RX_CTRL_DATA_WIDTH_MASK        (0x0000000Fu)
+
+/* UART_TX_CTRL and UART_RX_CTRL: stop bits in half bits minus one, parity
+* (set for odd) and parity enable.
+*/
+#define UART_UART_TX_CTRL_STOP_BITS_MASK    (0x00000007u)
+#define UART_UART_TX_CTRL_PARITY            (0x00000010u)
+#define UART_UART_TX_CTRL_PARITY_ENABLED    (0x00000020u)
+#define UART_UART_RX_CTRL_STOP_BITS_MASK    (0x00000007u)
+#define UART_UART_RX_CTRL_PARITY            (0x00000010u)
+#define UART_UART_RX_CTRL_PARITY_ENABLED    (0x00000020u)
+
+
+/***************************************
+*    Interrupt sources
+****************************************/
+
+#define UART_INTR_RX_TRIGGER                (0x00000001u)
+#define UART_INTR_RX_NOT_EMPTY              (0x00000004u)
+#define UART_INTR_RX_FULL                   (0x00000008u)
+#define UART_INTR_RX_OVERFLOW               (0x00000020u)
+#define UART_INTR_RX_FRAME_ERROR            (0x00000100u)
+#define UART_INTR_RX_PARITY_ERROR           (0x00000200u)
+#define UART_INTR_RX_BREAK_DETECT           (0x00000800u)
+
+#define UART_INTR_TX_TRIGGER                (0x00000001u)
+#define UART_INTR_TX_NOT_FULL               (0x00000002u)
+#define UART_INTR_TX_EMPTY                  (0x00000010u)
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void   UART_Start(void);
+void   UART_Enable(void);
+void   UART_Stop(void);
+void   UART_EnableInt(void);
+void   UART_DisableInt(void);
+void   UART_SetCustomInterruptHandler(cyisraddress func);
+
+void   UART_SetRxInterruptMode(uint32 interruptMask);
+void   UART_SetTxInterruptMode(uint32 interruptMask);
+uint32 UART_GetRxInterruptSourceMasked(void);
+uint32 UART_GetTxInterruptSourceMasked(void);
+void   UART_ClearRxInterruptSource(uint32 interruptMask);
+void   UART_ClearTxInterruptSource(uint32 interruptMask);
+void   UART_SetRxFifoLevel(uint32 level);
+void   UART_SetTxFifoLevel(uint32 level);
+
+uint32 UART_SpiUartReadRxData(void);
+void   UART_SpiUartWriteTxData(uint32 txData);
+uint32 UART_SpiUartGetRxBufferSize(void);
+uint32 UART_SpiUartGetTxBufferSize(void);
+
+void   UART_UartSetRtsFifoLevel(uint32 level);
+void   UART_UartEnableCts(void);
+void   UART_UartDisableCts(void);
+
+void   UART_SCBCLK_Start(void);
+void   UART_SCBCLK_Stop(void);
+void   UART_SCBCLK_SetFractionalDividerRegister(uint16 clkDivider, uint8 clkFractional);
+
+/* Emulation: the baud rate in use, the bytes received and the bytes lost
+* because the RX FIFO was full.
+*/
+uint32 UART_SimBaud(void);
+
+extern reg32  UART_simRegs[4u];
+extern uint32 UART_simBytes;
+extern uint32 UART_simOverflows;
+
+#endif /* (CY_SCB_UART_H) */
+
+
+/* [] END OF FILE */
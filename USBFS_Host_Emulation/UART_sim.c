@@ -0,0 +1,645 @@
+/*******************************************************************************
+* File Name: UART_sim.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host emulation of the SCB UART instance (UART.h), a loopback stand-in for
+*  a UART peer. A byte written to the TX FIFO is shifted out when the
+*  transmitter is idle and CTS is asserted, and is written to the RX FIFO one
+*  frame time later: start bit, data bits, parity bit and stop bits at the
+*  baud rate set by the clock divider. A byte that finds the RX FIFO full is
+*  lost and raises the RX overflow interrupt source. RTS is asserted while
+*  the RX FIFO holds fewer bytes than the RTS FIFO level, or always when the
+*  level is 0.
+*
+*  The interrupt sources that follow a FIFO level are recomputed on every
+*  change, and the custom interrupt handler is called while a masked source
+*  is active, as the level interrupt of the SCB does.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "project.h"
+#include "sim_bus.h"
+
+/* Baud rate before the firmware sets the clock divider. */
+#define UART_SIM_DEFAULT_BAUD   (115200u)
+
+/* Register reset values: 8 data bits, 1 stop bit, no parity. */
+#define UART_SIM_DATA_WIDTH_8   (7u)
+#define UART_SIM_STOP_BITS_1    (1u)
+
+reg32  UART_simRegs[4u] =
+{
+    UART_SIM_DATA_WIDTH_8, UART_SIM_DATA_WIDTH_8, UART_SIM_STOP_BITS_1, UART_SIM_STOP_BITS_1
+};
+uint32 UART_simBytes;
+uint32 UART_simOverflows;
+
+static uint8  uartSimTx[UART_FIFO_SIZE];
+static uint8  uartSimRx[UART_FIFO_SIZE];
+static uint32 uartSimTxCount;
+static uint32 uartSimRxCount;
+static uint8  uartSimShifter;
+static uint8  uartSimShifting;
+static uint8  uartSimEnabled;
+static uint8  uartSimIntEnabled;
+static uint8  uartSimIsrPending;
+static uint8  uartSimCts;
+static uint32 uartSimRtsLevel;
+static uint32 uartSimRxMask;
+static uint32 uartSimTxMask;
+static uint32 uartSimRxSticky;
+static uint32 uartSimRxLevel;
+static uint32 uartSimTxLevel;
+static uint32 uartSimDivider32;     /* Clock divider in 1/32 steps; 0 if not set. */
+static cyisraddress uartSimHandler;
+
+static uint32 UART_SimRxSource(void);
+static uint32 UART_SimTxSource(void);
+static void   UART_SimUpdate(void);
+static void   UART_SimKick(void);
+static void   UART_SimByteDone(uint32 arg);
+static void   UART_SimIsr(uint32 arg);
+
+
+/*******************************************************************************
+* Function Name: UART_SimRxSource
+********************************************************************************
+*
+* Summary:
+*  Returns the RX interrupt sources: the level sources computed from the RX
+*  FIFO and the sticky error sources.
+*
+*******************************************************************************/
+static uint32 UART_SimRxSource(void)
+{
+    uint32 source = uartSimRxSticky;
+
+    source |= (uartSimRxCount > uartSimRxLevel) ? UART_INTR_RX_TRIGGER : 0u;
+    source |= (0u != uartSimRxCount) ? UART_INTR_RX_NOT_EMPTY : 0u;
+    source |= (UART_FIFO_SIZE == uartSimRxCount) ? UART_INTR_RX_FULL : 0u;
+
+    return (source);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SimTxSource
+********************************************************************************
+*
+* Summary:
+*  Returns the TX interrupt sources computed from the TX FIFO.
+*
+*******************************************************************************/
+static uint32 UART_SimTxSource(void)
+{
+    uint32 source = 0u;
+
+    source |= (uartSimTxCount < uartSimTxLevel) ? UART_INTR_TX_TRIGGER : 0u;
+    source |= (uartSimTxCount < UART_FIFO_SIZE) ? UART_INTR_TX_NOT_FULL : 0u;
+    source |= (0u == uartSimTxCount) ? UART_INTR_TX_EMPTY : 0u;
+
+    return (source);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SimUpdate
+********************************************************************************
+*
+* Summary:
+*  Raises the interrupt when a masked source is active.
+*
+*******************************************************************************/
+static void UART_SimUpdate(void)
+{
+    if ((0u != uartSimIntEnabled) && (0u == uartSimIsrPending) && (NULL != uartSimHandler) &&
+        ((0u != (UART_SimRxSource() & uartSimRxMask)) ||
+         (0u != (UART_SimTxSource() & uartSimTxMask))))
+    {
+        uartSimIsrPending = Sim_Schedule(0u, &UART_SimIsr, 0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SimIsr
+********************************************************************************
+*
+* Summary:
+*  SCB interrupt: calls the custom interrupt handler.
+*
+*******************************************************************************/
+static void UART_SimIsr(uint32 arg)
+{
+    CY_UNUSED_PARAMETER(arg);
+
+    if (0u != uartSimIntEnabled)
+    {
+        uartSimHandler();
+    }
+
+    /* The interrupt is level sensitive: it is raised again on return if a
+    * masked source is still active.
+    */
+    uartSimIsrPending = 0u;
+    UART_SimUpdate();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SimBaud
+********************************************************************************
+*
+* Summary:
+*  Returns the baud rate set by the clock divider and the oversampling.
+*
+*******************************************************************************/
+uint32 UART_SimBaud(void)
+{
+    return ((0u == uartSimDivider32) ? UART_SIM_DEFAULT_BAUD :
+            (uint32) (((uint64) cydelay_freq_hz * 32u) /
+                      ((uint64) uartSimDivider32 * UART_UART_OVS_FACTOR)));
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SimKick
+********************************************************************************
+*
+* Summary:
+*  Starts shifting out the next byte of the TX FIFO when the transmitter is
+*  idle and CTS, if enabled, is asserted. The frame time follows the TX
+*  frame format.
+*
+*******************************************************************************/
+static void UART_SimKick(void)
+{
+    uint32 halfBits;
+    uint8  rts;
+
+    rts = ((0u == uartSimRtsLevel) || (uartSimRxCount < uartSimRtsLevel)) ? 1u : 0u;
+
+    if ((0u != uartSimEnabled) && (0u == uartSimShifting) && (0u != uartSimTxCount) &&
+        ((0u == uartSimCts) || (0u != rts)))
+    {
+        uartSimShifter = uartSimTx[0u];
+        --uartSimTxCount;
+        (void) memmove(uartSimTx, &uartSimTx[1u], uartSimTxCount);
+
+        /* Start bit, data bits and parity bit, then the stop half bits. */
+        halfBits = 2u * (1u + (UART_TX_CTRL_REG & UART_TX_CTRL_DATA_WIDTH_MASK) + 1u +
+                         ((0u != (UART_UART_TX_CTRL_REG & UART_UART_TX_CTRL_PARITY_ENABLED)) ? 1u : 0u));
+        halfBits += (UART_UART_TX_CTRL_REG & UART_UART_TX_CTRL_STOP_BITS_MASK) + 1u;
+
+        uartSimShifting = Sim_ScheduleHw(((uint64) halfBits * 1000000000u) / (2u * (uint64) UART_SimBaud()),
+                                         &UART_SimByteDone, 0u);
+        UART_SimUpdate();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SimByteDone
+********************************************************************************
+*
+* Summary:
+*  End of a frame: the byte arrives at the RX FIFO, or is lost if it is full.
+*  Data bits beyond the RX data width are dropped.
+*
+*******************************************************************************/
+static void UART_SimByteDone(uint32 arg)
+{
+    uint32 mask = (1u << ((UART_RX_CTRL_REG & UART_RX_CTRL_DATA_WIDTH_MASK) + 1u)) - 1u;
+
+    CY_UNUSED_PARAMETER(arg);
+
+    uartSimShifting = 0u;
+    ++UART_simBytes;
+
+    if (uartSimRxCount < UART_FIFO_SIZE)
+    {
+        uartSimRx[uartSimRxCount] = (uint8) (uartSimShifter & mask);
+        ++uartSimRxCount;
+    }
+    else
+    {
+        uartSimRxSticky |= UART_INTR_RX_OVERFLOW;
+        ++UART_simOverflows;
+    }
+
+    UART_SimKick();
+    UART_SimUpdate();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_Start
+********************************************************************************
+*
+* Summary:
+*  Enables the SCB and its interrupt.
+*
+*******************************************************************************/
+void UART_Start(void)
+{
+    UART_Enable();
+    UART_EnableInt();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_Enable
+********************************************************************************
+*
+* Summary:
+*  Enables the SCB.
+*
+*******************************************************************************/
+void UART_Enable(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+    uartSimEnabled = 1u;
+    UART_SimKick();
+    UART_SimUpdate();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_Stop
+********************************************************************************
+*
+* Summary:
+*  Disables the SCB. The FIFOs are cleared and a byte being shifted is lost.
+*
+*******************************************************************************/
+void UART_Stop(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+    Sim_Cancel(&UART_SimByteDone);
+    uartSimEnabled  = 0u;
+    uartSimShifting = 0u;
+    uartSimTxCount  = 0u;
+    uartSimRxCount  = 0u;
+    uartSimRxSticky = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: UART_EnableInt
+********************************************************************************
+*
+* Summary:
+*  Enables the SCB interrupt.
+*
+*******************************************************************************/
+void UART_EnableInt(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimIntEnabled = 1u;
+    UART_SimUpdate();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_DisableInt
+********************************************************************************
+*
+* Summary:
+*  Disables the SCB interrupt.
+*
+*******************************************************************************/
+void UART_DisableInt(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimIntEnabled = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SetCustomInterruptHandler
+********************************************************************************
+*
+* Summary:
+*  Sets the function the SCB interrupt calls.
+*
+*******************************************************************************/
+void UART_SetCustomInterruptHandler(cyisraddress func)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+    uartSimHandler = func;
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SetRxInterruptMode
+********************************************************************************
+*
+* Summary:
+*  Sets the RX interrupt sources that raise the interrupt.
+*
+*******************************************************************************/
+void UART_SetRxInterruptMode(uint32 interruptMask)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimRxMask = interruptMask;
+    UART_SimUpdate();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SetTxInterruptMode
+********************************************************************************
+*
+* Summary:
+*  Sets the TX interrupt sources that raise the interrupt.
+*
+*******************************************************************************/
+void UART_SetTxInterruptMode(uint32 interruptMask)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimTxMask = interruptMask;
+    UART_SimUpdate();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_GetRxInterruptSourceMasked
+********************************************************************************
+*
+* Summary:
+*  Returns the active RX interrupt sources that raise the interrupt.
+*
+*******************************************************************************/
+uint32 UART_GetRxInterruptSourceMasked(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+
+    return (UART_SimRxSource() & uartSimRxMask);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_GetTxInterruptSourceMasked
+********************************************************************************
+*
+* Summary:
+*  Returns the active TX interrupt sources that raise the interrupt.
+*
+*******************************************************************************/
+uint32 UART_GetTxInterruptSourceMasked(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+
+    return (UART_SimTxSource() & uartSimTxMask);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_ClearRxInterruptSource
+********************************************************************************
+*
+* Summary:
+*  Clears RX interrupt sources. A level source stays active while its
+*  condition holds.
+*
+*******************************************************************************/
+void UART_ClearRxInterruptSource(uint32 interruptMask)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimRxSticky &= ~interruptMask;
+}
+
+
+/*******************************************************************************
+* Function Name: UART_ClearTxInterruptSource
+********************************************************************************
+*
+* Summary:
+*  Clears TX interrupt sources. The emulated TX sources all follow the FIFO
+*  level, so they stay active while their condition holds.
+*
+*******************************************************************************/
+void UART_ClearTxInterruptSource(uint32 interruptMask)
+{
+    CY_UNUSED_PARAMETER(interruptMask);
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SetRxFifoLevel
+********************************************************************************
+*
+* Summary:
+*  Sets the RX FIFO level above which the RX trigger source is active.
+*
+*******************************************************************************/
+void UART_SetRxFifoLevel(uint32 level)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimRxLevel = level;
+    UART_SimUpdate();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SetTxFifoLevel
+********************************************************************************
+*
+* Summary:
+*  Sets the TX FIFO level below which the TX trigger source is active.
+*
+*******************************************************************************/
+void UART_SetTxFifoLevel(uint32 level)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimTxLevel = level;
+    UART_SimUpdate();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SpiUartReadRxData
+********************************************************************************
+*
+* Summary:
+*  Reads the next byte of the RX FIFO; 0 if it is empty.
+*
+*******************************************************************************/
+uint32 UART_SpiUartReadRxData(void)
+{
+    uint32 data = 0u;
+
+    Sim_Step(SIM_REG_CYCLES);
+
+    if (0u != uartSimRxCount)
+    {
+        data = uartSimRx[0u];
+        --uartSimRxCount;
+        (void) memmove(uartSimRx, &uartSimRx[1u], uartSimRxCount);
+
+        /* RTS may be asserted again. */
+        UART_SimKick();
+    }
+
+    return (data);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SpiUartWriteTxData
+********************************************************************************
+*
+* Summary:
+*  Writes a byte to the TX FIFO. The byte is dropped if the FIFO is full.
+*
+*******************************************************************************/
+void UART_SpiUartWriteTxData(uint32 txData)
+{
+    Sim_Step(SIM_REG_CYCLES);
+
+    if (uartSimTxCount < UART_FIFO_SIZE)
+    {
+        uartSimTx[uartSimTxCount] = (uint8) txData;
+        ++uartSimTxCount;
+        UART_SimKick();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SpiUartGetRxBufferSize
+********************************************************************************
+*
+* Summary:
+*  Returns the number of bytes in the RX FIFO.
+*
+*******************************************************************************/
+uint32 UART_SpiUartGetRxBufferSize(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+
+    return (uartSimRxCount);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SpiUartGetTxBufferSize
+********************************************************************************
+*
+* Summary:
+*  Returns the number of bytes in the TX FIFO.
+*
+*******************************************************************************/
+uint32 UART_SpiUartGetTxBufferSize(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+
+    return (uartSimTxCount);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_UartSetRtsFifoLevel
+********************************************************************************
+*
+* Summary:
+*  Sets the RX FIFO level at which RTS is deasserted; 0 keeps it asserted.
+*
+*******************************************************************************/
+void UART_UartSetRtsFifoLevel(uint32 level)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimRtsLevel = level;
+    UART_SimKick();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_UartEnableCts
+********************************************************************************
+*
+* Summary:
+*  The transmitter waits for CTS before each byte.
+*
+*******************************************************************************/
+void UART_UartEnableCts(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimCts = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: UART_UartDisableCts
+********************************************************************************
+*
+* Summary:
+*  The transmitter ignores CTS.
+*
+*******************************************************************************/
+void UART_UartDisableCts(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimCts = 0u;
+    UART_SimKick();
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SCBCLK_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the SCB clock. The emulated clock always runs.
+*
+*******************************************************************************/
+void UART_SCBCLK_Start(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SCBCLK_Stop
+********************************************************************************
+*
+* Summary:
+*  Stops the SCB clock. The emulated clock always runs.
+*
+*******************************************************************************/
+void UART_SCBCLK_Stop(void)
+{
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SCBCLK_SetFractionalDividerRegister
+********************************************************************************
+*
+* Summary:
+*  Sets the divider of the SCB clock: clkDivider + 1 + clkFractional / 32.
+*
+*******************************************************************************/
+void UART_SCBCLK_SetFractionalDividerRegister(uint16 clkDivider, uint8 clkFractional)
+{
+    Sim_Step(SIM_REG_CYCLES);
+    uartSimDivider32 = (((uint32) clkDivider + 1u) * 32u) + (clkFractional & 0x1Fu);
+}
+
+
+/* [] END OF FILE */
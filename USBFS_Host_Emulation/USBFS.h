@@ -0,0 +1,229 @@
+/*******************************************************************************
+* File Name: USBFS.h
+*
+* Version: 1.0
+*
+* Description:
+*  Host stand-in for the generated USBFS component header (USBFS v3.10 API).
+*  Only the subset of the API used by the code examples is provided. The
+*  endpoint state machine behind it is implemented in USBFS_sim.c on top of
+*  the simulated bus in sim_bus.c.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(CY_USBFS_USBFS_H)
+#define CY_USBFS_USBFS_H
+
+#include "cytypes.h"
+
+/* Searched on the include path so the cyapicallbacks.h of the example project
+* takes precedence over the empty one of the emulation.
+*/
+#include <cyapicallbacks.h>
+
+
+/***************************************
+*    Customizer parameters
+****************************************/
+
+#define USBFS_TRUE                      (1u)
+#define USBFS_FALSE                     (0u)
+
+#define USBFS_MAX_EP                    (9u)
+#define USBFS_MAX_INTERFACES_NUMBER     (2u)
+#define USBFS_EP0_SIZE                  (8u)
+
+/* Endpoint memory management: select with -DUSBFS_SIM_EP_MM=<value>. */
+#define USBFS__EP_MANUAL                (0u)
+#define USBFS__EP_DMAMANUAL             (1u)
+#define USBFS__EP_DMAAUTO               (2u)
+
+#if !defined(USBFS_SIM_EP_MM)
+    #define USBFS_SIM_EP_MM             (USBFS__EP_MANUAL)
+#endif /* !defined(USBFS_SIM_EP_MM) */
+
+#define USBFS_EP_MM                     (USBFS_SIM_EP_MM)
+#define USBFS_EP_MANAGEMENT_MANUAL      (USBFS_EP_MM == USBFS__EP_MANUAL)
+#define USBFS_EP_MANAGEMENT_DMA_MANUAL  (USBFS_EP_MM == USBFS__EP_DMAMANUAL)
+#define USBFS_EP_MANAGEMENT_DMA_AUTO    (USBFS_EP_MM == USBFS__EP_DMAAUTO)
+#define USBFS_EP_MANAGEMENT_DMA         (USBFS_EP_MANAGEMENT_DMA_MANUAL || \
+                                         USBFS_EP_MANAGEMENT_DMA_AUTO)
+
+/* 16-bit endpoint access APIs: select with -DUSBFS_GEN_16BITS_EP_ACCESS=1u. */
+#if !defined(USBFS_GEN_16BITS_EP_ACCESS)
+    #define USBFS_GEN_16BITS_EP_ACCESS  (0u)
+#endif /* !defined(USBFS_GEN_16BITS_EP_ACCESS) */
+
+#define USBFS_16BITS_EP_ACCESS_ENABLE   ((0u != USBFS_GEN_16BITS_EP_ACCESS) && \
+                                         USBFS_EP_MANAGEMENT_DMA)
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+typedef struct
+{
+    uint8  attrib;
+    uint8  apiEpState;
+    uint8  hwEpState;
+    uint8  epToggle;
+    uint8  addr;
+    uint8  epMode;
+    uint16 buffOffset;
+    uint16 bufferSize;
+    uint8  interface;
+} T_USBFS_EP_CTL_BLOCK;
+
+/* Arbiter registers of an endpoint: only the data register is modelled. */
+typedef struct
+{
+    reg32 rwDr;
+} T_USBFS_ARB_EP;
+
+typedef struct
+{
+    T_USBFS_ARB_EP arbEp[USBFS_MAX_EP];
+} T_USBFS_ARB_EPS;
+
+typedef struct
+{
+    volatile uint8 *pData;
+    volatile T_USBFS_EP_CTL_BLOCK *pStatusBlock;
+    uint16 count;
+} T_USBFS_TD;
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void   USBFS_Start(uint8 device, uint8 mode);
+void   USBFS_Init(void);
+void   USBFS_InitComponent(uint8 device, uint8 mode);
+void   USBFS_Stop(void);
+void   USBFS_ConfigReg(void);
+uint8  USBFS_CheckActivity(void);
+uint8  USBFS_GetConfiguration(void);
+uint8  USBFS_IsConfigurationChanged(void);
+uint8  USBFS_GetInterfaceSetting(uint8 interfaceNumber);
+uint8  USBFS_GetDeviceAddress(void);
+uint8  USBFS_GetEPState(uint8 epNumber);
+uint16 USBFS_GetEPCount(uint8 epNumber);
+uint8  USBFS_GetEPAckState(uint8 epNumber);
+void   USBFS_EnableOutEP(uint8 epNumber);
+void   USBFS_DisableOutEP(uint8 epNumber);
+void   USBFS_LoadInEP(uint8 epNumber, const uint8 pData[], uint16 length);
+uint16 USBFS_ReadOutEP(uint8 epNumber, uint8 pData[], uint16 length);
+void   USBFS_SetPowerStatus(uint8 powerStatus);
+void   USBFS_SerialNumString(uint8 snString[]);
+void   USBFS_Suspend(void);
+void   USBFS_Resume(void);
+uint32 USBFS_Lpm_GetBeslValue(void);
+
+uint8  USBFS_InitControlRead(void);
+uint8  USBFS_InitControlWrite(void);
+uint8  USBFS_InitNoDataControlTransfer(void);
+uint8  USBFS_HandleVendorRqst(void);
+
+#if defined(USBFS_HANDLE_VENDOR_RQST_CALLBACK)
+    uint8 USBFS_HandleVendorRqst_Callback(void);
+#endif /* (USBFS_HANDLE_VENDOR_RQST_CALLBACK) */
+
+#if (USBFS_16BITS_EP_ACCESS_ENABLE)
+    void   USBFS_LoadInEP16 (uint8 epNumber, const uint8 pData[], uint16 length);
+    uint16 USBFS_ReadOutEP16(uint8 epNumber,       uint8 pData[], uint16 length);
+#endif /* (USBFS_16BITS_EP_ACCESS_ENABLE) */
+
+
+/***************************************
+*    External data references
+****************************************/
+
+extern uint8 USBFS_initVar;
+extern volatile uint8 USBFS_configuration;
+extern volatile uint8 USBFS_configurationChanged;
+extern volatile uint8 USBFS_interfaceSetting[USBFS_MAX_INTERFACES_NUMBER];
+extern volatile uint8 USBFS_interfaceSettingLast[USBFS_MAX_INTERFACES_NUMBER];
+extern volatile T_USBFS_EP_CTL_BLOCK USBFS_EP[USBFS_MAX_EP];
+extern volatile T_USBFS_TD USBFS_currentTD;
+extern T_USBFS_ARB_EPS USBFS_simArbEp;
+extern reg8  USBFS_simSetup[8u];
+extern reg32 USBFS_simCr0;
+
+
+/***************************************
+*    API Constants
+****************************************/
+
+#define USBFS_3V_OPERATION              (0x00u)
+#define USBFS_5V_OPERATION              (0x01u)
+#define USBFS_DWR_POWER_OPERATION       (0x02u)
+
+#define USBFS_DEVICE_STATUS_BUS_POWERED (0x00u)
+#define USBFS_DEVICE_STATUS_SELF_POWERED (0x01u)
+
+/* Endpoint states returned by USBFS_GetEPState(). */
+#define USBFS_NO_EVENT_ALLOWED          (2u)
+#define USBFS_EVENT_PENDING             (1u)
+#define USBFS_NO_EVENT_PENDING          (0u)
+
+#define USBFS_IN_BUFFER_FULL            (USBFS_NO_EVENT_PENDING)
+#define USBFS_IN_BUFFER_EMPTY           (USBFS_EVENT_PENDING)
+#define USBFS_OUT_BUFFER_FULL           (USBFS_EVENT_PENDING)
+#define USBFS_OUT_BUFFER_EMPTY          (USBFS_NO_EVENT_PENDING)
+
+#define USBFS_DIR_IN                    (0x80u)
+#define USBFS_DIR_OUT                   (0x00u)
+
+/* Control request fields (bmRequestType). */
+#define USBFS_RQST_DIR_MASK             (0x80u)
+#define USBFS_RQST_DIR_D2H              (0x80u)
+#define USBFS_RQST_DIR_H2D              (0x00u)
+#define USBFS_RQST_TYPE_MASK            (0x60u)
+#define USBFS_RQST_TYPE_STD             (0x00u)
+#define USBFS_RQST_TYPE_CLS             (0x20u)
+#define USBFS_RQST_TYPE_VND             (0x40u)
+#define USBFS_RQST_RCPT_MASK            (0x03u)
+#define USBFS_RQST_RCPT_DEV             (0x00u)
+#define USBFS_RQST_RCPT_IFC             (0x01u)
+#define USBFS_RQST_RCPT_EP              (0x02u)
+
+
+/***************************************
+*    Registers
+****************************************/
+
+/* Setup packet of the control transfer in progress. */
+#define USBFS_bmRequestTypeReg          (USBFS_simSetup[0u])
+#define USBFS_bRequestReg               (USBFS_simSetup[1u])
+#define USBFS_wValueLoReg               (USBFS_simSetup[2u])
+#define USBFS_wValueHiReg               (USBFS_simSetup[3u])
+#define USBFS_wIndexLoReg               (USBFS_simSetup[4u])
+#define USBFS_wIndexHiReg               (USBFS_simSetup[5u])
+#define USBFS_wLengthLoReg              (USBFS_simSetup[6u])
+#define USBFS_wLengthHiReg              (USBFS_simSetup[7u])
+
+/* Arbiter data register of an endpoint: access it with CY_SET_REG8() and
+* CY_GET_REG8(). Each access moves the arbiter pointer to the next byte of the
+* endpoint buffer; the pointer is reset when a transaction completes.
+*/
+#define USBFS_ARB_EP_BASE               (USBFS_simArbEp)
+
+#define USBFS_CR0_REG                   (USBFS_simCr0)
+#define USBFS_CR0_DEVICE_ADDRESS_MASK   (0x7Fu)
+#define USBFS_CR0_ENABLE                (0x80u)
+
+#endif /* (CY_USBFS_USBFS_H) */
+
+
+/* [] END OF FILE */
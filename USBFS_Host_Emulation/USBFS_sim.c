@@ -0,0 +1,1014 @@
+/*******************************************************************************
+* File Name: USBFS_sim.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host emulation of the USBFS component endpoint API. The endpoint state
+*  machine follows the USBFS v3.10 manual and DMA endpoint memory management
+*  modes: the apiEpState of an endpoint is updated by the endpoint interrupt
+*  and by the ReadOutEP/LoadInEP/EnableOutEP calls, exactly as on the device.
+*  The cyapicallbacks.h hooks of the example project are called from the
+*  emulated interrupts.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "project.h"
+#include "sim_bus.h"
+
+uint8 USBFS_initVar = 0u;
+volatile uint8 USBFS_configuration;
+volatile uint8 USBFS_configurationChanged;
+volatile uint8 USBFS_interfaceSetting[USBFS_MAX_INTERFACES_NUMBER];
+volatile uint8 USBFS_interfaceSettingLast[USBFS_MAX_INTERFACES_NUMBER];
+volatile T_USBFS_EP_CTL_BLOCK USBFS_EP[USBFS_MAX_EP];
+volatile T_USBFS_TD USBFS_currentTD;
+T_USBFS_ARB_EPS USBFS_simArbEp;
+reg8  USBFS_simSetup[8u];
+reg32 USBFS_simCr0;
+
+static uint8 *USBFS_serialNumString;
+static uint32 USBFS_beslValue;
+static uint8 USBFS_controlDir;
+
+static void  USBFS_SimBusReset(void);
+static void  USBFS_SimSetConfiguration(uint8 configuration);
+static void  USBFS_SimEpIsr(uint8 epNumber);
+static void  USBFS_SimSofIsr(void);
+static void  USBFS_SimLpmIsr(uint32 besl);
+static uint8 USBFS_SimControl(const uint8 setup[], uint8 data[], uint16 *length);
+static void  USBFS_SimEpCallback(uint8 epNumber, uint8 exitCallback);
+
+#if (USBFS_EP_MANAGEMENT_DMA_MANUAL)
+    static void USBFS_SimDmaDone(uint32 arg);
+#endif /* (USBFS_EP_MANAGEMENT_DMA_MANUAL) */
+
+static const SIM_DEVICE USBFS_simDevice =
+{
+    &USBFS_SimBusReset,
+    &USBFS_SimSetConfiguration,
+    &USBFS_SimEpIsr,
+    &USBFS_SimSofIsr,
+    &USBFS_SimLpmIsr,
+    &USBFS_SimControl,
+};
+
+
+/*******************************************************************************
+* Function Name: USBFS_Start
+********************************************************************************
+*
+* Summary:
+*  Initializes the component and connects the device to the bus.
+*
+*******************************************************************************/
+void USBFS_Start(uint8 device, uint8 mode)
+{
+    if (0u == USBFS_initVar)
+    {
+        USBFS_Init();
+        USBFS_initVar = 1u;
+    }
+
+    USBFS_InitComponent(device, mode);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_Init
+********************************************************************************
+*
+* Summary:
+*  Resets the component state and attaches it to the simulated bus.
+*
+*******************************************************************************/
+void USBFS_Init(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    USBFS_configuration = 0u;
+    USBFS_configurationChanged = 0u;
+    (void) memset((void *) USBFS_EP, 0, sizeof(USBFS_EP));
+    (void) memset((void *) USBFS_interfaceSetting, 0, sizeof(USBFS_interfaceSetting));
+    (void) memset((void *) USBFS_interfaceSettingLast, 0, sizeof(USBFS_interfaceSettingLast));
+    USBFS_simCr0 = 0u;
+
+    Sim_Attach(&USBFS_simDevice);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_InitComponent
+********************************************************************************
+*
+* Summary:
+*  Enables the Dp pull-up. The host enumerates the device unless it wakes up
+*  from hibernate, where the configuration is restored by the application.
+*
+*******************************************************************************/
+void USBFS_InitComponent(uint8 device, uint8 mode)
+{
+    CY_UNUSED_PARAMETER(device);
+    CY_UNUSED_PARAMETER(mode);
+
+    Sim_Step(SIM_API_CALL_CYCLES);
+    Sim_Connect((CY_PM_RESET_REASON_WAKEUP_HIB != Sim_resetReason) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_Stop
+********************************************************************************
+*
+* Summary:
+*  Disables the component.
+*
+*******************************************************************************/
+void USBFS_Stop(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+    USBFS_configuration = 0u;
+    USBFS_initVar = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_ConfigReg
+********************************************************************************
+*
+* Summary:
+*  Configures the endpoints of the active configuration: IN endpoints are
+*  empty and OUT endpoints NAK until the application enables them.
+*
+*******************************************************************************/
+void USBFS_ConfigReg(void)
+{
+    uint8 ep;
+
+    for (ep = 1u; ep < USBFS_MAX_EP; ++ep)
+    {
+        if (SIM_EP_TYPE_NONE == Sim_ep[ep].type)
+        {
+            USBFS_EP[ep].apiEpState = USBFS_NO_EVENT_ALLOWED;
+        }
+        else if (0u != Sim_ep[ep].dirIn)
+        {
+            USBFS_EP[ep].addr = (uint8) (USBFS_DIR_IN | ep);
+            USBFS_EP[ep].apiEpState = USBFS_IN_BUFFER_EMPTY;
+        }
+        else
+        {
+            USBFS_EP[ep].addr = (uint8) (USBFS_DIR_OUT | ep);
+            USBFS_EP[ep].apiEpState = USBFS_OUT_BUFFER_EMPTY;
+        }
+
+        USBFS_EP[ep].attrib = Sim_ep[ep].type;
+        USBFS_EP[ep].bufferSize = Sim_ep[ep].maxPacket;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_CheckActivity
+********************************************************************************
+*
+* Summary:
+*  Returns the bus activity since the last call and clears it.
+*
+*******************************************************************************/
+uint8 USBFS_CheckActivity(void)
+{
+    uint8 activity;
+
+    Sim_Step(SIM_API_CALL_CYCLES);
+    activity = Sim_busActivity;
+    Sim_busActivity = 0u;
+
+    return (activity);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_GetConfiguration
+********************************************************************************
+*
+* Summary:
+*  Returns the current configuration set by the host.
+*
+*******************************************************************************/
+uint8 USBFS_GetConfiguration(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (USBFS_configuration);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_IsConfigurationChanged
+********************************************************************************
+*
+* Summary:
+*  Returns non-zero once after the host sets a configuration or interface.
+*
+*******************************************************************************/
+uint8 USBFS_IsConfigurationChanged(void)
+{
+    uint8 changed;
+
+    Sim_Step(SIM_API_CALL_CYCLES);
+    changed = USBFS_configurationChanged;
+    USBFS_configurationChanged = 0u;
+
+    return (changed);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_GetInterfaceSetting
+********************************************************************************
+*
+* Summary:
+*  Returns the alternate setting of an interface.
+*
+*******************************************************************************/
+uint8 USBFS_GetInterfaceSetting(uint8 interfaceNumber)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (USBFS_interfaceSetting[interfaceNumber]);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_GetDeviceAddress
+********************************************************************************
+*
+* Summary:
+*  Returns the device address assigned by the host.
+*
+*******************************************************************************/
+uint8 USBFS_GetDeviceAddress(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return ((uint8) (USBFS_CR0_REG & USBFS_CR0_DEVICE_ADDRESS_MASK));
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_GetEPState
+********************************************************************************
+*
+* Summary:
+*  Returns the API state of an endpoint.
+*
+*******************************************************************************/
+uint8 USBFS_GetEPState(uint8 epNumber)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (USBFS_EP[epNumber].apiEpState);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_GetEPCount
+********************************************************************************
+*
+* Summary:
+*  Returns the number of bytes received in an OUT endpoint buffer.
+*
+*******************************************************************************/
+uint16 USBFS_GetEPCount(uint8 epNumber)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (Sim_ep[epNumber].count);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_GetEPAckState
+********************************************************************************
+*
+* Summary:
+*  Returns non-zero if the last loaded IN packet was ACKed by the host.
+*
+*******************************************************************************/
+uint8 USBFS_GetEPAckState(uint8 epNumber)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (Sim_ep[epNumber].ackd);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_EnableOutEP
+********************************************************************************
+*
+* Summary:
+*  Arms an OUT endpoint to ACK the next packet from the host.
+*
+*******************************************************************************/
+void USBFS_EnableOutEP(uint8 epNumber)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    if ((epNumber > 0u) && (epNumber < USBFS_MAX_EP))
+    {
+        USBFS_EP[epNumber].apiEpState = USBFS_NO_EVENT_PENDING;
+        Sim_ep[epNumber].armed = 1u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_DisableOutEP
+********************************************************************************
+*
+* Summary:
+*  Makes an OUT endpoint NAK the host.
+*
+*******************************************************************************/
+void USBFS_DisableOutEP(uint8 epNumber)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    if ((epNumber > 0u) && (epNumber < USBFS_MAX_EP))
+    {
+        Sim_ep[epNumber].armed = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_LoadInEP
+********************************************************************************
+*
+* Summary:
+*  Copies data into the IN endpoint buffer and arms the endpoint. In manual
+*  mode the data is written a byte at a time to the arbiter data register, and
+*  a NULL pData only sets the count of the data the firmware has written there.
+*  In DMA manual mode the endpoint is armed when the DMA transfer completes. In
+*  DMA auto mode no data is copied: the DMA reads pData while the host reads
+*  the endpoint, and a NULL pData keeps the buffer of the previous call.
+*
+*******************************************************************************/
+void USBFS_LoadInEP(uint8 epNumber, const uint8 pData[], uint16 length)
+{
+    SIM_EP *ep;
+#if (USBFS_EP_MANAGEMENT_MANUAL)
+    uint16 i;
+#endif /* (USBFS_EP_MANAGEMENT_MANUAL) */
+
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    if ((epNumber == 0u) || (epNumber >= USBFS_MAX_EP))
+    {
+        return;
+    }
+
+    ep = &Sim_ep[epNumber];
+    length = (length > ep->maxPacket) ? ep->maxPacket : length;
+
+#if (USBFS_EP_MANAGEMENT_DMA_AUTO)
+    if (NULL != pData)
+    {
+        ep->dmaBuffer = (uint8 *) pData;
+        ep->dmaLength = length;
+    }
+#elif (USBFS_EP_MANAGEMENT_MANUAL)
+    if (NULL != pData)
+    {
+        ep->arbPtr = 0u;
+        for (i = 0u; i < length; ++i)
+        {
+            CY_SET_REG8(&USBFS_ARB_EP_BASE.arbEp[epNumber].rwDr, pData[i]);
+        }
+    }
+#else
+    if ((NULL != pData) && (0u != length))
+    {
+        (void) memcpy(ep->buffer, pData, length);
+    }
+#endif /* (USBFS_EP_MANAGEMENT_DMA_AUTO) */
+
+    ep->count = length;
+    ep->ackd  = 0u;
+    USBFS_EP[epNumber].apiEpState = USBFS_NO_EVENT_PENDING;
+
+#if (USBFS_EP_MANAGEMENT_MANUAL)
+    ep->armed = 1u;
+#elif (USBFS_EP_MANAGEMENT_DMA_AUTO)
+    Sim_Step(SIM_DMA_SETUP_CYCLES);
+    ep->armed = 1u;
+#else
+    Sim_Step(SIM_DMA_SETUP_CYCLES);
+    (void) Sim_Schedule(Sim_CyclesToNs((uint32) length * SIM_DMA_CYCLES_PER_BYTE),
+                        &USBFS_SimDmaDone, epNumber);
+#endif /* (USBFS_EP_MANAGEMENT_MANUAL) */
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_ReadOutEP
+********************************************************************************
+*
+* Summary:
+*  Copies data from the OUT endpoint buffer. In manual mode the data is read a
+*  byte at a time from the arbiter data register and the endpoint is re-armed
+*  on return. In DMA manual mode the endpoint stays OUT_BUFFER_FULL until the
+*  DMA transfer completes and the firmware re-arms it with
+*  USBFS_EnableOutEP(). In DMA auto mode no data is copied: the call sets the
+*  SRAM buffer that receives the following OUT packets while the host sends
+*  them, and returns 0.
+*
+*******************************************************************************/
+uint16 USBFS_ReadOutEP(uint8 epNumber, uint8 pData[], uint16 length)
+{
+    SIM_EP *ep;
+#if (USBFS_EP_MANAGEMENT_MANUAL)
+    uint16 i;
+#endif /* (USBFS_EP_MANAGEMENT_MANUAL) */
+
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    if ((epNumber == 0u) || (epNumber >= USBFS_MAX_EP) || (NULL == pData))
+    {
+        return (0u);
+    }
+
+    ep = &Sim_ep[epNumber];
+
+#if (USBFS_EP_MANAGEMENT_DMA_AUTO)
+    ep->dmaBuffer = pData;
+    ep->dmaLength = length;
+    Sim_Step(SIM_DMA_SETUP_CYCLES);
+    length = 0u;
+#else
+    length = (length > ep->count) ? ep->count : length;
+
+#if (USBFS_EP_MANAGEMENT_MANUAL)
+    ep->arbPtr = 0u;
+    for (i = 0u; i < length; ++i)
+    {
+        pData[i] = CY_GET_REG8(&USBFS_ARB_EP_BASE.arbEp[epNumber].rwDr);
+    }
+    USBFS_EP[epNumber].apiEpState = USBFS_NO_EVENT_PENDING;
+    ep->armed = 1u;
+#else
+    (void) memcpy(pData, ep->buffer, length);
+    Sim_Step(SIM_DMA_SETUP_CYCLES);
+    (void) Sim_Schedule(Sim_CyclesToNs((uint32) length * SIM_DMA_CYCLES_PER_BYTE),
+                        &USBFS_SimDmaDone, epNumber);
+#endif /* (USBFS_EP_MANAGEMENT_MANUAL) */
+#endif /* (USBFS_EP_MANAGEMENT_DMA_AUTO) */
+
+    return (length);
+}
+
+
+/*******************************************************************************
+* Function Name: CySimSetReg8
+********************************************************************************
+*
+* Summary:
+*  8-bit register write. A write to the arbiter data register of an endpoint
+*  stores the byte at the arbiter pointer and advances the pointer; bytes
+*  past the end of the buffer are dropped. Any other address is memory.
+*
+*******************************************************************************/
+void CySimSetReg8(reg8 *addr, uint8 value)
+{
+    uint8 epNumber;
+
+    Sim_Step(SIM_REG_CYCLES);
+
+    for (epNumber = 1u; epNumber < USBFS_MAX_EP; ++epNumber)
+    {
+        if (addr == (reg8 *) &USBFS_simArbEp.arbEp[epNumber].rwDr)
+        {
+            if (Sim_ep[epNumber].arbPtr < SIM_EP_MAX_PACKET)
+            {
+                Sim_ep[epNumber].buffer[Sim_ep[epNumber].arbPtr] = value;
+                ++Sim_ep[epNumber].arbPtr;
+            }
+            return;
+        }
+    }
+
+    *addr = value;
+}
+
+
+/*******************************************************************************
+* Function Name: CySimGetReg8
+********************************************************************************
+*
+* Summary:
+*  8-bit register read. A read of the arbiter data register of an endpoint
+*  returns the byte at the arbiter pointer and advances the pointer; reads
+*  past the end of the buffer return 0. Any other address is memory.
+*
+*******************************************************************************/
+uint8 CySimGetReg8(const reg8 *addr)
+{
+    uint8 epNumber;
+    uint8 value = 0u;
+
+    Sim_Step(SIM_REG_CYCLES);
+
+    for (epNumber = 1u; epNumber < USBFS_MAX_EP; ++epNumber)
+    {
+        if (addr == (const reg8 *) &USBFS_simArbEp.arbEp[epNumber].rwDr)
+        {
+            if (Sim_ep[epNumber].arbPtr < SIM_EP_MAX_PACKET)
+            {
+                value = Sim_ep[epNumber].buffer[Sim_ep[epNumber].arbPtr];
+                ++Sim_ep[epNumber].arbPtr;
+            }
+            return (value);
+        }
+    }
+
+    return (*addr);
+}
+
+
+#if (USBFS_16BITS_EP_ACCESS_ENABLE)
+/*******************************************************************************
+* Function Name: USBFS_LoadInEP16
+********************************************************************************
+*
+* Summary:
+*  16-bit access variant of USBFS_LoadInEP().
+*
+*******************************************************************************/
+void USBFS_LoadInEP16(uint8 epNumber, const uint8 pData[], uint16 length)
+{
+    USBFS_LoadInEP(epNumber, pData, length);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_ReadOutEP16
+********************************************************************************
+*
+* Summary:
+*  16-bit access variant of USBFS_ReadOutEP().
+*
+*******************************************************************************/
+uint16 USBFS_ReadOutEP16(uint8 epNumber, uint8 pData[], uint16 length)
+{
+    return (USBFS_ReadOutEP(epNumber, pData, length));
+}
+#endif /* (USBFS_16BITS_EP_ACCESS_ENABLE) */
+
+
+#if (USBFS_EP_MANAGEMENT_DMA_MANUAL)
+/*******************************************************************************
+* Function Name: USBFS_SimDmaDone
+********************************************************************************
+*
+* Summary:
+*  DMA done interrupt: arms the IN endpoint or releases the OUT endpoint
+*  buffer. The OUT endpoint is re-armed by USBFS_EnableOutEP().
+*
+*******************************************************************************/
+static void USBFS_SimDmaDone(uint32 arg)
+{
+    uint8 epNumber = (uint8) arg;
+
+    if (0u != Sim_ep[epNumber].dirIn)
+    {
+        Sim_ep[epNumber].armed = 1u;
+    }
+    else
+    {
+        USBFS_EP[epNumber].apiEpState = USBFS_NO_EVENT_PENDING;
+    }
+}
+#endif /* (USBFS_EP_MANAGEMENT_DMA_MANUAL) */
+
+
+/*******************************************************************************
+* Function Name: USBFS_SetPowerStatus
+********************************************************************************
+*
+* Summary:
+*  Sets the device power status reported to GET_STATUS.
+*
+*******************************************************************************/
+void USBFS_SetPowerStatus(uint8 powerStatus)
+{
+    CY_UNUSED_PARAMETER(powerStatus);
+    Sim_Step(SIM_API_CALL_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_SerialNumString
+********************************************************************************
+*
+* Summary:
+*  Sets the user serial number string descriptor.
+*
+*******************************************************************************/
+void USBFS_SerialNumString(uint8 snString[])
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+    USBFS_serialNumString = snString;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_Suspend
+********************************************************************************
+*
+* Summary:
+*  Prepares the component for DeepSleep.
+*
+*******************************************************************************/
+void USBFS_Suspend(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_Resume
+********************************************************************************
+*
+* Summary:
+*  Restores the component after DeepSleep.
+*
+*******************************************************************************/
+void USBFS_Resume(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_Lpm_GetBeslValue
+********************************************************************************
+*
+* Summary:
+*  Returns the BESL value of the last LPM request.
+*
+*******************************************************************************/
+uint32 USBFS_Lpm_GetBeslValue(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (USBFS_beslValue);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_InitControlRead
+********************************************************************************
+*
+* Summary:
+*  Starts the data stage of a device-to-host control transfer described by
+*  USBFS_currentTD.
+*
+*******************************************************************************/
+uint8 USBFS_InitControlRead(void)
+{
+    USBFS_controlDir = USBFS_RQST_DIR_D2H;
+
+    return (USBFS_TRUE);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_InitControlWrite
+********************************************************************************
+*
+* Summary:
+*  Starts the data stage of a host-to-device control transfer described by
+*  USBFS_currentTD.
+*
+*******************************************************************************/
+uint8 USBFS_InitControlWrite(void)
+{
+    USBFS_controlDir = USBFS_RQST_DIR_H2D;
+
+    return (USBFS_TRUE);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_InitNoDataControlTransfer
+********************************************************************************
+*
+* Summary:
+*  Completes a control transfer without a data stage.
+*
+*******************************************************************************/
+uint8 USBFS_InitNoDataControlTransfer(void)
+{
+    USBFS_currentTD.count = 0u;
+    USBFS_controlDir = USBFS_RQST_DIR_H2D;
+
+    return (USBFS_TRUE);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_HandleVendorRqst
+********************************************************************************
+*
+* Summary:
+*  Vendor request handler of the component. Passes the request to the
+*  application through the vendor request callback.
+*
+*******************************************************************************/
+uint8 USBFS_HandleVendorRqst(void)
+{
+    uint8 requestHandled = USBFS_FALSE;
+
+#ifdef USBFS_HANDLE_VENDOR_RQST_CALLBACK
+    requestHandled = USBFS_HandleVendorRqst_Callback();
+#endif /* (USBFS_HANDLE_VENDOR_RQST_CALLBACK) */
+
+    return (requestHandled);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_SimControl
+********************************************************************************
+*
+* Summary:
+*  EP0 interrupt: dispatches a control request and runs its data stage.
+*
+*******************************************************************************/
+static uint8 USBFS_SimControl(const uint8 setup[], uint8 data[], uint16 *length)
+{
+    uint8 requestHandled = USBFS_FALSE;
+    uint16 count;
+    uint8 i;
+
+#ifdef USBFS_EP_0_ISR_ENTRY_CALLBACK
+    USBFS_EP_0_ISR_EntryCallback();
+#endif /* (USBFS_EP_0_ISR_ENTRY_CALLBACK) */
+
+    for (i = 0u; i < 8u; ++i)
+    {
+        USBFS_simSetup[i] = setup[i];
+    }
+
+    USBFS_currentTD.pData = NULL;
+    USBFS_currentTD.count = 0u;
+
+    if (USBFS_RQST_TYPE_VND == (setup[0u] & USBFS_RQST_TYPE_MASK))
+    {
+        requestHandled = USBFS_HandleVendorRqst();
+    }
+
+#ifdef USBFS_SIM_CLASS_RQST_HANDLER
+    else if (USBFS_RQST_TYPE_CLS == (setup[0u] & USBFS_RQST_TYPE_MASK))
+    {
+        requestHandled = USBFS_SIM_CLASS_RQST_HANDLER();
+    }
+#endif /* (USBFS_SIM_CLASS_RQST_HANDLER) */
+
+    else
+    {
+        /* Standard requests are handled during enumeration. */
+    }
+
+    if (USBFS_FALSE == requestHandled)
+    {
+        *length = 0u;
+    }
+    else
+    {
+        count = (*length < USBFS_currentTD.count) ? *length : USBFS_currentTD.count;
+
+        if (NULL != USBFS_currentTD.pData)
+        {
+            if (USBFS_RQST_DIR_D2H == USBFS_controlDir)
+            {
+                (void) memcpy(data, (const void *) USBFS_currentTD.pData, count);
+            }
+            else
+            {
+                (void) memcpy((void *) USBFS_currentTD.pData, data, count);
+            }
+        }
+
+        *length = count;
+    }
+
+#ifdef USBFS_EP_0_ISR_EXIT_CALLBACK
+    USBFS_EP_0_ISR_ExitCallback();
+#endif /* (USBFS_EP_0_ISR_EXIT_CALLBACK) */
+
+    return (requestHandled);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_SimBusReset
+********************************************************************************
+*
+* Summary:
+*  Bus reset interrupt: the device returns to the default state.
+*
+*******************************************************************************/
+static void USBFS_SimBusReset(void)
+{
+    uint8 ep;
+
+#ifdef USBFS_BUS_RESET_ISR_ENTRY_CALLBACK
+    USBFS_BUS_RESET_ISR_EntryCallback();
+#endif /* (USBFS_BUS_RESET_ISR_ENTRY_CALLBACK) */
+
+    USBFS_configuration = 0u;
+    USBFS_simCr0 = USBFS_CR0_ENABLE;
+
+    for (ep = 1u; ep < USBFS_MAX_EP; ++ep)
+    {
+        USBFS_EP[ep].apiEpState = USBFS_NO_EVENT_ALLOWED;
+        Sim_ep[ep].armed = 0u;
+        Sim_ep[ep].ackd  = 0u;
+        Sim_ep[ep].arbPtr = 0u;
+        Sim_ep[ep].dmaBuffer = NULL;
+    }
+
+#ifdef USBFS_BUS_RESET_ISR_EXIT_CALLBACK
+    USBFS_BUS_RESET_ISR_ExitCallback();
+#endif /* (USBFS_BUS_RESET_ISR_EXIT_CALLBACK) */
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_SimSetConfiguration
+********************************************************************************
+*
+* Summary:
+*  EP0 interrupt: SET_ADDRESS followed by SET_CONFIGURATION.
+*
+*******************************************************************************/
+static void USBFS_SimSetConfiguration(uint8 configuration)
+{
+#ifdef USBFS_EP_0_ISR_ENTRY_CALLBACK
+    USBFS_EP_0_ISR_EntryCallback();
+#endif /* (USBFS_EP_0_ISR_ENTRY_CALLBACK) */
+
+    USBFS_simCr0 = USBFS_CR0_ENABLE | 1u;
+    USBFS_configuration = configuration;
+    USBFS_configurationChanged = USBFS_TRUE;
+    USBFS_ConfigReg();
+
+#ifdef USBFS_EP_0_ISR_EXIT_CALLBACK
+    USBFS_EP_0_ISR_ExitCallback();
+#endif /* (USBFS_EP_0_ISR_EXIT_CALLBACK) */
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_SimEpIsr
+********************************************************************************
+*
+* Summary:
+*  Data endpoint interrupt: the host completed a transaction on the endpoint.
+*
+*******************************************************************************/
+static void USBFS_SimEpIsr(uint8 epNumber)
+{
+    USBFS_SimEpCallback(epNumber, 0u);
+
+    /* IN: buffer is empty. OUT: buffer is full. Both are EVENT_PENDING. */
+    USBFS_EP[epNumber].apiEpState = USBFS_EVENT_PENDING;
+
+    USBFS_SimEpCallback(epNumber, 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_SimEpCallback
+********************************************************************************
+*
+* Summary:
+*  Calls the entry or exit callback of a data endpoint interrupt, when the
+*  project defines it in cyapicallbacks.h.
+*
+*******************************************************************************/
+static void USBFS_SimEpCallback(uint8 epNumber, uint8 exitCallback)
+{
+    switch ((2u * epNumber) + exitCallback)
+    {
+    #ifdef USBFS_EP_1_ISR_ENTRY_CALLBACK
+        case 2u: USBFS_EP_1_ISR_EntryCallback(); break;
+    #endif
+    #ifdef USBFS_EP_1_ISR_EXIT_CALLBACK
+        case 3u: USBFS_EP_1_ISR_ExitCallback(); break;
+    #endif
+    #ifdef USBFS_EP_2_ISR_ENTRY_CALLBACK
+        case 4u: USBFS_EP_2_ISR_EntryCallback(); break;
+    #endif
+    #ifdef USBFS_EP_2_ISR_EXIT_CALLBACK
+        case 5u: USBFS_EP_2_ISR_ExitCallback(); break;
+    #endif
+    #ifdef USBFS_EP_3_ISR_ENTRY_CALLBACK
+        case 6u: USBFS_EP_3_ISR_EntryCallback(); break;
+    #endif
+    #ifdef USBFS_EP_3_ISR_EXIT_CALLBACK
+        case 7u: USBFS_EP_3_ISR_ExitCallback(); break;
+    #endif
+    #ifdef USBFS_EP_4_ISR_ENTRY_CALLBACK
+        case 8u: USBFS_EP_4_ISR_EntryCallback(); break;
+    #endif
+    #ifdef USBFS_EP_4_ISR_EXIT_CALLBACK
+        case 9u: USBFS_EP_4_ISR_ExitCallback(); break;
+    #endif
+    #ifdef USBFS_EP_5_ISR_ENTRY_CALLBACK
+        case 10u: USBFS_EP_5_ISR_EntryCallback(); break;
+    #endif
+    #ifdef USBFS_EP_5_ISR_EXIT_CALLBACK
+        case 11u: USBFS_EP_5_ISR_ExitCallback(); break;
+    #endif
+    #ifdef USBFS_EP_6_ISR_ENTRY_CALLBACK
+        case 12u: USBFS_EP_6_ISR_EntryCallback(); break;
+    #endif
+    #ifdef USBFS_EP_6_ISR_EXIT_CALLBACK
+        case 13u: USBFS_EP_6_ISR_ExitCallback(); break;
+    #endif
+    #ifdef USBFS_EP_7_ISR_ENTRY_CALLBACK
+        case 14u: USBFS_EP_7_ISR_EntryCallback(); break;
+    #endif
+    #ifdef USBFS_EP_7_ISR_EXIT_CALLBACK
+        case 15u: USBFS_EP_7_ISR_ExitCallback(); break;
+    #endif
+    #ifdef USBFS_EP_8_ISR_ENTRY_CALLBACK
+        case 16u: USBFS_EP_8_ISR_EntryCallback(); break;
+    #endif
+    #ifdef USBFS_EP_8_ISR_EXIT_CALLBACK
+        case 17u: USBFS_EP_8_ISR_ExitCallback(); break;
+    #endif
+        default:
+            break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_SimSofIsr
+********************************************************************************
+*
+* Summary:
+*  Start of frame interrupt.
+*
+*******************************************************************************/
+static void USBFS_SimSofIsr(void)
+{
+#ifdef USBFS_SOF_ISR_ENTRY_CALLBACK
+    USBFS_SOF_ISR_EntryCallback();
+#endif /* (USBFS_SOF_ISR_ENTRY_CALLBACK) */
+
+#ifdef USBFS_SOF_ISR_EXIT_CALLBACK
+    USBFS_SOF_ISR_ExitCallback();
+#endif /* (USBFS_SOF_ISR_EXIT_CALLBACK) */
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_SimLpmIsr
+********************************************************************************
+*
+* Summary:
+*  LPM interrupt: the host requested L1 with the given BESL.
+*
+*******************************************************************************/
+static void USBFS_SimLpmIsr(uint32 besl)
+{
+    USBFS_beslValue = besl;
+
+#ifdef USBFS_LPM_ISR_ENTRY_CALLBACK
+    USBFS_LPM_ISR_EntryCallback();
+#endif /* (USBFS_LPM_ISR_ENTRY_CALLBACK) */
+
+#ifdef USBFS_LPM_ISR_EXIT_CALLBACK
+    USBFS_LPM_ISR_ExitCallback();
+#endif /* (USBFS_LPM_ISR_EXIT_CALLBACK) */
+}
+
+
+/* [] END OF FILE */
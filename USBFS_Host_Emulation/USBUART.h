@@ -0,0 +1,183 @@
+/*******************************************************************************
+* File Name: USBUART.h
+*
+* Version: 1.0
+*
+* Description:
+*  Host stand-in for the USBFS component instantiated as USBUART in the
+*  USBFS_UART example. The generic device API of the instance is the USBFS
+*  emulation (USBFS_sim.c); the CDC class API is emulated in USBUART_sim.c.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(CY_USBFS_USBUART_H)
+#define CY_USBFS_USBUART_H
+
+#include "USBFS.h"
+
+
+/***************************************
+*    Generic device API of the instance
+****************************************/
+
+#define USBUART_Start                   USBFS_Start
+#define USBUART_Stop                    USBFS_Stop
+#define USBUART_GetConfiguration        USBFS_GetConfiguration
+#define USBUART_IsConfigurationChanged  USBFS_IsConfigurationChanged
+#define USBUART_GetEPState              USBFS_GetEPState
+#define USBUART_GetEPCount              USBFS_GetEPCount
+#define USBUART_LoadInEP                USBFS_LoadInEP
+#define USBUART_ReadOutEP               USBFS_ReadOutEP
+#define USBUART_EnableOutEP             USBFS_EnableOutEP
+#define USBUART_CheckActivity           USBFS_CheckActivity
+#define USBUART_Suspend                 USBFS_Suspend
+#define USBUART_Resume                  USBFS_Resume
+
+#define USBUART_3V_OPERATION            USBFS_3V_OPERATION
+#define USBUART_5V_OPERATION            USBFS_5V_OPERATION
+#define USBUART_DWR_POWER_OPERATION     USBFS_DWR_POWER_OPERATION
+
+#define USBUART_IN_BUFFER_FULL          USBFS_IN_BUFFER_FULL
+#define USBUART_IN_BUFFER_EMPTY         USBFS_IN_BUFFER_EMPTY
+#define USBUART_OUT_BUFFER_FULL         USBFS_OUT_BUFFER_FULL
+#define USBUART_OUT_BUFFER_EMPTY        USBFS_OUT_BUFFER_EMPTY
+
+/* Interrupt callbacks of the USBUART instance (cyapicallbacks.h). */
+#ifdef USBUART_SOF_ISR_ENTRY_CALLBACK
+    #define USBFS_SOF_ISR_ENTRY_CALLBACK
+    #define USBFS_SOF_ISR_EntryCallback         USBUART_SOF_ISR_EntryCallback
+#endif /* (USBUART_SOF_ISR_ENTRY_CALLBACK) */
+
+#ifdef USBUART_BUS_RESET_ISR_EXIT_CALLBACK
+    #define USBFS_BUS_RESET_ISR_EXIT_CALLBACK
+    #define USBFS_BUS_RESET_ISR_ExitCallback    USBUART_BUS_RESET_ISR_ExitCallback
+#endif /* (USBUART_BUS_RESET_ISR_EXIT_CALLBACK) */
+
+#ifdef USBUART_EP_0_ISR_EXIT_CALLBACK
+    #define USBFS_EP_0_ISR_EXIT_CALLBACK
+    #define USBFS_EP_0_ISR_ExitCallback         USBUART_EP_0_ISR_ExitCallback
+#endif /* (USBUART_EP_0_ISR_EXIT_CALLBACK) */
+
+#ifdef USBUART_EP_1_ISR_EXIT_CALLBACK
+    #define USBFS_EP_1_ISR_EXIT_CALLBACK
+    #define USBFS_EP_1_ISR_ExitCallback         USBUART_EP_1_ISR_ExitCallback
+#endif /* (USBUART_EP_1_ISR_EXIT_CALLBACK) */
+
+#ifdef USBUART_EP_2_ISR_EXIT_CALLBACK
+    #define USBFS_EP_2_ISR_EXIT_CALLBACK
+    #define USBFS_EP_2_ISR_ExitCallback         USBUART_EP_2_ISR_ExitCallback
+#endif /* (USBUART_EP_2_ISR_EXIT_CALLBACK) */
+
+#ifdef USBUART_EP_3_ISR_EXIT_CALLBACK
+    #define USBFS_EP_3_ISR_EXIT_CALLBACK
+    #define USBFS_EP_3_ISR_ExitCallback         USBUART_EP_3_ISR_ExitCallback
+#endif /* (USBUART_EP_3_ISR_EXIT_CALLBACK) */
+
+#ifdef USBUART_EP_4_ISR_EXIT_CALLBACK
+    #define USBFS_EP_4_ISR_EXIT_CALLBACK
+    #define USBFS_EP_4_ISR_ExitCallback         USBUART_EP_4_ISR_ExitCallback
+#endif /* (USBUART_EP_4_ISR_EXIT_CALLBACK) */
+
+#ifdef USBUART_EP_5_ISR_EXIT_CALLBACK
+    #define USBFS_EP_5_ISR_EXIT_CALLBACK
+    #define USBFS_EP_5_ISR_ExitCallback         USBUART_EP_5_ISR_ExitCallback
+#endif /* (USBUART_EP_5_ISR_EXIT_CALLBACK) */
+
+#ifdef USBUART_EP_6_ISR_EXIT_CALLBACK
+    #define USBFS_EP_6_ISR_EXIT_CALLBACK
+    #define USBFS_EP_6_ISR_ExitCallback         USBUART_EP_6_ISR_ExitCallback
+#endif /* (USBUART_EP_6_ISR_EXIT_CALLBACK) */
+
+
+/***************************************
+*    CDC class API
+****************************************/
+
+#define USBUART_MAX_MULTI_COM_NUM       (2u)
+#define USBUART_COM_PORT1               (0u)
+#define USBUART_COM_PORT2               (1u)
+#define USBUART_LINE_CODING_SIZE        (7u)
+
+void   USBUART_CDC_Init(void);
+void   USBUART_PutData(const uint8 *pData, uint16 length);
+void   USBUART_PutString(const char8 string[]);
+void   USBUART_PutChar(char8 txDataByte);
+void   USBUART_PutCRLF(void);
+uint16 USBUART_GetCount(void);
+uint8  USBUART_CDCIsReady(void);
+uint8  USBUART_DataIsReady(void);
+uint16 USBUART_GetData(uint8 *pData, uint16 length);
+uint16 USBUART_GetAll(uint8 *pData);
+uint8  USBUART_GetChar(void);
+uint8  USBUART_IsLineChanged(void);
+uint32 USBUART_GetDTERate(void);
+uint8  USBUART_GetCharFormat(void);
+uint8  USBUART_GetParityType(void);
+uint8  USBUART_GetDataBits(void);
+uint16 USBUART_GetLineControl(void);
+void   USBUART_SendSerialState(uint16 serialState);
+uint16 USBUART_GetSerialState(void);
+uint8  USBUART_NotificationIsReady(void);
+uint8  USBUART_SetComPort(uint8 comNumber);
+uint8  USBUART_GetComPort(void);
+
+/* Class request handler called by the emulated EP0 interrupt. */
+uint8  USBUART_DispatchCDCClassRqst(void);
+#define USBFS_SIM_CLASS_RQST_HANDLER    USBUART_DispatchCDCClassRqst
+
+extern volatile uint8  USBUART_linesCoding[USBUART_MAX_MULTI_COM_NUM][USBUART_LINE_CODING_SIZE];
+extern volatile uint8  USBUART_linesChanged[USBUART_MAX_MULTI_COM_NUM];
+extern volatile uint16 USBUART_linesControlBitmap[USBUART_MAX_MULTI_COM_NUM];
+extern volatile uint16 USBUART_serialStateBitmap[USBUART_MAX_MULTI_COM_NUM];
+extern volatile uint8  USBUART_cdcDataInEp[USBUART_MAX_MULTI_COM_NUM];
+extern volatile uint8  USBUART_cdcDataOutEp[USBUART_MAX_MULTI_COM_NUM];
+extern volatile uint8  USBUART_cdcCommInInterruptEp[USBUART_MAX_MULTI_COM_NUM];
+extern volatile uint8  USBUART_activeCom;
+
+/* CDC class requests. */
+#define USBUART_CDC_SET_LINE_CODING         (0x20u)
+#define USBUART_CDC_GET_LINE_CODING         (0x21u)
+#define USBUART_CDC_SET_CONTROL_LINE_STATE  (0x22u)
+
+/* USBUART_IsLineChanged() return values. */
+#define USBUART_LINE_CODING_CHANGED         (0x01u)
+#define USBUART_LINE_CONTROL_CHANGED        (0x02u)
+
+/* USBUART_GetLineControl() bits. */
+#define USBUART_LINE_CONTROL_DTR            (0x01u)
+#define USBUART_LINE_CONTROL_RTS            (0x02u)
+
+/* USBUART_GetCharFormat() return values. */
+#define USBUART_LINE_CODING_STOP_BITS_1     (0u)
+#define USBUART_LINE_CODING_STOP_BITS_1_5   (1u)
+#define USBUART_LINE_CODING_STOP_BITS_2     (2u)
+
+/* USBUART_GetParityType() return values. */
+#define USBUART_LINE_CODING_PARITY_NONE     (0u)
+#define USBUART_LINE_CODING_PARITY_ODD      (1u)
+#define USBUART_LINE_CODING_PARITY_EVEN     (2u)
+#define USBUART_LINE_CODING_PARITY_MARK     (3u)
+#define USBUART_LINE_CODING_PARITY_SPACE    (4u)
+
+/* SERIAL_STATE notification bits. */
+#define USBUART_SERIAL_STATE_DCD            (0x0001u)
+#define USBUART_SERIAL_STATE_DSR            (0x0002u)
+#define USBUART_SERIAL_STATE_BREAK          (0x0004u)
+#define USBUART_SERIAL_STATE_RI             (0x0008u)
+#define USBUART_SERIAL_STATE_FRAMING        (0x0010u)
+#define USBUART_SERIAL_STATE_PARITY         (0x0020u)
+#define USBUART_SERIAL_STATE_OVERRUN        (0x0040u)
+
+#endif /* (CY_USBFS_USBUART_H) */
+
+
+/* [] END OF FILE */
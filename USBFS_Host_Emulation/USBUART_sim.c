@@ -0,0 +1,524 @@
+/*******************************************************************************
+* File Name: USBUART_sim.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host emulation of the USBFS CDC class API (USBUART instance). The CDC
+*  data and notification endpoints are located from the endpoint layout that
+*  the host scenario configured, in the order they appear in the descriptor:
+*  interrupt IN, bulk IN and bulk OUT for each COM port.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "project.h"
+#include "sim_bus.h"
+
+/* SERIAL_STATE notification: 8-byte header and 2-byte bitmap. */
+#define USBUART_SERIAL_STATE_LENGTH     (10u)
+#define USBUART_SERIAL_STATE            (0x20u)
+#define USBUART_NOTIFICATION_REQUEST    (0xA1u)
+
+volatile uint8  USBUART_linesCoding[USBUART_MAX_MULTI_COM_NUM][USBUART_LINE_CODING_SIZE] =
+{
+    /* 115200 bps, 1 stop bit, no parity, 8 data bits. */
+    {0x00u, 0xC2u, 0x01u, 0x00u, 0x00u, 0x00u, 0x08u},
+    {0x00u, 0xC2u, 0x01u, 0x00u, 0x00u, 0x00u, 0x08u},
+};
+volatile uint8  USBUART_linesChanged[USBUART_MAX_MULTI_COM_NUM];
+volatile uint16 USBUART_linesControlBitmap[USBUART_MAX_MULTI_COM_NUM];
+volatile uint16 USBUART_serialStateBitmap[USBUART_MAX_MULTI_COM_NUM];
+volatile uint8  USBUART_cdcDataInEp[USBUART_MAX_MULTI_COM_NUM];
+volatile uint8  USBUART_cdcDataOutEp[USBUART_MAX_MULTI_COM_NUM];
+volatile uint8  USBUART_cdcCommInInterruptEp[USBUART_MAX_MULTI_COM_NUM];
+volatile uint8  USBUART_activeCom;
+
+static uint8 USBUART_serialStateNotification[USBUART_SERIAL_STATE_LENGTH];
+
+
+/*******************************************************************************
+* Function Name: USBUART_CDC_Init
+********************************************************************************
+*
+* Summary:
+*  Locates the CDC endpoints of every COM port, clears the line state and
+*  enables the data OUT endpoints.
+*
+*******************************************************************************/
+void USBUART_CDC_Init(void)
+{
+    uint8 com = 0u;
+    uint8 ep;
+
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    (void) memset((void *) USBUART_cdcDataInEp, 0, sizeof(USBUART_cdcDataInEp));
+    (void) memset((void *) USBUART_cdcDataOutEp, 0, sizeof(USBUART_cdcDataOutEp));
+    (void) memset((void *) USBUART_cdcCommInInterruptEp, 0, sizeof(USBUART_cdcCommInInterruptEp));
+
+    for (ep = 1u; (ep < SIM_MAX_EP) && (com < USBUART_MAX_MULTI_COM_NUM); ++ep)
+    {
+        if (SIM_EP_TYPE_INT == Sim_ep[ep].type)
+        {
+            USBUART_cdcCommInInterruptEp[com] = ep;
+        }
+        else if ((SIM_EP_TYPE_BULK == Sim_ep[ep].type) && (0u != Sim_ep[ep].dirIn))
+        {
+            USBUART_cdcDataInEp[com] = ep;
+        }
+        else if (SIM_EP_TYPE_BULK == Sim_ep[ep].type)
+        {
+            USBUART_cdcDataOutEp[com] = ep;
+            ++com;
+        }
+        else
+        {
+            /* Endpoint is not used. */
+        }
+    }
+
+    for (com = 0u; com < USBUART_MAX_MULTI_COM_NUM; ++com)
+    {
+        USBUART_linesChanged[com] = 0u;
+        USBUART_linesControlBitmap[com] = 0u;
+        USBUART_serialStateBitmap[com] = 0u;
+
+        if (0u != USBUART_cdcDataOutEp[com])
+        {
+            USBFS_EnableOutEP(USBUART_cdcDataOutEp[com]);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_PutData
+********************************************************************************
+*
+* Summary:
+*  Sends up to one data packet to the host on the active COM port. A NULL
+*  pointer with zero length sends a zero-length packet.
+*
+*******************************************************************************/
+void USBUART_PutData(const uint8 *pData, uint16 length)
+{
+    USBFS_LoadInEP(USBUART_cdcDataInEp[USBUART_activeCom], pData, length);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_PutString
+********************************************************************************
+*
+* Summary:
+*  Sends a null-terminated string, waiting for the endpoint between packets.
+*
+*******************************************************************************/
+void USBUART_PutString(const char8 string[])
+{
+    uint16 length = (uint16) strlen(string);
+    uint16 chunk;
+
+    do
+    {
+        chunk = (length > SIM_EP_MAX_PACKET) ? SIM_EP_MAX_PACKET : length;
+
+        while (0u == USBUART_CDCIsReady())
+        {
+        }
+
+        USBUART_PutData((const uint8 *) string, chunk);
+        string = &string[chunk];
+        length -= chunk;
+    }
+    while (0u != length);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_PutChar
+********************************************************************************
+*
+* Summary:
+*  Sends a single byte.
+*
+*******************************************************************************/
+void USBUART_PutChar(char8 txDataByte)
+{
+    uint8 dataByte = (uint8) txDataByte;
+
+    USBUART_PutData(&dataByte, 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_PutCRLF
+********************************************************************************
+*
+* Summary:
+*  Sends a carriage return and line feed.
+*
+*******************************************************************************/
+void USBUART_PutCRLF(void)
+{
+    static const uint8 crlf[2u] = {0x0Du, 0x0Au};
+
+    USBUART_PutData(crlf, 2u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetCount
+********************************************************************************
+*
+* Summary:
+*  Returns the number of bytes received on the active COM port.
+*
+*******************************************************************************/
+uint16 USBUART_GetCount(void)
+{
+    uint8 ep = USBUART_cdcDataOutEp[USBUART_activeCom];
+
+    return ((USBFS_OUT_BUFFER_FULL == USBFS_GetEPState(ep)) ? USBFS_GetEPCount(ep) : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_CDCIsReady
+********************************************************************************
+*
+* Summary:
+*  Returns non-zero when the data IN endpoint can accept a packet.
+*
+*******************************************************************************/
+uint8 USBUART_CDCIsReady(void)
+{
+    return ((USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(USBUART_cdcDataInEp[USBUART_activeCom])) ?
+            1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_DataIsReady
+********************************************************************************
+*
+* Summary:
+*  Returns non-zero when the data OUT endpoint holds a packet.
+*
+*******************************************************************************/
+uint8 USBUART_DataIsReady(void)
+{
+    return ((USBFS_OUT_BUFFER_FULL == USBFS_GetEPState(USBUART_cdcDataOutEp[USBUART_activeCom])) ?
+            1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetData
+********************************************************************************
+*
+* Summary:
+*  Reads up to length bytes of the received packet and re-enables the OUT
+*  endpoint.
+*
+*******************************************************************************/
+uint16 USBUART_GetData(uint8 *pData, uint16 length)
+{
+    return (USBFS_ReadOutEP(USBUART_cdcDataOutEp[USBUART_activeCom], pData, length));
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetAll
+********************************************************************************
+*
+* Summary:
+*  Reads the whole received packet and re-enables the OUT endpoint.
+*
+*******************************************************************************/
+uint16 USBUART_GetAll(uint8 *pData)
+{
+    uint8 ep = USBUART_cdcDataOutEp[USBUART_activeCom];
+
+    return (USBFS_ReadOutEP(ep, pData, USBFS_GetEPCount(ep)));
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetChar
+********************************************************************************
+*
+* Summary:
+*  Reads one byte of the received packet.
+*
+*******************************************************************************/
+uint8 USBUART_GetChar(void)
+{
+    uint8 rxData = 0u;
+
+    (void) USBFS_ReadOutEP(USBUART_cdcDataOutEp[USBUART_activeCom], &rxData, 1u);
+
+    return (rxData);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_IsLineChanged
+********************************************************************************
+*
+* Summary:
+*  Returns and clears the line coding and line control change flags.
+*
+*******************************************************************************/
+uint8 USBUART_IsLineChanged(void)
+{
+    uint8 state;
+
+    Sim_Step(SIM_API_CALL_CYCLES);
+    state = USBUART_linesChanged[USBUART_activeCom];
+    USBUART_linesChanged[USBUART_activeCom] = 0u;
+
+    return (state);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetDTERate
+********************************************************************************
+*
+* Summary:
+*  Returns the data terminal rate set by the host.
+*
+*******************************************************************************/
+uint32 USBUART_GetDTERate(void)
+{
+    volatile uint8 *coding = USBUART_linesCoding[USBUART_activeCom];
+
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return ((uint32) coding[0u] | ((uint32) coding[1u] << 8u) |
+            ((uint32) coding[2u] << 16u) | ((uint32) coding[3u] << 24u));
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetCharFormat
+********************************************************************************
+*
+* Summary:
+*  Returns the number of stop bits set by the host.
+*
+*******************************************************************************/
+uint8 USBUART_GetCharFormat(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (USBUART_linesCoding[USBUART_activeCom][4u]);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetParityType
+********************************************************************************
+*
+* Summary:
+*  Returns the parity type set by the host.
+*
+*******************************************************************************/
+uint8 USBUART_GetParityType(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (USBUART_linesCoding[USBUART_activeCom][5u]);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetDataBits
+********************************************************************************
+*
+* Summary:
+*  Returns the number of data bits set by the host.
+*
+*******************************************************************************/
+uint8 USBUART_GetDataBits(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (USBUART_linesCoding[USBUART_activeCom][6u]);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetLineControl
+********************************************************************************
+*
+* Summary:
+*  Returns the DTR/RTS bitmap set by the host.
+*
+*******************************************************************************/
+uint16 USBUART_GetLineControl(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    return (USBUART_linesControlBitmap[USBUART_activeCom]);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_SendSerialState
+********************************************************************************
+*
+* Summary:
+*  Sends a SERIAL_STATE notification on the interrupt endpoint of the active
+*  COM port, when the endpoint is free.
+*
+*******************************************************************************/
+void USBUART_SendSerialState(uint16 serialState)
+{
+    uint8 ep = USBUART_cdcCommInInterruptEp[USBUART_activeCom];
+
+    USBUART_serialStateBitmap[USBUART_activeCom] = serialState;
+
+    if ((0u != ep) && (USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(ep)))
+    {
+        USBUART_serialStateNotification[0u] = USBUART_NOTIFICATION_REQUEST;
+        USBUART_serialStateNotification[1u] = USBUART_SERIAL_STATE;
+        USBUART_serialStateNotification[2u] = 0u;
+        USBUART_serialStateNotification[3u] = 0u;
+        USBUART_serialStateNotification[4u] = (uint8) (2u * USBUART_activeCom);
+        USBUART_serialStateNotification[5u] = 0u;
+        USBUART_serialStateNotification[6u] = 2u;
+        USBUART_serialStateNotification[7u] = 0u;
+        USBUART_serialStateNotification[8u] = (uint8) serialState;
+        USBUART_serialStateNotification[9u] = (uint8) (serialState >> 8u);
+
+        USBFS_LoadInEP(ep, USBUART_serialStateNotification, USBUART_SERIAL_STATE_LENGTH);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetSerialState
+********************************************************************************
+*
+* Summary:
+*  Returns the last serial state sent to the host.
+*
+*******************************************************************************/
+uint16 USBUART_GetSerialState(void)
+{
+    return (USBUART_serialStateBitmap[USBUART_activeCom]);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_NotificationIsReady
+********************************************************************************
+*
+* Summary:
+*  Returns non-zero when the notification endpoint can accept a packet.
+*
+*******************************************************************************/
+uint8 USBUART_NotificationIsReady(void)
+{
+    return ((USBFS_IN_BUFFER_EMPTY ==
+             USBFS_GetEPState(USBUART_cdcCommInInterruptEp[USBUART_activeCom])) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_SetComPort
+********************************************************************************
+*
+* Summary:
+*  Selects the COM port used by the CDC API.
+*
+*******************************************************************************/
+uint8 USBUART_SetComPort(uint8 comNumber)
+{
+    if (comNumber >= USBUART_MAX_MULTI_COM_NUM)
+    {
+        return (USBFS_FALSE);
+    }
+
+    USBUART_activeCom = comNumber;
+
+    return (USBFS_TRUE);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_GetComPort
+********************************************************************************
+*
+* Summary:
+*  Returns the COM port used by the CDC API.
+*
+*******************************************************************************/
+uint8 USBUART_GetComPort(void)
+{
+    return (USBUART_activeCom);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_DispatchCDCClassRqst
+********************************************************************************
+*
+* Summary:
+*  Handles the CDC class requests addressed to a communication interface. The
+*  COM port is the communication interface number divided by two.
+*
+*******************************************************************************/
+uint8 USBUART_DispatchCDCClassRqst(void)
+{
+    uint8 requestHandled = USBFS_FALSE;
+    uint8 com = (uint8) (USBFS_wIndexLoReg / 2u);
+
+    if (com >= USBUART_MAX_MULTI_COM_NUM)
+    {
+        return (USBFS_FALSE);
+    }
+
+    switch (USBFS_bRequestReg)
+    {
+        case USBUART_CDC_SET_LINE_CODING:
+            USBFS_currentTD.pData = USBUART_linesCoding[com];
+            USBFS_currentTD.count = USBUART_LINE_CODING_SIZE;
+            USBUART_linesChanged[com] |= USBUART_LINE_CODING_CHANGED;
+            requestHandled = USBFS_InitControlWrite();
+            break;
+
+        case USBUART_CDC_GET_LINE_CODING:
+            USBFS_currentTD.pData = USBUART_linesCoding[com];
+            USBFS_currentTD.count = USBUART_LINE_CODING_SIZE;
+            requestHandled = USBFS_InitControlRead();
+            break;
+
+        case USBUART_CDC_SET_CONTROL_LINE_STATE:
+            USBUART_linesControlBitmap[com] = USBFS_wValueLoReg;
+            USBUART_linesChanged[com] |= USBUART_LINE_CONTROL_CHANGED;
+            requestHandled = USBFS_InitNoDataControlTransfer();
+            break;
+
+        default:
+            break;
+    }
+
+    return (requestHandled);
+}
+
+
+/* [] END OF FILE */
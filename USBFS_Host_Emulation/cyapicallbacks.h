@@ -0,0 +1,28 @@
+/*******************************************************************************
+* File Name: cyapicallbacks.h
+*
+* Version: 1.0
+*
+* Description:
+*  Empty callback definitions for the example projects that do not provide
+*  cyapicallbacks.h. The example project directory precedes the emulation
+*  directory on the include path, so a project file takes precedence.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#ifndef CYAPICALLBACKS_H
+#define CYAPICALLBACKS_H
+
+#endif /* CYAPICALLBACKS_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,144 @@
+/*******************************************************************************
+* File Name: cytypes.h
+*
+* Version: 1.0
+*
+* Description:
+*  Host stand-in for the PSoC Creator cytypes.h and CyLib.h headers. Provides
+*  the base types, attribute macros and the handful of CyLib/cyPm services
+*  that the USBFS code examples use, so that their main.c files compile
+*  unchanged on a Linux host against the USBFS emulation.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(CY_BOOT_CYTYPES_H)
+#define CY_BOOT_CYTYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/***************************************
+*    Device family
+****************************************/
+
+/* The emulation models the PSoC 4200L USBFS block. */
+#define CY_PSOC3            (0u)
+#define CY_PSOC4            (1u)
+#define CY_PSOC5            (0u)
+#define CY_PSOC5LP          (0u)
+#define CY_IP_CPUSS_CM0     (1u)
+
+
+/***************************************
+*    Base types
+****************************************/
+
+typedef uint8_t     uint8;
+typedef uint16_t    uint16;
+typedef uint32_t    uint32;
+typedef int8_t      int8;
+typedef int16_t     int16;
+typedef int32_t     int32;
+typedef char        char8;
+typedef float       float32;
+typedef double      float64;
+typedef uint64_t    uint64;
+typedef int64_t     int64;
+
+typedef volatile uint8  reg8;
+typedef volatile uint16 reg16;
+typedef volatile uint32 reg32;
+
+typedef void (*cyisraddress)(void);
+
+#define CY_ISR(FuncName)        void FuncName (void)
+#define CY_ISR_PROTO(FuncName)  void FuncName (void)
+
+#define CY_INLINE               inline
+#define CY_NOINIT
+#define CY_ALIGN(align)         __attribute__((aligned(align)))
+#define CY_UNUSED_PARAMETER(x)  ((void)(x))
+
+#define CYRET_SUCCESS           (0x00u)
+#define CYRET_BAD_PARAM         (0x01u)
+
+
+/***************************************
+*    Register access
+****************************************/
+
+/* The arbiter data register of a USBFS endpoint reads or writes the next byte
+* of the endpoint buffer on each access (USBFS_sim.c); any other address is
+* plain memory.
+*/
+void  CySimSetReg8(reg8 *addr, uint8 value);
+uint8 CySimGetReg8(const reg8 *addr);
+
+#define CY_SET_REG8(addr, value)    CySimSetReg8((reg8 *) (addr), (uint8) (value))
+#define CY_GET_REG8(addr)           CySimGetReg8((const reg8 *) (addr))
+
+
+/***************************************
+*    CyLib services
+****************************************/
+
+#define CyGlobalIntEnable   do { CyIntSetGlobalState(1u); } while (0)
+#define CyGlobalIntDisable  do { CyIntSetGlobalState(0u); } while (0)
+
+void   CyIntSetGlobalState(uint8 enable);
+uint8  CyEnterCriticalSection(void);
+void   CyExitCriticalSection(uint8 savedIntrStatus);
+void   CyDelay(uint32 milliseconds);
+void   CyDelayUs(uint16 microseconds);
+
+/* SYSCLK frequency. */
+extern uint32 cydelay_freq_hz;
+
+/* SysTick: 24-bit down counter clocked by SYSCLK. The interrupt calls the
+* callbacks set with CySysTickSetCallback() each time the counter reaches
+* zero.
+*/
+#define CY_SYS_SYST_RVR_CNT_MASK        (0x00FFFFFFu)
+#define CY_SYS_SYST_NUM_OF_CALLBACKS    (5u)
+
+typedef void (*cySysTickCallback)(void);
+
+void   CySysTickStart(void);
+void   CySysTickEnable(void);
+void   CySysTickStop(void);
+void   CySysTickEnableInterrupt(void);
+void   CySysTickDisableInterrupt(void);
+cySysTickCallback CySysTickSetCallback(uint32 number, cySysTickCallback function);
+void   CySysTickSetReload(uint32 value);
+uint32 CySysTickGetValue(void);
+void   CySysTickClear(void);
+
+
+/***************************************
+*    cyPm services (PSoC 4)
+****************************************/
+
+#define CY_PM_RESET_REASON_UNKN         (0u)
+#define CY_PM_RESET_REASON_XRES         (1u)
+#define CY_PM_RESET_REASON_WAKEUP_HIB   (2u)
+#define CY_PM_RESET_REASON_WAKEUP_STOP  (3u)
+
+uint32 CySysPmGetResetReason(void);
+void   CySysPmSleep(void);
+void   CySysPmDeepSleep(void);
+void   CySysPmHibernate(void);
+
+#endif /* (CY_BOOT_CYTYPES_H) */
+
+
+/* [] END OF FILE */
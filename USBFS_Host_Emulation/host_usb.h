@@ -0,0 +1,84 @@
+/*******************************************************************************
+* File Name: host_usb.h
+*
+* Version: 1.0
+*
+* Description:
+*  Host USB access for the host tools of the USBFS code examples. A tool is
+*  written once against this interface and built either with libusb
+*  (libusb/host_usb_libusb.c) to drive a device on the bus, or with the USBFS
+*  emulation (host_usb_sim.c) to drive the example firmware on a simulated bus.
+*  The calls block like the libusb synchronous API.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(HOST_USB_H)
+#define HOST_USB_H
+
+#include "cytypes.h"
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* Return values. */
+#define HOST_USB_SUCCESS        (0)
+#define HOST_USB_ERROR          (-1)    /* Stall, device not found, etc. */
+#define HOST_USB_TIMEOUT        (-2)
+#define HOST_USB_OVERFLOW       (-3)    /* Device sent more than requested. */
+
+/* Endpoint address direction and transfer types. */
+#define HOST_USB_DIR_IN         (0x80u)
+#define HOST_USB_EP_BULK        (2u)
+#define HOST_USB_EP_INT         (3u)
+
+/* Maximum number of endpoints of a device. */
+#define HOST_USB_MAX_EP         (8u)
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Endpoint descriptor fields of the device configuration. The libusb backend
+* reads them from the device; the emulation backend configures the simulated
+* device with them.
+*/
+typedef struct
+{
+    uint8  address;         /* bEndpointAddress */
+    uint8  type;            /* HOST_USB_EP_BULK or HOST_USB_EP_INT */
+    uint16 maxPacket;       /* wMaxPacketSize */
+} HOST_USB_EP;
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+int    HostUsb_Open(uint16 vid, uint16 pid, const HOST_USB_EP eps[], uint8 count);
+void   HostUsb_Close(int status);
+int    HostUsb_Control(uint8 requestType, uint8 request, uint16 value, uint16 index,
+                       uint8 data[], uint16 length, uint32 timeoutMs);
+int    HostUsb_Transfer(uint8 endpoint, uint8 data[], uint32 length,
+                        uint32 *transferred, uint32 timeoutMs);
+uint64 HostUsb_TimeNs(void);
+void   HostUsb_SleepNs(uint64 delayNs);
+
+/* Entry point of the host tool, called by the backend. */
+int    HostTool_Main(int argc, char *argv[]);
+
+#endif /* (HOST_USB_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,610 @@
+/*******************************************************************************
+* File Name: host_usb_sim.c
+*
+* Version: 1.0
+*
+* Description:
+*  Emulation backend of the host USB access (host_usb.h). The "host" scenario
+*  runs a host tool linked with the example firmware: the tool runs in its own
+*  thread, in lockstep with the simulated bus. While a host call is in
+*  progress the tool waits and the bus performs the transfer one transaction
+*  at a time; while the tool runs the simulation waits, so no simulated time
+*  passes between the host calls and runs stay deterministic.
+*
+*  Options after "--" on the command line are passed to the tool:
+*   bulk_bench_sim -s host -- -m source
+*  With -p the transfers of the tool are written to a usbmon pcap file
+*  (sim_pcap.h), as a capture of the tool on a Linux host would record them.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_bus.h"
+#include "sim_pcap.h"
+#include "host_usb.h"
+
+/* The host tool is linked only into the host tool builds. */
+#pragma weak HostTool_Main
+
+/* Host calls passed to the simulation thread. */
+#define HOST_SIM_NONE           (0u)
+#define HOST_SIM_OPEN           (1u)
+#define HOST_SIM_CONTROL        (2u)
+#define HOST_SIM_TRANSFER       (3u)
+#define HOST_SIM_SLEEP          (4u)
+#define HOST_SIM_CLOSE          (5u)
+
+/* URB status recorded in the capture: Linux errno values. */
+#define HOST_SIM_EINPROGRESS    (-115)      /* Submitted */
+#define HOST_SIM_EPIPE          (-32)       /* Stall */
+#define HOST_SIM_ENOENT         (-2)        /* Unlinked on timeout */
+#define HOST_SIM_EOVERFLOW      (-75)
+
+typedef struct
+{
+    uint8  type;
+    const HOST_USB_EP *eps;
+    uint8  epCount;
+    uint8  setup[8u];
+    uint8  endpoint;
+    uint8  *data;
+    uint32 length;
+    uint32 done;
+    uint64 deadline;
+    int    result;
+} HOST_SIM_CALL;
+
+static HOST_SIM_CALL   hostCall;
+static pthread_t       hostThread;
+static pthread_mutex_t hostLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  hostTurnChanged = PTHREAD_COND_INITIALIZER;
+static uint8  hostToolTurn;
+static uint8  hostClosed;
+static int    hostStatus;
+static uint32 hostPollFrame[SIM_MAX_EP];
+static uint64 hostUrbId;
+
+static void   HostSim_Switch(uint8 toolTurn);
+static int    HostSim_Call(uint8 type);
+static void   HostSim_Complete(int result);
+static uint8  HostSim_Transfer(void);
+static void  *HostSim_Thread(void *arg);
+static void   HostSim_Configure(void);
+static void   HostSim_Start(void);
+static void   HostSim_Frame(void);
+static uint8  HostSim_Transaction(void);
+static uint8  HostSim_Done(void);
+static int    HostSim_Report(void);
+static int32  HostSim_Errno(int result);
+
+const SIM_SCENARIO HostSim_scenario =
+{
+    "host", "run the linked host tool; tool options follow --",
+    &HostSim_Configure, &HostSim_Start, &HostSim_Frame, &HostSim_Transaction,
+    &HostSim_Done, &HostSim_Report
+};
+
+
+/*******************************************************************************
+* Function Name: HostSim_Switch
+********************************************************************************
+*
+* Summary:
+*  Passes control to the tool thread or back to the simulation thread and
+*  waits until control is passed back.
+*
+* Parameters:
+*  toolTurn: Non-zero to let the tool thread run.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void HostSim_Switch(uint8 toolTurn)
+{
+    (void) pthread_mutex_lock(&hostLock);
+
+    hostToolTurn = toolTurn;
+    (void) pthread_cond_broadcast(&hostTurnChanged);
+
+    while (hostToolTurn == toolTurn)
+    {
+        (void) pthread_cond_wait(&hostTurnChanged, &hostLock);
+    }
+
+    (void) pthread_mutex_unlock(&hostLock);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Call
+********************************************************************************
+*
+* Summary:
+*  Tool thread: hands the prepared call to the simulation and waits for its
+*  result.
+*
+*******************************************************************************/
+static int HostSim_Call(uint8 type)
+{
+    hostCall.type = type;
+    hostCall.done = 0u;
+    hostCall.result = HOST_USB_SUCCESS;
+    HostSim_Switch(0u);
+
+    return (hostCall.result);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Complete
+********************************************************************************
+*
+* Summary:
+*  Simulation thread: ends the call in progress and runs the tool up to its
+*  next call.
+*
+*******************************************************************************/
+static void HostSim_Complete(int result)
+{
+    hostCall.type = HOST_SIM_NONE;
+    hostCall.result = result;
+    HostSim_Switch(1u);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Thread
+********************************************************************************
+*
+* Summary:
+*  Tool thread: runs the tool with the options that follow "--".
+*
+*******************************************************************************/
+static void *HostSim_Thread(void *arg)
+{
+    int status;
+
+    (void) arg;
+
+    (void) pthread_mutex_lock(&hostLock);
+    while (0u == hostToolTurn)
+    {
+        (void) pthread_cond_wait(&hostTurnChanged, &hostLock);
+    }
+    (void) pthread_mutex_unlock(&hostLock);
+
+    optind = 1;
+    status = HostTool_Main(Sim_options.toolArgc, Sim_options.toolArgv);
+    HostUsb_Close(status);
+
+    return (NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Configure
+********************************************************************************
+*
+* Summary:
+*  Starts the tool and configures the simulated device with the endpoints
+*  passed to HostUsb_Open(). The open call completes at enumeration.
+*
+*******************************************************************************/
+static void HostSim_Configure(void)
+{
+    uint8 i;
+
+    if (NULL == &HostTool_Main)
+    {
+        printf("no host tool is linked\n");
+        Sim_Finish(SIM_EXIT_USAGE);
+    }
+
+    if ((NULL != Sim_options.pcapPath) && (0u == Sim_PcapOpen(Sim_options.pcapPath)))
+    {
+        printf("cannot create %s\n", Sim_options.pcapPath);
+        Sim_Finish(SIM_EXIT_USAGE);
+    }
+
+    (void) pthread_create(&hostThread, NULL, &HostSim_Thread, NULL);
+    HostSim_Switch(1u);
+
+    if (HOST_SIM_OPEN != hostCall.type)
+    {
+        /* The tool ended before it opened the device. */
+        Sim_Finish(hostStatus);
+    }
+
+    for (i = 0u; i < hostCall.epCount; ++i)
+    {
+        Sim_HostConfigureEp(hostCall.eps[i].address & (uint8) ~HOST_USB_DIR_IN,
+                            (HOST_USB_EP_INT == hostCall.eps[i].type) ?
+                                SIM_EP_TYPE_INT : SIM_EP_TYPE_BULK,
+                            (0u != (hostCall.eps[i].address & HOST_USB_DIR_IN)) ? 1u : 0u,
+                            hostCall.eps[i].maxPacket);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Start
+********************************************************************************
+*
+* Summary:
+*  The device is enumerated: completes the open call.
+*
+*******************************************************************************/
+static void HostSim_Start(void)
+{
+    HostSim_Complete(HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Frame
+********************************************************************************
+*
+* Summary:
+*  No periodic host activity.
+*
+*******************************************************************************/
+static void HostSim_Frame(void)
+{
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Transfer
+********************************************************************************
+*
+* Summary:
+*  Performs one transaction of the bulk or interrupt transfer in progress. An
+*  OUT transfer is sent in wMaxPacketSize packets; an IN transfer ends with a
+*  short packet or when the buffer is full. Interrupt endpoints are polled
+*  once per frame.
+*
+* Return:
+*  Zero if the transfer waits for the next frame.
+*
+*******************************************************************************/
+static uint8 HostSim_Transfer(void)
+{
+    uint8  epNumber = hostCall.endpoint & (uint8) ~HOST_USB_DIR_IN;
+    SIM_EP *ep = &Sim_ep[epNumber];
+    uint8  packet[SIM_EP_MAX_PACKET];
+    uint16 length;
+    uint8  handshake;
+
+    if ((SIM_EP_TYPE_INT == ep->type) && (hostPollFrame[epNumber] == Sim_frame))
+    {
+        return (0u);
+    }
+    hostPollFrame[epNumber] = Sim_frame;
+
+    if (0u == (hostCall.endpoint & HOST_USB_DIR_IN))
+    {
+        length = (uint16) (((hostCall.length - hostCall.done) > ep->maxPacket) ?
+                           ep->maxPacket : (hostCall.length - hostCall.done));
+        handshake = Sim_HostOut(epNumber, &hostCall.data[hostCall.done], length);
+    }
+    else
+    {
+        handshake = Sim_HostIn(epNumber, packet, &length);
+
+        if ((SIM_ACK == handshake) && (length > (hostCall.length - hostCall.done)))
+        {
+            HostSim_Complete(HOST_USB_OVERFLOW);
+            return (1u);
+        }
+        if (SIM_ACK == handshake)
+        {
+            (void) memcpy(&hostCall.data[hostCall.done], packet, length);
+        }
+    }
+
+    if (SIM_ACK == handshake)
+    {
+        hostCall.done += length;
+
+        if ((hostCall.done == hostCall.length) || (length < ep->maxPacket))
+        {
+            HostSim_Complete(HOST_USB_SUCCESS);
+        }
+    }
+    else if (SIM_STALL == handshake)
+    {
+        HostSim_Complete(HOST_USB_ERROR);
+    }
+    else if ((0u != hostCall.deadline) && (Sim_busTime >= hostCall.deadline))
+    {
+        HostSim_Complete(HOST_USB_TIMEOUT);
+    }
+    else
+    {
+        /* NAK: the host retries. */
+    }
+
+    return (1u);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Transaction
+********************************************************************************
+*
+* Summary:
+*  Runs the host call in progress until it uses the bus or has to wait.
+*
+*******************************************************************************/
+static uint8 HostSim_Transaction(void)
+{
+    uint64 before = Sim_busTime;
+    uint16 length;
+    uint8  busy = 1u;
+
+    while ((0u != busy) && (before == Sim_busTime))
+    {
+        switch (hostCall.type)
+        {
+            case HOST_SIM_CONTROL:
+                length = (uint16) hostCall.length;
+                HostSim_Complete((SIM_ACK == Sim_HostControl(hostCall.setup, hostCall.data, &length)) ?
+                                 (int) length : HOST_USB_ERROR);
+                break;
+
+            case HOST_SIM_TRANSFER:
+                busy = HostSim_Transfer();
+                break;
+
+            case HOST_SIM_SLEEP:
+                if (Sim_busTime < hostCall.deadline)
+                {
+                    busy = 0u;
+                }
+                else
+                {
+                    HostSim_Complete(HOST_USB_SUCCESS);
+                }
+                break;
+
+            default:
+                busy = 0u;
+                break;
+        }
+    }
+
+    return ((before != Sim_busTime) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Done
+********************************************************************************
+*
+* Summary:
+*  The run is done when the tool closes the device.
+*
+*******************************************************************************/
+static uint8 HostSim_Done(void)
+{
+    return (hostClosed);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the device side of the run; the tool has printed its own results.
+*
+*******************************************************************************/
+static int HostSim_Report(void)
+{
+    Sim_PcapClose();
+
+    Sim_ReportHeader("host");
+    printf("result          : %s\n", (SIM_EXIT_PASS == hostStatus) ? "PASS" : "FAIL");
+
+    return (hostStatus);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSim_Errno
+********************************************************************************
+*
+* Summary:
+*  Returns the URB status usbmon records for the result of a host call.
+*
+*******************************************************************************/
+static int32 HostSim_Errno(int result)
+{
+    int32 status;
+
+    switch (result)
+    {
+        case HOST_USB_ERROR:    status = HOST_SIM_EPIPE;     break;
+        case HOST_USB_TIMEOUT:  status = HOST_SIM_ENOENT;    break;
+        case HOST_USB_OVERFLOW: status = HOST_SIM_EOVERFLOW; break;
+        default:                status = 0;                  break;
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_Open
+********************************************************************************
+*
+* Summary:
+*  Configures the simulated device with the endpoints and waits until it is
+*  enumerated. The vendor and product IDs are not checked.
+*
+*******************************************************************************/
+int HostUsb_Open(uint16 vid, uint16 pid, const HOST_USB_EP eps[], uint8 count)
+{
+    (void) vid;
+    (void) pid;
+
+    hostCall.eps = eps;
+    hostCall.epCount = count;
+
+    return (HostSim_Call(HOST_SIM_OPEN));
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_Close
+********************************************************************************
+*
+* Summary:
+*  Ends the run with the tool status. Does not return.
+*
+*******************************************************************************/
+void HostUsb_Close(int status)
+{
+    hostStatus = status;
+    hostClosed = 1u;
+    (void) fflush(stdout);
+
+    for (;;)
+    {
+        (void) HostSim_Call(HOST_SIM_CLOSE);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_Control
+********************************************************************************
+*
+* Summary:
+*  Performs a control transfer.
+*
+* Return:
+*  Number of data stage bytes, or HOST_USB_ERROR if the request is stalled.
+*
+*******************************************************************************/
+int HostUsb_Control(uint8 requestType, uint8 request, uint16 value, uint16 index,
+                    uint8 data[], uint16 length, uint32 timeoutMs)
+{
+    uint8  dirIn = requestType & HOST_USB_DIR_IN;
+    uint32 received;
+    int    result;
+
+    (void) timeoutMs;
+
+    hostCall.setup[0u] = requestType;
+    hostCall.setup[1u] = request;
+    hostCall.setup[2u] = (uint8) value;
+    hostCall.setup[3u] = (uint8) (value >> 8u);
+    hostCall.setup[4u] = (uint8) index;
+    hostCall.setup[5u] = (uint8) (index >> 8u);
+    hostCall.setup[6u] = (uint8) length;
+    hostCall.setup[7u] = (uint8) (length >> 8u);
+    hostCall.data = data;
+    hostCall.length = length;
+
+    ++hostUrbId;
+    Sim_PcapRecord(Sim_busTime, hostUrbId, SIM_PCAP_SUBMIT, SIM_PCAP_XFER_CONTROL, dirIn,
+                   hostCall.setup, HOST_SIM_EINPROGRESS, length,
+                   data, (0u != dirIn) ? 0u : length);
+
+    result = HostSim_Call(HOST_SIM_CONTROL);
+    received = (result > 0) ? (uint32) result : 0u;
+
+    Sim_PcapRecord(Sim_busTime, hostUrbId, SIM_PCAP_COMPLETE, SIM_PCAP_XFER_CONTROL, dirIn,
+                   NULL, HostSim_Errno(result), received,
+                   data, (0u != dirIn) ? received : 0u);
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_Transfer
+********************************************************************************
+*
+* Summary:
+*  Performs a bulk or interrupt transfer. A zero timeout waits forever.
+*
+* Return:
+*  HOST_USB_SUCCESS, HOST_USB_TIMEOUT, HOST_USB_OVERFLOW or HOST_USB_ERROR.
+*  The number of bytes transferred is returned in all cases.
+*
+*******************************************************************************/
+int HostUsb_Transfer(uint8 endpoint, uint8 data[], uint32 length,
+                     uint32 *transferred, uint32 timeoutMs)
+{
+    uint8 xferType = (SIM_EP_TYPE_INT == Sim_ep[endpoint & (uint8) ~HOST_USB_DIR_IN].type) ?
+                     SIM_PCAP_XFER_INT : SIM_PCAP_XFER_BULK;
+    int   result;
+
+    hostCall.endpoint = endpoint;
+    hostCall.data = data;
+    hostCall.length = length;
+    hostCall.deadline = (0u != timeoutMs) ?
+                        (Sim_busTime + ((uint64) timeoutMs * SIM_NS_PER_MS)) : 0u;
+
+    ++hostUrbId;
+    Sim_PcapRecord(Sim_busTime, hostUrbId, SIM_PCAP_SUBMIT, xferType, endpoint, NULL,
+                   HOST_SIM_EINPROGRESS, length,
+                   data, (0u != (endpoint & HOST_USB_DIR_IN)) ? 0u : length);
+
+    result = HostSim_Call(HOST_SIM_TRANSFER);
+    *transferred = hostCall.done;
+
+    Sim_PcapRecord(Sim_busTime, hostUrbId, SIM_PCAP_COMPLETE, xferType, endpoint, NULL,
+                   HostSim_Errno(result), *transferred,
+                   data, (0u != (endpoint & HOST_USB_DIR_IN)) ? *transferred : 0u);
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_TimeNs
+********************************************************************************
+*
+* Summary:
+*  Returns the simulated bus time.
+*
+*******************************************************************************/
+uint64 HostUsb_TimeNs(void)
+{
+    return (Sim_busTime);
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_SleepNs
+********************************************************************************
+*
+* Summary:
+*  Lets the simulated time pass without host activity.
+*
+*******************************************************************************/
+void HostUsb_SleepNs(uint64 delayNs)
+{
+    hostCall.deadline = Sim_busTime + delayNs;
+    (void) HostSim_Call(HOST_SIM_SLEEP);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,237 @@
+/*******************************************************************************
+* File Name: host_usb_libusb.c
+*
+* Version: 1.0
+*
+* Description:
+*  libusb-1.0 backend of the host USB access (host_usb.h): runs a host tool
+*  against a device on the bus. Link with -lusb-1.0. The tool claims
+*  interface 0 of the first device with the vendor and product IDs.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <time.h>
+
+#include <libusb-1.0/libusb.h>
+
+#include "host_usb.h"
+
+#define HOST_USB_INTERFACE      (0)
+
+/* Index of an endpoint address in the endpoint type table. */
+#define HOST_USB_EP_INDEX(address)  ((((address) & 0x0Fu) * 2u) + (((address) & HOST_USB_DIR_IN) >> 7u))
+
+static libusb_context *hostContext;
+static libusb_device_handle *hostHandle;
+static uint8 hostEpType[2u * HOST_USB_MAX_EP];
+
+static int HostUsb_Result(int error);
+
+
+/*******************************************************************************
+* Function Name: HostUsb_Result
+********************************************************************************
+*
+* Summary:
+*  Converts a libusb error code.
+*
+*******************************************************************************/
+static int HostUsb_Result(int error)
+{
+    int result;
+
+    switch (error)
+    {
+        case LIBUSB_SUCCESS:        result = HOST_USB_SUCCESS;  break;
+        case LIBUSB_ERROR_TIMEOUT:  result = HOST_USB_TIMEOUT;  break;
+        case LIBUSB_ERROR_OVERFLOW: result = HOST_USB_OVERFLOW; break;
+        default:                    result = HOST_USB_ERROR;    break;
+    }
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_Open
+********************************************************************************
+*
+* Summary:
+*  Opens the device and claims its interface. The endpoint list selects bulk
+*  or interrupt transfers for each endpoint.
+*
+*******************************************************************************/
+int HostUsb_Open(uint16 vid, uint16 pid, const HOST_USB_EP eps[], uint8 count)
+{
+    uint8 i;
+
+    for (i = 0u; i < count; ++i)
+    {
+        hostEpType[HOST_USB_EP_INDEX(eps[i].address)] = eps[i].type;
+    }
+
+    if (LIBUSB_SUCCESS != libusb_init(&hostContext))
+    {
+        printf("libusb_init failed\n");
+        return (HOST_USB_ERROR);
+    }
+
+    hostHandle = libusb_open_device_with_vid_pid(hostContext, vid, pid);
+
+    if (NULL == hostHandle)
+    {
+        printf("device %04x:%04x not found\n", vid, pid);
+        libusb_exit(hostContext);
+        return (HOST_USB_ERROR);
+    }
+
+    (void) libusb_set_auto_detach_kernel_driver(hostHandle, 1);
+
+    if (LIBUSB_SUCCESS != libusb_claim_interface(hostHandle, HOST_USB_INTERFACE))
+    {
+        printf("cannot claim interface %d\n", HOST_USB_INTERFACE);
+        libusb_close(hostHandle);
+        libusb_exit(hostContext);
+        hostHandle = NULL;
+        return (HOST_USB_ERROR);
+    }
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_Close
+********************************************************************************
+*
+* Summary:
+*  Releases the device.
+*
+*******************************************************************************/
+void HostUsb_Close(int status)
+{
+    (void) status;
+
+    if (NULL != hostHandle)
+    {
+        (void) libusb_release_interface(hostHandle, HOST_USB_INTERFACE);
+        libusb_close(hostHandle);
+        libusb_exit(hostContext);
+        hostHandle = NULL;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_Control
+********************************************************************************
+*
+* Summary:
+*  Performs a control transfer.
+*
+* Return:
+*  Number of data stage bytes, or HOST_USB_ERROR.
+*
+*******************************************************************************/
+int HostUsb_Control(uint8 requestType, uint8 request, uint16 value, uint16 index,
+                    uint8 data[], uint16 length, uint32 timeoutMs)
+{
+    int result = libusb_control_transfer(hostHandle, requestType, request, value, index,
+                                         data, length, timeoutMs);
+
+    return ((result < 0) ? HOST_USB_ERROR : result);
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_Transfer
+********************************************************************************
+*
+* Summary:
+*  Performs a bulk or interrupt transfer. A zero timeout waits forever.
+*
+*******************************************************************************/
+int HostUsb_Transfer(uint8 endpoint, uint8 data[], uint32 length,
+                     uint32 *transferred, uint32 timeoutMs)
+{
+    int actual = 0;
+    int error;
+
+    if (HOST_USB_EP_INT == hostEpType[HOST_USB_EP_INDEX(endpoint)])
+    {
+        error = libusb_interrupt_transfer(hostHandle, endpoint, data, (int) length,
+                                          &actual, timeoutMs);
+    }
+    else
+    {
+        error = libusb_bulk_transfer(hostHandle, endpoint, data, (int) length,
+                                     &actual, timeoutMs);
+    }
+
+    *transferred = (uint32) actual;
+
+    return (HostUsb_Result(error));
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_TimeNs
+********************************************************************************
+*
+* Summary:
+*  Returns the monotonic time.
+*
+*******************************************************************************/
+uint64 HostUsb_TimeNs(void)
+{
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (((uint64) now.tv_sec * 1000000000u) + (uint64) now.tv_nsec);
+}
+
+
+/*******************************************************************************
+* Function Name: HostUsb_SleepNs
+********************************************************************************
+*
+* Summary:
+*  Sleeps for the delay.
+*
+*******************************************************************************/
+void HostUsb_SleepNs(uint64 delayNs)
+{
+    struct timespec delay;
+
+    delay.tv_sec  = (time_t) (delayNs / 1000000000u);
+    delay.tv_nsec = (long) (delayNs % 1000000000u);
+    (void) nanosleep(&delay, NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*  Runs the host tool.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    return (HostTool_Main(argc, argv));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,33 @@
+/*******************************************************************************
+* File Name: project.h
+*
+* Version: 1.0
+*
+* Description:
+*  Host stand-in for the generated project.h. Includes the emulated component
+*  APIs used by the USBFS code examples.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(CY_PROJECT_H)
+#define CY_PROJECT_H
+
+#include "cytypes.h"
+#include "USBFS.h"
+#include "USBUART.h"
+#include "UART.h"
+#include "sim_periph.h"
+
+#endif /* (CY_PROJECT_H) */
+
+
+/* [] END OF FILE */
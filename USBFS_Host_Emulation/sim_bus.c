@@ -0,0 +1,1067 @@
+/*******************************************************************************
+* File Name: sim_bus.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file implements the simulated full-speed USB bus and host, and the
+*  entry point of the host emulation. The firmware main() is compiled with
+*  -Dmain=Firmware_main and is called from here once the command line has been
+*  parsed. The run ends when the selected host scenario is done; the scenario
+*  report decides the exit status so the run can gate CI.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim_bus.h"
+
+/* The firmware main() is renamed on the command line; restore it here. */
+#undef main
+
+extern int Firmware_main();
+
+/* Bus timing in bit times, including inter-packet gaps. */
+#define SIM_TOKEN_BITS          (35u)
+#define SIM_DATA_BITS(length)   (35u + (8u * (uint32) (length)))
+#define SIM_HANDSHAKE_BITS      (19u)
+#define SIM_GAP_BITS            (16u)
+#define SIM_SOF_BITS            (SIM_TOKEN_BITS + SIM_GAP_BITS)
+
+/* Time from pull-up connect until SET_CONFIGURATION completes. */
+#define SIM_ENUMERATION_NS      (5u * SIM_NS_PER_MS)
+
+/* Defaults of the run options. */
+#define SIM_DEFAULT_PACKETS     (10000u)
+#define SIM_DEFAULT_LENGTH      (64u)
+#define SIM_DEFAULT_WINDOW      (2u)
+#define SIM_DEFAULT_INTERVAL    (10u)
+#define SIM_DEFAULT_DURATION    (1000u)
+#define SIM_DEFAULT_TIME_LIMIT  (60000u)
+#define SIM_DEFAULT_BAUD        (115200u)
+#define SIM_DEFAULT_PORTS       (2u)
+
+typedef struct
+{
+    uint64 time;
+    SIM_EVENT_FN handler;
+    uint32 arg;
+    uint8  used;
+    uint8  isr;         /* Handler runs as an interrupt */
+} SIM_EVENT;
+
+SIM_EP  Sim_ep[SIM_MAX_EP];
+SIM_OPTIONS Sim_options;
+uint64  Sim_now;
+uint64  Sim_busTime;
+uint64  Sim_startTime;
+uint64  Sim_sleepNs;
+uint32  Sim_frame;
+uint32  Sim_apiCalls;
+uint32  Sim_isrCount;
+uint8   Sim_configured;
+uint8   Sim_busSuspended;
+uint8   Sim_busActivity;
+uint32  Sim_resetReason = CY_PM_RESET_REASON_XRES;
+uint8   Sim_intEnabled;
+
+static const SIM_DEVICE   *simDevice;
+static const SIM_SCENARIO *simScenario;
+static SIM_EVENT simEvents[SIM_MAX_EVENTS];
+static uint64  simNextSof;
+static uint64  simEnumTime;
+static uint8   simEnumPending;
+static uint8   simInService;
+static uint8   simIrq;
+static uint8   simDeepSleep;
+static uint16  simPendingEp;
+static uint8   simPendingSof;
+static uint8   simPendingLpm;
+static uint32  simLpmBesl;
+static jmp_buf simResetJmp;
+static struct timespec simWallStart;
+
+static void   Sim_Service(void);
+static void   Sim_DeliverIsr(void);
+static uint8  Sim_RunEvents(uint8 interrupts);
+static uint64 Sim_NextEventTime(void);
+static void   Sim_Usage(const char8 *program);
+
+
+/*******************************************************************************
+* Function Name: Sim_CyclesToNs
+********************************************************************************
+*
+* Summary:
+*  Converts CPU cycles into simulated nanoseconds for the configured HFCLK.
+*
+* Parameters:
+*  cycles: Number of CPU cycles.
+*
+* Return:
+*  Duration in nanoseconds.
+*
+*******************************************************************************/
+uint64 Sim_CyclesToNs(uint32 cycles)
+{
+    return (((uint64) cycles * 1000000000u) / Sim_options.cpuHz);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Attach
+********************************************************************************
+*
+* Summary:
+*  Registers the interrupt hooks of the emulated component. Called from the
+*  component initialization.
+*
+* Parameters:
+*  device: Component hooks.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sim_Attach(const SIM_DEVICE *device)
+{
+    simDevice = device;
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Connect
+********************************************************************************
+*
+* Summary:
+*  Models the Dp pull-up being enabled. The host enumerates the device unless
+*  it is reconnecting after hibernate, in which case the host still considers
+*  the device configured.
+*
+* Parameters:
+*  enumerate: Non-zero to let the host reset and configure the device.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sim_Connect(uint8 enumerate)
+{
+    if (0u != enumerate)
+    {
+        Sim_configured = 0u;
+        simEnumPending = 1u;
+        simEnumTime    = Sim_now + SIM_ENUMERATION_NS;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Step
+********************************************************************************
+*
+* Summary:
+*  Charges CPU cycles for the calling API and lets the bus catch up with the
+*  CPU. Endpoint interrupts raised by the host are delivered from here, which
+*  models an interrupt preempting the main loop at the next instruction.
+*
+* Parameters:
+*  cycles: CPU cycles consumed by the caller.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sim_Step(uint32 cycles)
+{
+    ++Sim_apiCalls;
+    Sim_now += Sim_CyclesToNs(cycles);
+
+    /* Component APIs called from an interrupt hook only consume time. */
+    if (0u == simInService)
+    {
+        Sim_Service();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Sleep
+********************************************************************************
+*
+* Summary:
+*  Models WFI (Sleep) or DeepSleep: simulated time advances without CPU
+*  activity until an interrupt is raised. In DeepSleep only bus activity
+*  (resume or reset signaling) wakes the device; timers and SOF are stopped.
+*
+* Parameters:
+*  deepSleep: Non-zero for DeepSleep.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sim_Sleep(uint8 deepSleep)
+{
+    uint64 start = Sim_now;
+    uint64 next;
+
+    simIrq = 0u;
+    simDeepSleep = deepSleep;
+
+    if ((0u != deepSleep) && (0u == Sim_busSuspended))
+    {
+        /* Bus is active: the Dp edge wakes the device at the next SOF. */
+        simIrq = 1u;
+        Sim_now = (simNextSof > Sim_now) ? simNextSof : Sim_now;
+    }
+
+    while (0u == simIrq)
+    {
+        next = (0u != Sim_configured) ? Sim_busTime : (Sim_now + SIM_FRAME_NS);
+
+        if (0u == deepSleep)
+        {
+            if (Sim_NextEventTime() < next)
+            {
+                next = Sim_NextEventTime();
+            }
+            if ((0u != simEnumPending) && (simEnumTime < next))
+            {
+                next = simEnumTime;
+            }
+        }
+
+        /* Always make progress: the time limit ends a sleep that never wakes. */
+        Sim_now = (next > Sim_now) ? next : (Sim_now + SIM_BIT_TIME_NS(1u));
+        Sim_Service();
+    }
+
+    simDeepSleep = 0u;
+    Sim_sleepNs += Sim_now - start;
+    Sim_Service();
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Hibernate
+********************************************************************************
+*
+* Summary:
+*  Models Hibernate: the device sleeps until the host resumes the bus and then
+*  restarts from reset with the hibernate wakeup reset reason. Variables keep
+*  their values, as CY_NOINIT variables do on the device.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Does not return.
+*
+*******************************************************************************/
+void Sim_Hibernate(void)
+{
+    uint8 i;
+
+    Sim_Sleep(1u);
+
+    for (i = 0u; i < SIM_MAX_EVENTS; ++i)
+    {
+        simEvents[i].used = 0u;
+    }
+
+    simDevice       = NULL;
+    simPendingEp    = 0u;
+    simPendingSof   = 0u;
+    simPendingLpm   = 0u;
+    Sim_intEnabled  = 0u;
+    Sim_resetReason = CY_PM_RESET_REASON_WAKEUP_HIB;
+
+    longjmp(simResetJmp, 1);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_AddEvent
+********************************************************************************
+*
+* Summary:
+*  Adds a timed event to the event table. Returns non-zero on success, zero if
+*  the table is full.
+*
+*******************************************************************************/
+static uint8 Sim_AddEvent(uint64 delayNs, SIM_EVENT_FN handler, uint32 arg, uint8 isr)
+{
+    uint8 i;
+
+    for (i = 0u; i < SIM_MAX_EVENTS; ++i)
+    {
+        if (0u == simEvents[i].used)
+        {
+            simEvents[i].time    = Sim_now + delayNs;
+            simEvents[i].handler = handler;
+            simEvents[i].arg     = arg;
+            simEvents[i].isr     = isr;
+            simEvents[i].used    = 1u;
+            return (1u);
+        }
+    }
+
+    return (0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Schedule
+********************************************************************************
+*
+* Summary:
+*  Schedules a timed event (timer interrupt or DMA completion).
+*
+* Parameters:
+*  delayNs: Delay from now.
+*  handler: Event handler, called in interrupt context.
+*  arg:     Handler argument.
+*
+* Return:
+*  Non-zero on success, zero if the event table is full.
+*
+*******************************************************************************/
+uint8 Sim_Schedule(uint64 delayNs, SIM_EVENT_FN handler, uint32 arg)
+{
+    return (Sim_AddEvent(delayNs, handler, arg, 1u));
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_ScheduleHw
+********************************************************************************
+*
+* Summary:
+*  Schedules a timed peripheral state change that does not interrupt the CPU,
+*  such as a UART frame shifted out. The handler costs no CPU cycles and does
+*  not wake the CPU; it schedules an interrupt event if one is due.
+*
+* Parameters:
+*  delayNs: Delay from now.
+*  handler: Event handler.
+*  arg:     Handler argument.
+*
+* Return:
+*  Non-zero on success, zero if the event table is full.
+*
+*******************************************************************************/
+uint8 Sim_ScheduleHw(uint64 delayNs, SIM_EVENT_FN handler, uint32 arg)
+{
+    return (Sim_AddEvent(delayNs, handler, arg, 0u));
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Cancel
+********************************************************************************
+*
+* Summary:
+*  Removes all pending events of a handler.
+*
+* Parameters:
+*  handler: Event handler.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sim_Cancel(SIM_EVENT_FN handler)
+{
+    uint8 i;
+
+    for (i = 0u; i < SIM_MAX_EVENTS; ++i)
+    {
+        if (handler == simEvents[i].handler)
+        {
+            simEvents[i].used = 0u;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_NextEventTime
+********************************************************************************
+*
+* Summary:
+*  Returns the time of the earliest pending event.
+*
+*******************************************************************************/
+static uint64 Sim_NextEventTime(void)
+{
+    uint64 next = UINT64_MAX;
+    uint8 i;
+
+    for (i = 0u; i < SIM_MAX_EVENTS; ++i)
+    {
+        if ((0u != simEvents[i].used) && (simEvents[i].time < next))
+        {
+            next = simEvents[i].time;
+        }
+    }
+
+    return (next);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_RunEvents
+********************************************************************************
+*
+* Summary:
+*  Runs the events that are due: the peripheral state changes, and the
+*  interrupts when they are enabled. Returns non-zero if an interrupt is due
+*  but masked.
+*
+*******************************************************************************/
+static uint8 Sim_RunEvents(uint8 interrupts)
+{
+    uint8 masked = 0u;
+    uint8 i;
+
+    for (i = 0u; i < SIM_MAX_EVENTS; ++i)
+    {
+        if ((0u != simEvents[i].used) && (simEvents[i].time <= Sim_now))
+        {
+            if (0u == simEvents[i].isr)
+            {
+                simEvents[i].used = 0u;
+                simEvents[i].handler(simEvents[i].arg);
+            }
+            else if (0u != interrupts)
+            {
+                simEvents[i].used = 0u;
+                simEvents[i].handler(simEvents[i].arg);
+                ++Sim_isrCount;
+                Sim_now += Sim_CyclesToNs(SIM_ISR_CYCLES);
+                simIrq = 1u;
+            }
+            else
+            {
+                masked = 1u;
+            }
+        }
+    }
+
+    return (masked);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_DeliverIsr
+********************************************************************************
+*
+* Summary:
+*  Delivers the pending USB interrupts to the component when interrupts are
+*  globally enabled.
+*
+*******************************************************************************/
+static void Sim_DeliverIsr(void)
+{
+    uint8 ep;
+
+    if ((0u == Sim_intEnabled) || (NULL == simDevice))
+    {
+        return;
+    }
+
+    if ((0u != simPendingLpm) && (NULL != simDevice->lpmIsr))
+    {
+        simPendingLpm = 0u;
+        simDevice->lpmIsr(simLpmBesl);
+        ++Sim_isrCount;
+        simIrq = 1u;
+    }
+
+    if ((0u != simPendingSof) && (0u == simDeepSleep))
+    {
+        simPendingSof = 0u;
+        if (NULL != simDevice->sofIsr)
+        {
+            simDevice->sofIsr();
+            ++Sim_isrCount;
+            simIrq = 1u;
+        }
+    }
+
+    for (ep = 1u; (0u != simPendingEp) && (ep < SIM_MAX_EP); ++ep)
+    {
+        if (0u != (simPendingEp & (1u << ep)))
+        {
+            simPendingEp &= (uint16) ~(1u << ep);
+            simDevice->epIsr(ep);
+            ++Sim_isrCount;
+            Sim_now += Sim_CyclesToNs(SIM_ISR_CYCLES);
+            simIrq = 1u;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Service
+********************************************************************************
+*
+* Summary:
+*  Advances the bus up to the current CPU time: enumeration, SOF, timed events
+*  and host transactions of the selected scenario.
+*
+*******************************************************************************/
+static void Sim_Service(void)
+{
+    uint64 before;
+
+    simInService = 1u;
+
+    for (;;)
+    {
+        if ((0u == simDeepSleep) && (0u != Sim_RunEvents(Sim_intEnabled)))
+        {
+            /* A masked interrupt stays pending and still ends WFI. */
+            simIrq = 1u;
+        }
+
+        if ((0u != simEnumPending) && (Sim_now >= simEnumTime) && (NULL != simDevice))
+        {
+            simEnumPending = 0u;
+            Sim_busSuspended = 0u;
+            Sim_busActivity = 1u;
+            simDevice->busReset();
+            simDevice->setConfiguration(1u);
+            Sim_configured = 1u;
+            Sim_busTime = Sim_now;
+            simNextSof = Sim_now;
+            simIrq = 1u;
+
+            if (0u == Sim_startTime)
+            {
+                Sim_startTime = Sim_now;
+                simScenario->start();
+            }
+        }
+
+        Sim_DeliverIsr();
+
+        if ((0u != Sim_startTime) && (0u != simScenario->done()))
+        {
+            Sim_Finish(simScenario->report());
+        }
+
+        if (Sim_now >= Sim_options.timeLimitNs)
+        {
+            (void) simScenario->report();
+            printf("result          : TIMEOUT\n");
+            Sim_Finish(SIM_EXIT_TIMEOUT);
+        }
+
+        if ((Sim_busTime > Sim_now) || (0u == Sim_configured))
+        {
+            break;
+        }
+
+        if (Sim_busTime >= simNextSof)
+        {
+            /* Start of frame. A transaction never crosses the SOF, so the
+            * host only delays the SOF by the transaction still in progress.
+            */
+            simNextSof += SIM_FRAME_NS;
+
+            if (0u == Sim_busSuspended)
+            {
+                ++Sim_frame;
+                Sim_busActivity = 1u;
+                simPendingSof = 1u;
+                simIrq = 1u;
+                Sim_busTime += SIM_BIT_TIME_NS(SIM_SOF_BITS);
+            }
+
+            simScenario->frame();
+        }
+        else if (0u == Sim_busSuspended)
+        {
+            before = Sim_busTime;
+            (void) simScenario->transaction();
+
+            if (before == Sim_busTime)
+            {
+                /* Host is idle until the next frame. */
+                Sim_busTime = simNextSof;
+            }
+        }
+        else
+        {
+            Sim_busTime = simNextSof;
+        }
+    }
+
+    simInService = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_HostConfigureEp
+********************************************************************************
+*
+* Summary:
+*  Describes a device endpoint as listed in the configuration descriptor of
+*  the example project. Called from the scenario configure hook.
+*
+* Parameters:
+*  epNumber:  Endpoint number (1-8).
+*  type:      SIM_EP_TYPE_BULK or SIM_EP_TYPE_INT.
+*  dirIn:     Non-zero for IN endpoints.
+*  maxPacket: wMaxPacketSize.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sim_HostConfigureEp(uint8 epNumber, uint8 type, uint8 dirIn, uint16 maxPacket)
+{
+    Sim_ep[epNumber].type      = type;
+    Sim_ep[epNumber].dirIn     = dirIn;
+    Sim_ep[epNumber].maxPacket = maxPacket;
+    Sim_ep[epNumber].armed     = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_HostOut
+********************************************************************************
+*
+* Summary:
+*  Performs one OUT transaction. The data packet is always sent on the bus; the
+*  device ACKs it only when the endpoint is armed.
+*
+* Parameters:
+*  epNumber: Endpoint number.
+*  data:     Packet payload.
+*  length:   Payload length (up to wMaxPacketSize).
+*
+* Return:
+*  SIM_ACK, SIM_NAK or SIM_STALL.
+*
+*******************************************************************************/
+uint8 Sim_HostOut(uint8 epNumber, const uint8 data[], uint16 length)
+{
+    SIM_EP *ep = &Sim_ep[epNumber];
+    uint8 handshake;
+
+    Sim_busActivity = 1u;
+    Sim_busTime += SIM_BIT_TIME_NS(SIM_TOKEN_BITS + SIM_DATA_BITS(length) +
+                                   SIM_HANDSHAKE_BITS + SIM_GAP_BITS);
+
+    if ((SIM_EP_TYPE_NONE == ep->type) || (0u != ep->dirIn) || (length > ep->maxPacket))
+    {
+        handshake = SIM_STALL;
+    }
+    else if (0u == ep->armed)
+    {
+        ++ep->naks;
+        handshake = SIM_NAK;
+    }
+    else
+    {
+        if (0u != length)
+        {
+            (void) memcpy(ep->buffer, data, length);
+
+            /* DMA with automatic management streams the packet to SRAM. */
+            if (NULL != ep->dmaBuffer)
+            {
+                (void) memcpy(ep->dmaBuffer, data, (length > ep->dmaLength) ? ep->dmaLength : length);
+            }
+        }
+        ep->count  = length;
+        ep->armed  = 0u;
+        ep->arbPtr = 0u;
+        ++ep->acks;
+        simPendingEp |= (uint16) (1u << epNumber);
+        simIrq = 1u;
+        handshake = SIM_ACK;
+    }
+
+    return (handshake);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_HostIn
+********************************************************************************
+*
+* Summary:
+*  Performs one IN transaction.
+*
+* Parameters:
+*  epNumber: Endpoint number.
+*  data:     Buffer of wMaxPacketSize bytes for the packet payload.
+*  length:   Returns the payload length.
+*
+* Return:
+*  SIM_ACK, SIM_NAK or SIM_STALL.
+*
+*******************************************************************************/
+uint8 Sim_HostIn(uint8 epNumber, uint8 data[], uint16 *length)
+{
+    SIM_EP *ep = &Sim_ep[epNumber];
+    uint8 handshake;
+
+    Sim_busActivity = 1u;
+    *length = 0u;
+
+    if ((SIM_EP_TYPE_NONE == ep->type) || (0u == ep->dirIn))
+    {
+        Sim_busTime += SIM_BIT_TIME_NS(SIM_TOKEN_BITS + SIM_HANDSHAKE_BITS + SIM_GAP_BITS);
+        handshake = SIM_STALL;
+    }
+    else if (0u == ep->armed)
+    {
+        Sim_busTime += SIM_BIT_TIME_NS(SIM_TOKEN_BITS + SIM_HANDSHAKE_BITS + SIM_GAP_BITS);
+        ++ep->naks;
+        handshake = SIM_NAK;
+    }
+    else
+    {
+        Sim_busTime += SIM_BIT_TIME_NS(SIM_TOKEN_BITS + SIM_DATA_BITS(ep->count) +
+                                       SIM_HANDSHAKE_BITS + SIM_GAP_BITS);
+        if (0u != ep->count)
+        {
+            (void) memcpy(data, (NULL != ep->dmaBuffer) ? ep->dmaBuffer : ep->buffer, ep->count);
+        }
+        *length    = ep->count;
+        ep->armed  = 0u;
+        ep->arbPtr = 0u;
+        ep->ackd   = 1u;
+        ++ep->acks;
+        simPendingEp |= (uint16) (1u << epNumber);
+        simIrq = 1u;
+        handshake = SIM_ACK;
+    }
+
+    return (handshake);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_HostControl
+********************************************************************************
+*
+* Summary:
+*  Performs a control transfer on endpoint 0. The request is handled by the
+*  component in the context of the EP0 interrupt.
+*
+* Parameters:
+*  setup:  8-byte setup packet.
+*  data:   Data stage buffer (host to device data, or device to host result).
+*  length: In: wLength for OUT data; Out: number of bytes returned for IN.
+*
+* Return:
+*  SIM_ACK or SIM_STALL.
+*
+*******************************************************************************/
+uint8 Sim_HostControl(const uint8 setup[], uint8 data[], uint16 *length)
+{
+    uint8 handshake = SIM_STALL;
+    uint16 stages;
+
+    Sim_busActivity = 1u;
+
+    if ((NULL != simDevice) && (NULL != simDevice->control))
+    {
+        handshake = (0u != simDevice->control(setup, data, length)) ? SIM_ACK : SIM_STALL;
+        ++Sim_isrCount;
+        Sim_now += Sim_CyclesToNs(SIM_ISR_CYCLES);
+    }
+
+    /* Setup, 8-byte data stages and the status stage. */
+    stages = (uint16) ((*length + 7u) / 8u);
+    Sim_busTime += SIM_BIT_TIME_NS((2u + stages) * (SIM_TOKEN_BITS + SIM_DATA_BITS(8u) +
+                                   SIM_HANDSHAKE_BITS + SIM_GAP_BITS));
+
+    return (handshake);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_HostBusReset
+********************************************************************************
+*
+* Summary:
+*  Drives bus reset and re-enumerates the device.
+*
+*******************************************************************************/
+void Sim_HostBusReset(void)
+{
+    uint8 ep;
+
+    for (ep = 1u; ep < SIM_MAX_EP; ++ep)
+    {
+        Sim_ep[ep].armed = 0u;
+    }
+
+    Sim_configured   = 0u;
+    Sim_busSuspended = 0u;
+    simEnumPending   = 1u;
+    simEnumTime      = Sim_busTime + SIM_ENUMERATION_NS;
+    simIrq           = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_HostSuspend
+********************************************************************************
+*
+* Summary:
+*  Stops SOF generation; the device detects suspend after 3 ms of idle bus.
+*
+*******************************************************************************/
+void Sim_HostSuspend(void)
+{
+    Sim_busSuspended = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_HostResume
+********************************************************************************
+*
+* Summary:
+*  Drives resume signaling and restarts SOF generation. Wakes the device from
+*  DeepSleep.
+*
+*******************************************************************************/
+void Sim_HostResume(void)
+{
+    Sim_busSuspended = 0u;
+    Sim_busActivity = 1u;
+    simIrq = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_HostLpm
+********************************************************************************
+*
+* Summary:
+*  Sends an LPM transaction with the given BESL and puts the link into L1.
+*
+*******************************************************************************/
+void Sim_HostLpm(uint32 besl)
+{
+    Sim_busTime += SIM_BIT_TIME_NS(2u * SIM_TOKEN_BITS + SIM_HANDSHAKE_BITS + SIM_GAP_BITS);
+    simLpmBesl = besl;
+    simPendingLpm = 1u;
+    Sim_busSuspended = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_ReportHeader
+********************************************************************************
+*
+* Summary:
+*  Prints the common part of a scenario report.
+*
+*******************************************************************************/
+void Sim_ReportHeader(const char8 *title)
+{
+    struct timespec now;
+    uint64 simNs = Sim_now - Sim_startTime;
+    uint64 wallNs;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    wallNs = ((uint64) (now.tv_sec - simWallStart.tv_sec) * 1000000000u) +
+             (uint64) now.tv_nsec - (uint64) simWallStart.tv_nsec;
+
+    printf("scenario        : %s\n", title);
+    printf("sim time        : %.3f ms\n", (double) simNs / 1e6);
+    printf("frames          : %lu\n", (unsigned long) Sim_frame);
+    printf("cpu busy        : %.1f %%\n",
+           (0u != Sim_now) ? (100.0 * (double) (Sim_now - Sim_sleepNs) / (double) Sim_now) : 0.0);
+    printf("api calls       : %lu\n", (unsigned long) Sim_apiCalls);
+    printf("interrupts      : %lu\n", (unsigned long) Sim_isrCount);
+    printf("wall time       : %.3f ms\n", (double) wallNs / 1e6);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_ReportLatency
+********************************************************************************
+*
+* Summary:
+*  Prints a min/avg/max latency line in microseconds.
+*
+*******************************************************************************/
+void Sim_ReportLatency(const char8 *label, uint64 minNs, uint64 sumNs,
+                       uint64 maxNs, uint32 samples)
+{
+    if (0u == samples)
+    {
+        printf("%-16s: n/a\n", label);
+    }
+    else
+    {
+        printf("%-16s: min %.2f avg %.2f max %.2f us\n", label, (double) minNs / 1e3,
+               ((double) sumNs / (double) samples) / 1e3, (double) maxNs / 1e3);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Finish
+********************************************************************************
+*
+* Summary:
+*  Ends the simulation run.
+*
+*******************************************************************************/
+void Sim_Finish(int status)
+{
+    (void) fflush(stdout);
+    exit(status);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_Usage
+********************************************************************************
+*
+* Summary:
+*  Prints the command line help and the list of scenarios.
+*
+*******************************************************************************/
+static void Sim_Usage(const char8 *program)
+{
+    uint8 i;
+
+    printf("usage: %s -s <scenario> [options] [-- host tool options]\n", program);
+    printf("  -n <count>   packets to transfer (%u)\n", SIM_DEFAULT_PACKETS);
+    printf("  -l <bytes>   packet length (%u)\n", SIM_DEFAULT_LENGTH);
+    printf("  -w <count>   packets the host keeps in flight (%u)\n", SIM_DEFAULT_WINDOW);
+    printf("  -i <ms>      polling or event interval (%u)\n", SIM_DEFAULT_INTERVAL);
+    printf("  -d <ms>      duration of timed scenarios (%u)\n", SIM_DEFAULT_DURATION);
+    printf("  -t <ms>      simulated time limit (%u)\n", SIM_DEFAULT_TIME_LIMIT);
+    printf("  -k <KB/s>    fail if throughput is below this value\n");
+    printf("  -c <MHz>     CPU clock (%u)\n", SIM_CPU_HZ / 1000000u);
+    printf("  -b <baud>    COM port baud rate set by the host (%u)\n", SIM_DEFAULT_BAUD);
+    printf("  -m <count>   COM ports of the cdc-multi scenario (%u)\n", SIM_DEFAULT_PORTS);
+    printf("  -p <file>    write the host tool traffic to a usbmon pcap file\n");
+    printf("  -v           verbose\n");
+    printf("scenarios:\n");
+
+    for (i = 0u; NULL != Sim_scenarios[i]; ++i)
+    {
+        printf("  %-12s %s\n", Sim_scenarios[i]->name, Sim_scenarios[i]->help);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+*
+* Summary:
+*  Parses the command line, configures the scenario and runs the firmware.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char8 *name = NULL;
+    int opt;
+    uint8 i;
+
+    Sim_options.packets     = SIM_DEFAULT_PACKETS;
+    Sim_options.length      = SIM_DEFAULT_LENGTH;
+    Sim_options.window      = SIM_DEFAULT_WINDOW;
+    Sim_options.interval    = SIM_DEFAULT_INTERVAL;
+    Sim_options.durationMs  = SIM_DEFAULT_DURATION;
+    Sim_options.timeLimitNs = (uint64) SIM_DEFAULT_TIME_LIMIT * SIM_NS_PER_MS;
+    Sim_options.cpuHz       = SIM_CPU_HZ;
+    Sim_options.baud        = SIM_DEFAULT_BAUD;
+    Sim_options.ports       = SIM_DEFAULT_PORTS;
+
+    while (-1 != (opt = getopt(argc, argv, "s:n:l:w:i:d:t:k:c:b:m:p:vh")))
+    {
+        switch (opt)
+        {
+            case 's': name = optarg; break;
+            case 'n': Sim_options.packets    = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'l': Sim_options.length     = (uint16) strtoul(optarg, NULL, 0); break;
+            case 'w': Sim_options.window     = (uint16) strtoul(optarg, NULL, 0); break;
+            case 'i': Sim_options.interval   = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'd': Sim_options.durationMs = (uint32) strtoul(optarg, NULL, 0); break;
+            case 't': Sim_options.timeLimitNs = (uint64) strtoul(optarg, NULL, 0) * SIM_NS_PER_MS; break;
+            case 'k': Sim_options.minKBps    = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'c': Sim_options.cpuHz      = (uint32) strtoul(optarg, NULL, 0) * 1000000u; break;
+            case 'b': Sim_options.baud       = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'm': Sim_options.ports      = (uint8) strtoul(optarg, NULL, 0); break;
+            case 'p': Sim_options.pcapPath   = optarg; break;
+            case 'v': Sim_options.verbose    = 1u; break;
+            default:
+                Sim_Usage(argv[0]);
+                return (SIM_EXIT_USAGE);
+        }
+    }
+
+    /* Options after "--" are passed to the host tool. */
+    argv[optind - 1] = argv[0];
+    Sim_options.toolArgc = argc - optind + 1;
+    Sim_options.toolArgv = &argv[optind - 1];
+
+    for (i = 0u; (NULL != name) && (NULL != Sim_scenarios[i]); ++i)
+    {
+        if (0 == strcmp(name, Sim_scenarios[i]->name))
+        {
+            simScenario = Sim_scenarios[i];
+        }
+    }
+
+    if ((NULL == simScenario) || (0u == Sim_options.cpuHz) || (0u == Sim_options.baud) ||
+        (0u == Sim_options.window) ||
+        (0u == Sim_options.ports) || (Sim_options.ports > SIM_MAX_COM_PORTS) ||
+        (Sim_options.window > SIM_MAX_WINDOW) ||
+        (Sim_options.length > SIM_EP_MAX_PACKET))
+    {
+        Sim_Usage(argv[0]);
+        return (SIM_EXIT_USAGE);
+    }
+
+    cydelay_freq_hz = Sim_options.cpuHz;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &simWallStart);
+    simScenario->configure();
+
+    /* Hibernate wakeup restarts the firmware from here. */
+    (void) setjmp(simResetJmp);
+    simInService = 0u;
+    simDeepSleep = 0u;
+
+    (void) Firmware_main();
+
+    /* The examples never return from main(). */
+    printf("firmware returned from main()\n");
+    return (SIM_EXIT_DATA_ERROR);
+}
+
+
+/* [] END OF FILE */
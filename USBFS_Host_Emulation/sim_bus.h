@@ -0,0 +1,198 @@
+/*******************************************************************************
+* File Name: sim_bus.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides the interface of the simulated full-speed USB bus and
+*  host used by the USBFS host emulation. The bus runs in simulated time:
+*  every emulated component API call charges CPU cycles, and the host
+*  scenario performs bus transactions until the bus catches up with the CPU.
+*  Endpoint completions are delivered to the emulated component as interrupts.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(SIM_BUS_H)
+#define SIM_BUS_H
+
+#include "cytypes.h"
+
+
+/***************************************
+*    Constants
+****************************************/
+
+#define SIM_MAX_EP              (9u)
+#define SIM_EP_MAX_PACKET       (64u)
+#define SIM_MAX_EVENTS          (16u)
+#define SIM_MAX_WINDOW          (64u)
+
+/* A CDC COM port takes three of the eight data endpoints. */
+#define SIM_MAX_COM_PORTS       ((SIM_MAX_EP - 1u) / 3u)
+
+/* Endpoint transfer types (bmAttributes). */
+#define SIM_EP_TYPE_NONE        (0u)
+#define SIM_EP_TYPE_BULK        (2u)
+#define SIM_EP_TYPE_INT         (3u)
+
+/* Handshake returned to the host. */
+#define SIM_ACK                 (0u)
+#define SIM_NAK                 (1u)
+#define SIM_STALL               (2u)
+
+/* Full-speed timing in nanoseconds. */
+#define SIM_NS_PER_MS           (1000000u)
+#define SIM_FRAME_NS            (SIM_NS_PER_MS)
+#define SIM_BIT_TIME_NS(bits)   (((uint64) (bits) * 1000u) / 12u)
+
+/* Default CPU model: PSoC 4200L running from a 48-MHz HFCLK. */
+#define SIM_CPU_HZ              (48000000u)
+#define SIM_API_CALL_CYCLES     (40u)
+#define SIM_REG_CYCLES          (4u)    /* Pin write or register access */
+#define SIM_ISR_CYCLES          (60u)
+#define SIM_DMA_SETUP_CYCLES    (120u)
+#define SIM_DMA_CYCLES_PER_BYTE (2u)
+
+/* Exit status of the simulation run. */
+#define SIM_EXIT_PASS           (0)
+#define SIM_EXIT_DATA_ERROR     (1)
+#define SIM_EXIT_SLOW           (2)
+#define SIM_EXIT_TIMEOUT        (3)
+#define SIM_EXIT_USAGE          (4)
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Endpoint hardware state: SIE mode plus the endpoint buffer. */
+typedef struct
+{
+    uint8  type;
+    uint8  dirIn;
+    uint8  armed;
+    uint8  ackd;
+    uint16 maxPacket;
+    uint16 count;
+    uint16 arbPtr;          /* Byte the arbiter data register accesses next */
+    uint8  buffer[SIM_EP_MAX_PACKET];
+    uint8  *dmaBuffer;      /* SRAM buffer of DMA with automatic management */
+    uint16 dmaLength;
+    uint32 acks;
+    uint32 naks;
+} SIM_EP;
+
+/* Device side hooks: the interrupt sources of the emulated component. */
+typedef struct
+{
+    void  (*busReset)(void);
+    void  (*setConfiguration)(uint8 configuration);
+    void  (*epIsr)(uint8 epNumber);
+    void  (*sofIsr)(void);
+    void  (*lpmIsr)(uint32 besl);
+    uint8 (*control)(const uint8 setup[], uint8 data[], uint16 *length);
+} SIM_DEVICE;
+
+/* Host side traffic model selected on the command line. */
+typedef struct
+{
+    const char8 *name;
+    const char8 *help;
+    void  (*configure)(void);
+    void  (*start)(void);
+    void  (*frame)(void);
+    uint8 (*transaction)(void);
+    uint8 (*done)(void);
+    int   (*report)(void);
+} SIM_SCENARIO;
+
+/* Run options shared by all scenarios. */
+typedef struct
+{
+    uint32 packets;
+    uint16 length;
+    uint16 window;
+    uint32 interval;
+    uint32 durationMs;
+    uint64 timeLimitNs;
+    uint32 minKBps;
+    uint32 cpuHz;
+    uint32 baud;            /* Line coding the host sets on the COM port */
+    uint8  ports;           /* COM ports of the cdc-multi scenario */
+    uint8  verbose;
+    const char8 *pcapPath;  /* Capture of the host tool traffic; NULL if none */
+    int    toolArgc;        /* Options after "--" for the host tool */
+    char   **toolArgv;
+} SIM_OPTIONS;
+
+/* Timed event: timer interrupt or DMA completion. */
+typedef void (*SIM_EVENT_FN)(uint32 arg);
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+/* Device side. */
+void   Sim_Attach(const SIM_DEVICE *device);
+void   Sim_Connect(uint8 enumerate);
+void   Sim_Step(uint32 cycles);
+void   Sim_Sleep(uint8 deepSleep);
+uint8  Sim_Schedule(uint64 delayNs, SIM_EVENT_FN handler, uint32 arg);
+uint8  Sim_ScheduleHw(uint64 delayNs, SIM_EVENT_FN handler, uint32 arg);
+void   Sim_Cancel(SIM_EVENT_FN handler);
+uint64 Sim_CyclesToNs(uint32 cycles);
+void   Sim_Hibernate(void);
+
+/* Host side. */
+uint8  Sim_HostOut(uint8 epNumber, const uint8 data[], uint16 length);
+uint8  Sim_HostIn(uint8 epNumber, uint8 data[], uint16 *length);
+uint8  Sim_HostControl(const uint8 setup[], uint8 data[], uint16 *length);
+void   Sim_HostBusReset(void);
+void   Sim_HostSuspend(void);
+void   Sim_HostResume(void);
+void   Sim_HostLpm(uint32 besl);
+void   Sim_HostConfigureEp(uint8 epNumber, uint8 type, uint8 dirIn, uint16 maxPacket);
+void   Sim_Finish(int status);
+
+/* Reporting helpers. */
+void   Sim_ReportHeader(const char8 *title);
+void   Sim_ReportLatency(const char8 *label, uint64 minNs, uint64 sumNs,
+                         uint64 maxNs, uint32 samples);
+
+
+/***************************************
+*    External data references
+****************************************/
+
+extern SIM_EP  Sim_ep[SIM_MAX_EP];
+extern SIM_OPTIONS Sim_options;
+extern uint64  Sim_now;
+extern uint64  Sim_busTime;
+extern uint64  Sim_startTime;
+extern uint64  Sim_sleepNs;
+extern uint32  Sim_frame;
+extern uint32  Sim_apiCalls;
+extern uint32  Sim_isrCount;
+extern uint8   Sim_configured;
+extern uint8   Sim_busSuspended;
+extern uint8   Sim_busActivity;
+extern uint32  Sim_resetReason;
+extern uint8   Sim_intEnabled;
+
+extern const SIM_SCENARIO *const Sim_scenarios[];
+extern const SIM_SCENARIO HostSim_scenario;
+
+#endif /* (SIM_BUS_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,203 @@
+/*******************************************************************************
+* File Name: sim_pcap.c
+*
+* Version: 1.0
+*
+* Description:
+*  USB traffic capture of the USBFS emulation in the usbmon pcap format. The
+*  file is written little-endian, like a capture on an x86 or ARM host. Each
+*  record is the 64-byte usbmon header followed by the captured data:
+*   offset  0: URB id (8 bytes)
+*           8: event type 'S' or 'C'
+*           9: transfer type
+*          10: endpoint address
+*          11: device address
+*          12: bus number (2 bytes)
+*          14: flag_setup: 0 if the setup packet is present, '-' otherwise
+*          15: flag_data: 0 if data is present, '<' or '>' otherwise
+*          16: timestamp, seconds (8 bytes) and microseconds (4 bytes)
+*          28: status (4 bytes)
+*          32: URB length (4 bytes)
+*          36: captured data length (4 bytes)
+*          40: setup packet (8 bytes)
+*          48: interval, start frame, transfer flags, descriptors (16 bytes)
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sim_pcap.h"
+
+/* pcap file header: magic of microsecond timestamps, version 2.4. */
+#define SIM_PCAP_MAGIC          (0xA1B2C3D4u)
+#define SIM_PCAP_VERSION_MAJOR  (2u)
+#define SIM_PCAP_VERSION_MINOR  (4u)
+#define SIM_PCAP_SNAPLEN        (65535u)
+#define SIM_PCAP_LINKTYPE       (220u)      /* LINKTYPE_USB_LINUX_MMAPPED */
+
+#define SIM_PCAP_FILE_HEADER    (24u)
+#define SIM_PCAP_RECORD_HEADER  (16u)
+#define SIM_PCAP_USB_HEADER     (64u)
+
+static FILE *simPcapFile;
+
+static void Sim_PcapPut(uint8 buffer[], uint32 offset, uint64 value, uint8 size);
+
+
+/*******************************************************************************
+* Function Name: Sim_PcapPut
+********************************************************************************
+*
+* Summary:
+*  Stores a little-endian field of size bytes.
+*
+*******************************************************************************/
+static void Sim_PcapPut(uint8 buffer[], uint32 offset, uint64 value, uint8 size)
+{
+    uint8 i;
+
+    for (i = 0u; i < size; ++i)
+    {
+        buffer[offset + i] = (uint8) (value >> (8u * i));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_PcapOpen
+********************************************************************************
+*
+* Summary:
+*  Creates the capture file and writes the pcap file header.
+*
+* Return:
+*  Non-zero on success.
+*
+*******************************************************************************/
+uint8 Sim_PcapOpen(const char8 *path)
+{
+    uint8 header[SIM_PCAP_FILE_HEADER];
+
+    simPcapFile = fopen(path, "wb");
+
+    if (NULL == simPcapFile)
+    {
+        return (0u);
+    }
+
+    (void) memset(header, 0, sizeof(header));
+    Sim_PcapPut(header, 0u,  SIM_PCAP_MAGIC, 4u);
+    Sim_PcapPut(header, 4u,  SIM_PCAP_VERSION_MAJOR, 2u);
+    Sim_PcapPut(header, 6u,  SIM_PCAP_VERSION_MINOR, 2u);
+    Sim_PcapPut(header, 16u, SIM_PCAP_SNAPLEN, 4u);
+    Sim_PcapPut(header, 20u, SIM_PCAP_LINKTYPE, 4u);
+
+    return ((1u == fwrite(header, sizeof(header), 1u, simPcapFile)) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_PcapRecord
+********************************************************************************
+*
+* Summary:
+*  Writes one usbmon event. Does nothing if no capture is open.
+*
+* Parameters:
+*  timeNs:     Simulated bus time of the event.
+*  id:         URB id; the submission and completion of a transfer share it.
+*  event:      SIM_PCAP_SUBMIT or SIM_PCAP_COMPLETE.
+*  xferType:   SIM_PCAP_XFER_CONTROL, _BULK or _INT.
+*  endpoint:   Endpoint address, with the direction bit.
+*  setup:      Setup packet of a control submission; NULL otherwise.
+*  status:     0, or the negative errno of a failed completion.
+*  length:     URB length: requested on submission, actual on completion.
+*  data:       Data of an OUT submission or an IN completion; NULL if none.
+*  dataLength: Bytes of data.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sim_PcapRecord(uint64 timeNs, uint64 id, char8 event, uint8 xferType, uint8 endpoint,
+                    const uint8 setup[], int32 status, uint32 length,
+                    const uint8 data[], uint32 dataLength)
+{
+    uint8  header[SIM_PCAP_RECORD_HEADER + SIM_PCAP_USB_HEADER];
+    uint8 *usb = &header[SIM_PCAP_RECORD_HEADER];
+    uint64 seconds = timeNs / 1000000000u;
+    uint32 micros  = (uint32) ((timeNs % 1000000000u) / 1000u);
+
+    if (NULL == simPcapFile)
+    {
+        return;
+    }
+
+    /* usbmon truncates the data to the snapshot length as well. */
+    dataLength = (NULL != data) ? dataLength : 0u;
+    dataLength = (dataLength > (SIM_PCAP_SNAPLEN - SIM_PCAP_USB_HEADER)) ?
+                 (SIM_PCAP_SNAPLEN - SIM_PCAP_USB_HEADER) : dataLength;
+
+    (void) memset(header, 0, sizeof(header));
+    Sim_PcapPut(header, 0u,  seconds, 4u);
+    Sim_PcapPut(header, 4u,  micros, 4u);
+    Sim_PcapPut(header, 8u,  SIM_PCAP_USB_HEADER + dataLength, 4u);
+    Sim_PcapPut(header, 12u, SIM_PCAP_USB_HEADER + dataLength, 4u);
+
+    Sim_PcapPut(usb, 0u, id, 8u);
+    usb[8u]  = (uint8) event;
+    usb[9u]  = xferType;
+    usb[10u] = endpoint;
+    usb[11u] = SIM_PCAP_DEVICE;
+    Sim_PcapPut(usb, 12u, SIM_PCAP_BUS, 2u);
+    usb[14u] = (NULL != setup) ? 0u : (uint8) '-';
+    usb[15u] = (0u != dataLength) ? 0u : (uint8) ((SIM_PCAP_SUBMIT == event) ? '<' : '>');
+    Sim_PcapPut(usb, 16u, seconds, 8u);
+    Sim_PcapPut(usb, 24u, micros, 4u);
+    Sim_PcapPut(usb, 28u, (uint32) status, 4u);
+    Sim_PcapPut(usb, 32u, length, 4u);
+    Sim_PcapPut(usb, 36u, dataLength, 4u);
+
+    if (NULL != setup)
+    {
+        (void) memcpy(&usb[40u], setup, 8u);
+    }
+
+    (void) fwrite(header, sizeof(header), 1u, simPcapFile);
+
+    if (0u != dataLength)
+    {
+        (void) fwrite(data, dataLength, 1u, simPcapFile);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_PcapClose
+********************************************************************************
+*
+* Summary:
+*  Closes the capture file.
+*
+*******************************************************************************/
+void Sim_PcapClose(void)
+{
+    if (NULL != simPcapFile)
+    {
+        (void) fclose(simPcapFile);
+        simPcapFile = NULL;
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,62 @@
+/*******************************************************************************
+* File Name: sim_pcap.h
+*
+* Version: 1.0
+*
+* Description:
+*  USB traffic capture of the USBFS emulation. The host scenario writes the
+*  transfers of the host tool to a pcap file in the format of a Linux usbmon
+*  capture (LINKTYPE_USB_LINUX_MMAPPED, the format tcpdump writes for a
+*  usbmonN interface): one submission and one completion record per
+*  transfer, with the simulated bus time as timestamp. A capture of the
+*  emulation and a capture of a device on the bus are read by the same tools.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(SIM_PCAP_H)
+#define SIM_PCAP_H
+
+#include "cytypes.h"
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* usbmon event types. */
+#define SIM_PCAP_SUBMIT         ('S')
+#define SIM_PCAP_COMPLETE       ('C')
+
+/* usbmon transfer types. */
+#define SIM_PCAP_XFER_INT       (1u)
+#define SIM_PCAP_XFER_CONTROL   (2u)
+#define SIM_PCAP_XFER_BULK      (3u)
+
+/* Bus and device address of the simulated device in the capture. */
+#define SIM_PCAP_BUS            (1u)
+#define SIM_PCAP_DEVICE         (2u)
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+uint8 Sim_PcapOpen(const char8 *path);
+void  Sim_PcapRecord(uint64 timeNs, uint64 id, char8 event, uint8 xferType, uint8 endpoint,
+                     const uint8 setup[], int32 status, uint32 length,
+                     const uint8 data[], uint32 dataLength);
+void  Sim_PcapClose(void);
+
+#endif /* (SIM_PCAP_H) */
+
+
+/* [] END OF FILE */
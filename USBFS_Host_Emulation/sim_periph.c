@@ -0,0 +1,576 @@
+/*******************************************************************************
+* File Name: sim_periph.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host stand-ins for the CyLib and cyPm services and for the non-USB
+*  components of the USBFS code examples. LED changes are traced in verbose
+*  mode; the timer raises its interrupt from the simulated bus time base.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <stdio.h>
+
+#include "project.h"
+#include "sim_bus.h"
+
+uint32 cydelay_freq_hz;
+
+static cyisraddress timerIsrAddress;
+static uint8 timerRunning;
+
+/* SysTick counts down from the reload value since sysTickOrigin. */
+static uint8  sysTickRunning;
+static uint8  sysTickInterrupt;
+static uint32 sysTickReload;
+static uint32 sysTickValue;
+static uint64 sysTickOrigin;
+static cySysTickCallback sysTickCallbacks[CY_SYS_SYST_NUM_OF_CALLBACKS];
+
+static void SysTick_SimSchedule(void);
+static void SysTick_SimTick(uint32 arg);
+static void Sim_PinWrite(const char8 *name, uint8 value);
+static void Timer_SimTick(uint32 arg);
+
+
+/*******************************************************************************
+* Function Name: CyIntSetGlobalState
+********************************************************************************
+*
+* Summary:
+*  Enables or disables interrupts globally. Interrupts raised while disabled
+*  are delivered when they are enabled again.
+*
+*******************************************************************************/
+void CyIntSetGlobalState(uint8 enable)
+{
+    Sim_intEnabled = enable;
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: CyEnterCriticalSection
+********************************************************************************
+*
+* Summary:
+*  Disables interrupts and returns the previous interrupt state.
+*
+*******************************************************************************/
+uint8 CyEnterCriticalSection(void)
+{
+    uint8 savedIntrStatus = Sim_intEnabled;
+
+    Sim_intEnabled = 0u;
+    Sim_Step(SIM_REG_CYCLES);
+
+    return (savedIntrStatus);
+}
+
+
+/*******************************************************************************
+* Function Name: CyExitCriticalSection
+********************************************************************************
+*
+* Summary:
+*  Restores the interrupt state saved by CyEnterCriticalSection().
+*
+*******************************************************************************/
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    Sim_intEnabled = savedIntrStatus;
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: CyDelay
+********************************************************************************
+*
+* Summary:
+*  Busy waits for the given number of milliseconds.
+*
+*******************************************************************************/
+void CyDelay(uint32 milliseconds)
+{
+    while (0u != milliseconds)
+    {
+        CyDelayUs(1000u);
+        --milliseconds;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: CyDelayUs
+********************************************************************************
+*
+* Summary:
+*  Busy waits for the given number of microseconds.
+*
+*******************************************************************************/
+void CyDelayUs(uint16 microseconds)
+{
+    Sim_Step((uint32) (((uint64) Sim_options.cpuHz * microseconds) / 1000000u));
+}
+
+
+/*******************************************************************************
+* Function Name: CySysTickStart
+********************************************************************************
+*
+* Summary:
+*  Starts SysTick with a 1 ms period and its interrupt enabled.
+*
+*******************************************************************************/
+void CySysTickStart(void)
+{
+    sysTickReload  = (cydelay_freq_hz / 1000u) - 1u;
+    sysTickValue   = sysTickReload;
+    sysTickRunning = 0u;
+    CySysTickEnable();
+}
+
+
+/*******************************************************************************
+* Function Name: CySysTickEnable
+********************************************************************************
+*
+* Summary:
+*  Starts the counter from its current value and enables the interrupt.
+*
+*******************************************************************************/
+void CySysTickEnable(void)
+{
+    if (0u == sysTickRunning)
+    {
+        /* Continue from the value the counter stopped at. */
+        sysTickOrigin = Sim_now - ((((uint64) (sysTickReload - sysTickValue)) * 1000000000u) /
+                                   Sim_options.cpuHz);
+    }
+
+    sysTickRunning   = 1u;
+    sysTickInterrupt = 1u;
+    SysTick_SimSchedule();
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: CySysTickStop
+********************************************************************************
+*
+* Summary:
+*  Stops SysTick; the counter keeps its value.
+*
+*******************************************************************************/
+void CySysTickStop(void)
+{
+    sysTickValue   = CySysTickGetValue();
+    sysTickRunning = 0u;
+    SysTick_SimSchedule();
+}
+
+
+/*******************************************************************************
+* Function Name: CySysTickEnableInterrupt
+********************************************************************************
+*
+* Summary:
+*  Enables the SysTick interrupt.
+*
+*******************************************************************************/
+void CySysTickEnableInterrupt(void)
+{
+    sysTickInterrupt = 1u;
+    SysTick_SimSchedule();
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: CySysTickDisableInterrupt
+********************************************************************************
+*
+* Summary:
+*  Disables the SysTick interrupt.
+*
+*******************************************************************************/
+void CySysTickDisableInterrupt(void)
+{
+    sysTickInterrupt = 0u;
+    SysTick_SimSchedule();
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: CySysTickSetCallback
+********************************************************************************
+*
+* Summary:
+*  Sets a callback of the SysTick interrupt and returns the previous one.
+*
+*******************************************************************************/
+cySysTickCallback CySysTickSetCallback(uint32 number, cySysTickCallback function)
+{
+    cySysTickCallback previous = sysTickCallbacks[number];
+
+    sysTickCallbacks[number] = function;
+
+    return (previous);
+}
+
+
+/*******************************************************************************
+* Function Name: CySysTickSetReload
+********************************************************************************
+*
+* Summary:
+*  Sets the reload value. The counter restarts from it.
+*
+*******************************************************************************/
+void CySysTickSetReload(uint32 value)
+{
+    sysTickReload = value & CY_SYS_SYST_RVR_CNT_MASK;
+    sysTickValue  = sysTickReload;
+    sysTickOrigin = Sim_now;
+    SysTick_SimSchedule();
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: CySysTickGetValue
+********************************************************************************
+*
+* Summary:
+*  Returns the counter: the reload value minus the SYSCLK cycles since the
+*  last reload.
+*
+*******************************************************************************/
+uint32 CySysTickGetValue(void)
+{
+    uint64 cycles;
+
+    Sim_Step(SIM_REG_CYCLES);
+
+    if (0u != sysTickRunning)
+    {
+        cycles = ((Sim_now - sysTickOrigin) * Sim_options.cpuHz) / 1000000000u;
+        sysTickValue = sysTickReload - (uint32) (cycles % ((uint64) sysTickReload + 1u));
+    }
+
+    return (sysTickValue);
+}
+
+
+/*******************************************************************************
+* Function Name: CySysTickClear
+********************************************************************************
+*
+* Summary:
+*  Clears the counter: it restarts from the reload value.
+*
+*******************************************************************************/
+void CySysTickClear(void)
+{
+    sysTickOrigin = Sim_now;
+    sysTickValue  = sysTickReload;
+    SysTick_SimSchedule();
+    Sim_Step(SIM_REG_CYCLES);
+}
+
+
+/*******************************************************************************
+* Function Name: SysTick_SimSchedule
+********************************************************************************
+*
+* Summary:
+*  Schedules the next SysTick interrupt: when the counter reaches zero, if it
+*  runs with the interrupt enabled.
+*
+*******************************************************************************/
+static void SysTick_SimSchedule(void)
+{
+    uint64 periodNs;
+    uint64 elapsedNs;
+
+    Sim_Cancel(&SysTick_SimTick);
+
+    if ((0u != sysTickRunning) && (0u != sysTickInterrupt))
+    {
+        periodNs  = (((uint64) sysTickReload + 1u) * 1000000000u) / Sim_options.cpuHz;
+        elapsedNs = (Sim_now - sysTickOrigin) % periodNs;
+        (void) Sim_Schedule(periodNs - elapsedNs, &SysTick_SimTick, 0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SysTick_SimTick
+********************************************************************************
+*
+* Summary:
+*  SysTick interrupt: calls the callbacks and schedules the next interrupt.
+*
+*******************************************************************************/
+static void SysTick_SimTick(uint32 arg)
+{
+    uint8 i;
+
+    CY_UNUSED_PARAMETER(arg);
+
+    SysTick_SimSchedule();
+
+    for (i = 0u; i < CY_SYS_SYST_NUM_OF_CALLBACKS; ++i)
+    {
+        if (NULL != sysTickCallbacks[i])
+        {
+            sysTickCallbacks[i]();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: CySysPmGetResetReason
+********************************************************************************
+*
+* Summary:
+*  Returns the reason of the last reset.
+*
+*******************************************************************************/
+uint32 CySysPmGetResetReason(void)
+{
+    return (Sim_resetReason);
+}
+
+
+/*******************************************************************************
+* Function Name: CySysPmSleep
+********************************************************************************
+*
+* Summary:
+*  Enters Sleep (WFI) until an interrupt.
+*
+*******************************************************************************/
+void CySysPmSleep(void)
+{
+    Sim_Sleep(0u);
+}
+
+
+/*******************************************************************************
+* Function Name: CySysPmDeepSleep
+********************************************************************************
+*
+* Summary:
+*  Enters DeepSleep until bus activity.
+*
+*******************************************************************************/
+void CySysPmDeepSleep(void)
+{
+    Sim_Sleep(1u);
+}
+
+
+/*******************************************************************************
+* Function Name: CySysPmHibernate
+********************************************************************************
+*
+* Summary:
+*  Enters Hibernate. The device restarts on bus activity.
+*
+*******************************************************************************/
+void CySysPmHibernate(void)
+{
+    Sim_Hibernate();
+}
+
+
+/*******************************************************************************
+* Function Name: Sim_PinWrite
+********************************************************************************
+*
+* Summary:
+*  Traces a pin write in verbose mode.
+*
+*******************************************************************************/
+static void Sim_PinWrite(const char8 *name, uint8 value)
+{
+    Sim_Step(SIM_REG_CYCLES);
+
+    if (0u != Sim_options.verbose)
+    {
+        printf("%12.3f ms  %s = %u\n", (double) Sim_now / 1e6, name, value);
+    }
+}
+
+void LED_Write(uint8 value)         { Sim_PinWrite("LED", value); }
+void LED_RED_Write(uint8 value)     { Sim_PinWrite("LED_RED", value); }
+void LED_GREEN_Write(uint8 value)   { Sim_PinWrite("LED_GREEN", value); }
+void LED_BLUE_Write(uint8 value)    { Sim_PinWrite("LED_BLUE", value); }
+void LED3_Write(uint8 value)        { Sim_PinWrite("LED3", value); }
+void LED4_Write(uint8 value)        { Sim_PinWrite("LED4", value); }
+void DTR_Write(uint8 value)         { Sim_PinWrite("DTR", value); }
+
+
+/*******************************************************************************
+* Function Name: Timer_SimTick
+********************************************************************************
+*
+* Summary:
+*  Terminal count interrupt of the timer.
+*
+*******************************************************************************/
+static void Timer_SimTick(uint32 arg)
+{
+    CY_UNUSED_PARAMETER(arg);
+
+    if (0u != timerRunning)
+    {
+        (void) Sim_Schedule(Timer_PERIOD_NS, &Timer_SimTick, 0u);
+
+        if (NULL != timerIsrAddress)
+        {
+            timerIsrAddress();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Timer_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the timer.
+*
+*******************************************************************************/
+void Timer_Start(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+
+    if (0u == timerRunning)
+    {
+        timerRunning = 1u;
+        (void) Sim_Schedule(Timer_PERIOD_NS, &Timer_SimTick, 0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Timer_Stop
+********************************************************************************
+*
+* Summary:
+*  Stops the timer.
+*
+*******************************************************************************/
+void Timer_Stop(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+    timerRunning = 0u;
+    Sim_Cancel(&Timer_SimTick);
+}
+
+
+/*******************************************************************************
+* Function Name: Timer_Sleep
+********************************************************************************
+*
+* Summary:
+*  Stops the timer before low-power mode.
+*
+*******************************************************************************/
+void Timer_Sleep(void)
+{
+    Timer_Stop();
+}
+
+
+/*******************************************************************************
+* Function Name: Timer_Wakeup
+********************************************************************************
+*
+* Summary:
+*  Restarts the timer after low-power mode.
+*
+*******************************************************************************/
+void Timer_Wakeup(void)
+{
+    Timer_Start();
+}
+
+
+/*******************************************************************************
+* Function Name: timerIsr_StartEx
+********************************************************************************
+*
+* Summary:
+*  Sets the timer interrupt vector and enables the interrupt.
+*
+*******************************************************************************/
+void timerIsr_StartEx(cyisraddress address)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+    timerIsrAddress = address;
+}
+
+
+/*******************************************************************************
+* Function Name: timerIsr_Stop
+********************************************************************************
+*
+* Summary:
+*  Disables the timer interrupt.
+*
+*******************************************************************************/
+void timerIsr_Stop(void)
+{
+    Sim_Step(SIM_API_CALL_CYCLES);
+    timerIsrAddress = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: Bootloader_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the USBFS communication component, enables the command endpoint and
+*  waits for host commands; never returns. Host commands are not emulated; the
+*  device idles in Sleep until the run ends.
+*
+*******************************************************************************/
+void Bootloader_Start(void)
+{
+    CyGlobalIntEnable;
+
+    USBFS_Start(0u, USBFS_5V_OPERATION);
+
+    while (0u == USBFS_GetConfiguration())
+    {
+    }
+
+    USBFS_EnableOutEP(Bootloader_OUT_EP_NUM);
+
+    for (;;)
+    {
+        Sim_Sleep(0u);
+    }
+}
+
+
+/* [] END OF FILE */
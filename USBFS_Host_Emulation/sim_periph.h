@@ -0,0 +1,71 @@
+/*******************************************************************************
+* File Name: sim_periph.h
+*
+* Version: 1.0
+*
+* Description:
+*  Host stand-ins for the non-USB components placed on the schematics of the
+*  USBFS code examples: LED pins, the 1-ms suspend detection timer and its
+*  interrupt, and the bootloader.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(SIM_PERIPH_H)
+#define SIM_PERIPH_H
+
+#include "cytypes.h"
+
+
+/***************************************
+*    Pins
+****************************************/
+
+void LED_Write(uint8 value);
+void LED_RED_Write(uint8 value);
+void LED_GREEN_Write(uint8 value);
+void LED_BLUE_Write(uint8 value);
+void LED3_Write(uint8 value);
+void LED4_Write(uint8 value);
+
+/* Output of the USB-UART bridge, active low. */
+void DTR_Write(uint8 value);
+
+
+/***************************************
+*    Timer and interrupt
+****************************************/
+
+/* Timer period used by the Suspend example. */
+#define Timer_PERIOD_NS     (1000000u)
+
+void Timer_Start(void);
+void Timer_Stop(void);
+void Timer_Sleep(void);
+void Timer_Wakeup(void);
+
+void timerIsr_StartEx(cyisraddress address);
+void timerIsr_Stop(void);
+
+
+/***************************************
+*    Bootloader
+****************************************/
+
+/* Command endpoint of the HID bootloader. */
+#define Bootloader_OUT_EP_NUM   (1u)
+
+void Bootloader_Start(void);
+
+#endif /* (SIM_PERIPH_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,2137 @@
+/*******************************************************************************
+* File Name: sim_scenarios.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host traffic models for the USBFS code examples. Each scenario describes
+*  the endpoints of the example configuration descriptor, drives bus
+*  transactions when the bus is free, verifies the data returned by the
+*  firmware and prints a report whose result is the exit status of the run.
+*
+*  loopback  - Bulk Wraparound: packets on EP2 OUT are expected back on EP1 IN.
+*  suspend   - loopback with periodic bus suspend and resume (Suspend example).
+*  lpm       - loopback with periodic LPM L1 entry (LPM example).
+*  cdc-echo  - USBUART: byte stream echo on EP3 OUT / EP2 IN.
+*  uart-bridge - USBUART built as a USB-UART bridge: cdc-echo through the
+*              looped-back SCB UART.
+*  cdc-multi - USBUART built with several COM ports: cdc-echo on every port
+*              at once.
+*  cdc-status - USBUART: cdc-echo while the host changes the control lines
+*              and counts the serial state notifications.
+*  hid-mouse - HID: the host polls the mouse report on EP1 IN.
+*  hid-telemetry - HID built with TELEMETRY_ENABLE: the host polls the
+*              telemetry reports on EP2 IN and checks every stream.
+*  idle      - Bootloader: the device enumerates and idles.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sim_bus.h"
+#include "UART.h"
+
+/* Endpoints of the bulk loopback examples. */
+#define LOOP_IN_EP              (1u)
+#define LOOP_OUT_EP             (2u)
+
+/* Endpoints of the USBUART example. */
+#define CDC_COMM_EP             (1u)
+#define CDC_IN_EP               (2u)
+#define CDC_OUT_EP              (3u)
+#define CDC_COMM_EP_SIZE        (16u)
+
+/* Endpoints of a COM port: the ports follow each other. */
+#define CDC_PORT_EP(com, ep)    ((uint8) ((ep) + (3u * (com))))
+
+/* Endpoint of the HID mouse example. */
+#define MOUSE_EP                (1u)
+#define MOUSE_EP_SIZE           (8u)
+#define MOUSE_REPORT_LENGTH     (3u)
+
+/* Cursor pattern of the HID mouse example: a stroke to the right, a rest, a
+* stroke to the left and a rest of 128 steps of 10 ms each. The movement adds
+* up to zero at the end of every cycle.
+*/
+#define MOUSE_CYCLE_MS          (4u * 128u * 10u)
+#define MOUSE_REST_MS           (MOUSE_CYCLE_MS / 4u)
+
+/* Short items of a HID report descriptor: the tag and type bits of the
+* prefix, and the size bits.
+*/
+#define HID_PREFIX_TAG_MASK     (0xFCu)
+#define HID_PREFIX_SIZE_MASK    (0x03u)
+#define HID_TAG_INPUT           (0x80u)
+#define HID_TAG_COLLECTION      (0xA0u)
+#define HID_TAG_END_COLLECTION  (0xC0u)
+#define HID_TAG_USAGE_PAGE      (0x04u)
+#define HID_TAG_LOGICAL_MIN     (0x14u)
+#define HID_TAG_LOGICAL_MAX     (0x24u)
+#define HID_TAG_REPORT_SIZE     (0x74u)
+#define HID_TAG_REPORT_COUNT    (0x94u)
+#define HID_TAG_USAGE           (0x08u)
+#define HID_TAG_USAGE_MIN       (0x18u)
+#define HID_TAG_USAGE_MAX       (0x28u)
+#define HID_INPUT_CONSTANT      (0x01u)
+
+/* Values and collections a report descriptor may hold, and usages per main
+* item.
+*/
+#define HID_MAX_ENTRIES         (32u)
+#define HID_MAX_USAGES          (8u)
+#define HID_MAX_DESCRIPTOR      (256u)
+
+/* Telemetry channel of the HID example: report ID n + 1 carries stream n,
+* which holds demo records of TELEMETRY_RECORD bytes.
+*/
+#define TELEMETRY_EP            (2u)
+#define TELEMETRY_REPORT_SIZE   (64u)
+#define TELEMETRY_HEADER_SIZE   (2u)
+#define TELEMETRY_STREAMS       (3u)
+#define TELEMETRY_RECORD        (8u)
+
+/* Endpoints of the HID bootloader. */
+#define BOOT_OUT_EP             (1u)
+#define BOOT_IN_EP              (2u)
+
+/* A packet that is not returned within this time is counted as lost. */
+#define LOSS_TIMEOUT_NS         (20u * SIM_NS_PER_MS)
+
+/* The host application opens the device this long after enumeration. */
+#define OPEN_DELAY_NS           (10u * SIM_NS_PER_MS)
+
+/* Time the host keeps the bus suspended or in L1, and the recovery time after
+* resume before the host sends traffic (TRSMRCY is 10 ms after suspend).
+*/
+#define SUSPEND_TIME_NS         (10u * SIM_NS_PER_MS)
+#define SUSPEND_RECOVERY_NS     (10u * SIM_NS_PER_MS)
+#define L1_TIME_NS              (5u * SIM_NS_PER_MS)
+#define L1_RECOVERY_NS          (1u * SIM_NS_PER_MS)
+
+/* CDC class requests. */
+#define CDC_RQST_OUT            (0x21u)
+#define CDC_SET_LINE_CODING     (0x20u)
+#define CDC_SET_CONTROL_LINE    (0x22u)
+
+/* Serial state test of the cdc-status scenario: control line states the host
+* sets back to back in a step, and the polling intervals (-i) per step. DCD
+* and DSR follow DTR.
+*/
+#define STATUS_BURST            (3u)
+#define STATUS_STEP_POLLS       (4u)
+#define STATUS_LINE_DTR         (0x0001u)
+#define STATUS_DCD_DSR          (0x0003u)
+
+/* Packets the host keeps in flight and their send time. */
+typedef struct
+{
+    uint64 sendTime;
+    uint32 endOffset;
+} HOST_PACKET;
+
+static HOST_PACKET hostPacket[SIM_MAX_WINDOW];
+
+/* Loopback and echo state. */
+static uint32 hostSent;
+static uint32 hostDone;
+static uint32 hostLost;
+static uint32 hostCorrupt;
+static uint32 hostSentBytes;
+static uint32 hostReceivedBytes;
+static uint8  hostNextIn;
+static uint8  hostPaused;
+static uint64 hostLastProgress;
+static uint64 hostHoldTime;
+static uint64 hostFirstTime;
+static uint64 hostLastTime;
+static uint64 hostLatMin;
+static uint64 hostLatSum;
+static uint64 hostLatMax;
+static uint32 hostLatCount;
+
+/* Power management state of the suspend and LPM scenarios. */
+static uint64 pmNextTime;
+static uint64 pmResumeTime;
+static uint32 pmCycles;
+static uint32 pmBeslIndex;
+static const uint32 pmBesl[] = {0u, 4u, 10u};
+
+/* Interrupt endpoint polling state. */
+static uint32 pollReports;
+static uint32 pollNaks;
+static uint32 pollBadReports;
+static uint16 pollLastState;
+
+/* Reports of the hid-mouse scenario: reports that carry no change, and the
+* movement and buttons reported.
+*/
+static uint32 mouseEmpty;
+static int32  mouseX;
+static int32  mouseY;
+static uint8  mouseButtons;
+
+/* An input value or a collection of a report descriptor, as the host sees
+* it: two descriptors describe the same report when they have the same
+* entries, whatever the order and the repetition of their global items.
+*/
+typedef struct
+{
+    uint8  item;            /* HID_TAG_INPUT, _COLLECTION or _END_COLLECTION */
+    uint8  flags;           /* Input flags or collection type */
+    uint16 page;
+    uint16 usage;
+    int32  min;
+    int32  max;
+    uint16 bit;             /* Bit offset of an input value in the report */
+    uint16 size;
+} HID_ENTRY;
+
+/* Report descriptor the USBFS component of the HID example sends: the
+* "3-Button Mouse" report of the HIDReportDescriptors parameter in
+* USBFS_HID TopDesign.cysch, as PSoC Creator generates it.
+*/
+static const uint8 mouseComponentDescriptor[] =
+{
+    0x05u, 0x01u, 0x09u, 0x02u, 0xA1u, 0x01u, 0x09u, 0x01u, 0xA1u, 0x00u,
+    0x05u, 0x09u, 0x05u, 0x09u, 0x05u, 0x09u, 0x19u, 0x01u, 0x29u, 0x03u,
+    0x15u, 0x00u, 0x25u, 0x01u, 0x95u, 0x03u, 0x75u, 0x01u, 0x81u, 0x02u,
+    0x95u, 0x01u, 0x75u, 0x05u, 0x81u, 0x01u, 0x05u, 0x01u, 0x09u, 0x30u,
+    0x09u, 0x31u, 0x15u, 0x81u, 0x25u, 0x7Fu, 0x75u, 0x08u, 0x95u, 0x02u,
+    0x81u, 0x06u, 0xC0u, 0xC0u
+};
+
+/* Report descriptor the HID example generates from its report table
+* (mouse_report.h): only the HID example has it.
+*/
+#pragma weak mouseReportDescriptor
+extern const uint8 mouseReportDescriptor[];
+
+/* Stream state of the hid-telemetry scenario: the record being put
+* together and the next sequence number.
+*/
+typedef struct
+{
+    uint8  record[TELEMETRY_RECORD];
+    uint8  fill;
+    uint8  started;
+    uint16 sequence;
+    uint32 reports;
+    uint32 bytes;
+    uint32 records;
+    uint32 dropped;
+    uint32 corrupt;
+} TELEMETRY_HOST_STREAM;
+
+static TELEMETRY_HOST_STREAM telemetryHost[TELEMETRY_STREAMS];
+static uint32 telemetryUnknownId;
+
+/* The CDC port is open: line coding and control lines are set. */
+static uint8 cdcOpen;
+
+/* Echo state of a COM port of the cdc-multi scenario. */
+typedef struct
+{
+    HOST_PACKET packet[SIM_MAX_WINDOW];
+    uint32 sent;
+    uint32 done;
+    uint32 lost;
+    uint32 corrupt;
+    uint32 sentBytes;
+    uint32 receivedBytes;
+    uint64 lastProgress;
+    uint64 lastTime;
+    uint8  nextIn;
+} MULTI_PORT;
+
+static MULTI_PORT multiPort[SIM_MAX_COM_PORTS];
+static uint8 multiNext;     /* Port of the next transaction. */
+
+/* A step of the cdc-status scenario: the control line states set within one
+* polling interval and the notifications the step may cause. Changes merged
+* while a notification waits for the poll take one more notification.
+*/
+typedef struct
+{
+    uint16 lines[STATUS_BURST];
+    uint8  maxReports;
+} STATUS_STEP;
+
+static const STATUS_STEP statusScript[] =
+{
+    {{0x0003u, 0x0003u, 0x0003u}, 0u},  /* Same state again */
+    {{0x0002u, 0x0003u, 0x0002u}, 2u},  /* DTR off, on, off */
+    {{0x0000u, 0x0002u, 0x0000u}, 0u},  /* RTS only */
+    {{0x0001u, 0x0000u, 0x0003u}, 2u},  /* DTR on, off, on */
+    {{0x0002u, 0x0003u, 0x0003u}, 2u}   /* DTR glitch */
+};
+
+#define STATUS_STEPS            (sizeof(statusScript) / sizeof(statusScript[0u]))
+
+static uint32 statusFrame;          /* Frames since the port was opened. */
+static uint32 statusSteps;
+static uint32 statusRequests;       /* SET_CONTROL_LINE_STATE requests. */
+static uint32 statusErrors;         /* Steps that failed the check. */
+static uint32 statusStepReports;    /* Notifications in the current step. */
+static uint8  statusMaxReports;
+static uint16 statusExpected;       /* Serial state after the current step. */
+static uint8  statusFinished;       /* Last step checked. */
+
+
+/*******************************************************************************
+* Function Name: Host_Pattern
+********************************************************************************
+*
+* Summary:
+*  Returns the test pattern byte of a loopback packet.
+*
+*******************************************************************************/
+static uint8 Host_Pattern(uint32 packet, uint32 index)
+{
+    return ((uint8) ((packet * 13u) + (packet >> 8u) + (index * 7u)));
+}
+
+
+/*******************************************************************************
+* Function Name: Host_StreamByte
+********************************************************************************
+*
+* Summary:
+*  Returns the test pattern byte at an offset of the echo byte stream.
+*
+*******************************************************************************/
+static uint8 Host_StreamByte(uint32 offset)
+{
+    return ((uint8) (offset + (offset >> 8u)));
+}
+
+
+/*******************************************************************************
+* Function Name: Host_Latency
+********************************************************************************
+*
+* Summary:
+*  Records the round trip latency of a packet.
+*
+*******************************************************************************/
+static void Host_Latency(uint64 sendTime)
+{
+    uint64 latency = Sim_busTime - sendTime;
+
+    hostLatMin = ((0u == hostLatCount) || (latency < hostLatMin)) ? latency : hostLatMin;
+    hostLatMax = (latency > hostLatMax) ? latency : hostLatMax;
+    hostLatSum += latency;
+    ++hostLatCount;
+}
+
+
+/*******************************************************************************
+* Function Name: Host_Setup
+********************************************************************************
+*
+* Summary:
+*  Builds a setup packet.
+*
+*******************************************************************************/
+static void Host_Setup(uint8 setup[], uint8 requestType, uint8 request, uint16 value,
+                       uint16 index, uint16 length)
+{
+    setup[0u] = requestType;
+    setup[1u] = request;
+    setup[2u] = (uint8) value;
+    setup[3u] = (uint8) (value >> 8u);
+    setup[4u] = (uint8) index;
+    setup[5u] = (uint8) (index >> 8u);
+    setup[6u] = (uint8) length;
+    setup[7u] = (uint8) (length >> 8u);
+}
+
+
+/*******************************************************************************
+* Function Name: Host_Reset
+********************************************************************************
+*
+* Summary:
+*  Clears the host state. Called from the configure hooks.
+*
+*******************************************************************************/
+static void Host_Reset(void)
+{
+    hostSent = 0u;
+    hostDone = 0u;
+    hostLost = 0u;
+    hostCorrupt = 0u;
+    hostSentBytes = 0u;
+    hostReceivedBytes = 0u;
+    hostNextIn = 0u;
+    hostPaused = 0u;
+    hostLatCount = 0u;
+    hostLatSum = 0u;
+    hostLatMax = 0u;
+    pmCycles = 0u;
+    pollReports = 0u;
+    pollNaks = 0u;
+    pollBadReports = 0u;
+    mouseEmpty = 0u;
+    mouseX = 0;
+    mouseY = 0;
+    mouseButtons = 0u;
+    (void) memset(telemetryHost, 0, sizeof(telemetryHost));
+    telemetryUnknownId = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Host_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the traffic once the device is configured and opened by the host
+*  application.
+*
+*******************************************************************************/
+static void Host_Start(void)
+{
+    hostFirstTime = Sim_busTime + OPEN_DELAY_NS;
+    hostHoldTime = hostFirstTime;
+    hostLastProgress = hostFirstTime;
+    hostLastTime = hostFirstTime;
+    pmNextTime = hostFirstTime + ((uint64) Sim_options.interval * SIM_NS_PER_MS);
+}
+
+
+/*******************************************************************************
+* Function Name: Host_ReportTraffic
+********************************************************************************
+*
+* Summary:
+*  Prints the traffic statistics and returns the exit status.
+*
+*******************************************************************************/
+static int Host_ReportTraffic(uint8 outEp, uint8 inEp)
+{
+    uint64 elapsed = hostLastTime - hostFirstTime;
+    double kbps = 0.0;
+    double pps = 0.0;
+    int status = SIM_EXIT_PASS;
+
+    if (0u != elapsed)
+    {
+        kbps = ((double) hostReceivedBytes * 1e9) / ((double) elapsed * 1024.0);
+        pps  = ((double) hostLatCount * 1e9) / (double) elapsed;
+    }
+
+    printf("packets         : %lu sent, %lu returned, %lu lost, %lu corrupt\n",
+           (unsigned long) hostSent, (unsigned long) hostLatCount,
+           (unsigned long) hostLost, (unsigned long) hostCorrupt);
+    printf("bytes           : %lu\n", (unsigned long) hostReceivedBytes);
+    printf("throughput      : %.1f KB/s, %.0f packets/s\n", kbps, pps);
+    Sim_ReportLatency("round trip", hostLatMin, hostLatSum, hostLatMax, hostLatCount);
+    printf("naks            : OUT %lu, IN %lu\n",
+           (unsigned long) Sim_ep[outEp].naks, (unsigned long) Sim_ep[inEp].naks);
+
+    if ((0u != hostLost) || (0u != hostCorrupt) || (0u != pollBadReports))
+    {
+        status = SIM_EXIT_DATA_ERROR;
+    }
+    else if ((0u != Sim_options.minKBps) && (kbps < (double) Sim_options.minKBps))
+    {
+        status = SIM_EXIT_SLOW;
+    }
+    else
+    {
+        /* Run passed. */
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Host_PrintResult
+********************************************************************************
+*
+* Summary:
+*  Prints the result line.
+*
+*******************************************************************************/
+static int Host_PrintResult(int status)
+{
+    printf("result          : %s\n", (SIM_EXIT_PASS == status) ? "PASS" :
+                                     (SIM_EXIT_SLOW == status) ? "SLOW" : "DATA_ERROR");
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Loop_Configure
+********************************************************************************
+*
+* Summary:
+*  Bulk loopback examples: EP1 bulk IN and EP2 bulk OUT, 64 bytes.
+*
+*******************************************************************************/
+static void Loop_Configure(void)
+{
+    Sim_HostConfigureEp(LOOP_IN_EP, SIM_EP_TYPE_BULK, 1u, SIM_EP_MAX_PACKET);
+    Sim_HostConfigureEp(LOOP_OUT_EP, SIM_EP_TYPE_BULK, 0u, SIM_EP_MAX_PACKET);
+    Host_Reset();
+}
+
+
+/*******************************************************************************
+* Function Name: Loop_Frame
+********************************************************************************
+*
+* Summary:
+*  Counts the oldest packet in flight as lost when the device did not return
+*  it in time.
+*
+*******************************************************************************/
+static void Loop_Frame(void)
+{
+    if ((hostSent != hostDone) && (0u == hostPaused) &&
+        (Sim_busTime > (hostLastProgress + LOSS_TIMEOUT_NS)))
+    {
+        if (0u != Sim_options.verbose)
+        {
+            printf("%12.3f ms  packet %lu lost\n", (double) Sim_busTime / 1e6,
+                   (unsigned long) hostDone);
+        }
+
+        ++hostLost;
+        ++hostDone;
+        hostLastProgress = Sim_busTime;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Loop_Transaction
+********************************************************************************
+*
+* Summary:
+*  Alternates OUT and IN transactions while keeping up to the window of packets
+*  in flight. A returned packet is matched against the packets in flight, so a
+*  packet dropped by the device is counted as lost rather than corrupt.
+*
+*******************************************************************************/
+static uint8 Loop_Transaction(void)
+{
+    uint8  data[SIM_EP_MAX_PACKET];
+    uint16 length = Sim_options.length;
+    uint32 packet;
+    uint32 i;
+
+    if ((0u != hostPaused) || (Sim_busTime < hostHoldTime))
+    {
+        return (0u);
+    }
+
+    if ((hostSent < Sim_options.packets) && ((hostSent - hostDone) < Sim_options.window) &&
+        ((0u == hostNextIn) || (hostSent == hostDone)))
+    {
+        for (i = 0u; i < length; ++i)
+        {
+            data[i] = Host_Pattern(hostSent, i);
+        }
+
+        if (SIM_ACK == Sim_HostOut(LOOP_OUT_EP, data, length))
+        {
+            hostPacket[hostSent % SIM_MAX_WINDOW].sendTime = Sim_busTime;
+            ++hostSent;
+            hostSentBytes += length;
+        }
+
+        hostNextIn = 1u;
+    }
+    else if (hostSent != hostDone)
+    {
+        if (SIM_ACK == Sim_HostIn(LOOP_IN_EP, data, &length))
+        {
+            for (packet = hostDone; packet < hostSent; ++packet)
+            {
+                for (i = 0u; (i < length) && (data[i] == Host_Pattern(packet, i)); ++i)
+                {
+                }
+
+                if ((i == length) && (length == Sim_options.length))
+                {
+                    break;
+                }
+            }
+
+            if (packet == hostSent)
+            {
+                /* Data does not match any packet in flight. */
+                ++hostCorrupt;
+                packet = hostDone;
+            }
+            else
+            {
+                hostLost += packet - hostDone;
+                Host_Latency(hostPacket[packet % SIM_MAX_WINDOW].sendTime);
+                hostReceivedBytes += length;
+            }
+
+            hostDone = packet + 1u;
+            hostLastProgress = Sim_busTime;
+            hostLastTime = Sim_busTime;
+        }
+
+        hostNextIn = 0u;
+    }
+    else
+    {
+        /* Nothing to send or receive. */
+        return (0u);
+    }
+
+    return (1u);
+}
+
+
+/*******************************************************************************
+* Function Name: Loop_Done
+********************************************************************************
+*
+* Summary:
+*  The run is done when every packet has been returned or counted as lost.
+*
+*******************************************************************************/
+static uint8 Loop_Done(void)
+{
+    return (((hostDone == Sim_options.packets) && (0u == hostPaused)) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Loop_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the loopback report.
+*
+*******************************************************************************/
+static int Loop_Report(void)
+{
+    Sim_ReportHeader("loopback");
+
+    return (Host_PrintResult(Host_ReportTraffic(LOOP_OUT_EP, LOOP_IN_EP)));
+}
+
+
+/*******************************************************************************
+* Function Name: Suspend_Frame
+********************************************************************************
+*
+* Summary:
+*  Suspends the bus every interval when no packet is in flight and resumes it
+*  after the suspend time.
+*
+*******************************************************************************/
+static void Suspend_Frame(void)
+{
+    if (0u != hostPaused)
+    {
+        if (Sim_busTime >= pmResumeTime)
+        {
+            Sim_HostResume();
+            hostPaused = 0u;
+            hostHoldTime = Sim_busTime + SUSPEND_RECOVERY_NS;
+            hostLastProgress = hostHoldTime;
+            pmNextTime = hostHoldTime + ((uint64) Sim_options.interval * SIM_NS_PER_MS);
+        }
+    }
+    else if ((Sim_busTime >= pmNextTime) && (hostSent == hostDone) &&
+             (hostSent < Sim_options.packets))
+    {
+        Sim_HostSuspend();
+        hostPaused = 1u;
+        pmResumeTime = Sim_busTime + SUSPEND_TIME_NS;
+        ++pmCycles;
+    }
+    else
+    {
+        Loop_Frame();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Suspend_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the suspend report.
+*
+*******************************************************************************/
+static int Suspend_Report(void)
+{
+    int status;
+
+    Sim_ReportHeader("suspend");
+    status = Host_ReportTraffic(LOOP_OUT_EP, LOOP_IN_EP);
+    printf("suspend cycles  : %lu\n", (unsigned long) pmCycles);
+    printf("low-power time  : %.3f ms\n", (double) Sim_sleepNs / 1e6);
+
+    return (Host_PrintResult(status));
+}
+
+
+/*******************************************************************************
+* Function Name: Lpm_Frame
+********************************************************************************
+*
+* Summary:
+*  Sends an LPM transaction every interval when no packet is in flight,
+*  cycling through BESL values that select active, DeepSleep and Hibernate in
+*  the LPM example, and exits L1 after the L1 time.
+*
+*******************************************************************************/
+static void Lpm_Frame(void)
+{
+    if (0u != hostPaused)
+    {
+        if (Sim_busTime >= pmResumeTime)
+        {
+            Sim_HostResume();
+            hostPaused = 0u;
+            hostHoldTime = Sim_busTime + L1_RECOVERY_NS;
+            hostLastProgress = hostHoldTime;
+            pmNextTime = hostHoldTime + ((uint64) Sim_options.interval * SIM_NS_PER_MS);
+        }
+    }
+    else if ((Sim_busTime >= pmNextTime) && (hostSent == hostDone) &&
+             (hostSent < Sim_options.packets))
+    {
+        Sim_HostLpm(pmBesl[pmBeslIndex]);
+        pmBeslIndex = (pmBeslIndex + 1u) % (sizeof(pmBesl) / sizeof(pmBesl[0u]));
+        hostPaused = 1u;
+        pmResumeTime = Sim_busTime + L1_TIME_NS;
+        ++pmCycles;
+    }
+    else
+    {
+        Loop_Frame();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Lpm_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the LPM report.
+*
+*******************************************************************************/
+static int Lpm_Report(void)
+{
+    int status;
+
+    Sim_ReportHeader("lpm");
+    status = Host_ReportTraffic(LOOP_OUT_EP, LOOP_IN_EP);
+    printf("L1 cycles       : %lu\n", (unsigned long) pmCycles);
+    printf("low-power time  : %.3f ms\n", (double) Sim_sleepNs / 1e6);
+
+    return (Host_PrintResult(status));
+}
+
+
+/*******************************************************************************
+* Function Name: Cdc_Configure
+********************************************************************************
+*
+* Summary:
+*  USBUART example: EP1 interrupt IN (notification), EP2 bulk IN and EP3 bulk
+*  OUT, 64 bytes.
+*
+*******************************************************************************/
+static void Cdc_Configure(void)
+{
+    Sim_HostConfigureEp(CDC_COMM_EP, SIM_EP_TYPE_INT, 1u, CDC_COMM_EP_SIZE);
+    Sim_HostConfigureEp(CDC_IN_EP, SIM_EP_TYPE_BULK, 1u, SIM_EP_MAX_PACKET);
+    Sim_HostConfigureEp(CDC_OUT_EP, SIM_EP_TYPE_BULK, 0u, SIM_EP_MAX_PACKET);
+    Host_Reset();
+}
+
+
+/*******************************************************************************
+* Function Name: Cdc_Start
+********************************************************************************
+*
+* Summary:
+*  The host application opens the port OPEN_DELAY_NS after enumeration, when
+*  the firmware has initialized the CDC interface.
+*
+*******************************************************************************/
+static void Cdc_Start(void)
+{
+    Host_Start();
+    cdcOpen = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Cdc_Open
+********************************************************************************
+*
+* Summary:
+*  Opens a port the way a terminal does: sets the line coding to the -b
+*  baud rate, 8N1, and raises DTR and RTS. The requests go to the
+*  communication interface of the port.
+*
+*******************************************************************************/
+static void Cdc_Open(uint8 com)
+{
+    uint8  lineCoding[7u] = {0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x08u};
+    uint8  setup[8u];
+    uint16 length;
+
+    lineCoding[0u] = (uint8) Sim_options.baud;
+    lineCoding[1u] = (uint8) (Sim_options.baud >> 8u);
+    lineCoding[2u] = (uint8) (Sim_options.baud >> 16u);
+    lineCoding[3u] = (uint8) (Sim_options.baud >> 24u);
+
+    Host_Setup(setup, CDC_RQST_OUT, CDC_SET_LINE_CODING, 0u, 2u * com, sizeof(lineCoding));
+    length = sizeof(lineCoding);
+    (void) Sim_HostControl(setup, lineCoding, &length);
+
+    Host_Setup(setup, CDC_RQST_OUT, CDC_SET_CONTROL_LINE, 0x0003u, 2u * com, 0u);
+    length = 0u;
+    (void) Sim_HostControl(setup, NULL, &length);
+}
+
+
+/*******************************************************************************
+* Function Name: Cdc_Frame
+********************************************************************************
+*
+* Summary:
+*  Opens the port, polls the notification endpoint once per frame and fails
+*  the run when the echo stream stalls.
+*
+*******************************************************************************/
+static void Cdc_Frame(void)
+{
+    uint8  data[SIM_EP_MAX_PACKET];
+    uint16 length;
+
+    if ((0u == cdcOpen) && (Sim_busTime >= hostHoldTime))
+    {
+        Cdc_Open(0u);
+        cdcOpen = 1u;
+    }
+
+    if (SIM_ACK == Sim_HostIn(CDC_COMM_EP, data, &length))
+    {
+        ++pollReports;
+        if (length >= 10u)
+        {
+            pollLastState = (uint16) (data[8u] | ((uint16) data[9u] << 8u));
+        }
+    }
+
+    if ((hostSentBytes != hostReceivedBytes) &&
+        (Sim_busTime > (hostLastProgress + LOSS_TIMEOUT_NS)))
+    {
+        hostLost = hostSent - hostDone;
+        hostDone = hostSent;
+        hostSentBytes = hostReceivedBytes;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cdc_Transaction
+********************************************************************************
+*
+* Summary:
+*  Sends the byte stream in packets of the configured length and checks that
+*  the echoed stream is identical. Like a terminal, the host keeps reading the
+*  IN endpoint, so zero-length packets are accepted anywhere.
+*
+*******************************************************************************/
+static uint8 Cdc_Transaction(void)
+{
+    uint8  data[SIM_EP_MAX_PACKET];
+    uint16 length = Sim_options.length;
+    uint16 i;
+
+    if ((Sim_busTime < hostHoldTime) || (0u == cdcOpen))
+    {
+        return (0u);
+    }
+
+    if ((hostSent < Sim_options.packets) && ((hostSent - hostDone) < Sim_options.window) &&
+        ((0u == hostNextIn) || (hostSent == hostDone)))
+    {
+        for (i = 0u; i < length; ++i)
+        {
+            data[i] = Host_StreamByte(hostSentBytes + i);
+        }
+
+        if (SIM_ACK == Sim_HostOut(CDC_OUT_EP, data, length))
+        {
+            hostSentBytes += length;
+            hostPacket[hostSent % SIM_MAX_WINDOW].sendTime = Sim_busTime;
+            hostPacket[hostSent % SIM_MAX_WINDOW].endOffset = hostSentBytes;
+            ++hostSent;
+        }
+
+        hostNextIn = 1u;
+    }
+    else
+    {
+        if (SIM_ACK == Sim_HostIn(CDC_IN_EP, data, &length))
+        {
+            for (i = 0u; i < length; ++i)
+            {
+                if (data[i] != Host_StreamByte(hostReceivedBytes + i))
+                {
+                    ++hostCorrupt;
+                    break;
+                }
+            }
+
+            hostReceivedBytes += length;
+            hostLastProgress = Sim_busTime;
+            hostLastTime = Sim_busTime;
+
+            while ((hostDone != hostSent) &&
+                   (hostReceivedBytes >= hostPacket[hostDone % SIM_MAX_WINDOW].endOffset))
+            {
+                Host_Latency(hostPacket[hostDone % SIM_MAX_WINDOW].sendTime);
+                ++hostDone;
+            }
+        }
+
+        hostNextIn = 0u;
+    }
+
+    return (1u);
+}
+
+
+/*******************************************************************************
+* Function Name: Cdc_Done
+********************************************************************************
+*
+* Summary:
+*  The run is done when the whole stream has been echoed.
+*
+*******************************************************************************/
+static uint8 Cdc_Done(void)
+{
+    return ((hostDone == Sim_options.packets) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Cdc_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the CDC echo report.
+*
+*******************************************************************************/
+static int Cdc_Report(void)
+{
+    int status;
+
+    Sim_ReportHeader("cdc-echo");
+    status = Host_ReportTraffic(CDC_OUT_EP, CDC_IN_EP);
+    printf("notifications   : %lu, serial state 0x%04X\n",
+           (unsigned long) pollReports, (unsigned) pollLastState);
+
+    return (Host_PrintResult(status));
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the USB-UART bridge report. Every byte echoed must have crossed the
+*  UART, and hardware flow control must not lose any.
+*
+*******************************************************************************/
+static int Bridge_Report(void)
+{
+    int status;
+
+    Sim_ReportHeader("uart-bridge");
+    status = Host_ReportTraffic(CDC_OUT_EP, CDC_IN_EP);
+    printf("uart            : %lu baud, %lu bytes, %lu overruns\n",
+           (unsigned long) UART_SimBaud(), (unsigned long) UART_simBytes,
+           (unsigned long) UART_simOverflows);
+    printf("notifications   : %lu, serial state 0x%04X\n",
+           (unsigned long) pollReports, (unsigned) pollLastState);
+
+    if ((SIM_EXIT_PASS == status) &&
+        ((0u != UART_simOverflows) || (UART_simBytes < hostReceivedBytes)))
+    {
+        status = SIM_EXIT_DATA_ERROR;
+    }
+
+    return (Host_PrintResult(status));
+}
+
+
+/*******************************************************************************
+* Function Name: Status_Configure
+********************************************************************************
+*
+* Summary:
+*  USBUART example, as cdc-echo.
+*
+*******************************************************************************/
+static void Status_Configure(void)
+{
+    Cdc_Configure();
+
+    statusFrame = 0u;
+    statusSteps = 0u;
+    statusRequests = 0u;
+    statusErrors = 0u;
+    statusFinished = 0u;
+    pollLastState = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Status_Step
+********************************************************************************
+*
+* Summary:
+*  Checks the notifications of the step that ends, then sets the control
+*  lines of the next step back to back, within one polling interval. A step
+*  fails if it took more notifications than allowed or the last serial state
+*  the host has seen does not follow the last DTR state set. Once the stream
+*  has been echoed, the run ends at the end of the script.
+*
+*******************************************************************************/
+static void Status_Step(void)
+{
+    const STATUS_STEP *step = &statusScript[statusSteps % STATUS_STEPS];
+    uint8  setup[8u];
+    uint16 length;
+    uint8  i;
+
+    if ((statusStepReports > statusMaxReports) || (pollLastState != statusExpected))
+    {
+        ++statusErrors;
+
+        if (0u != Sim_options.verbose)
+        {
+            printf("%10.3f ms step %lu: %lu notifications, serial state 0x%04X, expected 0x%04X\n",
+                   (double) Sim_busTime / SIM_NS_PER_MS, (unsigned long) statusSteps,
+                   (unsigned long) statusStepReports, (unsigned) pollLastState,
+                   (unsigned) statusExpected);
+        }
+    }
+
+    if ((hostDone == Sim_options.packets) && (statusSteps >= STATUS_STEPS) &&
+        (0u == (statusSteps % STATUS_STEPS)))
+    {
+        statusFinished = 1u;
+        return;
+    }
+
+    for (i = 0u; i < STATUS_BURST; ++i)
+    {
+        Host_Setup(setup, CDC_RQST_OUT, CDC_SET_CONTROL_LINE, step->lines[i], 0u, 0u);
+        length = 0u;
+        (void) Sim_HostControl(setup, NULL, &length);
+        ++statusRequests;
+    }
+
+    statusExpected = (0u != (step->lines[STATUS_BURST - 1u] & STATUS_LINE_DTR)) ? STATUS_DCD_DSR : 0u;
+    statusMaxReports = step->maxReports;
+    statusStepReports = 0u;
+    ++statusSteps;
+}
+
+
+/*******************************************************************************
+* Function Name: Status_Frame
+********************************************************************************
+*
+* Summary:
+*  Opens the port, which raises DTR and takes one notification, polls the
+*  notification endpoint every bInterval frames (-i) and runs a step of the
+*  control line script every STATUS_STEP_POLLS polls, right after a poll.
+*
+*******************************************************************************/
+static void Status_Frame(void)
+{
+    uint8  data[SIM_EP_MAX_PACKET];
+    uint16 length;
+    uint32 interval = (0u != Sim_options.interval) ? Sim_options.interval : 1u;
+
+    if ((0u == cdcOpen) && (Sim_busTime >= hostHoldTime))
+    {
+        Cdc_Open(0u);
+        cdcOpen = 1u;
+
+        statusExpected = STATUS_DCD_DSR;
+        statusMaxReports = 1u;
+        statusStepReports = 0u;
+    }
+
+    if (0u == cdcOpen)
+    {
+        return;
+    }
+
+    if (0u == (statusFrame % interval))
+    {
+        if (SIM_ACK == Sim_HostIn(CDC_COMM_EP, data, &length))
+        {
+            ++pollReports;
+            ++statusStepReports;
+            if (length >= 10u)
+            {
+                pollLastState = (uint16) (data[8u] | ((uint16) data[9u] << 8u));
+            }
+        }
+        else
+        {
+            ++pollNaks;
+        }
+    }
+
+    ++statusFrame;
+    if ((0u == statusFinished) && (0u == (statusFrame % (interval * STATUS_STEP_POLLS))))
+    {
+        Status_Step();
+    }
+
+    if ((hostSentBytes != hostReceivedBytes) &&
+        (Sim_busTime > (hostLastProgress + LOSS_TIMEOUT_NS)))
+    {
+        hostLost = hostSent - hostDone;
+        hostDone = hostSent;
+        hostSentBytes = hostReceivedBytes;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Status_Done
+********************************************************************************
+*
+* Summary:
+*  The run is done when the whole stream has been echoed and the steps of the
+*  last run of the script have been checked.
+*
+*******************************************************************************/
+static uint8 Status_Done(void)
+{
+    return (statusFinished);
+}
+
+
+/*******************************************************************************
+* Function Name: Status_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the serial state report. Every notification must carry a change,
+*  and the changes within a polling interval must be merged.
+*
+*******************************************************************************/
+static int Status_Report(void)
+{
+    int status;
+
+    Sim_ReportHeader("cdc-status");
+    status = Host_ReportTraffic(CDC_OUT_EP, CDC_IN_EP);
+    printf("control lines   : %lu requests in %lu steps\n",
+           (unsigned long) statusRequests, (unsigned long) statusSteps);
+    printf("notifications   : %lu, %lu polls NAKed, serial state 0x%04X\n",
+           (unsigned long) pollReports, (unsigned long) pollNaks, (unsigned) pollLastState);
+    printf("steps failed    : %lu\n", (unsigned long) statusErrors);
+
+    if ((SIM_EXIT_PASS == status) && (0u != statusErrors))
+    {
+        status = SIM_EXIT_DATA_ERROR;
+    }
+
+    return (Host_PrintResult(status));
+}
+
+
+/*******************************************************************************
+* Function Name: Multi_Configure
+********************************************************************************
+*
+* Summary:
+*  USBUART example with -m COM ports: for each port an interrupt IN
+*  (notification), a bulk IN and a bulk OUT endpoint, numbered as the
+*  endpoints of the first port plus three per port.
+*
+*******************************************************************************/
+static void Multi_Configure(void)
+{
+    uint8 com;
+
+    for (com = 0u; com < Sim_options.ports; ++com)
+    {
+        Sim_HostConfigureEp(CDC_PORT_EP(com, CDC_COMM_EP), SIM_EP_TYPE_INT, 1u, CDC_COMM_EP_SIZE);
+        Sim_HostConfigureEp(CDC_PORT_EP(com, CDC_IN_EP), SIM_EP_TYPE_BULK, 1u, SIM_EP_MAX_PACKET);
+        Sim_HostConfigureEp(CDC_PORT_EP(com, CDC_OUT_EP), SIM_EP_TYPE_BULK, 0u, SIM_EP_MAX_PACKET);
+    }
+
+    (void) memset(multiPort, 0, sizeof(multiPort));
+    multiNext = 0u;
+    Host_Reset();
+}
+
+
+/*******************************************************************************
+* Function Name: Multi_StreamByte
+********************************************************************************
+*
+* Summary:
+*  Returns the test pattern byte at an offset of the byte stream of a port.
+*  The streams differ, so data echoed on the wrong port is corrupt.
+*
+*******************************************************************************/
+static uint8 Multi_StreamByte(uint8 com, uint32 offset)
+{
+    return ((uint8) (Host_StreamByte(offset) + (0x55u * com)));
+}
+
+
+/*******************************************************************************
+* Function Name: Multi_Frame
+********************************************************************************
+*
+* Summary:
+*  Opens all ports and ends the echo stream of a port that stalls.
+*
+*******************************************************************************/
+static void Multi_Frame(void)
+{
+    MULTI_PORT *port;
+    uint8 com;
+
+    if ((0u == cdcOpen) && (Sim_busTime >= hostHoldTime))
+    {
+        for (com = 0u; com < Sim_options.ports; ++com)
+        {
+            Cdc_Open(com);
+            multiPort[com].lastProgress = hostFirstTime;
+            multiPort[com].lastTime = hostFirstTime;
+        }
+
+        cdcOpen = 1u;
+    }
+
+    for (com = 0u; com < Sim_options.ports; ++com)
+    {
+        port = &multiPort[com];
+
+        if ((port->sentBytes != port->receivedBytes) &&
+            (Sim_busTime > (port->lastProgress + LOSS_TIMEOUT_NS)))
+        {
+            port->lost += port->sent - port->done;
+            port->done = port->sent;
+            port->sentBytes = port->receivedBytes;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Multi_Transaction
+********************************************************************************
+*
+* Summary:
+*  Serves the ports round robin, one transaction each, as the host controller
+*  schedules bulk endpoints. Every port keeps -w packets of its own byte
+*  stream in flight, so all ports are saturated, and checks its echo.
+*
+*******************************************************************************/
+static uint8 Multi_Transaction(void)
+{
+    uint8  data[SIM_EP_MAX_PACKET];
+    uint16 length = Sim_options.length;
+    MULTI_PORT *port = NULL;
+    uint8  com = 0u;
+    uint8  i;
+    uint16 j;
+
+    if ((Sim_busTime < hostHoldTime) || (0u == cdcOpen))
+    {
+        return (0u);
+    }
+
+    /* Next port that has not finished. */
+    for (i = 0u; (i < Sim_options.ports) && (NULL == port); ++i)
+    {
+        com = (uint8) ((multiNext + i) % Sim_options.ports);
+
+        if (multiPort[com].done < Sim_options.packets)
+        {
+            port = &multiPort[com];
+        }
+    }
+
+    if (NULL == port)
+    {
+        return (0u);
+    }
+
+    multiNext = (uint8) ((com + 1u) % Sim_options.ports);
+
+    if ((port->sent < Sim_options.packets) && ((port->sent - port->done) < Sim_options.window) &&
+        ((0u == port->nextIn) || (port->sent == port->done)))
+    {
+        for (j = 0u; j < length; ++j)
+        {
+            data[j] = Multi_StreamByte(com, port->sentBytes + j);
+        }
+
+        if (SIM_ACK == Sim_HostOut(CDC_PORT_EP(com, CDC_OUT_EP), data, length))
+        {
+            port->sentBytes += length;
+            port->packet[port->sent % SIM_MAX_WINDOW].sendTime = Sim_busTime;
+            port->packet[port->sent % SIM_MAX_WINDOW].endOffset = port->sentBytes;
+            ++port->sent;
+            ++hostSent;
+        }
+
+        port->nextIn = 1u;
+    }
+    else
+    {
+        if (SIM_ACK == Sim_HostIn(CDC_PORT_EP(com, CDC_IN_EP), data, &length))
+        {
+            for (j = 0u; j < length; ++j)
+            {
+                if (data[j] != Multi_StreamByte(com, port->receivedBytes + j))
+                {
+                    ++port->corrupt;
+                    break;
+                }
+            }
+
+            port->receivedBytes += length;
+            port->lastProgress = Sim_busTime;
+            port->lastTime = Sim_busTime;
+
+            while ((port->done != port->sent) &&
+                   (port->receivedBytes >= port->packet[port->done % SIM_MAX_WINDOW].endOffset))
+            {
+                Host_Latency(port->packet[port->done % SIM_MAX_WINDOW].sendTime);
+                ++port->done;
+            }
+        }
+
+        port->nextIn = 0u;
+    }
+
+    return (1u);
+}
+
+
+/*******************************************************************************
+* Function Name: Multi_Done
+********************************************************************************
+*
+* Summary:
+*  The run is done when the streams of all ports have been echoed.
+*
+*******************************************************************************/
+static uint8 Multi_Done(void)
+{
+    uint8 com;
+
+    for (com = 0u; com < Sim_options.ports; ++com)
+    {
+        if (multiPort[com].done < Sim_options.packets)
+        {
+            return (0u);
+        }
+    }
+
+    return (1u);
+}
+
+
+/*******************************************************************************
+* Function Name: Multi_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the throughput of every port, the aggregate throughput and the
+*  fairness: the throughput of the slowest port relative to the fastest. A
+*  port that gets less than half the throughput of the fastest is starved,
+*  and the run is SLOW.
+*
+*******************************************************************************/
+static int Multi_Report(void)
+{
+    MULTI_PORT *port;
+    uint64 last = hostFirstTime;
+    uint32 bytes = 0u;
+    uint32 lost = 0u;
+    uint32 corrupt = 0u;
+    double kbps;
+    double minKbps = 0.0;
+    double maxKbps = 0.0;
+    double total = 0.0;
+    int status = SIM_EXIT_PASS;
+    uint8 com;
+
+    Sim_ReportHeader("cdc-multi");
+
+    for (com = 0u; com < Sim_options.ports; ++com)
+    {
+        port = &multiPort[com];
+        kbps = 0.0;
+
+        if (port->lastTime > hostFirstTime)
+        {
+            kbps = ((double) port->receivedBytes * 1e9) /
+                   ((double) (port->lastTime - hostFirstTime) * 1024.0);
+        }
+
+        printf("port %u          : %lu sent, %lu returned, %lu lost, %lu corrupt, %.1f KB/s\n",
+               (unsigned) com, (unsigned long) port->sent, (unsigned long) port->done,
+               (unsigned long) port->lost, (unsigned long) port->corrupt, kbps);
+
+        minKbps = ((0u == com) || (kbps < minKbps)) ? kbps : minKbps;
+        maxKbps = (kbps > maxKbps) ? kbps : maxKbps;
+        last = (port->lastTime > last) ? port->lastTime : last;
+        bytes += port->receivedBytes;
+        lost += port->lost;
+        corrupt += port->corrupt;
+    }
+
+    if (last > hostFirstTime)
+    {
+        total = ((double) bytes * 1e9) / ((double) (last - hostFirstTime) * 1024.0);
+    }
+
+    printf("throughput      : %.1f KB/s aggregate, %lu bytes\n", total, (unsigned long) bytes);
+    printf("fairness        : %.0f %% (slowest / fastest port)\n",
+           (maxKbps > 0.0) ? ((100.0 * minKbps) / maxKbps) : 0.0);
+    Sim_ReportLatency("round trip", hostLatMin, hostLatSum, hostLatMax, hostLatCount);
+
+    if ((0u != lost) || (0u != corrupt))
+    {
+        status = SIM_EXIT_DATA_ERROR;
+    }
+    else if (((2.0 * minKbps) < maxKbps) ||
+             ((0u != Sim_options.minKBps) && (total < (double) Sim_options.minKBps)))
+    {
+        status = SIM_EXIT_SLOW;
+    }
+    else
+    {
+        /* Run passed. */
+    }
+
+    return (Host_PrintResult(status));
+}
+
+
+/*******************************************************************************
+* Function Name: Mouse_Configure
+********************************************************************************
+*
+* Summary:
+*  HID example: EP1 interrupt IN.
+*
+*******************************************************************************/
+static void Mouse_Configure(void)
+{
+    Sim_HostConfigureEp(MOUSE_EP, SIM_EP_TYPE_INT, 1u, MOUSE_EP_SIZE);
+    Host_Reset();
+}
+
+
+/*******************************************************************************
+* Function Name: Mouse_Frame
+********************************************************************************
+*
+* Summary:
+*  Polls the mouse endpoint every bInterval frames (-i), checks the report
+*  length and adds up the movement. A poll that gets NAK is an idle poll.
+*
+*******************************************************************************/
+static void Mouse_Frame(void)
+{
+    uint8  data[SIM_EP_MAX_PACKET];
+    uint16 length;
+    uint32 interval = (0u != Sim_options.interval) ? Sim_options.interval : 1u;
+
+    if ((Sim_busTime >= hostFirstTime) && (0u == (Sim_frame % interval)))
+    {
+        if (SIM_ACK == Sim_HostIn(MOUSE_EP, data, &length))
+        {
+            ++pollReports;
+            hostLastTime = Sim_busTime;
+            if (MOUSE_REPORT_LENGTH != length)
+            {
+                ++pollBadReports;
+            }
+            else
+            {
+                if ((0u == data[1u]) && (0u == data[2u]) && (mouseButtons == data[0u]))
+                {
+                    ++mouseEmpty;
+                }
+
+                mouseButtons = data[0u];
+                mouseX += (int8) data[1u];
+                mouseY += (int8) data[2u];
+            }
+        }
+        else
+        {
+            ++pollNaks;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Mouse_Done
+********************************************************************************
+*
+* Summary:
+*  The duration (-d) is rounded up to whole cursor cycles: the run ends in the
+*  middle of the last rest, when every step has been reported.
+*
+*******************************************************************************/
+static uint8 Mouse_Done(void)
+{
+    uint32 cycles = (Sim_options.durationMs + MOUSE_CYCLE_MS - 1u) / MOUSE_CYCLE_MS;
+    uint32 durationMs;
+
+    cycles = (0u != cycles) ? cycles : 1u;
+    durationMs = (cycles * MOUSE_CYCLE_MS) - (MOUSE_REST_MS / 2u);
+
+    return ((Sim_busTime >= (hostFirstTime + ((uint64) durationMs * SIM_NS_PER_MS))) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Hid_ParseDescriptor
+********************************************************************************
+*
+* Summary:
+*  Lists the input values and the collections of a report descriptor of
+*  short items, up to the end of its outermost collection.
+*
+* Parameters:
+*  desc:    Report descriptor.
+*  entries: Entries, filled in; HID_MAX_ENTRIES of them.
+*
+* Return:
+*  Number of entries, 0 if the descriptor has a long item, too many entries
+*  or usages, or does not close its collections.
+*
+*******************************************************************************/
+static uint16 Hid_ParseDescriptor(const uint8 desc[], HID_ENTRY entries[])
+{
+    uint16 usages[HID_MAX_USAGES];
+    uint16 count = 0u;
+    uint16 offset = 0u;
+    uint16 bit = 0u;
+    uint16 page = 0u;
+    uint16 usageCount = 0u;
+    uint16 usageMin = 0u;
+    uint16 usageMax = 0u;
+    uint16 reportSize = 0u;
+    uint16 reportCount = 0u;
+    int32  logicalMin = 0;
+    uint32 logicalMax = 0u;
+    int32  logicalMaxSigned = 0;
+    int32  depth = 0;
+    uint16 i;
+
+    while (offset < HID_MAX_DESCRIPTOR)
+    {
+        uint8  prefix = desc[offset];
+        uint8  size = prefix & HID_PREFIX_SIZE_MASK;
+        uint32 data = 0u;
+        int32  sdata;
+
+        size = (3u == size) ? 4u : size;
+        if (0xFEu == prefix)
+        {
+            return (0u);    /* Long item */
+        }
+
+        for (i = 0u; i < size; ++i)
+        {
+            data |= (uint32) desc[offset + 1u + i] << (8u * i);
+        }
+        sdata = (0u == size) ? 0 : (int32) (data << (32u - (8u * size))) >> (32u - (8u * size));
+        offset += 1u + size;
+
+        switch (prefix & HID_PREFIX_TAG_MASK)
+        {
+            case HID_TAG_USAGE_PAGE:   page = (uint16) data;           break;
+            case HID_TAG_LOGICAL_MIN:  logicalMin = sdata;             break;
+            case HID_TAG_LOGICAL_MAX:
+                /* Signed only when the logical minimum is negative. */
+                logicalMax = data;
+                logicalMaxSigned = sdata;
+                break;
+
+            case HID_TAG_REPORT_SIZE:  reportSize = (uint16) data;     break;
+            case HID_TAG_REPORT_COUNT: reportCount = (uint16) data;    break;
+            case HID_TAG_USAGE_MIN:    usageMin = (uint16) data;       break;
+            case HID_TAG_USAGE_MAX:    usageMax = (uint16) data;       break;
+
+            case HID_TAG_USAGE:
+                if (usageCount >= HID_MAX_USAGES)
+                {
+                    return (0u);
+                }
+                usages[usageCount] = (uint16) data;
+                ++usageCount;
+                break;
+
+            case HID_TAG_INPUT:
+                for (i = 0u; i < reportCount; ++i)
+                {
+                    if (count >= HID_MAX_ENTRIES)
+                    {
+                        return (0u);
+                    }
+
+                    /* A usage per value, a usage range, or the last usage
+                    * for the rest of the values. Constant values have none.
+                    */
+                    entries[count].item  = HID_TAG_INPUT;
+                    entries[count].flags = (uint8) data;
+                    entries[count].page  = page;
+                    entries[count].usage = (i < usageCount) ? usages[i] :
+                                           (0u != usageCount) ? usages[usageCount - 1u] :
+                                           ((usageMin + i) <= usageMax) ? (uint16) (usageMin + i) : usageMax;
+                    if (0u != (data & HID_INPUT_CONSTANT))
+                    {
+                        entries[count].page  = 0u;
+                        entries[count].usage = 0u;
+                    }
+                    entries[count].min  = logicalMin;
+                    entries[count].max  = (logicalMin < 0) ? logicalMaxSigned : (int32) logicalMax;
+                    entries[count].bit  = bit;
+                    entries[count].size = reportSize;
+                    bit += reportSize;
+                    ++count;
+                }
+                usageCount = 0u;
+                usageMin = 0u;
+                usageMax = 0u;
+                break;
+
+            case HID_TAG_COLLECTION:
+            case HID_TAG_END_COLLECTION:
+                if (count >= HID_MAX_ENTRIES)
+                {
+                    return (0u);
+                }
+                (void) memset(&entries[count], 0, sizeof(entries[count]));
+                entries[count].item = prefix & HID_PREFIX_TAG_MASK;
+                if (HID_TAG_COLLECTION == entries[count].item)
+                {
+                    entries[count].flags = (uint8) data;
+                    entries[count].page  = page;
+                    entries[count].usage = (0u != usageCount) ? usages[0u] : 0u;
+                    ++depth;
+                }
+                else
+                {
+                    --depth;
+                }
+                ++count;
+                usageCount = 0u;
+                usageMin = 0u;
+                usageMax = 0u;
+
+                if (0 == depth)
+                {
+                    return (count);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return (0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Timed_Transaction
+********************************************************************************
+*
+* Summary:
+*  The polling scenarios only use the periodic frame hook.
+*
+*******************************************************************************/
+static uint8 Timed_Transaction(void)
+{
+    return (0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Timed_Done
+********************************************************************************
+*
+* Summary:
+*  The timed scenarios end after the duration (-d).
+*
+*******************************************************************************/
+static uint8 Timed_Done(void)
+{
+    return ((Sim_busTime >= (hostFirstTime + ((uint64) Sim_options.durationMs * SIM_NS_PER_MS))) ?
+            1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Mouse_CheckDescriptor
+********************************************************************************
+*
+* Summary:
+*  Compares the report descriptor the HID example generates with the one its
+*  USBFS component sends, value by value: the customizer orders the items
+*  its own way and repeats some, so the bytes differ for the same report.
+*  Prints the first difference.
+*
+* Return:
+*  1 if both describe the same report, 0 if not.
+*
+*******************************************************************************/
+static uint8 Mouse_CheckDescriptor(void)
+{
+    HID_ENTRY component[HID_MAX_ENTRIES];
+    HID_ENTRY firmware[HID_MAX_ENTRIES];
+    const uint8 * volatile descriptor = mouseReportDescriptor;
+    uint16 componentCount;
+    uint16 firmwareCount;
+    uint16 i;
+
+    /* Volatile, or the compiler takes the weak array to be there. */
+    if (NULL == descriptor)
+    {
+        printf("descriptor      : mouseReportDescriptor missing\n");
+        return (0u);
+    }
+
+    componentCount = Hid_ParseDescriptor(mouseComponentDescriptor, component);
+    firmwareCount = Hid_ParseDescriptor(descriptor, firmware);
+
+    for (i = 0u; (i < componentCount) && (i < firmwareCount); ++i)
+    {
+        if ((component[i].item != firmware[i].item) || (component[i].flags != firmware[i].flags) ||
+            (component[i].page != firmware[i].page) || (component[i].usage != firmware[i].usage) ||
+            (component[i].min != firmware[i].min) || (component[i].max != firmware[i].max) ||
+            (component[i].bit != firmware[i].bit) || (component[i].size != firmware[i].size))
+        {
+            printf("descriptor      : entry %u differs: item 0x%02x flags 0x%02x usage %04x:%04x"
+                   " %ld..%ld bits %u+%u, component item 0x%02x flags 0x%02x usage %04x:%04x"
+                   " %ld..%ld bits %u+%u\n", i,
+                   firmware[i].item, firmware[i].flags, firmware[i].page, firmware[i].usage,
+                   (long) firmware[i].min, (long) firmware[i].max, firmware[i].bit, firmware[i].size,
+                   component[i].item, component[i].flags, component[i].page, component[i].usage,
+                   (long) component[i].min, (long) component[i].max, component[i].bit,
+                   component[i].size);
+            return (0u);
+        }
+    }
+
+    if ((0u == firmwareCount) || (componentCount != firmwareCount))
+    {
+        printf("descriptor      : %u entries, component %u\n", firmwareCount, componentCount);
+        return (0u);
+    }
+
+    printf("descriptor      : same report as the component, %u entries\n", firmwareCount);
+    return (1u);
+}
+
+
+/*******************************************************************************
+* Function Name: Mouse_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the HID report. The run fails when no report was read, a report
+*  has the wrong length or carries no change, since the mouse must leave the
+*  endpoint empty while it rests, or the movement over the whole cycles does
+*  not add up to zero, or the report descriptor of the example is not that of
+*  its USBFS component.
+*
+*******************************************************************************/
+static int Mouse_Report(void)
+{
+    int status = SIM_EXIT_PASS;
+    uint8 descriptorSame;
+
+    Sim_ReportHeader("hid-mouse");
+    printf("reports         : %lu, %lu idle polls, %lu bad length, %lu without change\n",
+           (unsigned long) pollReports, (unsigned long) pollNaks,
+           (unsigned long) pollBadReports, (unsigned long) mouseEmpty);
+    printf("movement        : x %+ld, y %+ld, buttons 0x%02x\n",
+           (long) mouseX, (long) mouseY, mouseButtons);
+    descriptorSame = Mouse_CheckDescriptor();
+
+    if ((0u != pollBadReports) || (0u != mouseEmpty) || (0u == pollReports) ||
+        (0 != mouseX) || (0 != mouseY) || (0u == descriptorSame))
+    {
+        status = SIM_EXIT_DATA_ERROR;
+    }
+
+    return (Host_PrintResult(status));
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Configure
+********************************************************************************
+*
+* Summary:
+*  HID example built with TELEMETRY_ENABLE: EP1 interrupt IN for the mouse,
+*  EP2 interrupt IN, 64 bytes, for the telemetry.
+*
+*******************************************************************************/
+static void Telemetry_Configure(void)
+{
+    Sim_HostConfigureEp(MOUSE_EP, SIM_EP_TYPE_INT, 1u, MOUSE_EP_SIZE);
+    Sim_HostConfigureEp(TELEMETRY_EP, SIM_EP_TYPE_INT, 1u, TELEMETRY_REPORT_SIZE);
+    Host_Reset();
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Record
+********************************************************************************
+*
+* Summary:
+*  Checks a demo record of a stream: its report ID and pattern, and its
+*  sequence number against the last one. A gap is dropped records.
+*
+*******************************************************************************/
+static void Telemetry_Record(TELEMETRY_HOST_STREAM *stream, uint8 reportId)
+{
+    const uint8 *record = stream->record;
+    uint16 sequence = (uint16) (record[0u] | ((uint16) record[1u] << 8u));
+    uint8 i;
+
+    ++stream->records;
+
+    if (reportId != record[2u])
+    {
+        ++stream->corrupt;
+    }
+    else
+    {
+        for (i = 3u; i < TELEMETRY_RECORD; ++i)
+        {
+            if ((uint8) (record[0u] + reportId + i) != record[i])
+            {
+                ++stream->corrupt;
+                break;
+            }
+        }
+    }
+
+    if ((0u != stream->started) && (sequence != stream->sequence))
+    {
+        stream->dropped += (uint16) (sequence - stream->sequence);
+    }
+
+    stream->started = 1u;
+    stream->sequence = sequence + 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Frame
+********************************************************************************
+*
+* Summary:
+*  Polls the telemetry endpoint every bInterval frames (-i), checks the
+*  report length, report ID and zero padding, and puts the records of each
+*  stream back together.
+*
+*******************************************************************************/
+static void Telemetry_Frame(void)
+{
+    uint8  data[SIM_EP_MAX_PACKET];
+    uint16 length;
+    uint32 interval = (0u != Sim_options.interval) ? Sim_options.interval : 1u;
+    TELEMETRY_HOST_STREAM *stream;
+    uint8 reportId;
+    uint8 count;
+    uint8 i;
+
+    if ((Sim_busTime >= hostFirstTime) && (0u == (Sim_frame % interval)))
+    {
+        if (SIM_ACK == Sim_HostIn(TELEMETRY_EP, data, &length))
+        {
+            ++pollReports;
+            hostLastTime = Sim_busTime;
+            reportId = data[0u];
+            count = data[1u];
+
+            if ((TELEMETRY_REPORT_SIZE != length) || (0u == count) ||
+                (count > (TELEMETRY_REPORT_SIZE - TELEMETRY_HEADER_SIZE)))
+            {
+                ++pollBadReports;
+            }
+            else if ((0u == reportId) || (reportId > TELEMETRY_STREAMS))
+            {
+                ++telemetryUnknownId;
+            }
+            else
+            {
+                stream = &telemetryHost[reportId - 1u];
+                ++stream->reports;
+                stream->bytes += count;
+
+                for (i = 0u; i < count; ++i)
+                {
+                    stream->record[stream->fill] = data[TELEMETRY_HEADER_SIZE + i];
+                    ++stream->fill;
+                    if (TELEMETRY_RECORD == stream->fill)
+                    {
+                        stream->fill = 0u;
+                        Telemetry_Record(stream, reportId);
+                    }
+                }
+
+                for (i = TELEMETRY_HEADER_SIZE + count; i < TELEMETRY_REPORT_SIZE; ++i)
+                {
+                    if (0u != data[i])
+                    {
+                        ++stream->corrupt;
+                        break;
+                    }
+                }
+            }
+        }
+        else
+        {
+            ++pollNaks;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the telemetry report: the report rate against the one report per
+*  polling interval the endpoint can carry, and the rate, records, dropped
+*  records and corrupt records of each stream. The run fails when no report
+*  was read or a report is malformed, and is slow when the wire throughput
+*  is below -k.
+*
+*******************************************************************************/
+static int Telemetry_Report(void)
+{
+    uint32 interval = (0u != Sim_options.interval) ? Sim_options.interval : 1u;
+    double seconds = (double) Sim_options.durationMs / 1000.0;
+    TELEMETRY_HOST_STREAM *stream;
+    uint32 corrupt = 0u;
+    uint32 bytes = 0u;
+    double wire = 0.0;
+    int status = SIM_EXIT_PASS;
+    uint8 i;
+
+    Sim_ReportHeader("hid-telemetry");
+
+    if (0.0 == seconds)
+    {
+        seconds = 1.0;
+    }
+
+    printf("reports         : %lu, %.0f/s of %lu/s, %lu idle polls, %lu bad length, %lu unknown ID\n",
+           (unsigned long) pollReports, (double) pollReports / seconds,
+           (unsigned long) (1000u / interval), (unsigned long) pollNaks,
+           (unsigned long) pollBadReports, (unsigned long) telemetryUnknownId);
+
+    for (i = 0u; i < TELEMETRY_STREAMS; ++i)
+    {
+        stream = &telemetryHost[i];
+        printf("report ID %u     : %.0f reports/s, %.1f KB/s, %lu records, %lu dropped, %lu corrupt\n",
+               i + 1u, (double) stream->reports / seconds,
+               (double) stream->bytes / (seconds * 1024.0), (unsigned long) stream->records,
+               (unsigned long) stream->dropped, (unsigned long) stream->corrupt);
+        corrupt += stream->corrupt;
+        bytes += stream->bytes;
+    }
+
+    wire = ((double) pollReports * TELEMETRY_REPORT_SIZE) / (seconds * 1024.0);
+    printf("throughput      : %.1f KB/s on the wire, %.1f KB/s of stream data\n",
+           wire, (double) bytes / (seconds * 1024.0));
+
+    if ((0u != pollBadReports) || (0u != telemetryUnknownId) || (0u != corrupt) ||
+        (0u == pollReports))
+    {
+        status = SIM_EXIT_DATA_ERROR;
+    }
+    else if ((0u != Sim_options.minKBps) && (wire < (double) Sim_options.minKBps))
+    {
+        status = SIM_EXIT_SLOW;
+    }
+    else
+    {
+        /* Run passed. */
+    }
+
+    return (Host_PrintResult(status));
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Configure
+********************************************************************************
+*
+* Summary:
+*  HID bootloader: EP1 interrupt OUT and EP2 interrupt IN, 64 bytes.
+*
+*******************************************************************************/
+static void Idle_Configure(void)
+{
+    Sim_HostConfigureEp(BOOT_OUT_EP, SIM_EP_TYPE_INT, 0u, SIM_EP_MAX_PACKET);
+    Sim_HostConfigureEp(BOOT_IN_EP, SIM_EP_TYPE_INT, 1u, SIM_EP_MAX_PACKET);
+    Host_Reset();
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Frame
+********************************************************************************
+*
+* Summary:
+*  No traffic.
+*
+*******************************************************************************/
+static void Idle_Frame(void)
+{
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Report
+********************************************************************************
+*
+* Summary:
+*  Prints the idle report.
+*
+*******************************************************************************/
+static int Idle_Report(void)
+{
+    Sim_ReportHeader("idle");
+
+    return (Host_PrintResult(SIM_EXIT_PASS));
+}
+
+
+static const SIM_SCENARIO loopbackScenario =
+{
+    "loopback", "bulk EP2 OUT -> EP1 IN loopback (-n -l -w -k)",
+    &Loop_Configure, &Host_Start, &Loop_Frame, &Loop_Transaction, &Loop_Done, &Loop_Report
+};
+
+static const SIM_SCENARIO suspendScenario =
+{
+    "suspend", "loopback with bus suspend every -i ms",
+    &Loop_Configure, &Host_Start, &Suspend_Frame, &Loop_Transaction, &Loop_Done, &Suspend_Report
+};
+
+static const SIM_SCENARIO lpmScenario =
+{
+    "lpm", "loopback with LPM L1 every -i ms, BESL 0/4/10",
+    &Loop_Configure, &Host_Start, &Lpm_Frame, &Loop_Transaction, &Loop_Done, &Lpm_Report
+};
+
+static const SIM_SCENARIO cdcScenario =
+{
+    "cdc-echo", "CDC byte stream echo EP3 OUT -> EP2 IN (-n -l -w -k)",
+    &Cdc_Configure, &Cdc_Start, &Cdc_Frame, &Cdc_Transaction, &Cdc_Done, &Cdc_Report
+};
+
+static const SIM_SCENARIO bridgeScenario =
+{
+    "uart-bridge", "cdc-echo through the USB-UART bridge at -b baud (-n -l -w -k)",
+    &Cdc_Configure, &Cdc_Start, &Cdc_Frame, &Cdc_Transaction, &Cdc_Done, &Bridge_Report
+};
+
+static const SIM_SCENARIO multiScenario =
+{
+    "cdc-multi", "CDC echo on -m COM ports at once, round robin (-n -l -w -k)",
+    &Multi_Configure, &Cdc_Start, &Multi_Frame, &Multi_Transaction, &Multi_Done, &Multi_Report
+};
+
+static const SIM_SCENARIO statusScenario =
+{
+    "cdc-status", "CDC echo while the host toggles DTR, counts notifications (-n -i)",
+    &Status_Configure, &Cdc_Start, &Status_Frame, &Cdc_Transaction, &Status_Done, &Status_Report
+};
+
+static const SIM_SCENARIO mouseScenario =
+{
+    "hid-mouse", "poll HID mouse EP1 IN every -i ms for -d ms in whole cursor cycles",
+    &Mouse_Configure, &Host_Start, &Mouse_Frame, &Timed_Transaction, &Mouse_Done, &Mouse_Report
+};
+
+static const SIM_SCENARIO telemetryScenario =
+{
+    "hid-telemetry", "poll HID telemetry EP2 IN every -i ms for -d ms (-k)",
+    &Telemetry_Configure, &Host_Start, &Telemetry_Frame, &Timed_Transaction, &Timed_Done,
+    &Telemetry_Report
+};
+
+static const SIM_SCENARIO idleScenario =
+{
+    "idle", "enumerate and idle for -d ms",
+    &Idle_Configure, &Host_Start, &Idle_Frame, &Timed_Transaction, &Timed_Done, &Idle_Report
+};
+
+const SIM_SCENARIO *const Sim_scenarios[] =
+{
+    &loopbackScenario,
+    &suspendScenario,
+    &lpmScenario,
+    &cdcScenario,
+    &bridgeScenario,
+    &multiScenario,
+    &statusScenario,
+    &mouseScenario,
+    &telemetryScenario,
+    &idleScenario,
+    &HostSim_scenario,
+    NULL
+};
+
+
+/* [] END OF FILE */
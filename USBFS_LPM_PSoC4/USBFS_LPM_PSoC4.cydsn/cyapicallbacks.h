@@ -26,6 +26,18 @@ void USBFS_LPM_ISR_EntryCallback(void);
 
 #define USBFS_BUS_RESET_ISR_EXIT_CALLBACK
 void  USBFS_BUS_RESET_ISR_ExitCallback(void);
+
+#define USBFS_EP_0_ISR_EXIT_CALLBACK
+void USBFS_EP_0_ISR_ExitCallback(void);
+
+#define USBFS_EP_1_ISR_EXIT_CALLBACK
+void USBFS_EP_1_ISR_ExitCallback(void);
+
+#define USBFS_EP_2_ISR_EXIT_CALLBACK
+void USBFS_EP_2_ISR_ExitCallback(void);
+
+#define USBFS_HANDLE_VENDOR_RQST_CALLBACK
+uint8 USBFS_HandleVendorRqst_Callback(void);
     
 #endif /* CYAPICALLBACKS_H */   
 /* [] END OF FILE */
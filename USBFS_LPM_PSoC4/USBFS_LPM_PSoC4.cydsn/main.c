@@ -11,6 +11,10 @@
 *  BOS descriptor, and depending on the BESL value received from the host, the 
 *  device enters either the hibernate mode or deep sleep mode or stays in the
 *  active mode.
+*  The firmware counts the packets of each endpoint, including the OUT packets
+*  it drops because the IN endpoint buffer is still full, and the bus resets
+*  and configuration changes. The host reads the counters with the
+*  GET_USB_STATS vendor request (usb_stats.h). The counters survive hibernate.
 *  
 * Related Document:
 *   ECN:  Link Power Management (LPM) - 7/2007
@@ -29,6 +33,7 @@
 *******************************************************************************/
 
 #include <main.h>
+#include "usb_stats.h"
 
 
 /* Buffer for data transfer from OUT to IN endpoint. */
@@ -38,6 +43,12 @@ uint8 beslValue;
 /* Variables for detection suspend condition on USB bus. */
 CY_NOINIT volatile uint8 activeMode;
 
+/* Events posted by the USB interrupt callbacks: the host has completed a
+* transfer on the IN or OUT endpoint, or the configuration may have changed.
+*/
+volatile uint8 epEvent;
+volatile uint8 configEvent;
+
 /* Back up variables - settings to restore after hibernate*/
 CY_NOINIT uint8 hibAddressBu;
 CY_NOINIT uint8 hibConfigurationBu;
@@ -63,6 +74,9 @@ CY_NOINIT T_USBFS_EP_CTL_BLOCK hibUSBFS_EPBu[USBFS_MAX_EP];
 *      BESL_DEEP_MODE, goes to the hibernate mode.
 *      The device wakes up when the host drives a resume condition on the bus and 
 *      restores components the active mode operation.
+*   7. Between USB events in the active mode, the CPU waits in Sleep (WFI)
+*      until an interrupt callback posts an event.
+*   8. Counts the USB traffic for the GET_USB_STATS vendor request.
 *      
 * Parameters:
 *  None.
@@ -82,6 +96,9 @@ int main()
         LED_DEEP_SLEEP(LED_OFF);  
         LED_HIBERNATE(LED_OFF);  
         
+        /* Clear the USB traffic statistics before the first bus reset. */
+        UsbStats_Clear();
+        
         /* Start USBFS operation with 5V power supply. */
         /* LPM request is ACKed after Start was called. */
         USBFS_Start(USBFS_DEVICE, USBFS_5V_OPERATION);
@@ -89,6 +106,7 @@ int main()
         /* Wait until device is enumerated by host */
         while (0u == USBFS_GetConfiguration())
         {
+            WaitForUsbEvent();
         } 
         
     }
@@ -116,6 +134,9 @@ int main()
         {
             /* Run USBFS Wraparound Code Example in active mode. */
             BulkWrapAround();
+
+            /* Sleep until the next endpoint event or LPM request. */
+            WaitForUsbEvent();
         }
         else
         {
@@ -224,6 +245,7 @@ void USBFS_LPM_ISR_EntryCallback(void)
 *
 * Summary:
 *  This function executes in the Bus reset ISRnd and cleans up the status variables.
+*  It also counts the bus reset.
 *
 * Parameters:
 *  None.
@@ -234,8 +256,10 @@ void USBFS_LPM_ISR_EntryCallback(void)
 *******************************************************************************/
 void  USBFS_BUS_RESET_ISR_ExitCallback(void)
 {
+    USB_STATS_BUS_RESET;
     beslValue = 0u;
     activeMode = FALSE;
+    configEvent = TRUE;
     /* Turn on the red LED - entered active mode from non-hibernate reset */
     LED_DEVICE_STATE(LED_ON); 
     LED_DEEP_SLEEP(LED_OFF);  
@@ -261,14 +285,27 @@ void BulkWrapAround(void)
 {
     uint16 length;
     
-    /* Check if configuration is changed. */
-    if (0u != USBFS_IsConfigurationChanged())
+    /* Apply a clear of the statistics requested by the host. */
+    UsbStats_Service();
+
+    /* Configuration can change only in the control endpoint or bus reset
+    * interrupt.
+    */
+    if (FALSE != configEvent)
     {
-        /* Re-enable endpoint when device is configured. */
-        if (0u != USBFS_GetConfiguration())
+        configEvent = FALSE;
+
+        /* Check if configuration is changed. */
+        if (0u != USBFS_IsConfigurationChanged())
         {
-            /* Enable OUT endpoint to receive data from host. */
-            USBFS_EnableOutEP(OUT_EP_NUM);
+            USB_STATS_CONFIG_CHANGE;
+
+            /* Re-enable endpoint when device is configured. */
+            if (0u != USBFS_GetConfiguration())
+            {
+                /* Enable OUT endpoint to receive data from host. */
+                USBFS_EnableOutEP(OUT_EP_NUM);
+            }
         }
     }
 
@@ -280,6 +317,7 @@ void BulkWrapAround(void)
 
         /* Copy data from OUT endpoint buffer. */
         USBFS_ReadOutEP(OUT_EP_NUM, buffer, length);
+        USB_STATS_PACKET(OUT_EP_NUM, length);
         
         /* Check if IN endpoint buffer is empty. */
         if (USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(IN_EP_NUM))
@@ -288,8 +326,135 @@ void BulkWrapAround(void)
             * by host.
             */
             USBFS_LoadInEP(IN_EP_NUM, buffer, length);    
+            USB_STATS_PACKET(IN_EP_NUM, length);
         }
+        else
+        {
+            /* The host has not read the previous packet yet: the data is
+            * dropped.
+            */
+            USB_STATS_DROP(OUT_EP_NUM);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: WaitForUsbEvent
+********************************************************************************
+*
+* Summary:
+*  Puts the CPU into Sleep mode until a USB interrupt posts an event or an LPM
+*  request is received. Returns immediately if an event is already posted. The
+*  events are checked with interrupts disabled: an interrupt that occurs after
+*  the check stays pending and wakes the CPU from WFI. The endpoint event is
+*  cleared on return; the caller checks the endpoint state after that.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void WaitForUsbEvent(void)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    if ((FALSE == epEvent) && (FALSE == configEvent) && (FALSE != activeMode))
+    {
+        CySysPmSleep();
     }
+
+    CyExitCriticalSection(interruptState);
+
+    epEvent = FALSE;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_0_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the control endpoint ISR. It posts an
+*  event to check for a configuration change.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_0_ISR_ExitCallback(void)
+{
+    configEvent = TRUE;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_1_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the IN endpoint ISR, after the host
+*  has read the IN endpoint buffer.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_1_ISR_ExitCallback(void)
+{
+    epEvent = TRUE;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_2_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the OUT endpoint ISR, after the host
+*  has written the OUT endpoint buffer. It posts an event to loop back the data.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_2_ISR_ExitCallback(void)
+{
+    epEvent = TRUE;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_HandleVendorRqst_Callback
+********************************************************************************
+*
+* Summary:
+*  This function is called by the component to handle vendor-specific
+*  requests. It handles the request that reads the USB traffic statistics.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  TRUE if the request is handled; FALSE otherwise.
+*
+*******************************************************************************/
+uint8 USBFS_HandleVendorRqst_Callback(void)
+{
+    return (UsbStats_HandleRequest());
 }
 
 
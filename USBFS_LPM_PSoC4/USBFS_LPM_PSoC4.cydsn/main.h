@@ -29,6 +29,7 @@
 *******************************************************************************/
 
 void BulkWrapAround(void);
+void WaitForUsbEvent(void);
 void LowPowerMode(void);
 void HibernateBackUp(void);
 void HibernateRestore(void);
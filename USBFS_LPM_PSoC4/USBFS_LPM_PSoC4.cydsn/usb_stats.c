@@ -0,0 +1,182 @@
+/*******************************************************************************
+* File Name: usb_stats.c
+*
+* Version: 1.0
+*
+* Description:
+*  USB traffic statistics. The counters are not initialized at startup, so
+*  they survive Hibernate; the firmware clears them with UsbStats_Clear() after
+*  any other reset. The request handler sends a snapshot, so the main loop may
+*  keep counting while the control read is in progress. The main loop counts
+*  with plain increments, so the handler, in the control endpoint interrupt,
+*  does not write the counters: it leaves a clear to UsbStats_Service() in
+*  the main loop, which subtracts the counters the host has read and keeps
+*  the ones counted since.
+*  USBFS_suspend and USBFS_LPM_PSoC4 have identical copies of this file and
+*  usb_stats.h: change both projects together.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "usb_stats.h"
+
+/* Number of 32-bit words in the statistics block. */
+#define USB_STATS_WORDS     (sizeof(USB_STATS) / sizeof(uint32))
+
+/* Not initialized: USBFS_LPM_PSoC4 clears the block only after a reset
+* that is not a wakeup from Hibernate. USBFS_suspend does not hibernate and
+* clears it at every start.
+*/
+CY_NOINIT USB_STATS usbStats;
+
+/* Copy of the block sent by the control read in progress. */
+static USB_STATS usbStatsSnapshot;
+
+/* Counters read by the last request that clears them, and the flag that
+* tells the main loop to subtract them.
+*/
+static USB_STATS usbStatsRead;
+static volatile uint8 usbStatsClearPending;
+
+
+/*******************************************************************************
+* Function Name: UsbStats_Clear
+********************************************************************************
+*
+* Summary:
+*  Clears all counters. Call it from the main loop.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void UsbStats_Clear(void)
+{
+    uint8 interruptState;
+    uint8 epNumber;
+
+    /* The bus reset interrupt counts too. */
+    interruptState = CyEnterCriticalSection();
+
+    usbStatsClearPending   = 0u;
+    usbStats.epCount       = USBFS_MAX_EP;
+    usbStats.busResets     = 0u;
+    usbStats.configChanges = 0u;
+
+    for (epNumber = 0u; epNumber < USBFS_MAX_EP; ++epNumber)
+    {
+        usbStats.ep[epNumber].packets = 0u;
+        usbStats.ep[epNumber].bytes   = 0u;
+        usbStats.ep[epNumber].drops   = 0u;
+    }
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: UsbStats_Service
+********************************************************************************
+*
+* Summary:
+*  Applies the clear requested by the host: subtracts the counters the host
+*  has read from the counters. Call it from the main loop.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void UsbStats_Service(void)
+{
+    uint8 interruptState;
+    uint8 epNumber;
+
+    if (0u != usbStatsClearPending)
+    {
+        interruptState = CyEnterCriticalSection();
+
+        usbStatsClearPending    = 0u;
+        usbStats.busResets     -= usbStatsRead.busResets;
+        usbStats.configChanges -= usbStatsRead.configChanges;
+
+        for (epNumber = 0u; epNumber < USBFS_MAX_EP; ++epNumber)
+        {
+            usbStats.ep[epNumber].packets -= usbStatsRead.ep[epNumber].packets;
+            usbStats.ep[epNumber].bytes   -= usbStatsRead.ep[epNumber].bytes;
+            usbStats.ep[epNumber].drops   -= usbStatsRead.ep[epNumber].drops;
+        }
+
+        CyExitCriticalSection(interruptState);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UsbStats_HandleRequest
+********************************************************************************
+*
+* Summary:
+*  Handles the GET_USB_STATS vendor request. Called from the vendor request
+*  callback of the component. The block is sent little-endian: on PSoC 3 the
+*  words of the snapshot are swapped. A clear is left to UsbStats_Service().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  TRUE if the request is handled; FALSE otherwise.
+*
+*******************************************************************************/
+uint8 UsbStats_HandleRequest(void)
+{
+    uint8 requestHandled = USBFS_FALSE;
+#if (CY_PSOC3)
+    uint32 *word = (uint32 *) &usbStatsSnapshot;
+    uint8 i;
+#endif /* (CY_PSOC3) */
+
+    if ((USB_STATS_RQST_GET == USBFS_bRequestReg) &&
+        (USBFS_RQST_DIR_D2H == (USBFS_bmRequestTypeReg & USBFS_RQST_DIR_MASK)))
+    {
+        usbStatsSnapshot = usbStats;
+
+        /* The counters of an earlier clear not applied yet are part of
+        * these: the main loop subtracts these instead.
+        */
+        if (USB_STATS_CLEAR == USBFS_wValueLoReg)
+        {
+            usbStatsRead = usbStatsSnapshot;
+            usbStatsClearPending = 1u;
+        }
+
+    #if (CY_PSOC3)
+        for (i = 0u; i < USB_STATS_WORDS; ++i)
+        {
+            word[i] = CYSWAP_ENDIAN32(word[i]);
+        }
+    #endif /* (CY_PSOC3) */
+
+        USBFS_currentTD.pData = (volatile uint8 *) &usbStatsSnapshot;
+        USBFS_currentTD.count = sizeof(usbStatsSnapshot);
+        requestHandled = USBFS_InitControlRead();
+    }
+
+    return (requestHandled);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,97 @@
+/*******************************************************************************
+* File Name: usb_stats.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants, the statistics block and function prototypes
+*  of the USB traffic statistics. The firmware counts the packets, bytes and
+*  dropped packets of each endpoint, the bus resets and the configuration
+*  changes. The host reads the block with the GET_USB_STATS vendor request.
+*  USBFS_suspend and USBFS_LPM_PSoC4 have identical copies of this file and
+*  usb_stats.c: change both projects together.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(USB_STATS_H)
+#define USB_STATS_H
+
+#include <project.h>
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* Vendor-specific request: device to host, reads the statistics block.
+* A wValue of USB_STATS_CLEAR clears the counters after they are read.
+*/
+#define USB_STATS_RQST_GET      (0x04u)
+#define USB_STATS_CLEAR         (0x01u)
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Counters of one endpoint. OUT packets are counted when the firmware reads
+* them, IN packets when the firmware loads them. A dropped packet was read
+* from an OUT endpoint but never sent back, or was loaded into an IN endpoint
+* but never read by the host; it is also counted in packets.
+*/
+typedef struct
+{
+    uint32 packets;
+    uint32 bytes;
+    uint32 drops;
+} USB_EP_STATS;
+
+/* Block returned by the GET_USB_STATS request: 32-bit little-endian words
+* without padding. Entry 0 of the endpoint array, the control endpoint, is
+* not counted.
+*/
+typedef struct
+{
+    uint32 epCount;                 /* USBFS_MAX_EP */
+    uint32 busResets;
+    uint32 configChanges;
+    USB_EP_STATS ep[USBFS_MAX_EP];
+} USB_STATS;
+
+
+/***************************************
+*    Function Prototypes and Macros
+****************************************/
+
+void  UsbStats_Clear(void);
+void  UsbStats_Service(void);
+uint8 UsbStats_HandleRequest(void);
+
+extern USB_STATS usbStats;
+
+/* Counts a packet of length bytes read from or loaded into the endpoint. */
+#define USB_STATS_PACKET(epNumber, length) \
+                do{ \
+                    ++usbStats.ep[(epNumber)].packets; \
+                    usbStats.ep[(epNumber)].bytes += (length); \
+                }while(0)
+
+/* Counts a packet of the endpoint that was dropped. */
+#define USB_STATS_DROP(epNumber)    do{ ++usbStats.ep[(epNumber)].drops; }while(0)
+
+#define USB_STATS_BUS_RESET         do{ ++usbStats.busResets; }while(0)
+#define USB_STATS_CONFIG_CHANGE     do{ ++usbStats.configChanges; }while(0)
+
+#endif /* (USB_STATS_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,266 @@
+/*******************************************************************************
+* File Name: cobs.c
+*
+* Version: 1.0
+*
+* Description:
+*  COBS framing of the USBFS UART example project. The decoder keeps three
+*  bytes of state between chunks and copies nothing: a run of data bytes is
+*  returned in place, and the zero byte a block code stands for is returned
+*  as a span of cobsZero. The encoder reserves the code byte of a block when
+*  the block opens and writes it when the block closes, so each byte of the
+*  frame is stored once.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "cobs.h"
+
+static const uint8 cobsZero = 0u;
+
+
+/*******************************************************************************
+* Function Name: Cobs_DecoderInit
+********************************************************************************
+*
+* Summary:
+*  Prepares the decoder for the first byte of a frame.
+*
+* Parameters:
+*  decoder: decoder state.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Cobs_DecoderInit(COBS_DECODER *decoder)
+{
+    decoder->left = 0u;
+    decoder->zero = 0u;
+    decoder->inFrame = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Cobs_Decode
+********************************************************************************
+*
+* Summary:
+*  Decodes the next span of the stream from a chunk: a run of data bytes of
+*  the current block, up to the end of the block or of the chunk, or the zero
+*  byte that separates two blocks. Call it until the chunk is used up; the
+*  span may be empty. A delimiter ends the frame; a delimiter inside a block
+*  means that bytes were lost, and the frame is reported as an error. Either
+*  way the next byte starts a new frame. Empty delimiters are skipped.
+*
+* Parameters:
+*  decoder: decoder state.
+*  pData: the rest of the chunk.
+*  length: bytes in pData, at least one.
+*  span: returns the decoded bytes and whether they end the frame. The span
+*        is valid while the chunk is.
+*
+* Return:
+*  Number of bytes of pData used.
+*
+*******************************************************************************/
+uint16 Cobs_Decode(COBS_DECODER *decoder, const uint8 pData[], uint16 length, COBS_SPAN *span)
+{
+    uint16 count;
+    uint16 i;
+
+    span->pData = pData;
+    span->length = 0u;
+    span->end = COBS_FRAME_MORE;
+
+    if (0u != decoder->left)
+    {
+        count = (length < decoder->left) ? length : decoder->left;
+
+        for (i = 0u; (i < count) && (COBS_DELIMITER != pData[i]); ++i)
+        {
+        }
+
+        if (0u != i)
+        {
+            decoder->left -= (uint8) i;
+            span->length = i;
+            return (i);
+        }
+
+        /* A delimiter inside the block. */
+        Cobs_DecoderInit(decoder);
+        span->end = COBS_FRAME_ERROR;
+    }
+    else if (COBS_DELIMITER == pData[0u])
+    {
+        /* The zero byte owed by the last block is not part of the frame. */
+        span->end = (0u != decoder->inFrame) ? COBS_FRAME_END : COBS_FRAME_MORE;
+        Cobs_DecoderInit(decoder);
+    }
+    else
+    {
+        if (0u != decoder->zero)
+        {
+            span->pData = &cobsZero;
+            span->length = 1u;
+        }
+
+        decoder->left = pData[0u] - 1u;
+        decoder->zero = (COBS_CODE_FULL != pData[0u]) ? 1u : 0u;
+        decoder->inFrame = 1u;
+    }
+
+    return (1u);
+}
+
+
+/*******************************************************************************
+* Function Name: Cobs_EncodeStart
+********************************************************************************
+*
+* Summary:
+*  Starts encoding a frame into a buffer. COBS_ENCODED_SIZE() of the frame
+*  length is always enough.
+*
+* Parameters:
+*  encoder: encoder state.
+*  pOut: buffer of the encoded frame.
+*  size: size of pOut, at least 2.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Cobs_EncodeStart(COBS_ENCODER *encoder, uint8 pOut[], uint16 size)
+{
+    encoder->pOut = pOut;
+    encoder->size = size;
+    encoder->codeIndex = 0u;
+    encoder->length = 1u;
+    encoder->code = 1u;
+    encoder->overflow = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Cobs_EncodeWrite
+********************************************************************************
+*
+* Summary:
+*  Appends bytes to the frame. It may be called any number of times between
+*  Cobs_EncodeStart() and Cobs_EncodeEnd(). Bytes that do not fit the buffer
+*  make the frame fail at Cobs_EncodeEnd().
+*
+* Parameters:
+*  encoder: encoder state.
+*  pData: bytes to append.
+*  length: number of bytes.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Cobs_EncodeWrite(COBS_ENCODER *encoder, const uint8 pData[], uint16 length)
+{
+    uint8 *pOut = encoder->pOut;
+    uint16 out = encoder->length;
+    uint16 limit = encoder->size - 1u;     /* Room for the delimiter. */
+    uint16 codeIndex = encoder->codeIndex;
+    uint8  code = encoder->code;
+    uint16 i;
+
+    for (i = 0u; i < length; ++i)
+    {
+        if (out >= limit)
+        {
+            encoder->overflow = 1u;
+            break;
+        }
+
+        /* A block opens with a byte for its code. It has been reserved
+        * unless the last block was full.
+        */
+        if (0u == code)
+        {
+            codeIndex = out;
+            ++out;
+            code = 1u;
+
+            if (out >= limit)
+            {
+                encoder->overflow = 1u;
+                break;
+            }
+        }
+
+        if (COBS_DELIMITER == pData[i])
+        {
+            /* The zero byte closes the block and opens the next one. */
+            pOut[codeIndex] = code;
+            codeIndex = out;
+            code = 1u;
+        }
+        else
+        {
+            pOut[out] = pData[i];
+            ++code;
+
+            if (COBS_CODE_FULL == code)
+            {
+                pOut[codeIndex] = COBS_CODE_FULL;
+                code = 0u;
+            }
+        }
+
+        ++out;
+    }
+
+    encoder->length = out;
+    encoder->codeIndex = codeIndex;
+    encoder->code = code;
+}
+
+
+/*******************************************************************************
+* Function Name: Cobs_EncodeEnd
+********************************************************************************
+*
+* Summary:
+*  Closes the last block and appends the delimiter.
+*
+* Parameters:
+*  encoder: encoder state.
+*
+* Return:
+*  Length of the encoded frame, delimiter included; 0 if it did not fit.
+*
+*******************************************************************************/
+uint16 Cobs_EncodeEnd(COBS_ENCODER *encoder)
+{
+    if (0u != encoder->overflow)
+    {
+        return (0u);
+    }
+
+    if (0u != encoder->code)
+    {
+        encoder->pOut[encoder->codeIndex] = encoder->code;
+    }
+
+    encoder->pOut[encoder->length] = COBS_DELIMITER;
+    ++encoder->length;
+
+    return (encoder->length);
+}
+
+
+/* [] END OF FILE */
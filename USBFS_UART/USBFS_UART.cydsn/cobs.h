@@ -0,0 +1,107 @@
+/*******************************************************************************
+* File Name: cobs.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants, the codec state and function prototypes of
+*  the COBS (Consistent Overhead Byte Stuffing) framing of the USBFS UART
+*  example project.
+*
+*  COBS removes every zero byte from a frame, so a zero byte marks the end of
+*  each frame on the byte stream of the COM port. The frame is split into
+*  blocks of up to COBS_BLOCK_MAX non-zero bytes; each block starts with a
+*  code byte, the block length plus one. A code below 0xFF stands for the
+*  block followed by a zero byte, 0xFF for a full block with no zero after
+*  it. The overhead is one byte per COBS_BLOCK_MAX bytes of the frame at
+*  most, plus the code byte of the first block and the delimiter.
+*
+*  Both directions work incrementally on the data at hand. Cobs_Decode()
+*  takes any chunk of the stream, such as a packet from USBUART_GetAll(), and
+*  returns the decoded bytes as spans that point into the chunk itself, so a
+*  frame that spans packets is decoded without being buffered. The encoder
+*  writes straight into the buffer of the caller; it fills in the code byte of
+*  a block when the block ends.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(COBS_H)
+#define COBS_H
+
+#include <project.h>
+
+
+/***************************************
+*    Constants
+****************************************/
+
+#define COBS_DELIMITER          (0x00u)
+
+/* Non-zero bytes of a full block, coded 0xFF. */
+#define COBS_BLOCK_MAX          (254u)
+#define COBS_CODE_FULL          (0xFFu)
+
+/* Largest encoded size of a frame of n bytes, delimiter included. */
+#define COBS_ENCODED_SIZE(n)    ((n) + ((n) / COBS_BLOCK_MAX) + 2u)
+
+/* End of the span returned by Cobs_Decode(). */
+#define COBS_FRAME_MORE         (0u)    /* The frame goes on. */
+#define COBS_FRAME_END          (1u)    /* The span ends a complete frame. */
+#define COBS_FRAME_ERROR        (2u)    /* The frame was cut short: drop it. */
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Decoder state between chunks. */
+typedef struct
+{
+    uint8 left;                 /* Bytes left in the current block. */
+    uint8 zero;                 /* A zero byte follows the current block. */
+    uint8 inFrame;              /* A code byte of the frame has been read. */
+} COBS_DECODER;
+
+/* Decoded bytes: in the chunk passed to Cobs_Decode(), or a zero byte. */
+typedef struct
+{
+    const uint8 *pData;
+    uint16 length;
+    uint8  end;                 /* COBS_FRAME_MORE, _END or _ERROR. */
+} COBS_SPAN;
+
+/* Encoder state of one frame. */
+typedef struct
+{
+    uint8 *pOut;
+    uint16 size;
+    uint16 length;              /* Bytes written to pOut. */
+    uint16 codeIndex;           /* Code byte of the open block. */
+    uint8  code;                /* Its value so far; 0 if no block is open. */
+    uint8  overflow;            /* The frame does not fit pOut. */
+} COBS_ENCODER;
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void   Cobs_DecoderInit(COBS_DECODER *decoder);
+uint16 Cobs_Decode(COBS_DECODER *decoder, const uint8 pData[], uint16 length, COBS_SPAN *span);
+void   Cobs_EncodeStart(COBS_ENCODER *encoder, uint8 pOut[], uint16 size);
+void   Cobs_EncodeWrite(COBS_ENCODER *encoder, const uint8 pData[], uint16 length);
+uint16 Cobs_EncodeEnd(COBS_ENCODER *encoder);
+
+#endif /* (COBS_H) */
+
+
+/* [] END OF FILE */
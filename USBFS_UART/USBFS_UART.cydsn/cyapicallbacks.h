@@ -0,0 +1,50 @@
+/*******************************************************************************
+* File Name: cyapicallbacks.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides function prototypes for the callbacks functions of
+*  USBFS UART code example.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#ifndef CYAPICALLBACKS_H
+#define CYAPICALLBACKS_H
+    
+#define USBUART_EP_0_ISR_EXIT_CALLBACK
+void USBUART_EP_0_ISR_ExitCallback(void);
+
+#define USBUART_EP_1_ISR_EXIT_CALLBACK
+void USBUART_EP_1_ISR_ExitCallback(void);
+
+#define USBUART_EP_2_ISR_EXIT_CALLBACK
+void USBUART_EP_2_ISR_ExitCallback(void);
+
+#define USBUART_EP_3_ISR_EXIT_CALLBACK
+void USBUART_EP_3_ISR_ExitCallback(void);
+
+/* Endpoints of the second COM port. */
+#define USBUART_EP_4_ISR_EXIT_CALLBACK
+void USBUART_EP_4_ISR_ExitCallback(void);
+
+#define USBUART_EP_5_ISR_EXIT_CALLBACK
+void USBUART_EP_5_ISR_ExitCallback(void);
+
+#define USBUART_EP_6_ISR_EXIT_CALLBACK
+void USBUART_EP_6_ISR_ExitCallback(void);
+
+#define USBUART_BUS_RESET_ISR_EXIT_CALLBACK
+void USBUART_BUS_RESET_ISR_ExitCallback(void);
+    
+#endif /* CYAPICALLBACKS_H */   
+/* [] END OF FILE */
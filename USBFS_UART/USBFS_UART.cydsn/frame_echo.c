@@ -0,0 +1,150 @@
+/*******************************************************************************
+* File Name: frame_echo.c
+*
+* Version: 1.0
+*
+* Description:
+*  Frame echo of the USBFS UART example project. Each port keeps the last
+*  packet read from its OUT endpoint and decodes it span by span; the spans
+*  go straight into the encoder of the reply, so a byte from the host is
+*  copied once, from the packet to the reply. The next packet is only read
+*  when the last one is used up, and decoding stops while a reply waits for
+*  room in the transmit ring: the OUT endpoint then holds the data of the
+*  host back.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "frame_echo.h"
+
+#if (FRAME_ECHO_ENABLE)
+
+/* State of one port. */
+typedef struct
+{
+    uint8  packet[TX_RING_PACKET_SIZE];
+    uint16 packetLength;
+    uint16 packetOffset;            /* Next byte to decode. */
+    COBS_DECODER decoder;
+    COBS_ENCODER encoder;
+    uint8  reply[COBS_ENCODED_SIZE(FRAME_ECHO_MAX_PAYLOAD)];
+    uint16 replyLength;             /* Reply to send; 0 if none. */
+} FRAME_ECHO;
+
+static FRAME_ECHO frameEcho[TX_RING_PORTS];
+
+uint32 frameEchoFrames[TX_RING_PORTS];
+uint32 frameEchoDropped[TX_RING_PORTS];
+
+
+/*******************************************************************************
+* Function Name: FrameEcho_Init
+********************************************************************************
+*
+* Summary:
+*  Drops the packet and the frame in progress. Call it when the device is
+*  configured.
+*
+* Parameters:
+*  port: COM port.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void FrameEcho_Init(uint8 port)
+{
+    FRAME_ECHO *echo = &frameEcho[port];
+
+    echo->packetLength = 0u;
+    echo->packetOffset = 0u;
+    echo->replyLength = 0u;
+    Cobs_DecoderInit(&echo->decoder);
+    Cobs_EncodeStart(&echo->encoder, echo->reply, sizeof(echo->reply));
+}
+
+
+/*******************************************************************************
+* Function Name: FrameEcho_Service
+********************************************************************************
+*
+* Summary:
+*  Decodes the data from the host and writes each complete frame back to the
+*  transmit ring of the port, as long as the ring has room for the reply.
+*  The port must be the active COM port.
+*
+* Parameters:
+*  port: COM port.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void FrameEcho_Service(uint8 port)
+{
+    FRAME_ECHO *echo = &frameEcho[port];
+    COBS_SPAN span;
+
+    for (;;)
+    {
+        if (0u != echo->replyLength)
+        {
+            if (TxRing_Free(port) < echo->replyLength)
+            {
+                break;
+            }
+
+            (void) TxRing_Write(port, echo->reply, echo->replyLength);
+            echo->replyLength = 0u;
+            Cobs_EncodeStart(&echo->encoder, echo->reply, sizeof(echo->reply));
+        }
+
+        if (echo->packetOffset == echo->packetLength)
+        {
+            if (0u == USBUART_DataIsReady())
+            {
+                break;
+            }
+
+            /* Read received data and re-enable OUT endpoint. */
+            echo->packetLength = USBUART_GetAll(echo->packet);
+            echo->packetOffset = 0u;
+        }
+        else
+        {
+            echo->packetOffset += Cobs_Decode(&echo->decoder, &echo->packet[echo->packetOffset],
+                                              echo->packetLength - echo->packetOffset, &span);
+            Cobs_EncodeWrite(&echo->encoder, span.pData, span.length);
+
+            if (COBS_FRAME_END == span.end)
+            {
+                echo->replyLength = Cobs_EncodeEnd(&echo->encoder);
+
+                if (0u != echo->replyLength)
+                {
+                    ++frameEchoFrames[port];
+                }
+            }
+
+            if ((COBS_FRAME_ERROR == span.end) ||
+                ((COBS_FRAME_END == span.end) && (0u == echo->replyLength)))
+            {
+                ++frameEchoDropped[port];
+                Cobs_EncodeStart(&echo->encoder, echo->reply, sizeof(echo->reply));
+            }
+        }
+    }
+}
+
+#endif /* (FRAME_ECHO_ENABLE) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/*******************************************************************************
+* File Name: frame_echo.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants and function prototypes of the frame echo of
+*  the USBFS UART example project.
+*
+*  With FRAME_ECHO_ENABLE set, each COM port carries COBS frames (cobs.h)
+*  instead of a plain byte stream: the device decodes every frame the host
+*  sends, encodes it again and sends it back as a frame. A frame may span any
+*  number of packets and a packet may hold any number of frames. Frames of
+*  more than FRAME_ECHO_MAX_PAYLOAD bytes and frames cut short by a lost byte
+*  are dropped and counted. host/cobs_host.c is the host side of the framing.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(FRAME_ECHO_H)
+#define FRAME_ECHO_H
+
+#include <project.h>
+#include "cobs.h"
+#include "tx_ring.h"
+#include "uart_bridge.h"
+
+/* Set to 1u in the compiler preprocessor definitions to build the echo. */
+#if !defined(FRAME_ECHO_ENABLE)
+    #define FRAME_ECHO_ENABLE       (0u)
+#endif /* !defined(FRAME_ECHO_ENABLE) */
+
+#if (FRAME_ECHO_ENABLE)
+
+#if (UART_BRIDGE_ENABLE)
+    #error The frame echo and the USB-UART bridge cannot be built together.
+#endif /* (UART_BRIDGE_ENABLE) */
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* Largest frame echoed. Encoded, a reply must fit the transmit ring. */
+#define FRAME_ECHO_MAX_PAYLOAD  (250u)
+
+#if (COBS_ENCODED_SIZE(FRAME_ECHO_MAX_PAYLOAD) > TX_RING_SIZE)
+    #error An encoded frame of FRAME_ECHO_MAX_PAYLOAD bytes must fit the transmit ring.
+#endif /* (COBS_ENCODED_SIZE(FRAME_ECHO_MAX_PAYLOAD) > TX_RING_SIZE) */
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void FrameEcho_Init(uint8 port);
+void FrameEcho_Service(uint8 port);
+
+/* Frames echoed, and frames dropped because they were cut short or too long. */
+extern uint32 frameEchoFrames[TX_RING_PORTS];
+extern uint32 frameEchoDropped[TX_RING_PORTS];
+
+#endif /* (FRAME_ECHO_ENABLE) */
+
+#endif /* (FRAME_ECHO_H) */
+
+
+/* [] END OF FILE */
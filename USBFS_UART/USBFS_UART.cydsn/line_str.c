@@ -0,0 +1,256 @@
+/*******************************************************************************
+* File Name: line_str.c
+*
+* Version: 1.0
+*
+* Description:
+*  Line status formatter of the USBFS UART example project. The LCD is on the
+*  PSoC 3 and PSoC 5LP kits only. Integers are converted by subtracting powers
+*  of ten instead of dividing by ten: the 8051 of PSoC 3 divides only 8-bit
+*  operands, so each 32-bit division would be a call to the library routine.
+*  The Cortex-M3 of PSoC 5LP has a divide instruction, but one conversion
+*  serves both devices. The formatter keeps no state.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "line_str.h"
+
+/* Powers of ten of the digits of a uint32 but the last. */
+static const uint32 lineStrPow10[LINE_STR_UINT32_DIGITS - 1u] =
+{
+    1000000000u, 100000000u, 10000000u, 1000000u, 100000u, 10000u, 1000u, 100u, 10u
+};
+
+/* First letter of the parity types: None, Odd, Even, Mark, Space. */
+static const char8 lineStrParity[] = "NOEMS";
+
+/* Stop bits of the character formats. */
+static const char8 * const lineStrStop[] = {"1", "1.5", "2"};
+
+#define LINE_STR_PARITY_TYPES   (sizeof(lineStrParity) - 1u)
+#define LINE_STR_CHAR_FORMATS   (sizeof(lineStrStop) / sizeof(lineStrStop[0u]))
+
+
+/*******************************************************************************
+* Function Name: LineStr_AddChar
+********************************************************************************
+*
+* Summary:
+*  Adds a character to a line, unless the line is full.
+*
+* Parameters:
+*  str: line buffer of LINE_STR_SIZE bytes.
+*  pos: position of the character.
+*  character: character to add.
+*
+* Return:
+*  Position after the character.
+*
+*******************************************************************************/
+uint8 LineStr_AddChar(char8 str[], uint8 pos, char8 character)
+{
+    if (pos < LINE_STR_LENGTH)
+    {
+        str[pos] = character;
+        ++pos;
+    }
+
+    return (pos);
+}
+
+
+/*******************************************************************************
+* Function Name: LineStr_AddString
+********************************************************************************
+*
+* Summary:
+*  Adds a zero-terminated string to a line, up to the end of the line.
+*
+* Parameters:
+*  str: line buffer of LINE_STR_SIZE bytes.
+*  pos: position of the first character.
+*  text: string to add.
+*
+* Return:
+*  Position after the string.
+*
+*******************************************************************************/
+uint8 LineStr_AddString(char8 str[], uint8 pos, const char8 text[])
+{
+    uint8 i = 0u;
+
+    while ((0 != text[i]) && (pos < LINE_STR_LENGTH))
+    {
+        str[pos] = text[i];
+        ++pos;
+        ++i;
+    }
+
+    return (pos);
+}
+
+
+/*******************************************************************************
+* Function Name: LineStr_AddUint
+********************************************************************************
+*
+* Summary:
+*  Adds an unsigned integer in decimal to a line, right-aligned in a field of
+*  at least width characters padded with spaces, as "%*lu" does.
+*
+* Parameters:
+*  str: line buffer of LINE_STR_SIZE bytes.
+*  pos: position of the field.
+*  value: integer to add.
+*  width: minimum width of the field.
+*
+* Return:
+*  Position after the field.
+*
+*******************************************************************************/
+uint8 LineStr_AddUint(char8 str[], uint8 pos, uint32 value, uint8 width)
+{
+    char8 digits[LINE_STR_UINT32_DIGITS];
+    uint8 count = 0u;
+    uint8 digit;
+    uint8 i;
+
+    /* Each digit is the number of times its power of ten fits: at most nine
+    * subtractions. Leading zeros are skipped.
+    */
+    for (i = 0u; i < (LINE_STR_UINT32_DIGITS - 1u); ++i)
+    {
+        digit = 0u;
+
+        while (value >= lineStrPow10[i])
+        {
+            value -= lineStrPow10[i];
+            ++digit;
+        }
+
+        if ((0u != digit) || (0u != count))
+        {
+            digits[count] = (char8) ('0' + digit);
+            ++count;
+        }
+    }
+
+    /* Last digit, also for zero. */
+    digits[count] = (char8) ('0' + (uint8) value);
+    ++count;
+
+    while (width > count)
+    {
+        pos = LineStr_AddChar(str, pos, ' ');
+        --width;
+    }
+
+    for (i = 0u; i < count; ++i)
+    {
+        pos = LineStr_AddChar(str, pos, digits[i]);
+    }
+
+    return (pos);
+}
+
+
+/*******************************************************************************
+* Function Name: LineStr_End
+********************************************************************************
+*
+* Summary:
+*  Pads a line with spaces to LINE_STR_LENGTH characters and terminates it.
+*
+* Parameters:
+*  str: line buffer of LINE_STR_SIZE bytes.
+*  pos: position after the last field.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LineStr_End(char8 str[], uint8 pos)
+{
+    while (pos < LINE_STR_LENGTH)
+    {
+        str[pos] = ' ';
+        ++pos;
+    }
+
+    str[LINE_STR_LENGTH] = 0;
+}
+
+
+/*******************************************************************************
+* Function Name: LineStr_Coding
+********************************************************************************
+*
+* Summary:
+*  Formats the line coding as "BR:115200 8N1": the baud rate in a field of
+*  four, the data bits, the first letter of the parity type and the stop
+*  bits. A parity type or character format out of range shows as "?".
+*
+* Parameters:
+*  str: line buffer of LINE_STR_SIZE bytes.
+*  rate: baud rate.
+*  dataBits: data bits.
+*  parityType: parity type, USBUART_GetParityType().
+*  charFormat: character format, USBUART_GetCharFormat().
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LineStr_Coding(char8 str[], uint32 rate, uint8 dataBits, uint8 parityType, uint8 charFormat)
+{
+    uint8 pos;
+
+    pos = LineStr_AddString(str, 0u, "BR:");
+    pos = LineStr_AddUint(str, pos, rate, 4u);
+    pos = LineStr_AddChar(str, pos, ' ');
+    pos = LineStr_AddUint(str, pos, dataBits, 0u);
+    pos = LineStr_AddChar(str, pos,
+                          (parityType < LINE_STR_PARITY_TYPES) ? lineStrParity[parityType] : '?');
+    pos = LineStr_AddString(str, pos,
+                            (charFormat < LINE_STR_CHAR_FORMATS) ? lineStrStop[charFormat] : "?");
+    LineStr_End(str, pos);
+}
+
+
+/*******************************************************************************
+* Function Name: LineStr_Control
+********************************************************************************
+*
+* Summary:
+*  Formats the line control as "DTR:ON,RTS:OFF".
+*
+* Parameters:
+*  str: line buffer of LINE_STR_SIZE bytes.
+*  lineControl: control line state, USBUART_GetLineControl().
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LineStr_Control(char8 str[], uint8 lineControl)
+{
+    uint8 pos;
+
+    pos = LineStr_AddString(str, 0u, "DTR:");
+    pos = LineStr_AddString(str, pos, (0u != (lineControl & USBUART_LINE_CONTROL_DTR)) ? "ON" : "OFF");
+    pos = LineStr_AddString(str, pos, ",RTS:");
+    pos = LineStr_AddString(str, pos, (0u != (lineControl & USBUART_LINE_CONTROL_RTS)) ? "ON" : "OFF");
+    LineStr_End(str, pos);
+}
+
+
+/* [] END OF FILE */
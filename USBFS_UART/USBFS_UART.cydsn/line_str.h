@@ -0,0 +1,65 @@
+/*******************************************************************************
+* File Name: line_str.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants and function prototypes of the line status
+*  formatter of the USBFS UART example project.
+*
+*  The formatter builds the LCD lines that show the line coding and the line
+*  control settings without sprintf(), so the example links neither the
+*  printf library nor its floating point support. A line is built field by
+*  field into a caller buffer of LINE_STR_SIZE bytes: strings, characters and
+*  unsigned integers right-aligned in a field of spaces. Fields that do not
+*  fit are cut at LINE_STR_LENGTH characters, so no input can write past the
+*  buffer. LineStr_End() pads the line with spaces to the full LCD width,
+*  which also clears what the previous line left on the display.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(LINE_STR_H)
+#define LINE_STR_H
+
+#include <project.h>
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* Characters in a line: the width of the LCD. */
+#define LINE_STR_LENGTH         (20u)
+
+/* Size of a line buffer: the characters and the terminating zero. */
+#define LINE_STR_SIZE           (LINE_STR_LENGTH + 1u)
+
+/* Digits of the largest uint32. */
+#define LINE_STR_UINT32_DIGITS  (10u)
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+uint8 LineStr_AddString(char8 str[], uint8 pos, const char8 text[]);
+uint8 LineStr_AddChar(char8 str[], uint8 pos, char8 character);
+uint8 LineStr_AddUint(char8 str[], uint8 pos, uint32 value, uint8 width);
+void  LineStr_End(char8 str[], uint8 pos);
+
+void  LineStr_Coding(char8 str[], uint32 rate, uint8 dataBits, uint8 parityType, uint8 charFormat);
+void  LineStr_Control(char8 str[], uint8 lineControl);
+
+#endif /* (LINE_STR_H) */
+
+
+/* [] END OF FILE */
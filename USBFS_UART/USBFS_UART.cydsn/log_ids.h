@@ -0,0 +1,69 @@
+/*******************************************************************************
+* File Name: log_ids.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides the string table of the binary log of the USBFS UART
+*  example project: one entry per log message, with its ID name and its
+*  format string. The firmware only uses the IDs; the strings never reach the
+*  device. The host decoder (host/log_decode.c) includes this file to render
+*  the records, so a message is added or changed here only.
+*
+*  The arguments are 32-bit words: use %u, %x or %d in the format strings, at
+*  most LOG_MAX_ARGS of them. Add new messages at the end so that the IDs of
+*  logs already captured stay valid.
+*
+*  A record is a header word and its arguments, little-endian 32-bit words.
+*  The header holds a marker that lets the decoder check the record framing,
+*  the argument count, a sequence number that counts every record written
+*  or dropped, and the message ID.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(LOG_IDS_H)
+#define LOG_IDS_H
+
+/* Record header: marker, argument count, sequence number and ID. */
+#define LOG_MAX_ARGS            (3u)
+#define LOG_HEADER_MARK         (0xA0000000u)
+#define LOG_HEADER_MARK_MASK    (0xF0000000u)
+#define LOG_HEADER_ARGC_SHIFT   (26u)
+#define LOG_HEADER_ARGC_MASK    (0x0C000000u)
+#define LOG_HEADER_SEQ_SHIFT    (16u)
+#define LOG_HEADER_SEQ_MASK     (0x00FF0000u)
+#define LOG_HEADER_ID_MASK      (0x0000FFFFu)
+
+#define LOG_HEADER(id, argc)    (LOG_HEADER_MARK | ((uint32) (argc) << LOG_HEADER_ARGC_SHIFT) | \
+                                 (uint32) (id))
+
+/* Messages: ID and format string. */
+#define LOG_MESSAGES(X) \
+    X(LOG_ID_START,         "log started, ring of %u words") \
+    X(LOG_ID_BUS_RESET,     "bus reset") \
+    X(LOG_ID_CONFIGURED,    "configuration %u") \
+    X(LOG_ID_CONTROL_LINES, "port %u: control lines 0x%x") \
+    X(LOG_ID_EP_ISR,        "EP%u interrupt") \
+    X(LOG_ID_OUT_PACKET,    "port %u: OUT packet of %u bytes, ring %u bytes free")
+
+#define LOG_ENUM_ENTRY(id, format)  id,
+
+typedef enum
+{
+    LOG_MESSAGES(LOG_ENUM_ENTRY)
+    LOG_ID_COUNT
+} LOG_ID;
+
+#endif /* (LOG_IDS_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,218 @@
+/*******************************************************************************
+* File Name: log_ring.c
+*
+* Version: 1.0
+*
+* Description:
+*  Binary log of the USBFS UART example project. The head and tail are
+*  free-running 16-bit word counters. The producers, the main loop and any
+*  interrupt, share the head: LogRing_Write() stores a record and moves the
+*  head with interrupts disabled, which on the Cortex-M0 (no exclusive
+*  load/store) is the cheapest way to serialize them, and takes a few
+*  instructions. The main loop is the only consumer and the only writer of
+*  the tail. As it never runs while an interrupt is active, every record it
+*  finds in the ring is complete.
+*
+*  A write always stores LOG_MAX_ARGS argument words, also past the end of a
+*  shorter record, where the ring is free: the record length only moves the
+*  head, so the write path has no branch per argument.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "log_ring.h"
+
+#if (LOG_ENABLE)
+
+/* Words a write may store: the header and all arguments. */
+#define LOG_RECORD_MAX_WORDS    (1u + LOG_MAX_ARGS)
+
+static uint32 logRing[LOG_RING_WORDS];
+
+static volatile uint16 logRingHead;     /* Words written. */
+static volatile uint16 logRingTail;     /* Words moved to the transmit ring. */
+static uint8 logRingSeq;                /* Sequence number of the next record. */
+static uint8 logRingOpen;               /* The host has raised DTR. */
+
+
+/*******************************************************************************
+* Function Name: LogRing_Start
+********************************************************************************
+*
+* Summary:
+*  Empties the log. Call before interrupts are enabled.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LogRing_Start(void)
+{
+    logRingHead = 0u;
+    logRingTail = 0u;
+    logRingSeq = 0u;
+    logRingOpen = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: LogRing_Write
+********************************************************************************
+*
+* Summary:
+*  Writes a record, or drops it when the ring is full. Use the LOG0() to
+*  LOG3() macros, which build the header. May be called from any interrupt
+*  and from the main loop.
+*
+* Parameters:
+*  header: LOG_HEADER() of the message ID and the argument count.
+*  arg0, arg1, arg2: arguments; those past the count are not sent.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LogRing_Write(uint32 header, uint32 arg0, uint32 arg1, uint32 arg2)
+{
+    uint16 head;
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    head = logRingHead;
+
+    if ((uint16) (head - logRingTail) <= (LOG_RING_WORDS - LOG_RECORD_MAX_WORDS))
+    {
+        logRing[head & LOG_RING_MASK] = header | ((uint32) logRingSeq << LOG_HEADER_SEQ_SHIFT);
+        logRing[(head + 1u) & LOG_RING_MASK] = arg0;
+        logRing[(head + 2u) & LOG_RING_MASK] = arg1;
+        logRing[(head + 3u) & LOG_RING_MASK] = arg2;
+        logRingHead = head + 1u + (uint16) ((header & LOG_HEADER_ARGC_MASK) >> LOG_HEADER_ARGC_SHIFT);
+    }
+
+    ++logRingSeq;
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: LogRing_SetOpen
+********************************************************************************
+*
+* Summary:
+*  Follows DTR of the log port. When the host opens the port, drops the
+*  records not sent and the data left in the transmit ring of the port, so
+*  that the stream starts with a whole record, and writes a LOG_ID_START
+*  record. While the port is closed, the records stay in the ring.
+*
+* Parameters:
+*  open: DTR of the log port.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LogRing_SetOpen(uint8 open)
+{
+    uint8 interruptState;
+
+    if ((0u != open) && (0u == logRingOpen))
+    {
+        interruptState = CyEnterCriticalSection();
+        logRingTail = logRingHead;
+        CyExitCriticalSection(interruptState);
+
+        TxRing_Init(LOG_COM_PORT);
+        LOG1(LOG_ID_START, LOG_RING_WORDS);
+    }
+
+    logRingOpen = open;
+}
+
+
+/*******************************************************************************
+* Function Name: LogRing_Service
+********************************************************************************
+*
+* Summary:
+*  Moves as many words as the transmit ring of the log port takes, while the
+*  port is open. The ring packs them into full packets. LOG_COM_PORT must be
+*  the active COM port; TxRing_Service() sends the data.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LogRing_Service(void)
+{
+    uint16 tail = logRingTail;
+    uint16 count;
+    uint16 free;
+    uint16 first;
+
+    if (0u != logRingOpen)
+    {
+        count = (uint16) (logRingHead - tail);
+        free = TxRing_Free(LOG_COM_PORT) / LOG_WORD_SIZE;
+        count = (count < free) ? count : free;
+
+        if (0u != count)
+        {
+            /* Up to the end of the ring, then from its start. */
+            first = (uint16) (LOG_RING_WORDS - (tail & LOG_RING_MASK));
+            first = (count < first) ? count : first;
+
+            (void) TxRing_Write(LOG_COM_PORT, (const uint8 *) &logRing[tail & LOG_RING_MASK],
+                                first * LOG_WORD_SIZE);
+            if (count > first)
+            {
+                (void) TxRing_Write(LOG_COM_PORT, (const uint8 *) &logRing[0u],
+                                    (count - first) * LOG_WORD_SIZE);
+            }
+
+            logRingTail = tail + count;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LogRing_Pending
+********************************************************************************
+*
+* Summary:
+*  Returns non-zero when records wait to be sent and the transmit ring of the
+*  log port has room for them: the main loop must not sleep.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero when LogRing_Service() has work to do.
+*
+*******************************************************************************/
+uint8 LogRing_Pending(void)
+{
+    return (((0u != logRingOpen) && (logRingHead != logRingTail) &&
+             (TxRing_Free(LOG_COM_PORT) >= LOG_WORD_SIZE)) ? 1u : 0u);
+}
+
+#endif /* (LOG_ENABLE) */
+
+
+/* [] END OF FILE */
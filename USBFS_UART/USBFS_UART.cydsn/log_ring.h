@@ -0,0 +1,107 @@
+/*******************************************************************************
+* File Name: log_ring.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants, macros and function prototypes of the binary
+*  log of the USBFS UART example project.
+*
+*  With LOG_ENABLE set, the LOG0() to LOG3() macros write a record of a message
+*  ID (log_ids.h) and up to three 32-bit arguments into the log ring. They may
+*  be used in interrupts, including the USBUART callbacks, and in the main
+*  loop. Nothing is formatted on the device: a call stores a few words with
+*  interrupts disabled and returns. When the ring is full, the record is
+*  dropped; its sequence number shows the gap to the decoder.
+*
+*  The log is sent on COM port LOG_COM_PORT, which needs TX_RING_PORTS set to
+*  2. When the host raises DTR on that port, the records written before are
+*  dropped and the stream starts with a LOG_ID_START record; the main loop
+*  then moves the records to the transmit ring of the port, which sends them
+*  in full packets. host/log_decode.c renders the stream. Without LOG_ENABLE
+*  the macros compile to nothing.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(LOG_RING_H)
+#define LOG_RING_H
+
+#include <project.h>
+#include "log_ids.h"
+#include "tx_ring.h"
+
+/* Set to 1u in the compiler preprocessor definitions to build the log. */
+#if !defined(LOG_ENABLE)
+    #define LOG_ENABLE              (0u)
+#endif /* !defined(LOG_ENABLE) */
+
+#if (LOG_ENABLE)
+
+#if (2u != TX_RING_PORTS)
+    #error The log needs its own COM port: set TX_RING_PORTS to 2.
+#endif /* (2u != TX_RING_PORTS) */
+
+#if (CY_PSOC3)
+    #error The log records are little-endian words: PSoC 4 and PSoC 5LP only.
+#endif /* (CY_PSOC3) */
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* COM port that sends the log. */
+#define LOG_COM_PORT            (1u)
+
+/* Ring size in 32-bit words: a power of two. */
+#if !defined(LOG_RING_WORDS)
+    #define LOG_RING_WORDS          (256u)
+#endif /* !defined(LOG_RING_WORDS) */
+
+#define LOG_RING_MASK           (LOG_RING_WORDS - 1u)
+#define LOG_WORD_SIZE           (4u)
+
+
+/***************************************
+*    Macros
+****************************************/
+
+#define LOG0(id)                LogRing_Write(LOG_HEADER((id), 0u), 0u, 0u, 0u)
+#define LOG1(id, a)             LogRing_Write(LOG_HEADER((id), 1u), (uint32) (a), 0u, 0u)
+#define LOG2(id, a, b)          LogRing_Write(LOG_HEADER((id), 2u), (uint32) (a), (uint32) (b), 0u)
+#define LOG3(id, a, b, c)       LogRing_Write(LOG_HEADER((id), 3u), (uint32) (a), (uint32) (b), \
+                                              (uint32) (c))
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void  LogRing_Start(void);
+void  LogRing_Write(uint32 header, uint32 arg0, uint32 arg1, uint32 arg2);
+void  LogRing_SetOpen(uint8 open);
+void  LogRing_Service(void);
+uint8 LogRing_Pending(void);
+
+#else
+
+#define LOG0(id)
+#define LOG1(id, a)
+#define LOG2(id, a, b)
+#define LOG3(id, a, b, c)
+
+#endif /* (LOG_ENABLE) */
+
+#endif /* (LOG_RING_H) */
+
+
+/* [] END OF FILE */
@@ -5,8 +5,12 @@
 *
 * Description:
 *   The component is enumerated as a Virtual Com port. Receives data from the 
-*   hyper terminal, then sends back the received data.
+*   hyper terminal, then sends back the received data through a transmit
+*   ring that never waits for the host.
 *   For PSoC3/PSoC5LP, the LCD shows the line settings.
+*   With LOG_ENABLE set, the second COM port sends a binary log of the USB
+*   events (log_ring.h). With FRAME_ECHO_ENABLE set, the COM ports echo COBS
+*   frames instead of bytes (frame_echo.h).
 *
 * Related Document:
 *  Universal Serial Bus Specification Revision 2.0
@@ -25,14 +29,12 @@
 *******************************************************************************/
 
 #include <project.h>
-#include "stdio.h"
-
-#if defined (__GNUC__)
-    /* Add an explicit reference to the floating point printf library */
-    /* to allow usage of the floating point conversion specifiers. */
-    /* This is not linked in by default with the newlib-nano library. */
-    asm (".global _printf_float");
-#endif
+#include "frame_echo.h"
+#include "line_str.h"
+#include "log_ring.h"
+#include "serial_state.h"
+#include "tx_ring.h"
+#include "uart_bridge.h"
 
 #define USBFS_DEVICE    (0u)
 
@@ -40,10 +42,19 @@
 * endpoints.
 */
 #define USBUART_BUFFER_SIZE (64u)
-#define LINE_STR_LENGTH     (20u)
 
-char8* parity[] = {"None", "Odd", "Even", "Mark", "Space"};
-char8* stop[]   = {"1", "1.5", "2"};
+/* Events posted by the USBUART interrupt callbacks: the host has completed a
+* transfer on an endpoint, or the configuration or line settings may have
+* changed.
+*/
+volatile uint8 epEvent = 0u;
+volatile uint8 configEvent = 0u;
+
+void WaitForUsbEvent(void);
+
+#if (!UART_BRIDGE_ENABLE)
+    void EchoPort(uint8 port);
+#endif /* (!UART_BRIDGE_ENABLE) */
 
 
 /*******************************************************************************
@@ -55,8 +66,25 @@ char8* stop[]   = {"1", "1.5", "2"};
 *   1. Waits until VBUS becomes valid and starts the USBFS component which is
 *      enumerated as virtual Com port.
 *   2. Waits until the device is enumerated by the host.
-*   3. Waits for data coming from the hyper terminal and sends it back.
-*   4. PSoC3/PSoC5LP: the LCD shows the line settings.
+*   3. Waits for data coming from the hyper terminal and sends it back, or
+*      with UART_BRIDGE_ENABLE set, bridges it to the UART and applies the
+*      line settings to the UART. With TX_RING_PORTS set to 2, the device
+*      has two COM ports, each echoing its own data; a round-robin pass
+*      services every port once, so a busy port cannot starve the other.
+*      With LOG_ENABLE set, the second port sends the log instead. With
+*      FRAME_ECHO_ENABLE set, the ports echo frames instead of bytes.
+*   4. Reports the serial state of every port on its notification endpoint
+*      when it changes. The example has no modem status inputs: DCD and DSR
+*      follow DTR, as with a loopback plug; the bridge also reports the UART
+*      receive errors.
+*   5. PSoC3/PSoC5LP: the LCD shows the line settings of the first port.
+*   6. Sleeps between USB events: the interrupt callbacks post an event and
+*      the CPU waits in WFI while there is no work to do. The loop does not
+*      block on the IN endpoint: received data is copied into the transmit
+*      ring of the port, which packs it into full packets and sends them when
+*      the IN endpoint is ready. Data is read from the OUT endpoint as long as
+*      the ring has room for a packet. A packet that is not full waits up to
+*      TX_RING_FLUSH_TIMEOUT_US for more data.
 *
 * Parameters:
 *  None.
@@ -67,16 +95,36 @@ char8* stop[]   = {"1", "1.5", "2"};
 *******************************************************************************/
 int main()
 {
+    uint8 configured = 0u;  /* Device is configured by host. */
+    uint8 port;
+    uint8 dtr;
+
+#if (UART_BRIDGE_ENABLE)
     uint16 count;
     uint8 buffer[USBUART_BUFFER_SIZE];
-    
+    uint8 state;
+    uint8 interruptState;
+#else
+    uint8 firstPort = 0u;   /* Port served first in the next pass. */
+#endif /* (UART_BRIDGE_ENABLE) */
+
 #if (CY_PSOC3 || CY_PSOC5LP)
     uint8 state;
-    char8 lineStr[LINE_STR_LENGTH];
+    char8 lineStr[LINE_STR_SIZE];
     
     LCD_Start();
 #endif /* (CY_PSOC3 || CY_PSOC5LP) */
     
+    TxRing_Start();
+
+#if (LOG_ENABLE)
+    LogRing_Start();
+#endif /* (LOG_ENABLE) */
+
+#if (UART_BRIDGE_ENABLE)
+    UartBridge_Start();
+#endif /* (UART_BRIDGE_ENABLE) */
+
     CyGlobalIntEnable;
 
     /* Start USBFS operation with 5-V operation. */
@@ -84,73 +132,137 @@ int main()
     
     for(;;)
     {
-        /* Host can send double SET_INTERFACE request. */
-        if (0u != USBUART_IsConfigurationChanged())
+        /* Configuration can change only in the control endpoint or bus reset
+        * interrupt.
+        */
+        if (0u != configEvent)
         {
-            /* Initialize IN endpoints when device is configured. */
-            if (0u != USBUART_GetConfiguration())
+            configEvent = 0u;
+
+            /* Host can send double SET_INTERFACE request. */
+            if (0u != USBUART_IsConfigurationChanged())
+            {
+                /* Initialize IN endpoints when device is configured. */
+                if (0u != USBUART_GetConfiguration())
+                {
+                    /* Enumeration is done, enable OUT endpoint to receive data 
+                     * from host. */
+                    USBUART_CDC_Init();
+                    LOG1(LOG_ID_CONFIGURED, USBUART_GetConfiguration());
+
+                    /* Data not sent yet is lost. */
+                    for (port = 0u; port < TX_RING_PORTS; ++port)
+                    {
+                    #if (UART_BRIDGE_ENABLE)
+                        /* The UART interrupt writes to the ring. */
+                        interruptState = CyEnterCriticalSection();
+                        TxRing_Init(port);
+                        CyExitCriticalSection(interruptState);
+                    #else
+                        TxRing_Init(port);
+                    #endif /* (UART_BRIDGE_ENABLE) */
+
+                        SerialState_Init(port);
+
+                    #if (FRAME_ECHO_ENABLE)
+                        FrameEcho_Init(port);
+                    #endif /* (FRAME_ECHO_ENABLE) */
+                    }
+                }
+            }
+
+            configured = USBUART_GetConfiguration();
+
+            /* DCD and DSR follow DTR, and the log is sent while DTR of the
+            * log port is set. The control lines change only in the control
+            * endpoint interrupt.
+            */
+            if (0u != configured)
             {
-                /* Enumeration is done, enable OUT endpoint to receive data 
-                 * from host. */
-                USBUART_CDC_Init();
+                for (port = 0u; port < TX_RING_PORTS; ++port)
+                {
+                    (void) USBUART_SetComPort(port);
+                    dtr = (0u != (USBUART_GetLineControl() & USBUART_LINE_CONTROL_DTR)) ? 1u : 0u;
+                    LOG2(LOG_ID_CONTROL_LINES, port, USBUART_GetLineControl());
+
+                    SerialState_SetLevels(port,
+                        (0u != dtr) ? (SERIAL_STATE_DCD | SERIAL_STATE_DSR) : 0u);
+
+                #if (LOG_ENABLE)
+                    if (LOG_COM_PORT == port)
+                    {
+                        LogRing_SetOpen(dtr);
+                    }
+                #endif /* (LOG_ENABLE) */
+                }
             }
+
+        #if (UART_BRIDGE_ENABLE)
+            /* Apply the line settings to the UART. They change only in the
+            * control endpoint interrupt.
+            */
+            state = (0u != configured) ? USBUART_IsLineChanged() : 0u;
+            if (0u != (state & USBUART_LINE_CODING_CHANGED))
+            {
+                UartBridge_SetLineCoding(USBUART_GetDTERate(), USBUART_GetDataBits(),
+                                         USBUART_GetParityType(), USBUART_GetCharFormat());
+            }
+
+            if (0u != (state & USBUART_LINE_CONTROL_CHANGED))
+            {
+                UartBridge_SetLineControl((uint8) USBUART_GetLineControl());
+            }
+        #endif /* (UART_BRIDGE_ENABLE) */
         }
 
         /* Service USB CDC when device is configured. */
-        if (0u != USBUART_GetConfiguration())
+        if (0u != configured)
         {
-            /* Check for input data from host. */
-            if (0u != USBUART_DataIsReady())
+        #if (UART_BRIDGE_ENABLE)
+            /* Check for input data from host when the bridge ring has room
+            * for a packet.
+            */
+            if ((UartBridge_Free() >= USBUART_BUFFER_SIZE) && (0u != USBUART_DataIsReady()))
             {
                 /* Read received data and re-enable OUT endpoint. */
                 count = USBUART_GetAll(buffer);
+                (void) UartBridge_Write(buffer, count);
+            }
 
-                if (0u != count)
-                {
-                    /* Wait until component is ready to send data to host. */
-                    while (0u == USBUART_CDCIsReady())
-                    {
-                    }
-
-                    /* Send data back to host. */
-                    USBUART_PutData(buffer, count);
+            /* Restart the receiver if it waits for room in the ring. */
+            UartBridge_Service();
 
-                    /* If the last sent packet is exactly the maximum packet 
-                    *  size, it is followed by a zero-length packet to assure
-                    *  that the end of the segment is properly identified by 
-                    *  the terminal.
-                    */
-                    if (USBUART_BUFFER_SIZE == count)
-                    {
-                        /* Wait until component is ready to send data to PC. */
-                        while (0u == USBUART_CDCIsReady())
-                        {
-                        }
+            /* Send the data received by the UART to the host. */
+            TxRing_Service(UART_BRIDGE_COM_PORT);
 
-                        /* Send zero-length packet to PC. */
-                        USBUART_PutData(NULL, 0u);
-                    }
-                }
+            /* Report the line state and the UART receive errors. */
+            SerialState_Service(UART_BRIDGE_COM_PORT);
+        #else
+            /* Round robin: one pass gives every port one OUT and one IN
+            * packet, starting one port later than the previous pass.
+            */
+            for (port = 0u; port < TX_RING_PORTS; ++port)
+            {
+                EchoPort((uint8) ((firstPort + port) % TX_RING_PORTS));
             }
 
+            firstPort = (uint8) ((firstPort + 1u) % TX_RING_PORTS);
+        #endif /* (UART_BRIDGE_ENABLE) */
 
         #if (CY_PSOC3 || CY_PSOC5LP)
-            /* Check for Line settings change. */
+            /* Check for Line settings change of the first port. */
+            (void) USBUART_SetComPort(0u);
             state = USBUART_IsLineChanged();
             if (0u != state)
             {
                 /* Output on LCD Line Coding settings. */
                 if (0u != (state & USBUART_LINE_CODING_CHANGED))
-                {                  
-                    /* Get string to output. */
-                    sprintf(lineStr,"BR:%4ld %d%c%s", USBUART_GetDTERate(),\
-                                   (uint16) USBUART_GetDataBits(),\
-                                   parity[(uint16) USBUART_GetParityType()][0],\
-                                   stop[(uint16) USBUART_GetCharFormat()]);
-
-                    /* Clear LCD line. */
-                    LCD_Position(0u, 0u);
-                    LCD_PrintString("                    ");
+                {
+                    /* Get string to output: padded to the LCD width, it
+                    * overwrites the previous settings.
+                    */
+                    LineStr_Coding(lineStr, USBUART_GetDTERate(), USBUART_GetDataBits(),
+                                   USBUART_GetParityType(), USBUART_GetCharFormat());
 
                     /* Output string on LCD. */
                     LCD_Position(0u, 0u);
@@ -159,15 +271,9 @@ int main()
 
                 /* Output on LCD Line Control settings. */
                 if (0u != (state & USBUART_LINE_CONTROL_CHANGED))
-                {                   
+                {
                     /* Get string to output. */
-                    state = USBUART_GetLineControl();
-                    sprintf(lineStr,"DTR:%s,RTS:%s",  (0u != (state & USBUART_LINE_CONTROL_DTR)) ? "ON" : "OFF",
-                                                      (0u != (state & USBUART_LINE_CONTROL_RTS)) ? "ON" : "OFF");
-
-                    /* Clear LCD line. */
-                    LCD_Position(1u, 0u);
-                    LCD_PrintString("                    ");
+                    LineStr_Control(lineStr, USBUART_GetLineControl());
 
                     /* Output string on LCD. */
                     LCD_Position(1u, 0u);
@@ -176,8 +282,295 @@ int main()
             }
         #endif /* (CY_PSOC3 || CY_PSOC5LP) */
         }
+
+        /* Sleep until the next USB event. */
+        WaitForUsbEvent();
     }
 }
 
 
+#if (!UART_BRIDGE_ENABLE)
+
+/*******************************************************************************
+* Function Name: EchoPort
+********************************************************************************
+*
+* Summary:
+*  Services one COM port: reads a packet from the OUT endpoint into the
+*  transmit ring of the port when the ring has room for it, and sends the
+*  ring to the host when the IN endpoint is ready. Sends a notification when
+*  the serial state of the port has changed. With FRAME_ECHO_ENABLE set, the
+*  frame echo reads the OUT endpoint instead. The log port moves the log to
+*  its transmit ring instead and leaves the data from the host in the OUT
+*  endpoint.
+*
+* Parameters:
+*  port: COM port.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void EchoPort(uint8 port)
+{
+#if (!FRAME_ECHO_ENABLE)
+    uint16 count;
+    uint8 buffer[USBUART_BUFFER_SIZE];
+#endif /* (!FRAME_ECHO_ENABLE) */
+
+    (void) USBUART_SetComPort(port);
+
+#if (LOG_ENABLE)
+    if (LOG_COM_PORT == port)
+    {
+        LogRing_Service();
+    }
+    else
+#endif /* (LOG_ENABLE) */
+
+#if (FRAME_ECHO_ENABLE)
+    {
+        FrameEcho_Service(port);
+    }
+#else
+    /* Check for input data from host when the ring has room for a packet. */
+    if ((TxRing_Free(port) >= USBUART_BUFFER_SIZE) && (0u != USBUART_DataIsReady()))
+    {
+        /* Read received data and re-enable OUT endpoint. */
+        count = USBUART_GetAll(buffer);
+        (void) TxRing_Write(port, buffer, count);
+        LOG3(LOG_ID_OUT_PACKET, port, count, TxRing_Free(port));
+    }
+#endif /* (FRAME_ECHO_ENABLE) */
+
+    /* Send data back to host when the IN endpoint is ready. */
+    TxRing_Service(port);
+
+    SerialState_Service(port);
+}
+
+#endif /* (!UART_BRIDGE_ENABLE) */
+
+
+/*******************************************************************************
+* Function Name: WaitForUsbEvent
+********************************************************************************
+*
+* Summary:
+*  Puts the CPU into Sleep mode until a USB interrupt posts an event, the
+*  flush timeout of the transmit ring expires or the UART interrupt of the
+*  bridge posts an event. Returns immediately if an event is already posted
+*  or, with LOG_ENABLE set, log records wait to be sent. The events are
+*  checked with interrupts disabled: an interrupt that occurs after the check
+*  stays pending and wakes the CPU from WFI. The endpoint event is cleared on
+*  return; the caller checks the endpoint state after that. PSoC 3 has no WFI
+*  and polls.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void WaitForUsbEvent(void)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+#if (UART_BRIDGE_ENABLE)
+    if ((0u == epEvent) && (0u == configEvent) && (0u == TxRing_FlushDue()) &&
+        (0u == UartBridge_EventPending()))
+#elif (LOG_ENABLE)
+    if ((0u == epEvent) && (0u == configEvent) && (0u == TxRing_FlushDue()) &&
+        (0u == LogRing_Pending()))
+#else
+    if ((0u == epEvent) && (0u == configEvent) && (0u == TxRing_FlushDue()))
+#endif /* (UART_BRIDGE_ENABLE) */
+    {
+    #if (CY_PSOC4)
+        CySysPmSleep();
+    #elif (CY_PSOC5)
+        CY_PM_WFI;
+    #endif /* (CY_PSOC4) */
+    }
+
+    CyExitCriticalSection(interruptState);
+
+    epEvent = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_EP_0_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the control endpoint ISR. It posts an
+*  event to check for a configuration or line settings change.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBUART_EP_0_ISR_ExitCallback(void)
+{
+    configEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_EP_1_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the notification endpoint ISR, after
+*  the host has read a notification.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBUART_EP_1_ISR_ExitCallback(void)
+{
+    epEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_EP_2_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the data IN endpoint ISR, after the
+*  host has read the IN endpoint buffer. It posts an event to send more data.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBUART_EP_2_ISR_ExitCallback(void)
+{
+    epEvent = 1u;
+    LOG1(LOG_ID_EP_ISR, 2u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_EP_3_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the data OUT endpoint ISR, after the
+*  host has written the OUT endpoint buffer. It posts an event to read the data.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBUART_EP_3_ISR_ExitCallback(void)
+{
+    epEvent = 1u;
+    LOG1(LOG_ID_EP_ISR, 3u);
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_EP_4_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the notification endpoint ISR of the
+*  second COM port. It posts an event.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBUART_EP_4_ISR_ExitCallback(void)
+{
+    epEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_EP_5_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the data IN endpoint ISR of the
+*  second COM port. It posts an event to send more data.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBUART_EP_5_ISR_ExitCallback(void)
+{
+    epEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_EP_6_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the data OUT endpoint ISR of the
+*  second COM port. It posts an event to read the data.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBUART_EP_6_ISR_ExitCallback(void)
+{
+    epEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBUART_BUS_RESET_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the bus reset ISR. It posts an event
+*  to check for a configuration change.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBUART_BUS_RESET_ISR_ExitCallback(void)
+{
+    configEvent = 1u;
+    LOG0(LOG_ID_BUS_RESET);
+}
+
+
 /* [] END OF FILE */
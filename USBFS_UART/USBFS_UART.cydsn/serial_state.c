@@ -0,0 +1,146 @@
+/*******************************************************************************
+* File Name: serial_state.c
+*
+* Version: 1.0
+*
+* Description:
+*  Serial state notifications of the USBFS UART example project. The levels
+*  and the levels last sent are only used by the main loop; the events are
+*  posted by interrupts and taken by the main loop with interrupts disabled.
+*  A notification is loaded only when the interrupt endpoint is free, so a
+*  notification the host has not read yet is never overwritten: the changes
+*  wait in the state until the endpoint interrupt frees the endpoint.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "serial_state.h"
+
+static uint16 serialStateLevels[TX_RING_PORTS];
+static uint16 serialStateSent[TX_RING_PORTS];       /* Levels last sent. */
+static volatile uint16 serialStateEvents[TX_RING_PORTS];
+
+
+/*******************************************************************************
+* Function Name: SerialState_Init
+********************************************************************************
+*
+* Summary:
+*  Clears the serial state of a port when the device is configured: the host
+*  starts with all bits clear, so no notification is due.
+*
+* Parameters:
+*  port: COM port.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void SerialState_Init(uint8 port)
+{
+    uint8 interruptState;
+
+    serialStateLevels[port] = 0u;
+    serialStateSent[port] = 0u;
+
+    interruptState = CyEnterCriticalSection();
+    serialStateEvents[port] = 0u;
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: SerialState_SetLevels
+********************************************************************************
+*
+* Summary:
+*  Sets the DCD, DSR and RI levels of a port. Other bits are ignored. Levels
+*  that change and change back before the notification is loaded are not
+*  reported. Called from the main loop.
+*
+* Parameters:
+*  port: COM port.
+*  levels: SERIAL_STATE_LEVELS bits.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void SerialState_SetLevels(uint8 port, uint16 levels)
+{
+    serialStateLevels[port] = levels & SERIAL_STATE_LEVELS;
+}
+
+
+/*******************************************************************************
+* Function Name: SerialState_Post
+********************************************************************************
+*
+* Summary:
+*  Posts break, framing, parity or overrun events of a port. An event posted
+*  several times before the notification is loaded is reported once. May be
+*  called from an interrupt.
+*
+* Parameters:
+*  port: COM port.
+*  events: SERIAL_STATE_EVENTS bits.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void SerialState_Post(uint8 port, uint16 events)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+    serialStateEvents[port] |= events & SERIAL_STATE_EVENTS;
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: SerialState_Service
+********************************************************************************
+*
+* Summary:
+*  Sends a SERIAL_STATE notification when the levels differ from the levels
+*  last sent or events are posted, and the interrupt endpoint is free. Calls
+*  no USBFS function while there is nothing to send. The port must be the
+*  active COM port.
+*
+* Parameters:
+*  port: COM port.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void SerialState_Service(uint8 port)
+{
+    uint16 events;
+    uint8 interruptState;
+
+    if (((serialStateLevels[port] != serialStateSent[port]) || (0u != serialStateEvents[port])) &&
+        (0u != USBUART_NotificationIsReady()))
+    {
+        interruptState = CyEnterCriticalSection();
+        events = serialStateEvents[port];
+        serialStateEvents[port] = 0u;
+        CyExitCriticalSection(interruptState);
+
+        USBUART_SendSerialState(serialStateLevels[port] | events);
+        serialStateSent[port] = serialStateLevels[port];
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,69 @@
+/*******************************************************************************
+* File Name: serial_state.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants and function prototypes of the serial state
+*  notifications of the USBFS UART example project, one state per COM port.
+*
+*  The serial state is reported to the host with the CDC SERIAL_STATE
+*  notification on the interrupt endpoint of the port. DCD, DSR and RI are
+*  levels: SerialState_SetLevels() sets them, and a notification is sent only
+*  when they differ from the levels last sent. Break, framing, parity and
+*  overrun are events: SerialState_Post() latches them, also from an
+*  interrupt, and the next notification reports them once. While the host has
+*  not read the last notification, all changes are merged into the next one,
+*  so the endpoint carries at most one notification per polling interval and
+*  nothing while the state is steady.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(SERIAL_STATE_H)
+#define SERIAL_STATE_H
+
+#include <project.h>
+#include "tx_ring.h"
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* SERIAL_STATE bitmap (CDC PSTN subclass). */
+#define SERIAL_STATE_DCD        (0x0001u)   /* bRxCarrier */
+#define SERIAL_STATE_DSR        (0x0002u)   /* bTxCarrier */
+#define SERIAL_STATE_BREAK      (0x0004u)
+#define SERIAL_STATE_RI         (0x0008u)   /* bRingSignal */
+#define SERIAL_STATE_FRAMING    (0x0010u)
+#define SERIAL_STATE_PARITY     (0x0020u)
+#define SERIAL_STATE_OVERRUN    (0x0040u)
+
+/* Bits that follow a signal level, and bits that report an event once. */
+#define SERIAL_STATE_LEVELS     (SERIAL_STATE_DCD | SERIAL_STATE_DSR | SERIAL_STATE_RI)
+#define SERIAL_STATE_EVENTS     (SERIAL_STATE_BREAK | SERIAL_STATE_FRAMING | \
+                                 SERIAL_STATE_PARITY | SERIAL_STATE_OVERRUN)
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void SerialState_Init(uint8 port);
+void SerialState_SetLevels(uint8 port, uint16 levels);
+void SerialState_Post(uint8 port, uint16 events);
+void SerialState_Service(uint8 port);
+
+#endif /* (SERIAL_STATE_H) */
+
+
+/* [] END OF FILE */
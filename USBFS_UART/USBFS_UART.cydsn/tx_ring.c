@@ -0,0 +1,476 @@
+/*******************************************************************************
+* File Name: tx_ring.c
+*
+* Version: 1.0
+*
+* Description:
+*  Transmit rings of the USBFS UART example project, one per COM port. The
+*  head and tail are free-running 16-bit byte counters; their difference is
+*  the number of bytes in the ring. The bytes of the packet loaded into the IN
+*  endpoint stay in the ring until the host has read the packet, so the
+*  endpoint can take the data from the ring in any endpoint memory management
+*  mode. A packet that wraps around the end of the ring is copied to the
+*  packet buffer of the port first. TxRing_Write() may be called from one
+*  interrupt instead of the main loop: it is the only writer of the head.
+*
+*  The flush timer runs while a ring holds a packet that is not full. Its
+*  interrupt stops SysTick and posts the timeout; TxRing_Service() then sends
+*  the data held by every port that was waiting. The timer is not restarted
+*  by later writes, so no byte waits longer than the timeout once the IN
+*  endpoint is free.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "tx_ring.h"
+
+static uint8 txRingData[TX_RING_PORTS][TX_RING_SIZE];
+static uint8 txRingPacket[TX_RING_PORTS][TX_RING_PACKET_SIZE];
+
+static volatile uint16 txRingHead[TX_RING_PORTS];   /* Bytes written. */
+static uint16 txRingTail[TX_RING_PORTS];    /* Bytes read by the host. */
+static uint16 txRingSent[TX_RING_PORTS];    /* Bytes in the IN endpoint. */
+static uint8  txRingZlp[TX_RING_PORTS];     /* Last packet sent was full. */
+
+#if (!CY_PSOC3)
+    static uint32 txRingTimeout;        /* Flush timeout, SysTick cycles. */
+    static uint16 txRingFlushCount[TX_RING_PORTS];  /* Bytes to send without waiting. */
+    static uint8  txRingTimerRunning;
+    static uint8  txRingHolding;        /* Ports waiting for the timer, one bit each. */
+    static uint8  txRingTimeUp;         /* Ports whose wait is over, one bit each. */
+    static volatile uint8 txRingExpired;
+
+    static void TxRing_StopTimer(void);
+    static void TxRing_TimerIsr(void);
+#endif /* (!CY_PSOC3) */
+
+static uint8 TxRing_Hold(uint8 port, uint16 length);
+
+
+/*******************************************************************************
+* Function Name: TxRing_Start
+********************************************************************************
+*
+* Summary:
+*  Sets up SysTick for the flush timer, stopped, and sets the flush timeout to
+*  TX_RING_FLUSH_TIMEOUT_US. Empties all rings. Call it once at startup.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void TxRing_Start(void)
+{
+    uint8 port;
+
+#if (!CY_PSOC3)
+    CySysTickStart();
+    CySysTickStop();
+    (void) CySysTickSetCallback(TX_RING_SYSTICK_CALLBACK, &TxRing_TimerIsr);
+#endif /* (!CY_PSOC3) */
+
+    TxRing_SetFlushTimeout(TX_RING_FLUSH_TIMEOUT_US);
+
+    for (port = 0u; port < TX_RING_PORTS; ++port)
+    {
+        TxRing_Init(port);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TxRing_Init
+********************************************************************************
+*
+* Summary:
+*  Empties the ring of a port. Call it when the device is configured: data not
+*  sent yet is lost.
+*
+* Parameters:
+*  port: COM port.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void TxRing_Init(uint8 port)
+{
+    txRingHead[port] = 0u;
+    txRingTail[port] = 0u;
+    txRingSent[port] = 0u;
+    txRingZlp[port]  = 0u;
+
+#if (!CY_PSOC3)
+    txRingFlushCount[port] = 0u;
+    txRingHolding &= (uint8) ~(1u << port);
+    txRingTimeUp  &= (uint8) ~(1u << port);
+
+    if (0u == txRingHolding)
+    {
+        TxRing_StopTimer();
+    }
+#endif /* (!CY_PSOC3) */
+}
+
+
+/*******************************************************************************
+* Function Name: TxRing_Write
+********************************************************************************
+*
+* Summary:
+*  Copies data into the ring of a port, as much as fits. Does not wait for the
+*  host.
+*
+* Parameters:
+*  port:   COM port.
+*  pData:  Data to send.
+*  length: Number of bytes.
+*
+* Return:
+*  Number of bytes copied.
+*
+*******************************************************************************/
+uint16 TxRing_Write(uint8 port, const uint8 pData[], uint16 length)
+{
+    uint16 offset = txRingHead[port] & TX_RING_MASK;
+    uint16 first;
+
+    if (length > TxRing_Free(port))
+    {
+        length = TxRing_Free(port);
+    }
+
+    /* Up to the end of the ring, then from the start. */
+    first = ((offset + length) > TX_RING_SIZE) ? (TX_RING_SIZE - offset) : length;
+
+    (void) memcpy(&txRingData[port][offset], pData, first);
+    (void) memcpy(txRingData[port], &pData[first], length - first);
+
+    txRingHead[port] += length;
+
+    return (length);
+}
+
+
+/*******************************************************************************
+* Function Name: TxRing_Free
+********************************************************************************
+*
+* Summary:
+*  Returns the number of bytes TxRing_Write() accepts for a port.
+*
+* Parameters:
+*  port: COM port.
+*
+* Return:
+*  Free space in bytes.
+*
+*******************************************************************************/
+uint16 TxRing_Free(uint8 port)
+{
+    return (TX_RING_SIZE - (uint16) (txRingHead[port] - txRingTail[port]));
+}
+
+
+/*******************************************************************************
+* Function Name: TxRing_SetFlushTimeout
+********************************************************************************
+*
+* Summary:
+*  Sets how long a packet that is not full waits for more data. The new
+*  timeout applies from the next packet held.
+*
+* Parameters:
+*  microseconds: Flush timeout; 0 sends every write at once.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void TxRing_SetFlushTimeout(uint16 microseconds)
+{
+#if (!CY_PSOC3)
+    txRingTimeout = (uint32) microseconds * (cydelay_freq_hz / 1000000u);
+#else
+    CY_UNUSED_PARAMETER(microseconds);
+#endif /* (!CY_PSOC3) */
+}
+
+
+/*******************************************************************************
+* Function Name: TxRing_Flush
+********************************************************************************
+*
+* Summary:
+*  Sends the data written so far to a port as soon as its IN endpoint is free,
+*  without waiting for the flush timeout. Data written later waits again.
+*
+* Parameters:
+*  port: COM port.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void TxRing_Flush(uint8 port)
+{
+#if (!CY_PSOC3)
+    txRingFlushCount[port] = (uint16) (txRingHead[port] - txRingTail[port]);
+#else
+    CY_UNUSED_PARAMETER(port);
+#endif /* (!CY_PSOC3) */
+}
+
+
+/*******************************************************************************
+* Function Name: TxRing_FlushDue
+********************************************************************************
+*
+* Summary:
+*  Checks if the flush timeout has expired since the last TxRing_Service()
+*  call. Call it before the CPU sleeps, with interrupts disabled: the main
+*  loop must call TxRing_Service() again if it returns non-zero.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero if the flush timeout has expired.
+*
+*******************************************************************************/
+uint8 TxRing_FlushDue(void)
+{
+#if (!CY_PSOC3)
+    return (txRingExpired);
+#else
+    return (0u);
+#endif /* (!CY_PSOC3) */
+}
+
+
+/*******************************************************************************
+* Function Name: TxRing_Service
+********************************************************************************
+*
+* Summary:
+*  When the host has read the last packet of a port, frees its bytes and sends
+*  the next packet: up to TX_RING_PACKET_SIZE bytes from the ring, or a
+*  zero-length packet if the ring is empty and the last packet was full. A
+*  packet that is not full waits for the flush timeout. Call it for every port
+*  on every endpoint event, after writing to the ring and when the flush
+*  timeout expires. The port must be the active COM port
+*  (USBUART_SetComPort()).
+*
+* Parameters:
+*  port: COM port.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void TxRing_Service(uint8 port)
+{
+    const uint8 *pPacket;
+    uint16 offset;
+    uint16 length;
+    uint16 first;
+
+#if (!CY_PSOC3)
+    if (0u != txRingExpired)
+    {
+        /* The wait is over for every port holding a packet. */
+        txRingExpired = 0u;
+        txRingTimerRunning = 0u;
+        txRingTimeUp |= txRingHolding;
+        txRingHolding = 0u;
+    }
+#endif /* (!CY_PSOC3) */
+
+    if (0u != USBUART_CDCIsReady())
+    {
+        /* The host has read the last packet. */
+        txRingTail[port] += txRingSent[port];
+
+    #if (!CY_PSOC3)
+        txRingFlushCount[port] = (txRingFlushCount[port] > txRingSent[port]) ?
+                                 (uint16) (txRingFlushCount[port] - txRingSent[port]) : 0u;
+    #endif /* (!CY_PSOC3) */
+
+        txRingSent[port] = 0u;
+
+        length = (uint16) (txRingHead[port] - txRingTail[port]);
+
+        if (length > TX_RING_PACKET_SIZE)
+        {
+            length = TX_RING_PACKET_SIZE;
+        }
+
+        if (0u != TxRing_Hold(port, length))
+        {
+            /* Wait for more data or the flush timeout. */
+        }
+        else if (0u != length)
+        {
+            offset = txRingTail[port] & TX_RING_MASK;
+
+            if ((offset + length) <= TX_RING_SIZE)
+            {
+                pPacket = &txRingData[port][offset];
+            }
+            else
+            {
+                first = TX_RING_SIZE - offset;
+                (void) memcpy(txRingPacket[port], &txRingData[port][offset], first);
+                (void) memcpy(&txRingPacket[port][first], txRingData[port], length - first);
+                pPacket = txRingPacket[port];
+            }
+
+            USBUART_PutData(pPacket, length);
+
+            /* A full packet does not end the transfer: the host waits for a
+            * short packet.
+            */
+            txRingSent[port] = length;
+            txRingZlp[port]  = (TX_RING_PACKET_SIZE == length) ? 1u : 0u;
+        }
+        else if (0u != txRingZlp[port])
+        {
+            USBUART_PutData(NULL, 0u);
+            txRingZlp[port] = 0u;
+        }
+        else
+        {
+            /* Nothing to send. */
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TxRing_Hold
+********************************************************************************
+*
+* Summary:
+*  Decides if the next packet of a port waits: a packet that is not full waits
+*  while a flush timeout is set, the wait is not over and no flush is pending.
+*  Starts the flush timer when the first port starts to wait and stops it
+*  when no port waits any more.
+*
+* Parameters:
+*  port:   COM port.
+*  length: Number of bytes of the next packet.
+*
+* Return:
+*  Non-zero if the packet waits.
+*
+*******************************************************************************/
+static uint8 TxRing_Hold(uint8 port, uint16 length)
+{
+    uint8 hold = 0u;
+
+#if (!CY_PSOC3)
+    uint8 mask = (uint8) (1u << port);
+
+    if (length < TX_RING_PACKET_SIZE)
+    {
+        if ((0u != length) && (0u != txRingTimeout) && (0u == (txRingTimeUp & mask)) &&
+            (0u == txRingFlushCount[port]))
+        {
+            if (0u == txRingTimerRunning)
+            {
+                CySysTickSetReload(txRingTimeout - 1u);
+                CySysTickClear();
+                CySysTickEnable();
+                txRingTimerRunning = 1u;
+            }
+
+            txRingHolding |= mask;
+            hold = 1u;
+        }
+        else
+        {
+            /* The next packet that is not full starts a new wait. */
+            txRingHolding &= (uint8) ~mask;
+            txRingTimeUp  &= (uint8) ~mask;
+
+            if (0u == txRingHolding)
+            {
+                TxRing_StopTimer();
+            }
+        }
+    }
+#else
+    CY_UNUSED_PARAMETER(port);
+    CY_UNUSED_PARAMETER(length);
+#endif /* (!CY_PSOC3) */
+
+    return (hold);
+}
+
+
+#if (!CY_PSOC3)
+
+/*******************************************************************************
+* Function Name: TxRing_StopTimer
+********************************************************************************
+*
+* Summary:
+*  Stops the flush timer and discards a timeout not handled yet. Call it when
+*  no port is waiting.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void TxRing_StopTimer(void)
+{
+    if (0u != txRingTimerRunning)
+    {
+        CySysTickStop();
+        txRingTimerRunning = 0u;
+    }
+
+    txRingExpired = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: TxRing_TimerIsr
+********************************************************************************
+*
+* Summary:
+*  SysTick callback: the flush timeout has expired. The timer is one-shot.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void TxRing_TimerIsr(void)
+{
+    CySysTickStop();
+    txRingExpired = 1u;
+}
+
+#endif /* (!CY_PSOC3) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,95 @@
+/*******************************************************************************
+* File Name: tx_ring.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants and function prototypes of the transmit rings
+*  of the USBFS UART example project, one per COM port.
+*
+*  A ring decouples the producers of the COM port data from the bulk IN
+*  endpoint. TxRing_Write() copies data into the ring at any time and never
+*  waits; TxRing_Service() sends the data to the host in packets of up to
+*  TX_RING_PACKET_SIZE bytes whenever the endpoint is free, and follows a
+*  full packet that ends the data with a zero-length packet. Data written
+*  while the host has not read the previous packet is packed into the next
+*  one, so a slow host read never stops the reception.
+*
+*  With a flush timeout set, a packet that is not full is held until it fills
+*  up or the timeout expires, counted from when the ring starts holding it.
+*  Producers that write a few bytes at a time then share full packets instead
+*  of using a bus transaction each. TxRing_Flush() sends the data written so
+*  far without waiting for the timeout. The timeout is a one-shot SysTick
+*  interrupt; PSoC 3 has no SysTick and always sends at once. The rings share
+*  the timer: a packet that starts waiting while the timer runs for another
+*  port goes when the timer expires, before its own timeout.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(TX_RING_H)
+#define TX_RING_H
+
+#include <project.h>
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* Maximum packet size of the bulk IN endpoint. */
+#define TX_RING_PACKET_SIZE     (64u)
+
+/* Number of COM ports, each with its own ring. The USBFS component serves up
+* to USBUART_MAX_MULTI_COM_NUM ports, and each port takes three of the eight
+* data endpoints. The configuration descriptor must have a CDC interface pair
+* per port. Override it in the compiler preprocessor definitions.
+*/
+#if !defined(TX_RING_PORTS)
+    #define TX_RING_PORTS           (1u)
+#endif /* !defined(TX_RING_PORTS) */
+
+#if ((TX_RING_PORTS < 1u) || (TX_RING_PORTS > USBUART_MAX_MULTI_COM_NUM))
+    #error TX_RING_PORTS must be 1 up to USBUART_MAX_MULTI_COM_NUM.
+#endif /* ((TX_RING_PORTS < 1u) || (TX_RING_PORTS > USBUART_MAX_MULTI_COM_NUM)) */
+
+/* Ring size: a power of two and a multiple of the packet size. */
+#define TX_RING_SIZE            (256u)
+#define TX_RING_MASK            (TX_RING_SIZE - 1u)
+
+/* Flush timeout set by TxRing_Start(), in microseconds; 0 sends every write
+* at once. Override it in the compiler preprocessor definitions.
+*/
+#if !defined(TX_RING_FLUSH_TIMEOUT_US)
+    #define TX_RING_FLUSH_TIMEOUT_US    (250u)
+#endif /* !defined(TX_RING_FLUSH_TIMEOUT_US) */
+
+/* SysTick callback slot used for the flush timeout. */
+#define TX_RING_SYSTICK_CALLBACK    (0u)
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void   TxRing_Start(void);
+void   TxRing_Init(uint8 port);
+uint16 TxRing_Write(uint8 port, const uint8 pData[], uint16 length);
+uint16 TxRing_Free(uint8 port);
+void   TxRing_SetFlushTimeout(uint16 microseconds);
+void   TxRing_Flush(uint8 port);
+uint8  TxRing_FlushDue(void);
+void   TxRing_Service(uint8 port);
+
+#endif /* (TX_RING_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,483 @@
+/*******************************************************************************
+* File Name: uart_bridge.c
+*
+* Version: 1.0
+*
+* Description:
+*  USB-UART bridge of the USBFS UART example project. The main loop writes the
+*  data from the host into the bridge ring and the UART interrupt reads it, so
+*  the head and tail each have a single writer. The UART interrupt writes the
+*  data received into the transmit ring, which the main loop reads. Both rings
+*  are free-running 16-bit counters, read and written atomically.
+*
+*  The receiver reads the RX FIFO level once per interrupt and moves that
+*  many bytes; the limit this sets on the baud rate is given in uart_bridge.h.
+*
+*  The interrupt posts an event for the main loop only when data can move on:
+*  the transmit ring stops being empty or reaches a full packet, the bridge
+*  ring has room for a packet again, the receiver has stopped because the
+*  transmit ring is full, or a receive error is posted to the serial state.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "uart_bridge.h"
+#include "tx_ring.h"
+
+#if (UART_BRIDGE_ENABLE)
+
+/* Line coding fields of the SCB control registers. */
+#define UART_BRIDGE_PARITY_MASK     (UART_UART_TX_CTRL_PARITY | UART_UART_TX_CTRL_PARITY_ENABLED)
+#define UART_BRIDGE_LINE_MASK       (UART_BRIDGE_PARITY_MASK | UART_UART_TX_CTRL_STOP_BITS_MASK)
+
+static uint8 uartBridgeRing[UART_BRIDGE_RING_SIZE];
+
+static volatile uint16 uartBridgeHead;      /* Bytes written by the main loop. */
+static volatile uint16 uartBridgeTail;      /* Bytes sent to the UART. */
+static volatile uint8  uartBridgeEvent;
+static volatile uint8  uartBridgeRxStalled; /* Transmit ring was full. */
+
+static void UartBridge_Isr(void);
+static void UartBridge_Receive(void);
+static void UartBridge_Transmit(void);
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the UART at UART_BRIDGE_DEFAULT_BAUD 8N1 without flow control and
+*  deasserts DTR. Call it once at startup, after TxRing_Start().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void UartBridge_Start(void)
+{
+    uartBridgeHead = 0u;
+    uartBridgeTail = 0u;
+    uartBridgeRxStalled = 0u;
+
+    UART_SetCustomInterruptHandler(&UartBridge_Isr);
+    UART_SetTxFifoLevel(UART_BRIDGE_TX_LEVEL);
+    UART_Start();
+
+    UartBridge_SetLineCoding(UART_BRIDGE_DEFAULT_BAUD, 8u, USBUART_LINE_CODING_PARITY_NONE,
+                             USBUART_LINE_CODING_STOP_BITS_1);
+    UartBridge_SetLineControl(0u);
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Write
+********************************************************************************
+*
+* Summary:
+*  Copies data from the host into the bridge ring, as much as fits, and
+*  enables the TX FIFO interrupt to send it. Does not wait for the UART.
+*
+* Parameters:
+*  pData:  Data to send.
+*  length: Number of bytes.
+*
+* Return:
+*  Number of bytes copied.
+*
+*******************************************************************************/
+uint16 UartBridge_Write(const uint8 pData[], uint16 length)
+{
+    uint16 offset = uartBridgeHead & UART_BRIDGE_RING_MASK;
+    uint16 first;
+
+    if (length > UartBridge_Free())
+    {
+        length = UartBridge_Free();
+    }
+
+    /* Up to the end of the ring, then from the start. */
+    first = ((offset + length) > UART_BRIDGE_RING_SIZE) ? (UART_BRIDGE_RING_SIZE - offset) : length;
+
+    (void) memcpy(&uartBridgeRing[offset], pData, first);
+    (void) memcpy(uartBridgeRing, &pData[first], length - first);
+
+    uartBridgeHead += length;
+
+    /* The interrupt disables itself when it finds the ring empty: enabling it
+    * after the head has moved never leaves data behind.
+    */
+    UART_SetTxInterruptMode(UART_INTR_TX_TRIGGER);
+
+    return (length);
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Free
+********************************************************************************
+*
+* Summary:
+*  Returns the number of bytes UartBridge_Write() accepts.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Free space in bytes.
+*
+*******************************************************************************/
+uint16 UartBridge_Free(void)
+{
+    return (UART_BRIDGE_RING_SIZE - (uint16) (uartBridgeHead - uartBridgeTail));
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Service
+********************************************************************************
+*
+* Summary:
+*  Clears the event and restarts the receiver when the transmit ring has room
+*  again. Call it from the main loop before TxRing_Service().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void UartBridge_Service(void)
+{
+    uartBridgeEvent = 0u;
+
+    if ((0u != uartBridgeRxStalled) && (0u != TxRing_Free(UART_BRIDGE_COM_PORT)))
+    {
+        uartBridgeRxStalled = 0u;
+        UART_SetRxInterruptMode(UART_BRIDGE_RX_ERRORS | UART_INTR_RX_NOT_EMPTY);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_EventPending
+********************************************************************************
+*
+* Summary:
+*  Checks if the UART interrupt has posted an event since the last
+*  UartBridge_Service() call. Call it before the CPU sleeps, with interrupts
+*  disabled.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero if the main loop has work to do.
+*
+*******************************************************************************/
+uint8 UartBridge_EventPending(void)
+{
+    return (uartBridgeEvent);
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_SetLineCoding
+********************************************************************************
+*
+* Summary:
+*  Applies the line coding set by the host to the UART. The UART is stopped
+*  while it is reconfigured: the bytes in its FIFOs are lost, the data in the
+*  rings is kept. The SCB has no mark or space parity and no 16-bit data,
+*  and the receiver moves 8 bits per byte to the transmit ring: mark and
+*  space parity fall back to no parity, and 9 or 16 data bits to 8. A rate
+*  above HFCLK / oversampling is clamped to it.
+*
+* Parameters:
+*  rate:       Baud rate; 0 keeps UART_BRIDGE_DEFAULT_BAUD.
+*  dataBits:   Data bits, 5 to 8.
+*  parityType: USBUART_LINE_CODING_PARITY_* value.
+*  charFormat: USBUART_LINE_CODING_STOP_BITS_* value.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void UartBridge_SetLineCoding(uint32 rate, uint8 dataBits, uint8 parityType, uint8 charFormat)
+{
+    uint32 divider;
+    uint32 line;
+
+    if (0u == rate)
+    {
+        rate = UART_BRIDGE_DEFAULT_BAUD;
+    }
+
+    /* Fastest rate: HFCLK / oversampling. Clamped before the multiply below,
+    * which a larger rate from the host would overflow.
+    */
+    if (rate > (CYDEV_BCLK__HFCLK__HZ / UART_UART_OVS_FACTOR))
+    {
+        rate = CYDEV_BCLK__HFCLK__HZ / UART_UART_OVS_FACTOR;
+    }
+
+    /* Clock divider in 1/32 steps, rounded: HFCLK / (rate * oversampling). */
+    divider = ((CYDEV_BCLK__HFCLK__HZ * 32u) + ((rate * UART_UART_OVS_FACTOR) / 2u)) /
+              (rate * UART_UART_OVS_FACTOR);
+
+    if ((dataBits < 5u) || (dataBits > 8u))
+    {
+        dataBits = 8u;
+    }
+
+    switch (parityType)
+    {
+        case USBUART_LINE_CODING_PARITY_ODD:
+            line = UART_UART_TX_CTRL_PARITY_ENABLED | UART_UART_TX_CTRL_PARITY;
+            break;
+        case USBUART_LINE_CODING_PARITY_EVEN:
+            line = UART_UART_TX_CTRL_PARITY_ENABLED;
+            break;
+        default:
+            line = 0u;
+            break;
+    }
+
+    /* Stop bits in half bits, minus one. */
+    switch (charFormat)
+    {
+        case USBUART_LINE_CODING_STOP_BITS_1_5:
+            line |= 2u;
+            break;
+        case USBUART_LINE_CODING_STOP_BITS_2:
+            line |= 3u;
+            break;
+        default:
+            line |= 1u;
+            break;
+    }
+
+    UART_DisableInt();
+    UART_Stop();
+    UART_SCBCLK_Stop();
+
+    UART_SCBCLK_SetFractionalDividerRegister((uint16) ((divider / 32u) - 1u), (uint8) (divider % 32u));
+
+    UART_TX_CTRL_REG = (UART_TX_CTRL_REG & (uint32) ~UART_TX_CTRL_DATA_WIDTH_MASK) | ((uint32) dataBits - 1u);
+    UART_RX_CTRL_REG = (UART_RX_CTRL_REG & (uint32) ~UART_RX_CTRL_DATA_WIDTH_MASK) | ((uint32) dataBits - 1u);
+    UART_UART_TX_CTRL_REG = (UART_UART_TX_CTRL_REG & (uint32) ~UART_BRIDGE_LINE_MASK) | line;
+    UART_UART_RX_CTRL_REG = (UART_UART_RX_CTRL_REG & (uint32) ~UART_BRIDGE_LINE_MASK) | line;
+
+    UART_SCBCLK_Start();
+    UART_Enable();
+
+    /* Resume both directions; the interrupt stops them again if needed. */
+    UART_SetRxInterruptMode(UART_BRIDGE_RX_ERRORS |
+                            ((0u == uartBridgeRxStalled) ? UART_INTR_RX_NOT_EMPTY : 0u));
+    UART_SetTxInterruptMode(UART_INTR_TX_TRIGGER);
+    UART_EnableInt();
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_SetLineControl
+********************************************************************************
+*
+* Summary:
+*  Applies the control lines set by the host: DTR drives the DTR pin, active
+*  low, and RTS enables RTS/CTS flow control. Without flow control RTS stays
+*  asserted and the transmitter ignores CTS.
+*
+* Parameters:
+*  lineControl: USBUART_GetLineControl() value.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void UartBridge_SetLineControl(uint8 lineControl)
+{
+    DTR_Write((0u != (lineControl & USBUART_LINE_CONTROL_DTR)) ? 0u : 1u);
+
+    if (0u != (lineControl & USBUART_LINE_CONTROL_RTS))
+    {
+        UART_UartSetRtsFifoLevel(UART_BRIDGE_RTS_LEVEL);
+        UART_UartEnableCts();
+    }
+    else
+    {
+        UART_UartDisableCts();
+        UART_UartSetRtsFifoLevel(0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Isr
+********************************************************************************
+*
+* Summary:
+*  UART interrupt: moves received data to the transmit ring and refills the
+*  TX FIFO from the bridge ring.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void UartBridge_Isr(void)
+{
+    UartBridge_Receive();
+    UartBridge_Transmit();
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Receive
+********************************************************************************
+*
+* Summary:
+*  Posts receive errors to the serial state of the port and moves the RX
+*  FIFO to the transmit ring. When the transmit ring is full, disables the
+*  RX FIFO interrupt: the FIFO fills up and RTS stops the peer until
+*  UartBridge_Service() restarts the receiver.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void UartBridge_Receive(void)
+{
+    uint8  data[UART_FIFO_SIZE];
+    uint16 used;
+    uint16 free;
+    uint16 limit;
+    uint16 count;
+    uint32 level;
+    uint32 source;
+
+    source = UART_GetRxInterruptSourceMasked();
+
+    if (0u != (source & UART_BRIDGE_RX_ERRORS))
+    {
+        UART_ClearRxInterruptSource(source & UART_BRIDGE_RX_ERRORS);
+
+        SerialState_Post(UART_BRIDGE_COM_PORT, (uint16) (
+            ((0u != (source & UART_INTR_RX_OVERFLOW))     ? SERIAL_STATE_OVERRUN : 0u) |
+            ((0u != (source & UART_INTR_RX_FRAME_ERROR))  ? SERIAL_STATE_FRAMING : 0u) |
+            ((0u != (source & UART_INTR_RX_PARITY_ERROR)) ? SERIAL_STATE_PARITY  : 0u) |
+            ((0u != (source & UART_INTR_RX_BREAK_DETECT)) ? SERIAL_STATE_BREAK   : 0u)));
+        uartBridgeEvent = 1u;
+    }
+
+    if (0u != (source & UART_INTR_RX_NOT_EMPTY))
+    {
+        free = TxRing_Free(UART_BRIDGE_COM_PORT);
+        used = TX_RING_SIZE - free;
+
+        /* The FIFO level is read once: the bytes that arrive meanwhile are
+        * left for the next interrupt.
+        */
+        level = UART_SpiUartGetRxBufferSize();
+        limit = (level < free) ? (uint16) level : free;
+
+        for (count = 0u; count < limit; ++count)
+        {
+            data[count] = (uint8) UART_SpiUartReadRxData();
+        }
+
+        (void) TxRing_Write(UART_BRIDGE_COM_PORT, data, count);
+        UART_ClearRxInterruptSource(UART_INTR_RX_NOT_EMPTY);
+
+        if (count == free)
+        {
+            UART_SetRxInterruptMode(UART_BRIDGE_RX_ERRORS);
+            uartBridgeRxStalled = 1u;
+            uartBridgeEvent = 1u;
+        }
+        else if ((0u == used) ||
+                 ((used < UART_BRIDGE_PACKET_SIZE) && ((used + count) >= UART_BRIDGE_PACKET_SIZE)))
+        {
+            /* A packet to start or to complete. */
+            uartBridgeEvent = 1u;
+        }
+        else
+        {
+            /* The main loop already has work to do. */
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Transmit
+********************************************************************************
+*
+* Summary:
+*  Refills the TX FIFO from the bridge ring. Disables the TX FIFO interrupt
+*  when the ring is empty.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void UartBridge_Transmit(void)
+{
+    uint16 tail = uartBridgeTail;
+    uint16 used = (uint16) (uartBridgeHead - tail);
+    uint16 count = 0u;
+    uint32 space;
+
+    if (0u != (UART_GetTxInterruptSourceMasked() & UART_INTR_TX_TRIGGER))
+    {
+        space = UART_FIFO_SIZE - UART_SpiUartGetTxBufferSize();
+
+        while ((count < used) && (count < space))
+        {
+            UART_SpiUartWriteTxData(uartBridgeRing[(uint16) (tail + count) & UART_BRIDGE_RING_MASK]);
+            ++count;
+        }
+
+        uartBridgeTail = tail + count;
+        UART_ClearTxInterruptSource(UART_INTR_TX_TRIGGER);
+
+        if (count == used)
+        {
+            UART_SetTxInterruptMode(0u);
+        }
+
+        /* The ring has room for the next packet from the host. */
+        if (((UART_BRIDGE_RING_SIZE - used) < UART_BRIDGE_PACKET_SIZE) &&
+            ((UART_BRIDGE_RING_SIZE - used + count) >= UART_BRIDGE_PACKET_SIZE))
+        {
+            uartBridgeEvent = 1u;
+        }
+    }
+}
+
+#endif /* (UART_BRIDGE_ENABLE) */
+
+
+/* [] END OF FILE */
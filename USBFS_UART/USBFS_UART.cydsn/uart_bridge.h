@@ -0,0 +1,117 @@
+/*******************************************************************************
+* File Name: uart_bridge.h
+*
+* Version: 1.0
+*
+* Description:
+*  This file provides constants and function prototypes of the USB-UART
+*  bridge of the USBFS UART example project.
+*
+*  With UART_BRIDGE_ENABLE set, the COM port is bridged to an SCB UART instead
+*  of echoing the data. Data from the host is copied into the bridge ring by
+*  UartBridge_Write() and moved to the UART TX FIFO by the UART interrupt
+*  whenever the FIFO falls below half full. The UART interrupt moves every
+*  byte received to the transmit ring (tx_ring.h), which sends it to the host;
+*  while the transmit ring is full, the UART stops reading and RTS tells the
+*  peer to stop sending. The line coding and the control lines the host sets
+*  are applied to the UART: baud rate, data bits, parity and stop bits, DTR on
+*  the DTR pin, and RTS/CTS flow control while the host raises RTS. Overruns,
+*  framing and parity errors and breaks are reported to the host in the
+*  serial state (serial_state.h).
+*
+*  In the host emulation, with the UART looped back, the bridge carries
+*  3 Mbaud 8N1 without overruns at 287 KB/s (1 KB = 1024 bytes), 98% of the
+*  293 KB/s line rate, when the host keeps 12 packets in flight; 8 packets in
+*  flight give 282 KB/s. The CPU is 84% busy at that rate, most of it in the
+*  UART interrupt, which moves about two bytes each time: 3 Mbaud is the
+*  ceiling of this design. A faster rate needs the FIFOs served by DMA.
+*
+*  The bridge needs these components in the TopDesign, which the shipped
+*  design does not have:
+*   - UART: SCB in UART mode, RX and TX buffer size 8 (the FIFOs), internal
+*     interrupt, RTS and CTS enabled, with its clock UART_SCBCLK.
+*   - DTR: digital output pin.
+*  PSoC 4 only.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(UART_BRIDGE_H)
+#define UART_BRIDGE_H
+
+#include <project.h>
+#include "serial_state.h"
+#include "tx_ring.h"
+
+/* Set to 1u in the compiler preprocessor definitions to build the bridge. */
+#if !defined(UART_BRIDGE_ENABLE)
+    #define UART_BRIDGE_ENABLE      (0u)
+#endif /* !defined(UART_BRIDGE_ENABLE) */
+
+#if (UART_BRIDGE_ENABLE)
+
+#if (!CY_PSOC4)
+    #error The USB-UART bridge uses an SCB UART: PSoC 4 only.
+#endif /* (!CY_PSOC4) */
+
+#if (1u != TX_RING_PORTS)
+    #error The USB-UART bridge uses one COM port.
+#endif /* (1u != TX_RING_PORTS) */
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* COM port bridged to the UART. */
+#define UART_BRIDGE_COM_PORT        (0u)
+
+/* Bridge ring, USB to UART: a power of two. */
+#define UART_BRIDGE_RING_SIZE       (512u)
+#define UART_BRIDGE_RING_MASK       (UART_BRIDGE_RING_SIZE - 1u)
+
+/* The UART interrupt refills the TX FIFO when it holds fewer bytes. */
+#define UART_BRIDGE_TX_LEVEL        (UART_FIFO_SIZE / 2u)
+
+/* RTS is deasserted when the RX FIFO holds this many bytes, leaving room for
+* the bytes the peer sends before it sees RTS.
+*/
+#define UART_BRIDGE_RTS_LEVEL       (UART_FIFO_SIZE / 2u)
+
+/* The main loop is woken when this much data can move on. */
+#define UART_BRIDGE_PACKET_SIZE     (64u)
+
+/* Receive errors reported in the serial state. */
+#define UART_BRIDGE_RX_ERRORS       (UART_INTR_RX_OVERFLOW | UART_INTR_RX_FRAME_ERROR | \
+                                     UART_INTR_RX_PARITY_ERROR | UART_INTR_RX_BREAK_DETECT)
+
+/* Baud rate set by UartBridge_Start(), until the host sets the line coding. */
+#define UART_BRIDGE_DEFAULT_BAUD    (115200u)
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+void   UartBridge_Start(void);
+uint16 UartBridge_Write(const uint8 pData[], uint16 length);
+uint16 UartBridge_Free(void);
+void   UartBridge_Service(void);
+uint8  UartBridge_EventPending(void);
+void   UartBridge_SetLineCoding(uint32 rate, uint8 dataBits, uint8 parityType, uint8 charFormat);
+void   UartBridge_SetLineControl(uint8 lineControl);
+
+#endif /* (UART_BRIDGE_ENABLE) */
+
+#endif /* (UART_BRIDGE_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,214 @@
+/*******************************************************************************
+* File Name: cobs_host.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host side of the COBS framing of the USBFS UART example. The decoder keeps
+*  its state between chunks, so a frame may be split anywhere in the stream;
+*  the caller passes the rest of a chunk again after each frame.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include "cobs_host.h"
+
+
+/*******************************************************************************
+* Function Name: CobsHost_Encode
+********************************************************************************
+*
+* Summary:
+*  Encodes a frame and appends the delimiter.
+*
+* Parameters:
+*  data: frame.
+*  length: bytes in the frame.
+*  out: encoded frame; COBS_HOST_ENCODED_SIZE(length) bytes.
+*
+* Return:
+*  Length of the encoded frame.
+*
+*******************************************************************************/
+uint32 CobsHost_Encode(const uint8 data[], uint32 length, uint8 out[])
+{
+    uint32 codeIndex = 0u;
+    uint32 outLength = 1u;
+    uint8  code = 1u;
+    uint32 i;
+
+    for (i = 0u; i < length; ++i)
+    {
+        if (0u == code)
+        {
+            /* The last block was full: open the next one. */
+            codeIndex = outLength;
+            ++outLength;
+            code = 1u;
+        }
+
+        if (COBS_HOST_DELIMITER == data[i])
+        {
+            out[codeIndex] = code;
+            codeIndex = outLength;
+            code = 1u;
+        }
+        else
+        {
+            out[outLength] = data[i];
+            ++code;
+
+            if (COBS_HOST_CODE_FULL == code)
+            {
+                out[codeIndex] = COBS_HOST_CODE_FULL;
+                code = 0u;
+            }
+        }
+
+        ++outLength;
+    }
+
+    if (0u != code)
+    {
+        out[codeIndex] = code;
+    }
+
+    out[outLength] = COBS_HOST_DELIMITER;
+
+    return (outLength + 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: CobsHost_DecoderInit
+********************************************************************************
+*
+* Summary:
+*  Prepares the decoder for the first byte of a frame.
+*
+* Parameters:
+*  decoder: decoder state.
+*  frame: buffer of the decoded frame.
+*  size: size of the buffer; longer frames are reported as bad.
+*
+*******************************************************************************/
+void CobsHost_DecoderInit(COBS_HOST_DECODER *decoder, uint8 frame[], uint32 size)
+{
+    decoder->frame = frame;
+    decoder->size = size;
+    decoder->length = 0u;
+    decoder->left = 0u;
+    decoder->zero = 0u;
+    decoder->inFrame = 0u;
+    decoder->overflow = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: CobsHost_Decode
+********************************************************************************
+*
+* Summary:
+*  Decodes a chunk of the stream up to the end of the next frame. Empty
+*  delimiters are skipped. A delimiter inside a block means that bytes were
+*  lost: the frame is reported as bad and the next byte starts a new frame.
+*
+* Parameters:
+*  decoder: decoder state.
+*  data: chunk of the stream.
+*  length: bytes in the chunk.
+*  used: returns the bytes of the chunk used.
+*
+* Return:
+*  COBS_HOST_FRAME: decoder->frame holds decoder->length bytes of a frame.
+*  COBS_HOST_BAD_FRAME: a frame was dropped.
+*  COBS_HOST_MORE: the chunk is used up within a frame.
+*
+*******************************************************************************/
+int CobsHost_Decode(COBS_HOST_DECODER *decoder, const uint8 data[], uint32 length,
+                    uint32 *used)
+{
+    int    result = COBS_HOST_MORE;
+    uint8  byte;
+    uint32 i;
+
+    /* Once a frame is complete, the next byte starts a new one. */
+    if (0u == decoder->inFrame)
+    {
+        decoder->length = 0u;
+        decoder->overflow = 0u;
+    }
+
+    for (i = 0u; (i < length) && (COBS_HOST_MORE == result); ++i)
+    {
+        byte = data[i];
+
+        if (COBS_HOST_DELIMITER == byte)
+        {
+            if (0u != decoder->left)
+            {
+                result = COBS_HOST_BAD_FRAME;
+            }
+            else if (0u != decoder->inFrame)
+            {
+                result = (0u == decoder->overflow) ? COBS_HOST_FRAME : COBS_HOST_BAD_FRAME;
+            }
+            else
+            {
+                /* Empty delimiter. */
+            }
+
+            decoder->left = 0u;
+            decoder->zero = 0u;
+            decoder->inFrame = 0u;
+        }
+        else if (0u != decoder->left)
+        {
+            if (decoder->length < decoder->size)
+            {
+                decoder->frame[decoder->length] = byte;
+                ++decoder->length;
+            }
+            else
+            {
+                decoder->overflow = 1u;
+            }
+
+            --decoder->left;
+        }
+        else
+        {
+            if (0u != decoder->zero)
+            {
+                if (decoder->length < decoder->size)
+                {
+                    decoder->frame[decoder->length] = 0u;
+                    ++decoder->length;
+                }
+                else
+                {
+                    decoder->overflow = 1u;
+                }
+            }
+
+            decoder->left = (uint32) byte - 1u;
+            decoder->zero = (COBS_HOST_CODE_FULL != byte) ? 1u : 0u;
+            decoder->inFrame = 1u;
+        }
+    }
+
+    *used = i;
+
+    return (result);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,78 @@
+/*******************************************************************************
+* File Name: cobs_host.h
+*
+* Version: 1.0
+*
+* Description:
+*  Host side of the COBS framing of the USBFS UART example (cobs.h in the
+*  firmware). It works on byte streams and does not depend on the transport:
+*  the data may come from the COM port device, from host_usb.h or from a
+*  file. CobsHost_Encode() encodes a whole frame; the decoder takes the
+*  stream in chunks of any size and assembles frames in a buffer of the
+*  caller.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#if !defined(COBS_HOST_H)
+#define COBS_HOST_H
+
+#include "host_usb.h"
+
+
+/***************************************
+*    Constants
+****************************************/
+
+/* Framing of the firmware. */
+#define COBS_HOST_DELIMITER         (0x00u)
+#define COBS_HOST_BLOCK_MAX         (254u)
+#define COBS_HOST_CODE_FULL         (0xFFu)
+
+/* Largest encoded size of a frame of n bytes, delimiter included. */
+#define COBS_HOST_ENCODED_SIZE(n)   ((n) + ((n) / COBS_HOST_BLOCK_MAX) + 2u)
+
+/* Return values of CobsHost_Decode(). */
+#define COBS_HOST_MORE              (0)     /* The chunk is used up. */
+#define COBS_HOST_FRAME             (1)     /* A frame is complete. */
+#define COBS_HOST_BAD_FRAME         (2)     /* A frame was cut short or too long. */
+
+
+/***************************************
+*    Data Struct Definition
+****************************************/
+
+/* Decoder state: the frame being assembled. */
+typedef struct
+{
+    uint8 *frame;
+    uint32 size;
+    uint32 length;              /* Bytes of the frame so far. */
+    uint32 left;                /* Bytes left in the current block. */
+    uint8  zero;                /* A zero byte follows the current block. */
+    uint8  inFrame;             /* A code byte of the frame has been read. */
+    uint8  overflow;            /* The frame does not fit the buffer. */
+} COBS_HOST_DECODER;
+
+
+/***************************************
+*    Function Prototypes
+****************************************/
+
+uint32 CobsHost_Encode(const uint8 data[], uint32 length, uint8 out[]);
+void   CobsHost_DecoderInit(COBS_HOST_DECODER *decoder, uint8 frame[], uint32 size);
+int    CobsHost_Decode(COBS_HOST_DECODER *decoder, const uint8 data[], uint32 length,
+                       uint32 *used);
+
+#endif /* (COBS_HOST_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,544 @@
+/*******************************************************************************
+* File Name: cobs_test.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host tool of the COBS framing of the USBFS UART example, built with
+*  FRAME_ECHO_ENABLE: the device echoes every frame it receives. The tool
+*  first checks the host codec by itself, with frames of up to three blocks
+*  split into chunks of random size. It then sends -n frames of random length
+*  up to -l bytes and random content, about one byte in eight zero, and
+*  checks that every frame comes back whole and in order. It keeps up to -w
+*  encoded bytes in flight and writes all the frames that fit at once, so
+*  packets hold several frames and frames span packets.
+*
+*  On a PC, talk to the COM port: -f /dev/ttyACM0 (the tool opens it in raw
+*  mode). Without -f the tool uses host_usb.h: build it against the emulated
+*  firmware, add -pthread, -DFRAME_ECHO_ENABLE=1u, this file and cobs_host.c
+*  to the build command in USBFS_Host_Emulation/README.md, then run
+*   ./cobs_test_sim -s host -- -n 2000
+*  Build for a PC:
+*   gcc -I USBFS_Host_Emulation USBFS_UART/host/cobs_test.c \
+*       USBFS_UART/host/cobs_host.c \
+*       USBFS_Host_Emulation/libusb/host_usb_libusb.c -lusb-1.0 -o cobs_test
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "cobs_host.h"
+
+/* Device of the example: first COM port. */
+#define TEST_VID                (0x04B4u)
+#define TEST_PID                (0xF232u)
+#define TEST_IN_EP              (0x82u)
+#define TEST_OUT_EP             (0x03u)
+#define TEST_MAX_PACKET         (64u)
+#define TEST_COMM_PACKET        (16u)
+
+/* Largest frame the device echoes (FRAME_ECHO_MAX_PAYLOAD), and the bytes
+* in flight its transmit ring always takes.
+*/
+#define TEST_DEVICE_MAX_PAYLOAD (250u)
+#define TEST_DEVICE_WINDOW      (256u)
+
+/* Self-test: frames up to three full blocks long. */
+#define TEST_SELF_MAX_LENGTH    (3u * COBS_HOST_BLOCK_MAX + 10u)
+#define TEST_SELF_FRAMES        (2000u)
+
+#define TEST_MAX_IN_FLIGHT      (128u)
+#define TEST_DEFAULT_FRAMES     (1000u)
+#define TEST_TIMEOUT            (1000u)     /* ms */
+
+#define TEST_FRAME_SIZE         (TEST_SELF_MAX_LENGTH)
+#define TEST_ENCODED_SIZE       (COBS_HOST_ENCODED_SIZE(TEST_FRAME_SIZE))
+
+/* A frame sent and not yet echoed. */
+typedef struct
+{
+    uint8  data[TEST_DEVICE_MAX_PAYLOAD];
+    uint32 length;
+} TEST_FRAME;
+
+static const HOST_USB_EP testEps[] =
+{
+    {0x81u,         HOST_USB_EP_INT,  TEST_COMM_PACKET},
+    {TEST_IN_EP,    HOST_USB_EP_BULK, TEST_MAX_PACKET},
+    {TEST_OUT_EP,   HOST_USB_EP_BULK, TEST_MAX_PACKET}
+};
+
+static TEST_FRAME testQueue[TEST_MAX_IN_FLIGHT];
+static uint32 testRandom = 1u;
+static int    testFd = -1;
+
+static uint32 Test_Random(void);
+static uint32 Test_MakeFrame(uint8 data[], uint32 maxLength);
+static int    Test_Self(void);
+static int    Test_Write(const uint8 data[], uint32 length);
+static int    Test_Read(uint8 data[], uint32 size, uint32 *transferred);
+static int    Test_Echo(uint32 frames, uint32 maxLength, uint32 window);
+static void   Test_Usage(const char *program);
+
+
+/*******************************************************************************
+* Function Name: Test_Random
+********************************************************************************
+*
+* Summary:
+*  Returns the next number of a xorshift32 sequence.
+*
+*******************************************************************************/
+static uint32 Test_Random(void)
+{
+    testRandom ^= testRandom << 13u;
+    testRandom ^= testRandom >> 17u;
+    testRandom ^= testRandom << 5u;
+
+    return (testRandom);
+}
+
+
+/*******************************************************************************
+* Function Name: Test_MakeFrame
+********************************************************************************
+*
+* Summary:
+*  Fills a frame of random length from 0 to maxLength bytes. About one byte
+*  in eight is zero; every fourth frame has no zero byte, so full blocks
+*  occur as well.
+*
+* Return:
+*  Frame length.
+*
+*******************************************************************************/
+static uint32 Test_MakeFrame(uint8 data[], uint32 maxLength)
+{
+    uint32 length = Test_Random() % (maxLength + 1u);
+    uint8  noZero = (0u == (Test_Random() & 3u)) ? 1u : 0u;
+    uint32 value;
+    uint32 i;
+
+    for (i = 0u; i < length; ++i)
+    {
+        value = Test_Random();
+        data[i] = ((0u == (value & 0x700u)) && (0u == noZero)) ? 0u : (uint8) (value | 1u);
+    }
+
+    return (length);
+}
+
+
+/*******************************************************************************
+* Function Name: Test_Self
+********************************************************************************
+*
+* Summary:
+*  Encodes random frames back to back and decodes the stream in chunks of 1
+*  to 64 bytes. Checks every frame and the overhead bound.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Test_Self(void)
+{
+    static uint8 frames[TEST_SELF_FRAMES / 8u][TEST_FRAME_SIZE];
+    static uint32 lengths[TEST_SELF_FRAMES / 8u];
+    static uint8 stream[(TEST_SELF_FRAMES / 8u) * TEST_ENCODED_SIZE];
+    static uint8 frame[TEST_FRAME_SIZE];
+    COBS_HOST_DECODER decoder;
+    uint32 streamLength;
+    uint32 encoded;
+    uint32 offset;
+    uint32 chunk;
+    uint32 used;
+    uint32 next;
+    uint32 round;
+    uint32 i;
+    int result;
+
+    CobsHost_DecoderInit(&decoder, frame, sizeof(frame));
+
+    for (round = 0u; round < 8u; ++round)
+    {
+        streamLength = 0u;
+
+        for (i = 0u; i < (TEST_SELF_FRAMES / 8u); ++i)
+        {
+            lengths[i] = Test_MakeFrame(frames[i], TEST_SELF_MAX_LENGTH);
+            encoded = CobsHost_Encode(frames[i], lengths[i], &stream[streamLength]);
+
+            if ((encoded > COBS_HOST_ENCODED_SIZE(lengths[i])) ||
+                (NULL != memchr(&stream[streamLength], 0, encoded - 1u)))
+            {
+                printf("self-test: bad encoding of a frame of %u bytes\n", lengths[i]);
+                return (HOST_USB_ERROR);
+            }
+
+            streamLength += encoded;
+        }
+
+        next = 0u;
+        offset = 0u;
+
+        while (offset < streamLength)
+        {
+            chunk = 1u + (Test_Random() % TEST_MAX_PACKET);
+            chunk = (chunk < (streamLength - offset)) ? chunk : (streamLength - offset);
+
+            while (0u != chunk)
+            {
+                result = CobsHost_Decode(&decoder, &stream[offset], chunk, &used);
+                offset += used;
+                chunk -= used;
+
+                if (COBS_HOST_MORE != result)
+                {
+                    if ((COBS_HOST_FRAME != result) || (decoder.length != lengths[next]) ||
+                        (0 != memcmp(frame, frames[next], lengths[next])))
+                    {
+                        printf("self-test: frame %u of %u bytes decoded wrong\n",
+                               next, lengths[next]);
+                        return (HOST_USB_ERROR);
+                    }
+                    ++next;
+                }
+            }
+        }
+
+        if ((TEST_SELF_FRAMES / 8u) != next)
+        {
+            printf("self-test: %u frames decoded\n", next);
+            return (HOST_USB_ERROR);
+        }
+    }
+
+    printf("self-test       : %u frames of 0 to %u bytes\n", TEST_SELF_FRAMES,
+           TEST_SELF_MAX_LENGTH);
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Test_Write
+********************************************************************************
+*
+* Summary:
+*  Writes to the COM port device, or to the OUT endpoint.
+*
+*******************************************************************************/
+static int Test_Write(const uint8 data[], uint32 length)
+{
+    uint32 transferred;
+    ssize_t written;
+
+    if (testFd < 0)
+    {
+        return (HostUsb_Transfer(TEST_OUT_EP, (uint8 *) data, length, &transferred, TEST_TIMEOUT));
+    }
+
+    while (0u != length)
+    {
+        written = write(testFd, data, length);
+
+        if (written <= 0)
+        {
+            return (HOST_USB_ERROR);
+        }
+
+        data += written;
+        length -= (uint32) written;
+    }
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Test_Read
+********************************************************************************
+*
+* Summary:
+*  Reads what the COM port device or the IN endpoint has, waiting up to
+*  TEST_TIMEOUT.
+*
+*******************************************************************************/
+static int Test_Read(uint8 data[], uint32 size, uint32 *transferred)
+{
+    struct pollfd waitFd;
+    ssize_t length;
+
+    if (testFd < 0)
+    {
+        return (HostUsb_Transfer(TEST_IN_EP, data, size, transferred, TEST_TIMEOUT));
+    }
+
+    waitFd.fd = testFd;
+    waitFd.events = POLLIN;
+
+    if (0 >= poll(&waitFd, 1u, (int) TEST_TIMEOUT))
+    {
+        return (HOST_USB_TIMEOUT);
+    }
+
+    length = read(testFd, data, size);
+
+    if (length <= 0)
+    {
+        return (HOST_USB_ERROR);
+    }
+
+    *transferred = (uint32) length;
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Test_Echo
+********************************************************************************
+*
+* Summary:
+*  Sends frames through the echo of the device and checks what comes back.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Test_Echo(uint32 frames, uint32 maxLength, uint32 window)
+{
+    static uint8 out[TEST_MAX_IN_FLIGHT * COBS_HOST_ENCODED_SIZE(TEST_DEVICE_MAX_PAYLOAD)];
+    static uint8 frame[TEST_DEVICE_MAX_PAYLOAD];
+    uint8  packet[TEST_MAX_PACKET];
+    COBS_HOST_DECODER decoder;
+    TEST_FRAME *next;
+    uint32 inFlight = 0u;       /* Encoded bytes sent and not echoed. */
+    uint32 head = 0u;           /* Oldest frame in flight. */
+    uint32 count = 0u;          /* Frames in flight. */
+    uint32 sent = 0u;
+    uint32 received = 0u;
+    uint32 payload = 0u;
+    uint32 wire = 0u;
+    uint32 outLength;
+    uint32 encoded;
+    uint32 transferred;
+    uint32 offset;
+    uint32 used;
+    uint64 start;
+    double seconds;
+    uint8  pending = 0u;        /* The next frame is made but not sent. */
+    int result;
+
+    CobsHost_DecoderInit(&decoder, frame, sizeof(frame));
+    start = HostUsb_TimeNs();
+
+    while (received < frames)
+    {
+        /* Write the frames that fit the window at once. */
+        outLength = 0u;
+
+        while ((sent < frames) && (count < TEST_MAX_IN_FLIGHT))
+        {
+            next = &testQueue[(head + count) % TEST_MAX_IN_FLIGHT];
+
+            if (0u == pending)
+            {
+                next->length = Test_MakeFrame(next->data, maxLength);
+                pending = 1u;
+            }
+
+            if ((inFlight + COBS_HOST_ENCODED_SIZE(next->length)) > window)
+            {
+                break;
+            }
+
+            encoded = CobsHost_Encode(next->data, next->length, &out[outLength]);
+            outLength += encoded;
+            inFlight += COBS_HOST_ENCODED_SIZE(next->length);
+            wire += encoded;
+            payload += next->length;
+            pending = 0u;
+            ++count;
+            ++sent;
+        }
+
+        if ((0u != outLength) && (HOST_USB_SUCCESS != Test_Write(out, outLength)))
+        {
+            printf("write failed after %u frames\n", sent - count);
+            return (HOST_USB_ERROR);
+        }
+
+        if (HOST_USB_SUCCESS != Test_Read(packet, sizeof(packet), &transferred))
+        {
+            printf("no echo: %u frames sent, %u received\n", sent, received);
+            return (HOST_USB_ERROR);
+        }
+
+        for (offset = 0u; offset < transferred; offset += used)
+        {
+            result = CobsHost_Decode(&decoder, &packet[offset], transferred - offset, &used);
+
+            if (COBS_HOST_MORE == result)
+            {
+                continue;
+            }
+
+            next = &testQueue[head];
+
+            if ((0u == count) || (COBS_HOST_FRAME != result) || (decoder.length != next->length) ||
+                (0 != memcmp(frame, next->data, next->length)))
+            {
+                printf("frame %u of %u bytes echoed wrong\n", received, next->length);
+                return (HOST_USB_ERROR);
+            }
+
+            inFlight -= COBS_HOST_ENCODED_SIZE(next->length);
+            head = (head + 1u) % TEST_MAX_IN_FLIGHT;
+            --count;
+            ++received;
+        }
+    }
+
+    seconds = (double) (HostUsb_TimeNs() - start) / 1e9;
+
+    printf("frames          : %u of 0 to %u bytes, window %u bytes\n", received, maxLength, window);
+    printf("payload         : %u bytes, %.1f KB/s, %.0f frames/s\n", payload,
+           (double) payload / 1000.0 / seconds, (double) received / seconds);
+    printf("overhead        : %u bytes, %.2f per frame\n", wire - payload,
+           (double) (wire - payload) / (double) received);
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Test_Usage
+********************************************************************************
+*
+* Summary:
+*  Prints the command line help.
+*
+*******************************************************************************/
+static void Test_Usage(const char *program)
+{
+    printf("usage: %s [-f device] [-n frames] [-l bytes] [-w bytes] [-r seed]\n", program);
+    printf("  -f   COM port device (/dev/ttyACM0); default: host_usb.h\n");
+    printf("  -n   frames to echo (%u)\n", TEST_DEFAULT_FRAMES);
+    printf("  -l   largest frame, up to %u bytes (%u)\n", TEST_DEVICE_MAX_PAYLOAD,
+           TEST_DEVICE_MAX_PAYLOAD);
+    printf("  -w   encoded bytes in flight, up to %u (%u)\n", TEST_DEVICE_WINDOW,
+           TEST_DEVICE_WINDOW);
+    printf("  -r   random seed, not 0 (1)\n");
+}
+
+
+/*******************************************************************************
+* Function Name: HostTool_Main
+********************************************************************************
+*
+* Summary:
+*  Runs the self-test of the codec and the frame echo.
+*
+* Return:
+*  0 on success, 1 on a transfer or data error, 4 on a usage error.
+*
+*******************************************************************************/
+int HostTool_Main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    uint32 frames = TEST_DEFAULT_FRAMES;
+    uint32 maxLength = TEST_DEVICE_MAX_PAYLOAD;
+    uint32 window = TEST_DEVICE_WINDOW;
+    uint8  usage = 0u;
+    struct termios mode;
+    int result;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "f:n:l:w:r:h")))
+    {
+        switch (opt)
+        {
+            case 'f': path       = optarg; break;
+            case 'n': frames     = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'l': maxLength  = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'w': window     = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'r': testRandom = (uint32) strtoul(optarg, NULL, 0); break;
+            default:
+                usage = 1u;
+                break;
+        }
+    }
+
+    if ((0u != usage) || (maxLength > TEST_DEVICE_MAX_PAYLOAD) || (window > TEST_DEVICE_WINDOW) ||
+        (window < COBS_HOST_ENCODED_SIZE(maxLength)) || (0u == testRandom))
+    {
+        Test_Usage(argv[0]);
+        return (4);
+    }
+
+    result = Test_Self();
+
+    if (NULL != path)
+    {
+        testFd = open(path, O_RDWR | O_NOCTTY);
+
+        if (testFd < 0)
+        {
+            printf("cannot open %s\n", path);
+            return (1);
+        }
+
+        if (0 == tcgetattr(testFd, &mode))
+        {
+            cfmakeraw(&mode);
+            (void) tcsetattr(testFd, TCSANOW, &mode);
+        }
+    }
+    else if (HOST_USB_SUCCESS != HostUsb_Open(TEST_VID, TEST_PID, testEps,
+                                              (uint8) (sizeof(testEps) / sizeof(testEps[0u]))))
+    {
+        return (1);
+    }
+    else
+    {
+        /* host_usb.h is open. */
+    }
+
+    if (HOST_USB_SUCCESS == result)
+    {
+        result = Test_Echo(frames, maxLength, window);
+    }
+
+    result = (HOST_USB_SUCCESS == result) ? 0 : 1;
+
+    if (NULL != path)
+    {
+        (void) close(testFd);
+    }
+    else
+    {
+        HostUsb_Close(result);
+    }
+
+    return (result);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,508 @@
+/*******************************************************************************
+* File Name: log_decode.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host tool that renders the binary log of the USBFS UART example, built
+*  with LOG_ENABLE and TX_RING_PORTS set to 2. The firmware sends records of a
+*  message ID and raw arguments on its second COM port; the tool formats them
+*  with the string table of the firmware (log_ids.h), checks the framing of
+*  every record and counts the records the firmware dropped from the gaps in
+*  the sequence numbers.
+*
+*  On a PC, read the log port: -f /dev/ttyACM1 (the tool opens it in raw mode,
+*  which raises DTR and starts the log) or a file captured from it. Without -f
+*  the tool runs against the emulated firmware: it raises DTR on the log port,
+*  loops -n packets through the first port to make the firmware log, and reads
+*  the log endpoint for -d ms more.
+*
+*  Build for a PC:
+*   gcc -I USBFS_Host_Emulation -I USBFS_UART/USBFS_UART.cydsn \
+*       USBFS_UART/host/log_decode.c \
+*       USBFS_Host_Emulation/libusb/host_usb_libusb.c -lusb-1.0 -o log_decode
+*  Build against the emulated firmware: add -pthread, -DTX_RING_PORTS=2u,
+*  -DLOG_ENABLE=1u, -I USBFS_UART/USBFS_UART.cydsn and this file to the build
+*  command in USBFS_Host_Emulation/README.md, then run
+*   ./log_decode_sim -s host -- -n 1000
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "host_usb.h"
+#include "log_ids.h"
+
+/* Device of the example: first COM port for the traffic, second for the log.
+* The notification, IN and OUT endpoints of port N are 1+3N, 2+3N and 3+3N.
+*/
+#define DECODE_VID              (0x04B4u)
+#define DECODE_PID              (0xF232u)
+#define DECODE_ECHO_IN_EP       (0x82u)
+#define DECODE_ECHO_OUT_EP      (0x03u)
+#define DECODE_LOG_IN_EP        (0x85u)
+#define DECODE_MAX_PACKET       (64u)
+#define DECODE_COMM_PACKET      (16u)
+
+/* CDC request that raises DTR on the communication interface of the log
+* port.
+*/
+#define DECODE_RQST_OUT         (0x21u)
+#define DECODE_SET_CONTROL_LINE (0x22u)
+#define DECODE_DTR              (0x0001u)
+#define DECODE_LOG_INTERFACE    (2u)
+
+/* Defaults of the options. */
+#define DECODE_DEFAULT_DURATION (20u)       /* ms */
+#define DECODE_TIMEOUT          (1000u)     /* ms */
+#define DECODE_POLL_TIMEOUT     (1u)        /* ms */
+
+#define DECODE_WORD_SIZE        (4u)
+
+/* Decoder state: the words of the record being assembled and the counters. */
+typedef struct
+{
+    uint8  word[DECODE_WORD_SIZE];
+    uint8  wordBytes;
+    uint32 record[1u + LOG_MAX_ARGS];
+    uint8  recordWords;
+    uint8  nextSeq;
+    uint8  started;
+    uint8  quiet;
+    uint32 bytes;
+    uint32 records;
+    uint32 dropped;
+    uint32 badWords;
+    uint32 unknown;
+    uint32 count[LOG_ID_COUNT];
+} DECODE_STATE;
+
+#define DECODE_FORMAT_ENTRY(id, format)   format,
+#define DECODE_NAME_ENTRY(id, format)     #id,
+
+static const char *const decodeFormats[LOG_ID_COUNT] = { LOG_MESSAGES(DECODE_FORMAT_ENTRY) };
+static const char *const decodeNames[LOG_ID_COUNT] = { LOG_MESSAGES(DECODE_NAME_ENTRY) };
+
+static const HOST_USB_EP decodeEps[] =
+{
+    {0x81u,               HOST_USB_EP_INT,  DECODE_COMM_PACKET},
+    {DECODE_ECHO_IN_EP,   HOST_USB_EP_BULK, DECODE_MAX_PACKET},
+    {DECODE_ECHO_OUT_EP,  HOST_USB_EP_BULK, DECODE_MAX_PACKET},
+    {0x84u,               HOST_USB_EP_INT,  DECODE_COMM_PACKET},
+    {DECODE_LOG_IN_EP,    HOST_USB_EP_BULK, DECODE_MAX_PACKET},
+    {0x06u,               HOST_USB_EP_BULK, DECODE_MAX_PACKET}
+};
+
+static DECODE_STATE decode;
+
+static void   Decode_Record(void);
+static void   Decode_Word(uint32 word);
+static void   Decode_Bytes(const uint8 data[], uint32 length);
+static int    Decode_File(const char *path);
+static uint32 Decode_ReadLog(uint32 timeoutMs);
+static int    Decode_Live(uint32 packets, uint32 durationMs);
+static int    Decode_Summary(void);
+static void   Decode_Usage(const char *program);
+
+
+/*******************************************************************************
+* Function Name: Decode_Record
+********************************************************************************
+*
+* Summary:
+*  Renders a complete record with its format string and counts the records
+*  dropped since the previous one.
+*
+*******************************************************************************/
+static void Decode_Record(void)
+{
+    uint32 header = decode.record[0u];
+    uint32 id = header & LOG_HEADER_ID_MASK;
+    uint8  seq = (uint8) ((header & LOG_HEADER_SEQ_MASK) >> LOG_HEADER_SEQ_SHIFT);
+    uint8  gap;
+
+    if ((0u != decode.started) && (LOG_ID_START != id))
+    {
+        gap = (uint8) (seq - decode.nextSeq);
+        decode.dropped += gap;
+
+        if ((0u != gap) && (0u == decode.quiet))
+        {
+            printf("          ... %u records dropped\n", gap);
+        }
+    }
+
+    decode.started = 1u;
+    decode.nextSeq = (uint8) (seq + 1u);
+    ++decode.records;
+
+    if (id < LOG_ID_COUNT)
+    {
+        ++decode.count[id];
+
+        if (0u == decode.quiet)
+        {
+            printf("%3u  ", seq);
+            printf(decodeFormats[id], decode.record[1u], decode.record[2u], decode.record[3u]);
+            printf("\n");
+        }
+    }
+    else
+    {
+        ++decode.unknown;
+
+        if (0u == decode.quiet)
+        {
+            printf("%3u  unknown message %u\n", seq, id);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Decode_Word
+********************************************************************************
+*
+* Summary:
+*  Adds a word to the record being assembled. A header without the marker
+*  is counted and skipped, so the decoder finds the next record.
+*
+*******************************************************************************/
+static void Decode_Word(uint32 word)
+{
+    uint32 argc;
+
+    if (0u == decode.recordWords)
+    {
+        if (LOG_HEADER_MARK != (word & LOG_HEADER_MARK_MASK))
+        {
+            ++decode.badWords;
+            return;
+        }
+
+        (void) memset(decode.record, 0, sizeof(decode.record));
+    }
+
+    decode.record[decode.recordWords] = word;
+    ++decode.recordWords;
+
+    argc = (decode.record[0u] & LOG_HEADER_ARGC_MASK) >> LOG_HEADER_ARGC_SHIFT;
+
+    if (decode.recordWords > argc)
+    {
+        Decode_Record();
+        decode.recordWords = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Decode_Bytes
+********************************************************************************
+*
+* Summary:
+*  Feeds bytes of the stream: little-endian words that may span reads.
+*
+*******************************************************************************/
+static void Decode_Bytes(const uint8 data[], uint32 length)
+{
+    uint32 i;
+
+    decode.bytes += length;
+
+    for (i = 0u; i < length; ++i)
+    {
+        decode.word[decode.wordBytes] = data[i];
+        ++decode.wordBytes;
+
+        if (DECODE_WORD_SIZE == decode.wordBytes)
+        {
+            Decode_Word((uint32) decode.word[0u] | ((uint32) decode.word[1u] << 8u) |
+                        ((uint32) decode.word[2u] << 16u) | ((uint32) decode.word[3u] << 24u));
+            decode.wordBytes = 0u;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Decode_File
+********************************************************************************
+*
+* Summary:
+*  Decodes a captured log or the log port itself until the end of the file.
+*  A terminal is switched to raw mode so that no byte is translated.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Decode_File(const char *path)
+{
+    uint8  data[DECODE_MAX_PACKET];
+    struct termios mode;
+    ssize_t length;
+    int    fd;
+
+    fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        printf("cannot open %s\n", path);
+        return (HOST_USB_ERROR);
+    }
+
+    if ((0 != isatty(fd)) && (0 == tcgetattr(fd, &mode)))
+    {
+        cfmakeraw(&mode);
+        (void) tcsetattr(fd, TCSANOW, &mode);
+    }
+
+    while (0 < (length = read(fd, data, sizeof(data))))
+    {
+        Decode_Bytes(data, (uint32) length);
+    }
+
+    (void) close(fd);
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Decode_ReadLog
+********************************************************************************
+*
+* Summary:
+*  Reads and decodes the log endpoint until it has no data for timeoutMs.
+*
+* Return:
+*  Bytes read.
+*
+*******************************************************************************/
+static uint32 Decode_ReadLog(uint32 timeoutMs)
+{
+    uint8  data[DECODE_MAX_PACKET];
+    uint32 transferred;
+    uint32 total = 0u;
+
+    while ((HOST_USB_SUCCESS == HostUsb_Transfer(DECODE_LOG_IN_EP, data, DECODE_MAX_PACKET,
+                                                 &transferred, timeoutMs)) &&
+           (0u != transferred))
+    {
+        Decode_Bytes(data, transferred);
+        total += transferred;
+    }
+
+    return (total);
+}
+
+
+/*******************************************************************************
+* Function Name: Decode_Live
+********************************************************************************
+*
+* Summary:
+*  Opens the log port, loops the packets through the first port while it
+*  reads the log, then reads the log for durationMs more.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Decode_Live(uint32 packets, uint32 durationMs)
+{
+    uint8  data[DECODE_MAX_PACKET];
+    uint32 transferred;
+    uint32 received;
+    uint64 end;
+    uint32 i;
+
+    if (HOST_USB_SUCCESS != HostUsb_Open(DECODE_VID, DECODE_PID, decodeEps,
+                                         (uint8) (sizeof(decodeEps) / sizeof(decodeEps[0u]))))
+    {
+        return (HOST_USB_ERROR);
+    }
+
+    if (0 > HostUsb_Control(DECODE_RQST_OUT, DECODE_SET_CONTROL_LINE, DECODE_DTR,
+                            DECODE_LOG_INTERFACE, NULL, 0u, DECODE_TIMEOUT))
+    {
+        printf("SET_CONTROL_LINE_STATE failed\n");
+        return (HOST_USB_ERROR);
+    }
+
+    for (i = 0u; i < packets; ++i)
+    {
+        (void) memset(data, (int) i, sizeof(data));
+
+        if (HOST_USB_SUCCESS != HostUsb_Transfer(DECODE_ECHO_OUT_EP, data, DECODE_MAX_PACKET,
+                                                  &transferred, DECODE_TIMEOUT))
+        {
+            printf("OUT transfer failed after %u packets\n", i);
+            return (HOST_USB_ERROR);
+        }
+
+        /* The echo may come back in pieces. */
+        received = 0u;
+        while (received < DECODE_MAX_PACKET)
+        {
+            if (HOST_USB_SUCCESS != HostUsb_Transfer(DECODE_ECHO_IN_EP, data, DECODE_MAX_PACKET,
+                                                      &transferred, DECODE_TIMEOUT))
+            {
+                printf("echo lost after %u packets\n", i);
+                return (HOST_USB_ERROR);
+            }
+            received += transferred;
+        }
+
+        (void) Decode_ReadLog(DECODE_POLL_TIMEOUT);
+    }
+
+    end = HostUsb_TimeNs() + ((uint64) durationMs * 1000000u);
+    while (HostUsb_TimeNs() < end)
+    {
+        (void) Decode_ReadLog(DECODE_POLL_TIMEOUT);
+    }
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Decode_Summary
+********************************************************************************
+*
+* Summary:
+*  Prints the record counts. The log is bad if it does not start with a
+*  LOG_ID_START record, ends inside a record or has words without the record
+*  marker or unknown IDs.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Decode_Summary(void)
+{
+    uint32 i;
+
+    printf("log             : %u bytes, %u records, %u dropped\n",
+           decode.bytes, decode.records, decode.dropped);
+    printf("errors          : %u words out of frame, %u unknown IDs, %u bytes left over\n",
+           decode.badWords, decode.unknown,
+           (decode.recordWords * DECODE_WORD_SIZE) + decode.wordBytes);
+
+    for (i = 0u; i < LOG_ID_COUNT; ++i)
+    {
+        if (0u != decode.count[i])
+        {
+            printf("  %-22s %10u\n", decodeNames[i], decode.count[i]);
+        }
+    }
+
+    return (((0u == decode.count[LOG_ID_START]) || (0u != decode.badWords) ||
+             (0u != decode.unknown) || (0u != decode.recordWords) || (0u != decode.wordBytes)) ?
+            HOST_USB_ERROR : HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Decode_Usage
+********************************************************************************
+*
+* Summary:
+*  Prints the command line help.
+*
+*******************************************************************************/
+static void Decode_Usage(const char *program)
+{
+    printf("usage: %s [-f file] [-n packets] [-d ms] [-q]\n", program);
+    printf("  -f   decode a captured log or the log port (/dev/ttyACM1)\n");
+    printf("  -n   packets to loop through the first port while reading the log (0)\n");
+    printf("  -d   read the log for this long after the packets (%u ms)\n",
+           DECODE_DEFAULT_DURATION);
+    printf("  -q   print only the summary\n");
+}
+
+
+/*******************************************************************************
+* Function Name: HostTool_Main
+********************************************************************************
+*
+* Summary:
+*  Decodes the log from a file or from the device and prints the summary.
+*
+* Return:
+*  0 on success, 1 on a transfer or log error, 4 on a usage error.
+*
+*******************************************************************************/
+int HostTool_Main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    uint32 packets = 0u;
+    uint32 duration = DECODE_DEFAULT_DURATION;
+    uint8  usage = 0u;
+    int result;
+    int opt;
+
+    (void) memset(&decode, 0, sizeof(decode));
+
+    while (-1 != (opt = getopt(argc, argv, "f:n:d:qh")))
+    {
+        switch (opt)
+        {
+            case 'f': path     = optarg; break;
+            case 'n': packets  = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'd': duration = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'q': decode.quiet = 1u; break;
+            default:
+                usage = 1u;
+                break;
+        }
+    }
+
+    if (0u != usage)
+    {
+        Decode_Usage(argv[0]);
+        return (4);
+    }
+
+    if (NULL != path)
+    {
+        result = Decode_File(path);
+    }
+    else
+    {
+        result = Decode_Live(packets, duration);
+    }
+
+    if (HOST_USB_SUCCESS == result)
+    {
+        result = Decode_Summary();
+    }
+
+    result = (HOST_USB_SUCCESS == result) ? 0 : 1;
+
+    if (NULL == path)
+    {
+        HostUsb_Close(result);
+    }
+
+    return (result);
+}
+
+
+/* [] END OF FILE */
@@ -18,6 +18,10 @@
 *  mode. The LED is on when the USB bus is active and PSoC is in the active 
 *  mode. The LED is off after a suspend condition is detected and PSoC is in 
 *  the low-power mode.
+*  The firmware counts the packets of each endpoint, including the OUT packets
+*  it drops because the IN endpoint buffer is still full, and the bus resets
+*  and configuration changes. The host reads the counters with the
+*  GET_USB_STATS vendor request (usb_stats.h).
 *
 ********************************************************************************
 * Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
@@ -31,6 +35,7 @@
 *******************************************************************************/
 
 #include <main.h>
+#include "usb_stats.h"
 
 /* USB device number. */
 #define USBFS_DEVICE    (0u)
@@ -47,6 +52,12 @@ uint8 buffer[BUFFER_SIZE];
 uint8 usbIdleCounter = 0u;
 uint8 usbSuspend = 0u;
 
+/* Events posted by the USB interrupt callbacks: the host has completed a
+* transfer on the IN or OUT endpoint, or the configuration may have changed.
+*/
+volatile uint8 epEvent = 0u;
+volatile uint8 configEvent = 0u;
+
 /* Number of 1-ms counter ticks before suspend condition is detected. */
 #define SUSPEND_COUNT   (3u)
 
@@ -72,6 +83,9 @@ uint8 usbSuspend = 0u;
 *      (DeepSleep for PSoC 4200L or Sleep for PSoC 3/PSoC 5LP). A wakeup occurs
 *      when the host drives a resume condition on the USB bus and PSoC returns 
 *      to the active mode task execution.
+*   8. Between USB events in the active power state, PSoC waits in Sleep (WFI)
+*      until an endpoint interrupt callback or the timer posts an event.
+*   9. Counts the USB traffic for the GET_USB_STATS vendor request.
 *
 * Parameters:
 *  None.
@@ -84,12 +98,16 @@ int main()
 {
     CyGlobalIntEnable;
 
+    /* Clear the USB traffic statistics before the first bus reset. */
+    UsbStats_Clear();
+
     /* Start USBFS operation with 5V power supply. */
     USBFS_Start(USBFS_DEVICE, USBFS_5V_OPERATION);
 
     /* Wait until device is enumerated by host. It w */
     while (0u == USBFS_GetConfiguration())
     {
+        WaitForUsbEvent();
     }
 
     /* Enable OUT endpoint to receive data from host. */
@@ -119,6 +137,12 @@ int main()
             /* Indicate that device goes into low-power mode soon. */
             TURN_OFF_LED;
 
+            /* Data left into IN endpoint buffer is lost in low-power mode. */
+            if (USBFS_IN_BUFFER_EMPTY != USBFS_GetEPState(IN_EP_NUM))
+            {
+                USB_STATS_DROP(IN_EP_NUM);
+            }
+
             /* Prepare components before entering low-power mode. */
             Timer_Sleep();
             USBFS_Suspend();
@@ -149,6 +173,11 @@ int main()
             /* Indicate that device is in active mode. */
             TURN_ON_LED;
         }
+        else
+        {
+            /* Sleep until the next endpoint event or suspend detection. */
+            WaitForUsbEvent();
+        }
     }
 }
 
@@ -213,14 +242,27 @@ void BulkWrapAround(void)
 {
     uint16 length;
 
-    /* Check if configuration is changed. */
-    if (0u != USBFS_IsConfigurationChanged())
+    /* Apply a clear of the statistics requested by the host. */
+    UsbStats_Service();
+
+    /* Configuration can change only in the control endpoint or bus reset
+    * interrupt.
+    */
+    if (0u != configEvent)
     {
-        /* Re-enable endpoint when device is configured. */
-        if (0u != USBFS_GetConfiguration())
+        configEvent = 0u;
+
+        /* Check if configuration is changed. */
+        if (0u != USBFS_IsConfigurationChanged())
         {
-            /* Enable OUT endpoint to receive data from host. */
-            USBFS_EnableOutEP(OUT_EP_NUM);
+            USB_STATS_CONFIG_CHANGE;
+
+            /* Re-enable endpoint when device is configured. */
+            if (0u != USBFS_GetConfiguration())
+            {
+                /* Enable OUT endpoint to receive data from host. */
+                USBFS_EnableOutEP(OUT_EP_NUM);
+            }
         }
     }
 
@@ -232,6 +274,7 @@ void BulkWrapAround(void)
 
         /* Copy data from OUT endpoint buffer. */
         USBFS_ReadOutEP(OUT_EP_NUM, buffer, length);
+        USB_STATS_PACKET(OUT_EP_NUM, length);
 
         /* Check if IN endpoint buffer is empty. */
         if (USBFS_IN_BUFFER_EMPTY == USBFS_GetEPState(IN_EP_NUM))
@@ -240,9 +283,163 @@ void BulkWrapAround(void)
             * by host.
             */
             USBFS_LoadInEP(IN_EP_NUM, buffer, length);
+            USB_STATS_PACKET(IN_EP_NUM, length);
+        }
+        else
+        {
+            /* The host has not read the previous packet yet: the data is
+            * dropped.
+            */
+            USB_STATS_DROP(OUT_EP_NUM);
         }
     }
 }
 
 
+/*******************************************************************************
+* Function Name: WaitForUsbEvent
+********************************************************************************
+*
+* Summary:
+*  Puts the CPU into Sleep mode until a USB interrupt posts an event or a
+*  suspend condition is detected. Returns immediately if an event is already
+*  posted. The events are checked with interrupts disabled: an interrupt that
+*  occurs after the check stays pending and wakes the CPU from WFI. The
+*  endpoint event is cleared on return; the caller checks the endpoint state
+*  after that. PSoC 3 has no WFI and polls.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void WaitForUsbEvent(void)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    if ((0u == epEvent) && (0u == configEvent) && (0u == usbSuspend))
+    {
+    #if (CY_PSOC4)
+        CySysPmSleep();
+    #elif (CY_PSOC5)
+        CY_PM_WFI;
+    #endif /* (CY_PSOC4) */
+    }
+
+    CyExitCriticalSection(interruptState);
+
+    epEvent = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_0_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the control endpoint ISR. It posts an
+*  event to check for a configuration change.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_0_ISR_ExitCallback(void)
+{
+    configEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_1_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the IN endpoint ISR, after the host
+*  has read the IN endpoint buffer.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_1_ISR_ExitCallback(void)
+{
+    epEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_EP_2_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the OUT endpoint ISR, after the host
+*  has written the OUT endpoint buffer. It posts an event to loop back the data.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_EP_2_ISR_ExitCallback(void)
+{
+    epEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_BUS_RESET_ISR_ExitCallback
+********************************************************************************
+*
+* Summary:
+*  This function is called at the end of the bus reset ISR. It counts the bus
+*  reset and posts an event to check for a configuration change.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void USBFS_BUS_RESET_ISR_ExitCallback(void)
+{
+    USB_STATS_BUS_RESET;
+    configEvent = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: USBFS_HandleVendorRqst_Callback
+********************************************************************************
+*
+* Summary:
+*  This function is called by the component to handle vendor-specific
+*  requests. It handles the request that reads the USB traffic statistics.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  TRUE if the request is handled; FALSE otherwise.
+*
+*******************************************************************************/
+uint8 USBFS_HandleVendorRqst_Callback(void)
+{
+    return (UsbStats_HandleRequest());
+}
+
+
 /* [] END OF FILE */
@@ -29,6 +29,7 @@
 ****************************************/
 
 void BulkWrapAround(void);
+void WaitForUsbEvent(void);
 CY_ISR_PROTO(TimerIsr);
 
 
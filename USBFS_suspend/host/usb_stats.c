@@ -0,0 +1,312 @@
+/*******************************************************************************
+* File Name: usb_stats.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host tool that reads and decodes the USB traffic statistics of the USBFS
+*  Suspend and USBFS LPM examples with the GET_USB_STATS vendor request. It
+*  prints the bus resets, the configuration changes and the packets, bytes and
+*  dropped packets of each endpoint that has traffic.
+*  With -n the tool first loops packets through the bulk endpoints. It keeps up
+*  to -w packets written but not read back: with a window of more than one
+*  packet the firmware finds the IN endpoint buffer full and drops OUT data.
+*  With -c the device clears the counters after they are read.
+*
+*  Build against a device on the bus (libusb-1.0):
+*   gcc -I USBFS_Host_Emulation USBFS_suspend/host/usb_stats.c \
+*       USBFS_Host_Emulation/libusb/host_usb_libusb.c -lusb-1.0 -o usb_stats
+*  Build against the emulated firmware: add -pthread and this file to the
+*  build command in USBFS_Host_Emulation/README.md, then run
+*   ./usb_stats_sim -s host -- -n 100 -w 2
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation. All rights reserved.
+* This software is owned by Cypress Semiconductor Corporation and is protected
+* by and subject to worldwide patent and copyright laws and treaties.
+* Therefore, you may use this software only as provided in the license agreement
+* accompanying the software package from which you obtained this software.
+* CYPRESS AND ITS SUPPLIERS MAKE NO WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* WITH REGARD TO THIS SOFTWARE, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT,
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "host_usb.h"
+
+/* Device of the examples. */
+#define STATS_VID               (0x04B4u)
+#define STATS_PID               (0x8051u)
+#define STATS_IN_EP             (0x81u)
+#define STATS_OUT_EP            (0x02u)
+#define STATS_MAX_PACKET        (64u)
+
+/* Vendor-specific request of the firmware. */
+#define STATS_RQST_IN           (0xC0u)     /* Vendor, device, device to host */
+#define STATS_GET_USB_STATS     (0x04u)
+#define STATS_CLEAR             (0x01u)     /* wValue: clear after read */
+
+/* USB_STATS block of the firmware: endpoint count, bus resets and
+* configuration changes, then per endpoint packets, bytes and drops, all
+* 32-bit little-endian words.
+*/
+#define STATS_MAX_EP            (16u)
+#define STATS_HEADER            (12u)
+#define STATS_EP_SIZE           (12u)
+
+/* Defaults of the options. */
+#define STATS_DEFAULT_WINDOW    (1u)
+#define STATS_MAX_WINDOW        (16u)
+#define STATS_TIMEOUT           (1000u)     /* ms */
+#define STATS_DRAIN_TIMEOUT     (10u)       /* ms */
+
+static const HOST_USB_EP statsEps[] =
+{
+    {STATS_IN_EP,  HOST_USB_EP_BULK, STATS_MAX_PACKET},
+    {STATS_OUT_EP, HOST_USB_EP_BULK, STATS_MAX_PACKET}
+};
+
+static uint32 Stats_Word(const uint8 data[]);
+static int    Stats_Loop(uint32 packets, uint32 window);
+static int    Stats_Print(uint8 clear);
+static void   Stats_Usage(const char *program);
+
+
+/*******************************************************************************
+* Function Name: Stats_Word
+********************************************************************************
+*
+* Summary:
+*  Returns the little-endian 32-bit word at data.
+*
+*******************************************************************************/
+static uint32 Stats_Word(const uint8 data[])
+{
+    return ((uint32) data[0] | ((uint32) data[1] << 8u) |
+            ((uint32) data[2] << 16u) | ((uint32) data[3] << 24u));
+}
+
+
+/*******************************************************************************
+* Function Name: Stats_Loop
+********************************************************************************
+*
+* Summary:
+*  Writes the packets to the OUT endpoint with up to window packets not read
+*  back, then reads the IN endpoint until it times out. Prints how many
+*  packets came back; the firmware drops the others.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Stats_Loop(uint32 packets, uint32 window)
+{
+    uint8  data[STATS_MAX_PACKET];
+    uint32 written = 0u;
+    uint32 received = 0u;
+    uint32 pending = 0u;
+    uint32 transferred;
+    uint32 i;
+
+    /* Drop a packet left in the IN endpoint by an earlier run. */
+    while (HOST_USB_SUCCESS == HostUsb_Transfer(STATS_IN_EP, data, STATS_MAX_PACKET,
+                                                &transferred, STATS_DRAIN_TIMEOUT))
+    {
+    }
+
+    while (written < packets)
+    {
+        for (i = 0u; i < STATS_MAX_PACKET; ++i)
+        {
+            data[i] = (uint8) (written + i);
+        }
+
+        if (HOST_USB_SUCCESS != HostUsb_Transfer(STATS_OUT_EP, data, STATS_MAX_PACKET,
+                                                  &transferred, STATS_TIMEOUT))
+        {
+            printf("OUT transfer failed after %u packets\n", written);
+            return (HOST_USB_ERROR);
+        }
+
+        ++written;
+        ++pending;
+
+        /* Read back when the window is full. A dropped packet never comes
+        * back, so a short timeout ends the wait.
+        */
+        if (pending >= window)
+        {
+            while ((0u != pending) &&
+                   (HOST_USB_SUCCESS == HostUsb_Transfer(STATS_IN_EP, data, STATS_MAX_PACKET,
+                                                         &transferred, STATS_DRAIN_TIMEOUT)))
+            {
+                ++received;
+                --pending;
+            }
+            pending = 0u;
+        }
+    }
+
+    while (HOST_USB_SUCCESS == HostUsb_Transfer(STATS_IN_EP, data, STATS_MAX_PACKET,
+                                                &transferred, STATS_DRAIN_TIMEOUT))
+    {
+        ++received;
+    }
+
+    printf("loop            : %u packets written, %u read back\n", written, received);
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Stats_Print
+********************************************************************************
+*
+* Summary:
+*  Reads the statistics block with the GET_USB_STATS request and prints it.
+*
+* Return:
+*  HOST_USB_SUCCESS or HOST_USB_ERROR.
+*
+*******************************************************************************/
+static int Stats_Print(uint8 clear)
+{
+    uint8  block[STATS_HEADER + (STATS_MAX_EP * STATS_EP_SIZE)];
+    const uint8 *ep;
+    uint32 epCount;
+    uint32 i;
+    int    length;
+
+    length = HostUsb_Control(STATS_RQST_IN, STATS_GET_USB_STATS,
+                             (0u != clear) ? STATS_CLEAR : 0u, 0u,
+                             block, sizeof(block), STATS_TIMEOUT);
+
+    if (length < (int) STATS_HEADER)
+    {
+        printf("device does not support GET_USB_STATS\n");
+        return (HOST_USB_ERROR);
+    }
+
+    epCount = Stats_Word(&block[0]);
+
+    if ((epCount > STATS_MAX_EP) ||
+        ((uint32) length < (STATS_HEADER + (epCount * STATS_EP_SIZE))))
+    {
+        printf("unknown statistics block layout\n");
+        return (HOST_USB_ERROR);
+    }
+
+    printf("bus resets      : %u\n", Stats_Word(&block[4]));
+    printf("config changes  : %u\n", Stats_Word(&block[8]));
+    printf("  %-4s %10s %12s %10s\n", "ep", "packets", "bytes", "drops");
+
+    for (i = 0u; i < epCount; ++i)
+    {
+        ep = &block[STATS_HEADER + (i * STATS_EP_SIZE)];
+
+        if ((0u != Stats_Word(&ep[0])) || (0u != Stats_Word(&ep[8])))
+        {
+            printf("  %-4u %10u %12u %10u\n", i,
+                   Stats_Word(&ep[0]), Stats_Word(&ep[4]), Stats_Word(&ep[8]));
+        }
+    }
+
+    if (0u != clear)
+    {
+        printf("counters cleared\n");
+    }
+
+    return (HOST_USB_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Stats_Usage
+********************************************************************************
+*
+* Summary:
+*  Prints the command line help.
+*
+*******************************************************************************/
+static void Stats_Usage(const char *program)
+{
+    printf("usage: %s [-n packets] [-w window] [-c]\n", program);
+    printf("  -n   packets to loop through the bulk endpoints first (0)\n");
+    printf("  -w   packets written before they are read back (%u, max %u)\n",
+           STATS_DEFAULT_WINDOW, STATS_MAX_WINDOW);
+    printf("  -c   clear the counters after they are read\n");
+}
+
+
+/*******************************************************************************
+* Function Name: HostTool_Main
+********************************************************************************
+*
+* Summary:
+*  Optionally loops packets through the device, then reads and prints the
+*  statistics.
+*
+* Return:
+*  0 on success, 1 on a transfer error, 4 on a usage error.
+*
+*******************************************************************************/
+int HostTool_Main(int argc, char *argv[])
+{
+    uint32 packets = 0u;
+    uint32 window = STATS_DEFAULT_WINDOW;
+    uint8  clear = 0u;
+    uint8  usage = 0u;
+    int result;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "n:w:ch")))
+    {
+        switch (opt)
+        {
+            case 'n': packets = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'w': window  = (uint32) strtoul(optarg, NULL, 0); break;
+            case 'c': clear   = 1u; break;
+            default:
+                usage = 1u;
+                break;
+        }
+    }
+
+    if ((0u != usage) || (0u == window) || (window > STATS_MAX_WINDOW))
+    {
+        Stats_Usage(argv[0]);
+        return (4);
+    }
+
+    if (HOST_USB_SUCCESS != HostUsb_Open(STATS_VID, STATS_PID, statsEps, 2u))
+    {
+        HostUsb_Close(1);
+        return (1);
+    }
+
+    result = HOST_USB_SUCCESS;
+
+    if (0u != packets)
+    {
+        result = Stats_Loop(packets, window);
+    }
+
+    if (HOST_USB_SUCCESS == result)
+    {
+        result = Stats_Print(clear);
+    }
+
+    result = (HOST_USB_SUCCESS == result) ? 0 : 1;
+    HostUsb_Close(result);
+
+    return (result);
+}
+
+
+/* [] END OF FILE */